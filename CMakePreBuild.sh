@@ -14,7 +14,7 @@ echo "[Pre-build]  build root directory:       $BUILD_ROOT"
 
 # install packages
 #sudo apt-get update
-#sudo apt-get install -y libqt4-dev qt4-dev-tools libglew-dev glew-utils libgstreamer1.0-dev libgstreamer-plugins-base1.0-dev libglib2.0-dev
+#sudo apt-get install -y libqt4-dev qt4-dev-tools libglew-dev glew-utils libgstreamer1.0-dev libgstreamer-plugins-base1.0-dev libglib2.0-dev libturbojpeg0-dev libbenchmark-dev
 
 #sudo apt-get update
 
@@ -0,0 +1,1935 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "benchUtility.h"
+
+#include "cudaYUV.h"
+#include "cudaRGB.h"
+#include "cudaResize.h"
+#include "cudaLetterbox.h"
+#include "cudaNormalize.h"
+#include "cudaOverlay.h"
+#include "cudaFont.h"
+#include "cudaTensor.h"
+#include "cudaTensor-ROI.h"
+
+#include "cpuYUV.h"
+#include "cpuFeatures.h"
+#include "cpuThreadPool.h"
+
+#include "imageOps.h"
+#include "image.h"
+
+#include <algorithm>
+
+
+//-----------------------------------------------------------------------------------
+// CPU reference implementations (scalar, mirroring the CUDA kernels)
+//-----------------------------------------------------------------------------------
+static inline uint8_t refClamp( float f )
+{
+	return (uint8_t)std::min(std::max(f, 0.0f), 255.0f);
+}
+
+// BT.709 limited range in float (the default colorimetry of the fixed-point kernels)
+static inline uchar4 refYUV2RGBA( float y, float u, float v )
+{
+	y = (y - 16.0f) * 1.1644f;
+
+	return make_uchar4(refClamp(y + 1.7927f * v),
+				    refClamp(y - 0.2132f * u - 0.5329f * v),
+				    refClamp(y + 2.1124f * u), 255);
+}
+
+static void refNV12ToRGBA( const uint8_t* input, uchar4* output, size_t width, size_t height )
+{
+	const uint8_t* chroma = input + width * height;
+
+	for( size_t y=0; y < height; y++ )
+	{
+		const uint8_t* luma = input + y * width;
+		const uint8_t* uv   = chroma + (y >> 1) * width;
+
+		for( size_t x=0; x < width; x++ )
+		{
+			const size_t c = x & ~1;
+			output[y * width + x] = refYUV2RGBA(luma[x], uv[c] - 128.0f, uv[c+1] - 128.0f);
+		}
+	}
+}
+
+static void refNV12ToRGBAf( const uint8_t* input, float4* output, size_t width, size_t height )
+{
+	const uint8_t* chroma = input + width * height;
+
+	for( size_t y=0; y < height; y++ )
+	{
+		const uint8_t* luma = input + y * width;
+		const uint8_t* uv   = chroma + (y >> 1) * width;
+
+		for( size_t x=0; x < width; x++ )
+		{
+			const size_t c = x & ~1;
+			const uchar4 px = refYUV2RGBA(luma[x], uv[c] - 128.0f, uv[c+1] - 128.0f);
+			output[y * width + x] = make_float4(px.x, px.y, px.z, px.w);
+		}
+	}
+}
+
+static void refYUYVToRGBA( const uchar4* input, uchar4* output, size_t width, size_t height )
+{
+	const size_t pairs = width / 2;
+
+	for( size_t y=0; y < height; y++ )
+	{
+		for( size_t x=0; x < pairs; x++ )
+		{
+			const uchar4 m = input[y * pairs + x];
+			const float  u = m.y - 128.0f;
+			const float  v = m.w - 128.0f;
+
+			output[y * width + x * 2 + 0] = make_uchar4(refClamp(m.x + 1.4065f * v), refClamp(m.x - 0.3455f * u - 0.7169f * v), refClamp(m.x + 1.7790f * u), 255);
+			output[y * width + x * 2 + 1] = make_uchar4(refClamp(m.z + 1.4065f * v), refClamp(m.z - 0.3455f * u - 0.7169f * v), refClamp(m.z + 1.7790f * u), 255);
+		}
+	}
+}
+
+static void refRGBToRGBAf( const uchar3* input, float4* output, size_t width, size_t height )
+{
+	const size_t pixels = width * height;
+
+	for( size_t n=0; n < pixels; n++ )
+		output[n] = make_float4(input[n].x, input[n].y, input[n].z, 255.0f);
+}
+
+static void refResizeRGBA( const float4* input, size_t inputWidth, size_t inputHeight, float4* output, size_t outputWidth, size_t outputHeight )
+{
+	const float sx = float(inputWidth) / float(outputWidth);
+	const float sy = float(inputHeight) / float(outputHeight);
+
+	for( size_t y=0; y < outputHeight; y++ )
+	{
+		const float4* row = input + int(y * sy) * inputWidth;
+
+		for( size_t x=0; x < outputWidth; x++ )
+			output[y * outputWidth + x] = row[int(x * sx)];
+	}
+}
+
+static void refNormalizeRGBA( const float4* input, float4* output, size_t width, size_t height, float scale )
+{
+	const size_t pixels = width * height;
+
+	for( size_t n=0; n < pixels; n++ )
+		output[n] = make_float4(input[n].x * scale, input[n].y * scale, input[n].z * scale, input[n].w * scale);
+}
+
+static void refRectOutlineOverlay( const float4* input, float4* output, size_t width, size_t height, const float4* rects, int numRects, const float4& color )
+{
+	const float alpha = color.w / 255.0f;
+	const float ialph = 1.0f - alpha;
+
+	for( size_t y=0; y < height; y++ )
+	{
+		for( size_t x=0; x < width; x++ )
+		{
+			float4 px = input[y * width + x];
+
+			for( int n=0; n < numRects; n++ )
+			{
+				const float4& r = rects[n];
+
+				if( y >= r.y && y <= r.w && x >= r.x && x <= r.z )
+				{
+					px.x = alpha * color.x + ialph * px.x;
+					px.y = alpha * color.y + ialph * px.y;
+					px.z = alpha * color.z + ialph * px.z;
+				}
+			}
+
+			output[y * width + x] = px;
+		}
+	}
+}
+
+static void refOverlayText( const float4* font, int fontWidth, int cell, const short4* text, int length, float4* output, int width, int height, const float4& color )
+{
+	for( int c=0; c < length; c++ )
+	{
+		const short4 t = text[c];
+
+		for( int j=0; j < cell; j++ )
+		{
+			const int y = t.y + j;
+
+			if( y < 0 || y >= height )
+				continue;
+
+			for( int i=0; i < cell; i++ )
+			{
+				const int x = t.x + i;
+
+				if( x < 0 || x >= width )
+					continue;
+
+				const float4 f = font[(t.w + j) * fontWidth + t.z + i];
+				float4& px = output[y * width + x];
+
+				const float alpha = f.w * color.w / (255.0f * 255.0f);
+				const float ialph = 1.0f - alpha;
+
+				px.x = alpha * f.x * color.x / 255.0f + ialph * px.x;
+				px.y = alpha * f.y * color.y / 255.0f + ialph * px.y;
+				px.z = alpha * f.z * color.z / 255.0f + ialph * px.z;
+			}
+		}
+	}
+}
+
+
+// label the CPU backend benchmarks with the ISA and number of threads
+static void benchPoolLabel( benchmark::State& state )
+{
+	char str[64];
+	snprintf(str, sizeof(str), "%s x%u", cpuISAName(cpuGetISA()), cpuThreadPool::Global()->GetNumThreads());
+	state.SetLabel(str);
+}
+
+
+// bounding boxes used by the overlay benchmarks
+#define BENCH_RECTS 16
+
+static void benchRects( float4* rects, size_t width, size_t height )
+{
+	for( int n=0; n < BENCH_RECTS; n++ )
+	{
+		const float x = (n % 4) * width / 4.0f + 16.0f;
+		const float y = (n / 4) * height / 4.0f + 16.0f;
+
+		rects[n] = make_float4(x, y, x + width / 8.0f, y + height / 8.0f);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------
+// NV12 to RGBA
+//-----------------------------------------------------------------------------------
+static void BM_NV12ToRGBA_CPU( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 3 / 2);
+	benchBuffer output(width * height * sizeof(uchar4));
+
+	for( auto _ : state )
+	{
+		refNV12ToRGBA(input.cpu<uint8_t>(), output.cpu<uchar4>(), width, height);
+		benchmark::DoNotOptimize(output.cpu<uchar4>());
+	}
+
+	benchReport(state, width * height * 3 / 2 + width * height * sizeof(uchar4));
+}
+
+static void BM_NV12ToRGBA_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 3 / 2, true);
+	benchBuffer output(width * height * sizeof(uchar4), true);
+
+	for( auto _ : state )
+	{
+		cudaNV12ToRGBA(input.gpu<uint8_t>(), output.gpu<uchar4>(), width, height);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, width * height * 3 / 2 + width * height * sizeof(uchar4));
+}
+
+static void BM_NV12ToRGBAf_CPU( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 3 / 2);
+	benchBuffer output(width * height * sizeof(float4));
+
+	for( auto _ : state )
+	{
+		refNV12ToRGBAf(input.cpu<uint8_t>(), output.cpu<float4>(), width, height);
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, width * height * 3 / 2 + width * height * sizeof(float4));
+}
+
+static void BM_NV12ToRGBAf_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 3 / 2, true);
+	benchBuffer output(width * height * sizeof(float4), true);
+
+	for( auto _ : state )
+	{
+		cudaNV12ToRGBAf(input.gpu<uint8_t>(), output.gpu<float4>(), width, height);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, width * height * 3 / 2 + width * height * sizeof(float4));
+}
+
+static void BM_NV12ToRGBA_SIMD( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 3 / 2);
+	benchBuffer output(width * height * sizeof(uchar4));
+
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		cpuNV12ToRGBA(input.cpu<uint8_t>(), output.cpu<uchar4>(), width, height);
+		benchmark::DoNotOptimize(output.cpu<uchar4>());
+	}
+
+	benchReport(state, width * height * 3 / 2 + width * height * sizeof(uchar4));
+}
+
+static void BM_NV12ToRGBAf_SIMD( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 3 / 2);
+	benchBuffer output(width * height * sizeof(float4));
+
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		cpuNV12ToRGBAf(input.cpu<uint8_t>(), output.cpu<float4>(), width, height);
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, width * height * 3 / 2 + width * height * sizeof(float4));
+}
+
+static void BM_NV12ToBGR_SIMD( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 3 / 2);
+	benchBuffer output(width * height * sizeof(uchar3));
+
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		cpuNV12ToBGR(input.cpu<uint8_t>(), output.cpu<uchar3>(), width, height);
+		benchmark::DoNotOptimize(output.cpu<uchar3>());
+	}
+
+	benchReport(state, width * height * 3 / 2 + width * height * sizeof(uchar3));
+}
+
+BENCH_RESOLUTIONS(BM_NV12ToRGBA_CPU);
+BENCH_RESOLUTIONS(BM_NV12ToRGBA_SIMD);
+BENCH_RESOLUTIONS(BM_NV12ToRGBAf_SIMD);
+BENCH_RESOLUTIONS(BM_NV12ToBGR_SIMD);
+BENCH_RESOLUTIONS_CUDA(BM_NV12ToRGBA_CUDA);
+BENCH_RESOLUTIONS(BM_NV12ToRGBAf_CPU);
+BENCH_RESOLUTIONS_CUDA(BM_NV12ToRGBAf_CUDA);
+
+
+//-----------------------------------------------------------------------------------
+// RGBA to NV12 (the encode path), against the scalar I420 conversion
+//-----------------------------------------------------------------------------------
+static void BM_RGBAToI420_CPU( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(uchar4));
+	benchBuffer output(width * height * 3 / 2);
+
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		cpuRGBAToI420(input.cpu<uchar4>(), output.cpu<uint8_t>(), width, height);
+		benchmark::DoNotOptimize(output.cpu<uint8_t>());
+	}
+
+	benchReport(state, width * height * sizeof(uchar4) + width * height * 3 / 2);
+}
+
+static void BM_RGBAToNV12_SIMD( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(uchar4));
+	benchBuffer output(width * height * 3 / 2);
+
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		cpuRGBAToNV12(input.cpu<uchar4>(), output.cpu<uint8_t>(), width, height);
+		benchmark::DoNotOptimize(output.cpu<uint8_t>());
+	}
+
+	benchReport(state, width * height * sizeof(uchar4) + width * height * 3 / 2);
+}
+
+static void BM_RGBAfToNV12_SIMD( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(float4));
+	benchBuffer output(width * height * 3 / 2);
+
+	input.fillFloat(width * height * 4);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		cpuRGBAToNV12(input.cpu<float4>(), output.cpu<uint8_t>(), width, height);
+		benchmark::DoNotOptimize(output.cpu<uint8_t>());
+	}
+
+	benchReport(state, width * height * sizeof(float4) + width * height * 3 / 2);
+}
+
+static void BM_RGBAToNV12_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(uchar4), true);
+	benchBuffer output(width * height * 3 / 2, true);
+
+	for( auto _ : state )
+	{
+		cudaRGBAToNV12(input.gpu<uchar4>(), output.gpu<uint8_t>(), width, height);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, width * height * sizeof(uchar4) + width * height * 3 / 2);
+}
+
+BENCH_RESOLUTIONS(BM_RGBAToI420_CPU);
+BENCH_RESOLUTIONS(BM_RGBAToNV12_SIMD);
+BENCH_RESOLUTIONS(BM_RGBAfToNV12_SIMD);
+BENCH_RESOLUTIONS_CUDA(BM_RGBAToNV12_CUDA);
+
+
+//-----------------------------------------------------------------------------------
+// NV12 luma to quarter-resolution grayscale (only the Y plane is read)
+//-----------------------------------------------------------------------------------
+static void BM_NV12ToGray_CPU( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 3 / 2);
+	benchBuffer output(width / 2 * height / 2 * sizeof(float));
+
+	for( auto _ : state )
+	{
+		cpuYUVToGray(input.cpu<uint8_t>(), YUV_NV12, width, height, output.cpu<float>(), width / 2, height / 2);
+		benchmark::DoNotOptimize(output.cpu<float>());
+	}
+
+	benchReport(state, width * height + width / 2 * height / 2 * sizeof(float));
+}
+
+static void BM_NV12ToGray_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 3 / 2, true);
+	benchBuffer output(width / 2 * height / 2 * sizeof(float), true);
+
+	for( auto _ : state )
+	{
+		cudaYUVToGray(input.gpu<uint8_t>(), YUV_NV12, width, height, output.gpu<float>(), width / 2, height / 2);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, width * height + width / 2 * height / 2 * sizeof(float));
+}
+
+BENCH_RESOLUTIONS(BM_NV12ToGray_CPU);
+BENCH_RESOLUTIONS_CUDA(BM_NV12ToGray_CUDA);
+
+
+//-----------------------------------------------------------------------------------
+// NV12 to RGBAf of many streams, one call per frame vs one batch
+//-----------------------------------------------------------------------------------
+static void benchStreamFrames( benchmark::State& state, uint8_t* input, float4* output, std::vector<yuvBatchFrame>& frames )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	frames.resize(state.range(2));
+
+	for( size_t n=0; n < frames.size(); n++ )
+	{
+		frames[n].input        = input + n * width * height * 3 / 2;
+		frames[n].inputPitch   = width;
+		frames[n].inputWidth   = width;
+		frames[n].inputHeight  = height;
+		frames[n].output       = output + n * width * height;
+		frames[n].outputPitch  = width * sizeof(float4);
+		frames[n].outputWidth  = width;
+		frames[n].outputHeight = height;
+	}
+}
+
+static void BM_NV12ToRGBAfStreams_SIMD( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+	const size_t count  = state.range(2);
+
+	benchBuffer input(width * height * 3 / 2 * count);
+	benchBuffer output(width * height * sizeof(float4) * count);
+
+	std::vector<yuvBatchFrame> frames;
+	benchStreamFrames(state, input.cpu<uint8_t>(), output.cpu<float4>(), frames);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		for( size_t n=0; n < frames.size(); n++ )
+			cpuNV12ToRGBAf(frames[n].input, (float4*)frames[n].output, frames[n].outputWidth, frames[n].outputHeight);
+
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, (width * height * 3 / 2 + width * height * sizeof(float4)) * count);
+}
+
+static void BM_NV12ToRGBAfStreams_Batch_SIMD( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+	const size_t count  = state.range(2);
+
+	benchBuffer input(width * height * 3 / 2 * count);
+	benchBuffer output(width * height * sizeof(float4) * count);
+
+	std::vector<yuvBatchFrame> frames;
+	benchStreamFrames(state, input.cpu<uint8_t>(), output.cpu<float4>(), frames);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		cpuYUVToFormatBatch(&frames[0], frames.size(), YUV_NV12, IMAGE_RGBA32F);
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, (width * height * 3 / 2 + width * height * sizeof(float4)) * count);
+}
+
+static void BM_NV12ToRGBAfStreams_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+	const size_t count  = state.range(2);
+
+	benchBuffer input(width * height * 3 / 2 * count, true);
+	benchBuffer output(width * height * sizeof(float4) * count, true);
+
+	std::vector<yuvBatchFrame> frames;
+	benchStreamFrames(state, input.gpu<uint8_t>(), output.gpu<float4>(), frames);
+
+	for( auto _ : state )
+	{
+		for( size_t n=0; n < frames.size(); n++ )
+			cudaNV12ToRGBAf(frames[n].input, (float4*)frames[n].output, frames[n].outputWidth, frames[n].outputHeight);
+
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, (width * height * 3 / 2 + width * height * sizeof(float4)) * count);
+}
+
+static void BM_NV12ToRGBAfStreams_Batch_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+	const size_t count  = state.range(2);
+
+	benchBuffer input(width * height * 3 / 2 * count, true);
+	benchBuffer output(width * height * sizeof(float4) * count, true);
+
+	std::vector<yuvBatchFrame> frames;
+	benchStreamFrames(state, input.gpu<uint8_t>(), output.gpu<float4>(), frames);
+
+	for( auto _ : state )
+	{
+		cudaYUVToFormatBatch(&frames[0], frames.size(), YUV_NV12, IMAGE_RGBA32F);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, (width * height * 3 / 2 + width * height * sizeof(float4)) * count);
+}
+
+// width, height, number of streams
+#define BENCH_STREAMS(func)	\
+	BENCHMARK(func)->Args({320, 240, 32})->Args({640, 360, 32})->Unit(benchmark::kMicrosecond)
+
+BENCH_STREAMS(BM_NV12ToRGBAfStreams_SIMD);
+BENCH_STREAMS(BM_NV12ToRGBAfStreams_Batch_SIMD);
+BENCH_STREAMS(BM_NV12ToRGBAfStreams_CUDA);
+BENCH_STREAMS(BM_NV12ToRGBAfStreams_Batch_CUDA);
+
+
+//-----------------------------------------------------------------------------------
+// NV12 to a detector input (416x416 RGBAf planar), a preview (320x180 RGBA8) and
+// a full resolution RGBA8 snapshot, in one pass vs one batch call per output
+// (the batch has no planar layout, so it writes the detector input interleaved)
+//-----------------------------------------------------------------------------------
+static size_t benchProfiles( size_t width, size_t height, uint8_t* output, yuvProfile* profiles )
+{
+	profiles[0] = yuvProfile(416, 416, IMAGE_RGBA32F, IMAGE_PLANAR);
+	profiles[1] = yuvProfile(320, 180, IMAGE_RGBA8);
+	profiles[2] = yuvProfile(width, height, IMAGE_RGBA8);
+
+	size_t size = 0;
+
+	for( int n=0; n < 3; n++ )
+	{
+		profiles[n].output = output + size;
+		size += profiles[n].width * profiles[n].height * imageFormatSize(profiles[n].format);
+	}
+
+	return size;
+}
+
+static void benchProfileFrames( uint8_t* input, size_t width, size_t height, const yuvProfile* profiles, yuvBatchFrame* frames )
+{
+	for( int n=0; n < 3; n++ )
+	{
+		frames[n].input        = input;
+		frames[n].inputPitch   = width;
+		frames[n].inputWidth   = width;
+		frames[n].inputHeight  = height;
+		frames[n].output       = profiles[n].output;
+		frames[n].outputPitch  = profiles[n].width * imageFormatSize(profiles[n].format);
+		frames[n].outputWidth  = profiles[n].width;
+		frames[n].outputHeight = profiles[n].height;
+	}
+}
+
+static void BM_NV12Profiles_Pool( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	yuvProfile profiles[3];
+
+	benchBuffer input(width * height * 3 / 2);
+	benchBuffer output(benchProfiles(width, height, NULL, profiles));
+
+	const size_t outputSize = benchProfiles(width, height, output.cpu<uint8_t>(), profiles);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		cpuYUVToProfiles(input.cpu<uint8_t>(), width, YUV_NV12, width, height, profiles, 3);
+		benchmark::DoNotOptimize(output.cpu<uint8_t>());
+	}
+
+	benchReport(state, width * height * 3 / 2 + outputSize);
+}
+
+static void BM_NV12ProfilesBatch_Pool( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	yuvProfile profiles[3];
+	yuvBatchFrame frames[3];
+
+	benchBuffer input(width * height * 3 / 2);
+	benchBuffer output(benchProfiles(width, height, NULL, profiles));
+
+	const size_t outputSize = benchProfiles(width, height, output.cpu<uint8_t>(), profiles);
+	benchProfileFrames(input.cpu<uint8_t>(), width, height, profiles, frames);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		cpuYUVToFormatBatch(&frames[0], 1, YUV_NV12, IMAGE_RGBA32F);
+		cpuYUVToFormatBatch(&frames[1], 2, YUV_NV12, IMAGE_RGBA8);
+		benchmark::DoNotOptimize(output.cpu<uint8_t>());
+	}
+
+	benchReport(state, width * height * 3 / 2 * 3 + outputSize);
+}
+
+static void BM_NV12Profiles_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	yuvProfile profiles[3];
+
+	benchBuffer input(width * height * 3 / 2, true);
+	benchBuffer output(benchProfiles(width, height, NULL, profiles), true);
+
+	const size_t outputSize = benchProfiles(width, height, output.gpu<uint8_t>(), profiles);
+
+	for( auto _ : state )
+	{
+		cudaYUVToProfiles(input.gpu<uint8_t>(), width, YUV_NV12, width, height, profiles, 3);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, width * height * 3 / 2 + outputSize);
+}
+
+static void BM_NV12ProfilesBatch_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	yuvProfile profiles[3];
+	yuvBatchFrame frames[3];
+
+	benchBuffer input(width * height * 3 / 2, true);
+	benchBuffer output(benchProfiles(width, height, NULL, profiles), true);
+
+	const size_t outputSize = benchProfiles(width, height, output.gpu<uint8_t>(), profiles);
+	benchProfileFrames(input.gpu<uint8_t>(), width, height, profiles, frames);
+
+	for( auto _ : state )
+	{
+		cudaYUVToFormatBatch(&frames[0], 1, YUV_NV12, IMAGE_RGBA32F);
+		cudaYUVToFormatBatch(&frames[1], 2, YUV_NV12, IMAGE_RGBA8);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, width * height * 3 / 2 * 3 + outputSize);
+}
+
+#define BENCH_PROFILES(func)	\
+	BENCHMARK(func)->Args({1920, 1080})->Unit(benchmark::kMicrosecond)
+
+BENCH_PROFILES(BM_NV12Profiles_Pool);
+BENCH_PROFILES(BM_NV12ProfilesBatch_Pool);
+BENCH_PROFILES(BM_NV12Profiles_CUDA);
+BENCH_PROFILES(BM_NV12ProfilesBatch_CUDA);
+
+
+//-----------------------------------------------------------------------------------
+// YUYV to RGBA
+//-----------------------------------------------------------------------------------
+static void BM_YUYVToRGBA_CPU( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 2);
+	benchBuffer output(width * height * sizeof(uchar4));
+
+	for( auto _ : state )
+	{
+		refYUYVToRGBA(input.cpu<uchar4>(), output.cpu<uchar4>(), width, height);
+		benchmark::DoNotOptimize(output.cpu<uchar4>());
+	}
+
+	benchReport(state, width * height * 2 + width * height * sizeof(uchar4));
+}
+
+static void BM_YUYVToRGBA_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 2, true);
+	benchBuffer output(width * height * sizeof(uchar4), true);
+
+	for( auto _ : state )
+	{
+		cudaYUYVToRGBA(input.gpu<uchar2>(), output.gpu<uchar4>(), width, height);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, width * height * 2 + width * height * sizeof(uchar4));
+}
+
+static void BM_YUYVToRGBA_Pool( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 2);
+	benchBuffer output(width * height * sizeof(uchar4));
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		ops->YUYVToRGBA(input.cpu<uchar2>(), output.cpu<uchar4>(), width, height);
+		benchmark::DoNotOptimize(output.cpu<uchar4>());
+	}
+
+	benchReport(state, width * height * 2 + width * height * sizeof(uchar4));
+}
+
+BENCH_RESOLUTIONS(BM_YUYVToRGBA_CPU);
+BENCH_RESOLUTIONS(BM_YUYVToRGBA_Pool);
+BENCH_RESOLUTIONS_CUDA(BM_YUYVToRGBA_CUDA);
+
+
+//-----------------------------------------------------------------------------------
+// RGB to RGBAf
+//-----------------------------------------------------------------------------------
+static void BM_RGBToRGBAf_CPU( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(uchar3));
+	benchBuffer output(width * height * sizeof(float4));
+
+	for( auto _ : state )
+	{
+		refRGBToRGBAf(input.cpu<uchar3>(), output.cpu<float4>(), width, height);
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, width * height * (sizeof(uchar3) + sizeof(float4)));
+}
+
+static void BM_RGBToRGBAf_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(uchar3), true);
+	benchBuffer output(width * height * sizeof(float4), true);
+
+	for( auto _ : state )
+	{
+		cudaRGBToRGBAf(input.gpu<uchar3>(), output.gpu<float4>(), width, height);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, width * height * (sizeof(uchar3) + sizeof(float4)));
+}
+
+static void BM_RGBToRGBAf_Pool( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(uchar3));
+	benchBuffer output(width * height * sizeof(float4));
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		ops->RGBToRGBAf(input.cpu<uchar3>(), output.cpu<float4>(), width, height);
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, width * height * (sizeof(uchar3) + sizeof(float4)));
+}
+
+BENCH_RESOLUTIONS(BM_RGBToRGBAf_CPU);
+BENCH_RESOLUTIONS(BM_RGBToRGBAf_Pool);
+BENCH_RESOLUTIONS_CUDA(BM_RGBToRGBAf_CUDA);
+
+
+//-----------------------------------------------------------------------------------
+// resize (to half resolution)
+//-----------------------------------------------------------------------------------
+static void BM_ResizeRGBA_CPU( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(float4));
+	benchBuffer output(width * height / 4 * sizeof(float4));
+
+	input.fillFloat(width * height * 4);
+
+	for( auto _ : state )
+	{
+		refResizeRGBA(input.cpu<float4>(), width, height, output.cpu<float4>(), width / 2, height / 2);
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, width * height / 4 * sizeof(float4) * 2);
+}
+
+static void BM_ResizeRGBA_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(float4), true);
+	benchBuffer output(width * height / 4 * sizeof(float4), true);
+
+	input.fillFloat(width * height * 4);
+
+	for( auto _ : state )
+	{
+		cudaResizeRGBA(input.gpu<float4>(), width, height, output.gpu<float4>(), width / 2, height / 2);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, width * height / 4 * sizeof(float4) * 2);
+}
+
+static void BM_ResizeRGBA_Pool( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(float4));
+	benchBuffer output(width * height / 4 * sizeof(float4));
+
+	input.fillFloat(width * height * 4);
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		ops->ResizeRGBA(input.cpu<float4>(), width, height, output.cpu<float4>(), width / 2, height / 2);
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, width * height / 4 * sizeof(float4) * 2);
+}
+
+BENCH_RESOLUTIONS(BM_ResizeRGBA_CPU);
+BENCH_RESOLUTIONS(BM_ResizeRGBA_Pool);
+BENCH_RESOLUTIONS_CUDA(BM_ResizeRGBA_CUDA);
+
+
+//-----------------------------------------------------------------------------------
+// resize filters of RGBA8, to half resolution (the 2x area path) or to 300x300
+//-----------------------------------------------------------------------------------
+static void benchResizeSize( benchmark::State& state, int divisor, size_t& outputWidth, size_t& outputHeight )
+{
+	outputWidth  = (divisor > 0) ? state.range(0) / divisor : 300;
+	outputHeight = (divisor > 0) ? state.range(1) / divisor : 300;
+}
+
+static void BM_ResizeFilter_Pool( benchmark::State& state, resizeFilter filter, int divisor )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	size_t outputWidth, outputHeight;
+	benchResizeSize(state, divisor, outputWidth, outputHeight);
+
+	benchBuffer input(width * height * sizeof(uchar4));
+	benchBuffer output(outputWidth * outputHeight * sizeof(uchar4));
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		ops->Resize(ImageView<uchar4>(input.cpu<uchar4>(), width, height), ImageView<uchar4>(output.cpu<uchar4>(), outputWidth, outputHeight), filter);
+		benchmark::DoNotOptimize(output.cpu<uchar4>());
+	}
+
+	benchReport(state, (width * height + outputWidth * outputHeight) * sizeof(uchar4));
+}
+
+static void BM_ResizeFilter_CUDA( benchmark::State& state, resizeFilter filter, int divisor )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	size_t outputWidth, outputHeight;
+	benchResizeSize(state, divisor, outputWidth, outputHeight);
+
+	benchBuffer input(width * height * sizeof(uchar4), true);
+	benchBuffer output(outputWidth * outputHeight * sizeof(uchar4), true);
+
+	for( auto _ : state )
+	{
+		cudaResize(ImageView<uchar4>(input.gpu<uchar4>(), width, height), ImageView<uchar4>(output.gpu<uchar4>(), outputWidth, outputHeight), filter);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, (width * height + outputWidth * outputHeight) * sizeof(uchar4));
+}
+
+#define BENCH_RESIZE_FILTER(func, name, filter, divisor)	\
+	BENCHMARK_CAPTURE(func, name, filter, divisor)->Args({1920, 1080})->Args({3840, 2160})->Unit(benchmark::kMicrosecond)
+
+BENCH_RESIZE_FILTER(BM_ResizeFilter_Pool, nearest_half, RESIZE_NEAREST, 2);
+BENCH_RESIZE_FILTER(BM_ResizeFilter_Pool, bilinear_half, RESIZE_BILINEAR, 2);
+BENCH_RESIZE_FILTER(BM_ResizeFilter_Pool, area_half, RESIZE_AREA, 2);
+BENCH_RESIZE_FILTER(BM_ResizeFilter_Pool, bilinear_300, RESIZE_BILINEAR, 0);
+BENCH_RESIZE_FILTER(BM_ResizeFilter_Pool, area_300, RESIZE_AREA, 0);
+
+BENCH_RESIZE_FILTER(BM_ResizeFilter_CUDA, nearest_half, RESIZE_NEAREST, 2);
+BENCH_RESIZE_FILTER(BM_ResizeFilter_CUDA, bilinear_half, RESIZE_BILINEAR, 2);
+BENCH_RESIZE_FILTER(BM_ResizeFilter_CUDA, area_half, RESIZE_AREA, 2);
+BENCH_RESIZE_FILTER(BM_ResizeFilter_CUDA, bilinear_300, RESIZE_BILINEAR, 0);
+BENCH_RESIZE_FILTER(BM_ResizeFilter_CUDA, area_300, RESIZE_AREA, 0);
+
+
+//-----------------------------------------------------------------------------------
+// letterbox of RGBA8 into a 640x640 canvas (bilinear), against clearing the
+// canvas and then resizing into its letterbox crop
+//-----------------------------------------------------------------------------------
+static const uint32_t benchCanvasSize = 640;
+
+static void BM_Letterbox_Pool( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(uchar4));
+	benchBuffer output(benchCanvasSize * benchCanvasSize * sizeof(uchar4));
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		ops->Letterbox(ImageView<uchar4>(input.cpu<uchar4>(), width, height), ImageView<uchar4>(output.cpu<uchar4>(), benchCanvasSize, benchCanvasSize),
+					RESIZE_BILINEAR, make_uchar4(114, 114, 114, 255));
+
+		benchmark::DoNotOptimize(output.cpu<uchar4>());
+	}
+
+	benchReport(state, (width * height + benchCanvasSize * benchCanvasSize) * sizeof(uchar4));
+}
+
+static void BM_LetterboxClear_Pool( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(uchar4));
+	benchBuffer output(benchCanvasSize * benchCanvasSize * sizeof(uchar4));
+
+	const letterboxTransform t = letterboxCompute(width, height, benchCanvasSize, benchCanvasSize);
+	const ImageView<uchar4> canvas(output.cpu<uchar4>(), benchCanvasSize, benchCanvasSize);
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		std::fill(canvas.ptr, canvas.ptr + benchCanvasSize * benchCanvasSize, make_uchar4(114, 114, 114, 255));
+		ops->Resize(ImageView<uchar4>(input.cpu<uchar4>(), width, height), canvas.Crop(t.left, t.top, t.width, t.height), RESIZE_BILINEAR);
+
+		benchmark::DoNotOptimize(output.cpu<uchar4>());
+	}
+
+	benchReport(state, (width * height + benchCanvasSize * benchCanvasSize) * sizeof(uchar4));
+}
+
+static void BM_Letterbox_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(uchar4), true);
+	benchBuffer output(benchCanvasSize * benchCanvasSize * sizeof(uchar4), true);
+
+	for( auto _ : state )
+	{
+		cudaLetterbox(ImageView<uchar4>(input.gpu<uchar4>(), width, height), ImageView<uchar4>(output.gpu<uchar4>(), benchCanvasSize, benchCanvasSize),
+				    RESIZE_BILINEAR, make_uchar4(114, 114, 114, 255));
+
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, (width * height + benchCanvasSize * benchCanvasSize) * sizeof(uchar4));
+}
+
+static void BM_LetterboxClear_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(uchar4), true);
+	benchBuffer output(benchCanvasSize * benchCanvasSize * sizeof(uchar4), true);
+
+	const letterboxTransform t = letterboxCompute(width, height, benchCanvasSize, benchCanvasSize);
+	const ImageView<uchar4> canvas(output.gpu<uchar4>(), benchCanvasSize, benchCanvasSize);
+
+	for( auto _ : state )
+	{
+		cudaMemset(canvas.ptr, 114, benchCanvasSize * benchCanvasSize * sizeof(uchar4));
+		cudaResize(ImageView<uchar4>(input.gpu<uchar4>(), width, height), canvas.Crop(t.left, t.top, t.width, t.height), RESIZE_BILINEAR);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, (width * height + benchCanvasSize * benchCanvasSize) * sizeof(uchar4));
+}
+
+BENCH_RESOLUTIONS(BM_Letterbox_Pool);
+BENCH_RESOLUTIONS(BM_LetterboxClear_Pool);
+BENCH_RESOLUTIONS_CUDA(BM_Letterbox_CUDA);
+BENCH_RESOLUTIONS_CUDA(BM_LetterboxClear_CUDA);
+
+
+//-----------------------------------------------------------------------------------
+// mosaic of 640x360 RGBA8 streams into a 1080p RGBA8 or NV12 wall (bilinear), in one
+// op against resizing each stream into a temporary and copying it into its tile
+// (and encoding the whole wall to NV12 after that)
+//-----------------------------------------------------------------------------------
+static const uint32_t benchWallWidth  = 1920;
+static const uint32_t benchWallHeight = 1080;
+
+static void benchMosaicInputs( uchar4* input, uint32_t count, ImageView<uchar4>* inputs )
+{
+	for( uint32_t n=0; n < count; n++ )
+		inputs[n] = ImageView<uchar4>(input + n * 640 * 360, 640, 360);
+}
+
+static size_t benchMosaicSize( bool nv12 )
+{
+	return nv12 ? benchWallWidth * benchWallHeight * 3 / 2 : benchWallWidth * benchWallHeight * sizeof(uchar4);
+}
+
+static void BM_Mosaic_Pool( benchmark::State& state, bool nv12 )
+{
+	const uint32_t count = state.range(0);
+
+	benchBuffer input(640 * 360 * sizeof(uchar4) * count);
+	benchBuffer output(benchMosaicSize(nv12));
+
+	ImageView<uchar4> inputs[MOSAIC_MAX_TILES];
+	benchMosaicInputs(input.cpu<uchar4>(), count, inputs);
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		if( nv12 )
+			ops->MosaicNV12(inputs, count, output.cpu<uint8_t>(), benchWallWidth, benchWallWidth, benchWallHeight, RESIZE_BILINEAR);
+		else
+			ops->Mosaic(inputs, count, ImageView<uchar4>(output.cpu<uchar4>(), benchWallWidth, benchWallHeight), RESIZE_BILINEAR);
+
+		benchmark::DoNotOptimize(output.cpu<uint8_t>());
+	}
+
+	benchReport(state, 640 * 360 * sizeof(uchar4) * count + benchMosaicSize(nv12));
+}
+
+static void BM_MosaicCopy_Pool( benchmark::State& state, bool nv12 )
+{
+	const uint32_t count = state.range(0);
+
+	benchBuffer input(640 * 360 * sizeof(uchar4) * count);
+	benchBuffer output(benchMosaicSize(nv12));
+	benchBuffer wall(benchWallWidth * benchWallHeight * sizeof(uchar4));
+	benchBuffer temp(benchWallWidth * benchWallHeight * sizeof(uchar4));
+
+	ImageView<uchar4> inputs[MOSAIC_MAX_TILES];
+	benchMosaicInputs(input.cpu<uchar4>(), count, inputs);
+
+	const ImageView<uchar4> canvas(nv12 ? wall.cpu<uchar4>() : output.cpu<uchar4>(), benchWallWidth, benchWallHeight);
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		for( uint32_t n=0; n < count; n++ )
+		{
+			const mosaicTile t = mosaicTileRect(n, count, benchWallWidth, benchWallHeight, nv12);
+			ops->Resize(inputs[n], ImageView<uchar4>(temp.cpu<uchar4>(), t.width, t.height), RESIZE_BILINEAR);
+
+			for( uint32_t y=0; y < t.height; y++ )
+				memcpy(canvas.Row(t.top + y) + t.left, temp.cpu<uchar4>() + y * t.width, t.width * sizeof(uchar4));
+		}
+
+		if( nv12 )
+			ops->FormatToNV12(canvas.ptr, IMAGE_RGBA8, output.cpu<uint8_t>(), benchWallWidth, benchWallHeight);
+
+		benchmark::DoNotOptimize(output.cpu<uint8_t>());
+	}
+
+	benchReport(state, 640 * 360 * sizeof(uchar4) * count + benchMosaicSize(nv12));
+}
+
+static void BM_Mosaic_CUDA( benchmark::State& state, bool nv12 )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const uint32_t count = state.range(0);
+
+	benchBuffer input(640 * 360 * sizeof(uchar4) * count, true);
+	benchBuffer output(benchMosaicSize(nv12), true);
+
+	ImageView<uchar4> inputs[MOSAIC_MAX_TILES];
+	benchMosaicInputs(input.gpu<uchar4>(), count, inputs);
+
+	for( auto _ : state )
+	{
+		if( nv12 )
+			cudaMosaicNV12(inputs, count, output.gpu<uint8_t>(), benchWallWidth, benchWallWidth, benchWallHeight, RESIZE_BILINEAR);
+		else
+			cudaMosaic(inputs, count, ImageView<uchar4>(output.gpu<uchar4>(), benchWallWidth, benchWallHeight), RESIZE_BILINEAR);
+
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, 640 * 360 * sizeof(uchar4) * count + benchMosaicSize(nv12));
+}
+
+static void BM_MosaicCopy_CUDA( benchmark::State& state, bool nv12 )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const uint32_t count = state.range(0);
+
+	benchBuffer input(640 * 360 * sizeof(uchar4) * count, true);
+	benchBuffer output(benchMosaicSize(nv12), true);
+	benchBuffer wall(benchWallWidth * benchWallHeight * sizeof(uchar4), true);
+	benchBuffer temp(benchWallWidth * benchWallHeight * sizeof(uchar4), true);
+
+	ImageView<uchar4> inputs[MOSAIC_MAX_TILES];
+	benchMosaicInputs(input.gpu<uchar4>(), count, inputs);
+
+	const ImageView<uchar4> canvas(nv12 ? wall.gpu<uchar4>() : output.gpu<uchar4>(), benchWallWidth, benchWallHeight);
+
+	for( auto _ : state )
+	{
+		for( uint32_t n=0; n < count; n++ )
+		{
+			const mosaicTile t = mosaicTileRect(n, count, benchWallWidth, benchWallHeight, nv12);
+
+			cudaResize(inputs[n], ImageView<uchar4>(temp.gpu<uchar4>(), t.width, t.height), RESIZE_BILINEAR);
+			cudaMemcpy2DAsync(canvas.Row(t.top) + t.left, canvas.pitch, temp.gpu<uchar4>(), t.width * sizeof(uchar4),
+						   t.width * sizeof(uchar4), t.height, cudaMemcpyDeviceToDevice);
+		}
+
+		if( nv12 )
+			cudaRGBAToNV12(canvas.ptr, output.gpu<uint8_t>(), benchWallWidth, benchWallHeight);
+
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, 640 * 360 * sizeof(uchar4) * count + benchMosaicSize(nv12));
+}
+
+// number of streams (2x2, 3x3, 4x4)
+#define BENCH_MOSAIC(func, name, nv12)	\
+	BENCHMARK_CAPTURE(func, name, nv12)->Arg(4)->Arg(9)->Arg(16)->Unit(benchmark::kMicrosecond)
+
+BENCH_MOSAIC(BM_Mosaic_Pool, rgba, false);
+BENCH_MOSAIC(BM_MosaicCopy_Pool, rgba, false);
+BENCH_MOSAIC(BM_Mosaic_Pool, nv12, true);
+BENCH_MOSAIC(BM_MosaicCopy_Pool, nv12, true);
+
+BENCH_MOSAIC(BM_Mosaic_CUDA, rgba, false);
+BENCH_MOSAIC(BM_MosaicCopy_CUDA, rgba, false);
+BENCH_MOSAIC(BM_Mosaic_CUDA, nv12, true);
+BENCH_MOSAIC(BM_MosaicCopy_CUDA, nv12, true);
+
+
+//-----------------------------------------------------------------------------------
+// normalize ([0,255] to [0,1])
+//-----------------------------------------------------------------------------------
+static void BM_NormalizeRGBA_CPU( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(float4));
+	benchBuffer output(width * height * sizeof(float4));
+
+	input.fillFloat(width * height * 4);
+
+	for( auto _ : state )
+	{
+		refNormalizeRGBA(input.cpu<float4>(), output.cpu<float4>(), width, height, 1.0f / 255.0f);
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, width * height * sizeof(float4) * 2);
+}
+
+static void BM_NormalizeRGBA_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(float4), true);
+	benchBuffer output(width * height * sizeof(float4), true);
+
+	input.fillFloat(width * height * 4);
+
+	for( auto _ : state )
+	{
+		cudaNormalizeRGBA(input.gpu<float4>(), make_float2(0.0f, 255.0f), output.gpu<float4>(), make_float2(0.0f, 1.0f), width, height);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, width * height * sizeof(float4) * 2);
+}
+
+static void BM_NormalizeRGBA_Pool( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(float4));
+	benchBuffer output(width * height * sizeof(float4));
+
+	input.fillFloat(width * height * 4);
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		ops->NormalizeRGBA(input.cpu<float4>(), make_float2(0.0f, 255.0f), output.cpu<float4>(), make_float2(0.0f, 1.0f), width, height);
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, width * height * sizeof(float4) * 2);
+}
+
+BENCH_RESOLUTIONS(BM_NormalizeRGBA_CPU);
+BENCH_RESOLUTIONS(BM_NormalizeRGBA_Pool);
+BENCH_RESOLUTIONS_CUDA(BM_NormalizeRGBA_CUDA);
+
+//-----------------------------------------------------------------------------------
+// bounding box overlay
+//-----------------------------------------------------------------------------------
+static void BM_RectOutlineOverlay_CPU( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(float4));
+	benchBuffer output(width * height * sizeof(float4));
+	benchBuffer rects(BENCH_RECTS * sizeof(float4));
+
+	input.fillFloat(width * height * 4);
+	benchRects(rects.cpu<float4>(), width, height);
+
+	for( auto _ : state )
+	{
+		refRectOutlineOverlay(input.cpu<float4>(), output.cpu<float4>(), width, height, rects.cpu<float4>(), BENCH_RECTS, make_float4(0, 255, 0, 120));
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, width * height * sizeof(float4) * 2);
+}
+
+static void BM_RectOutlineOverlay_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(float4), true);
+	benchBuffer output(width * height * sizeof(float4), true);
+	benchBuffer rects(BENCH_RECTS * sizeof(float4), true);
+
+	input.fillFloat(width * height * 4);
+	benchRects(rects.cpu<float4>(), width, height);
+
+	for( auto _ : state )
+	{
+		cudaRectOutlineOverlay(input.gpu<float4>(), output.gpu<float4>(), width, height, rects.gpu<float4>(), BENCH_RECTS, make_float4(0, 255, 0, 120));
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, width * height * sizeof(float4) * 2);
+}
+
+static void BM_RectOutlineOverlay_Pool( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * sizeof(float4));
+	benchBuffer output(width * height * sizeof(float4));
+	benchBuffer rects(BENCH_RECTS * sizeof(float4));
+
+	input.fillFloat(width * height * 4);
+	benchRects(rects.cpu<float4>(), width, height);
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		ops->RectOutlineOverlay(input.cpu<float4>(), output.cpu<float4>(), width, height, rects.cpu<float4>(), BENCH_RECTS, make_float4(0, 255, 0, 120));
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, width * height * sizeof(float4) * 2);
+}
+
+BENCH_RESOLUTIONS(BM_RectOutlineOverlay_CPU);
+BENCH_RESOLUTIONS(BM_RectOutlineOverlay_Pool);
+BENCH_RESOLUTIONS_CUDA(BM_RectOutlineOverlay_CUDA);
+
+
+//-----------------------------------------------------------------------------------
+// font rendering (one line of 64 characters)
+//-----------------------------------------------------------------------------------
+#define BENCH_TEXT "jetson-bench 0123456789 abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLM"
+
+static void BM_OverlayText_CPU( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	// synthetic 16x6 font map with 32x32 cells
+	const int cell      = 32;
+	const int fontWidth = 16 * (cell + 1);
+	const int length    = sizeof(BENCH_TEXT) - 1;
+
+	benchBuffer font(fontWidth * 6 * (cell + 1) * sizeof(float4));
+	benchBuffer output(width * height * sizeof(float4));
+	benchBuffer text(length * sizeof(short4));
+
+	font.fillFloat(fontWidth * 6 * (cell + 1) * 4);
+	output.fillFloat(width * height * 4);
+
+	for( int n=0; n < length; n++ )
+	{
+		const int c = BENCH_TEXT[n] - 32;
+		text.cpu<short4>()[n] = make_short4(16 + n * cell, 16, (c % 16) * (cell + 1), (c / 16) * (cell + 1));
+	}
+
+	for( auto _ : state )
+	{
+		refOverlayText(font.cpu<float4>(), fontWidth, cell, text.cpu<short4>(), length, output.cpu<float4>(), width, height, make_float4(255, 255, 255, 255));
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, length * cell * cell * sizeof(float4) * 3);
+}
+
+static void BM_OverlayText_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	static cudaFont* font = cudaFont::Create();
+
+	if( !font )
+	{
+		state.SkipWithError("failed to load fontmapA.png");
+		return;
+	}
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer output(width * height * sizeof(float4), true);
+	output.fillFloat(width * height * 4);
+
+	for( auto _ : state )
+	{
+		font->RenderOverlay(output.gpu<float4>(), output.gpu<float4>(), width, height, BENCH_TEXT, 16, 16, make_float4(255, 255, 255, 255));
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, (sizeof(BENCH_TEXT) - 1) * 32 * 32 * sizeof(float4) * 3);
+}
+
+BENCH_RESOLUTIONS(BM_OverlayText_CPU);
+BENCH_RESOLUTIONS_CUDA(BM_OverlayText_CUDA);
+
+
+//-----------------------------------------------------------------------------------
+// network preprocessing (NV12 to a 224x224 FP32 CHW tensor, ImageNet normalization)
+//-----------------------------------------------------------------------------------
+#define BENCH_TENSOR_SIZE 224
+
+static tensorParams benchTensorParams()
+{
+	tensorParams params(BENCH_TENSOR_SIZE, BENCH_TENSOR_SIZE);
+
+	params.scale  = 1.0f / 255.0f;
+	params.mean   = make_float3(0.485f, 0.456f, 0.406f);
+	params.stdDev = make_float3(0.229f, 0.224f, 0.225f);
+
+	return params;
+}
+
+// bytes moved by the three-pass version:  NV12 read, float4 frame written and read back,
+// resized float4 written and read back, normalized float4 written
+static size_t benchPreprocessBytes( size_t width, size_t height )
+{
+	const size_t tensor = BENCH_TENSOR_SIZE * BENCH_TENSOR_SIZE * sizeof(float4);
+	return width * height * 3 / 2 + width * height * sizeof(float4) + tensor * 4;
+}
+
+// bytes moved by the fused version:  the sampled NV12 pixels read, the tensor written
+static size_t benchTensorBytes()
+{
+	const size_t pixels = BENCH_TENSOR_SIZE * BENCH_TENSOR_SIZE;
+	return pixels * 3 / 2 + pixels * 3 * sizeof(float);
+}
+
+static void BM_Preprocess3Pass_Pool( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 3 / 2);
+	benchBuffer rgba(width * height * sizeof(float4));
+	benchBuffer resized(BENCH_TENSOR_SIZE * BENCH_TENSOR_SIZE * sizeof(float4));
+	benchBuffer output(BENCH_TENSOR_SIZE * BENCH_TENSOR_SIZE * sizeof(float4));
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		ops->NV12ToRGBAf(input.cpu<uint8_t>(), rgba.cpu<float4>(), width, height);
+		ops->ResizeRGBA(rgba.cpu<float4>(), width, height, resized.cpu<float4>(), BENCH_TENSOR_SIZE, BENCH_TENSOR_SIZE);
+		ops->NormalizeRGBA(resized.cpu<float4>(), make_float2(0.0f, 255.0f), output.cpu<float4>(), make_float2(0.0f, 1.0f), BENCH_TENSOR_SIZE, BENCH_TENSOR_SIZE);
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, benchPreprocessBytes(width, height));
+}
+
+static void BM_Preprocess3Pass_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	benchBuffer input(width * height * 3 / 2, true);
+	benchBuffer rgba(width * height * sizeof(float4), true);
+	benchBuffer resized(BENCH_TENSOR_SIZE * BENCH_TENSOR_SIZE * sizeof(float4), true);
+	benchBuffer output(BENCH_TENSOR_SIZE * BENCH_TENSOR_SIZE * sizeof(float4), true);
+
+	for( auto _ : state )
+	{
+		cudaNV12ToRGBAf(input.gpu<uint8_t>(), rgba.gpu<float4>(), width, height);
+		cudaResizeRGBA(rgba.gpu<float4>(), width, height, resized.gpu<float4>(), BENCH_TENSOR_SIZE, BENCH_TENSOR_SIZE);
+		cudaNormalizeRGBA(resized.gpu<float4>(), make_float2(0.0f, 255.0f), output.gpu<float4>(), make_float2(0.0f, 1.0f), BENCH_TENSOR_SIZE, BENCH_TENSOR_SIZE);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, benchPreprocessBytes(width, height));
+}
+
+static void BM_NV12ToTensor_Pool( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	const tensorParams params = benchTensorParams();
+
+	benchBuffer input(width * height * 3 / 2);
+	benchBuffer output(tensorSize(params));
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		ops->NV12ToTensor(input.cpu<uint8_t>(), width, height, output.cpu<float>(), params);
+		benchmark::DoNotOptimize(output.cpu<float>());
+	}
+
+	benchReport(state, benchTensorBytes());
+}
+
+static void BM_NV12ToTensor_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	const tensorParams params = benchTensorParams();
+
+	benchBuffer input(width * height * 3 / 2, true);
+	benchBuffer output(tensorSize(params), true);
+
+	for( auto _ : state )
+	{
+		cudaNV12ToTensor(input.gpu<uint8_t>(), width, width, height, output.gpu<float>(), params);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, benchTensorBytes());
+}
+
+BENCH_RESOLUTIONS(BM_Preprocess3Pass_Pool);
+BENCH_RESOLUTIONS(BM_NV12ToTensor_Pool);
+BENCH_RESOLUTIONS_CUDA(BM_Preprocess3Pass_CUDA);
+BENCH_RESOLUTIONS_CUDA(BM_NV12ToTensor_CUDA);
+
+
+//-----------------------------------------------------------------------------------
+// normalize into a tensor (float4 to CHW with ImageNet normalization, FP32 or INT8),
+// with the SIMD rows and with the scalar ones
+//-----------------------------------------------------------------------------------
+static tensorParams benchNormalizeParams( size_t width, size_t height, tensorFormat format )
+{
+	tensorParams params = benchTensorParams();
+
+	params.width     = width;
+	params.height    = height;
+	params.format    = format;
+	params.int8Scale = 0.02f;
+
+	return params;
+}
+
+static void benchNormalizeTensor( benchmark::State& state, tensorFormat format, cpuISA isa )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	const tensorParams params = benchNormalizeParams(width, height, format);
+
+	benchBuffer input(width * height * sizeof(float4));
+	benchBuffer output(tensorSize(params));
+
+	input.fillFloat(width * height * 4);
+
+	const cpuISA detected = cpuGetISA();
+	cpuSetISA(isa);
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		ops->NormalizeRGBA(ImageView<float4>(input.cpu<float4>(), width, height), output.cpu<uint8_t>(), params);
+		benchmark::DoNotOptimize(output.cpu<uint8_t>());
+	}
+
+	cpuSetISA(detected);
+	benchReport(state, width * height * sizeof(float4) + tensorSize(params));
+}
+
+static void BM_NormalizeTensor_Pool( benchmark::State& state, tensorFormat format )
+{
+	benchNormalizeTensor(state, format, cpuDetectISA());
+}
+
+static void BM_NormalizeTensorScalar_Pool( benchmark::State& state, tensorFormat format )
+{
+	benchNormalizeTensor(state, format, CPU_ISA_SCALAR);
+}
+
+static void BM_NormalizeTensor_CUDA( benchmark::State& state, tensorFormat format )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	const tensorParams params = benchNormalizeParams(width, height, format);
+
+	benchBuffer input(width * height * sizeof(float4), true);
+	benchBuffer output(tensorSize(params), true);
+
+	input.fillFloat(width * height * 4);
+
+	for( auto _ : state )
+	{
+		cudaNormalizeRGBA(ImageView<float4>(input.gpu<float4>(), width, height), output.gpu<uint8_t>(), params);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, width * height * sizeof(float4) + tensorSize(params));
+}
+
+#define BENCH_NORMALIZE(func, name, format)	\
+	BENCHMARK_CAPTURE(func, name, format)->Args({1920, 1080})->Unit(benchmark::kMicrosecond)
+
+BENCH_NORMALIZE(BM_NormalizeTensor_Pool, fp32, TENSOR_FORMAT_FP32);
+BENCH_NORMALIZE(BM_NormalizeTensorScalar_Pool, fp32, TENSOR_FORMAT_FP32);
+BENCH_NORMALIZE(BM_NormalizeTensor_Pool, int8, TENSOR_FORMAT_INT8);
+BENCH_NORMALIZE(BM_NormalizeTensorScalar_Pool, int8, TENSOR_FORMAT_INT8);
+BENCH_NORMALIZE(BM_NormalizeTensor_CUDA, fp32, TENSOR_FORMAT_FP32);
+BENCH_NORMALIZE(BM_NormalizeTensor_CUDA, int8, TENSOR_FORMAT_INT8);
+
+
+//-----------------------------------------------------------------------------------
+// second-stage classifier input:  boxes of about 180x240 in a 1080p float4 frame to
+// 112x112 FP32 CHW tensors, batched in one op against a crop resize and normalize per box
+//-----------------------------------------------------------------------------------
+#define BENCH_ROI_SIZE 112
+
+static void benchROIs( tensorROI* rois, uint32_t count )
+{
+	for( uint32_t n=0; n < count; n++ )
+	{
+		const float x = (n % 8) * 230.0f + 7.5f;
+		const float y = (n / 8) * 260.0f + 3.25f;
+
+		rois[n].box   = make_float4(x, y, x + 180.0f + n, y + 240.0f - n);
+		rois[n].frame = 0;
+	}
+}
+
+// the per-box version reads the crop and writes and reads back the resized float4
+static size_t benchROIBytes( uint32_t count, bool batched )
+{
+	const size_t crop   = 180 * 240 * sizeof(float4);
+	const size_t tensor = BENCH_ROI_SIZE * BENCH_ROI_SIZE * (batched ? 3 * sizeof(float) : 3 * sizeof(float4));
+
+	return count * (batched ? tensor : crop + tensor);
+}
+
+static void BM_ROIToTensor_Pool( benchmark::State& state )
+{
+	const uint32_t count = state.range(0);
+
+	tensorParams params = benchTensorParams();
+	params.width = params.height = BENCH_ROI_SIZE;
+
+	benchBuffer input(1920 * 1080 * sizeof(float4));
+	benchBuffer rois(count * sizeof(tensorROI));
+	benchBuffer output(tensorSize(params) * count);
+
+	input.fillFloat(1920 * 1080 * 4);
+	benchROIs(rois.cpu<tensorROI>(), count);
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		ops->ROIToTensor(ImageView<float4>(input.cpu<float4>(), 1920, 1080), rois.cpu<tensorROI>(), count, output.cpu<float>(), params);
+		benchmark::DoNotOptimize(output.cpu<float>());
+	}
+
+	benchReport(state, benchROIBytes(count, true));
+}
+
+static void BM_ROIPerBox_Pool( benchmark::State& state )
+{
+	const uint32_t count = state.range(0);
+
+	benchBuffer input(1920 * 1080 * sizeof(float4));
+	benchBuffer rois(count * sizeof(tensorROI));
+	benchBuffer resized(BENCH_ROI_SIZE * BENCH_ROI_SIZE * sizeof(float4));
+	benchBuffer output(BENCH_ROI_SIZE * BENCH_ROI_SIZE * sizeof(float4) * count);
+
+	input.fillFloat(1920 * 1080 * 4);
+	benchROIs(rois.cpu<tensorROI>(), count);
+
+	const ImageView<float4> frame(input.cpu<float4>(), 1920, 1080);
+
+	imageOps* ops = imageOps::Get(IMAGE_BACKEND_CPU);
+	benchPoolLabel(state);
+
+	for( auto _ : state )
+	{
+		for( uint32_t n=0; n < count; n++ )
+		{
+			ops->Resize(tensorROICrop(frame, rois.cpu<tensorROI>()[n].box), ImageView<float4>(resized.cpu<float4>(), BENCH_ROI_SIZE, BENCH_ROI_SIZE), RESIZE_BILINEAR);
+			ops->NormalizeRGBA(resized.cpu<float4>(), make_float2(0.0f, 255.0f), output.cpu<float4>() + n * BENCH_ROI_SIZE * BENCH_ROI_SIZE,
+						    make_float2(0.0f, 1.0f), BENCH_ROI_SIZE, BENCH_ROI_SIZE);
+		}
+
+		benchmark::DoNotOptimize(output.cpu<float4>());
+	}
+
+	benchReport(state, benchROIBytes(count, false));
+}
+
+static void BM_ROIToTensor_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const uint32_t count = state.range(0);
+
+	tensorParams params = benchTensorParams();
+	params.width = params.height = BENCH_ROI_SIZE;
+
+	benchBuffer input(1920 * 1080 * sizeof(float4), true);
+	benchBuffer rois(count * sizeof(tensorROI), true);
+	benchBuffer output(tensorSize(params) * count, true);
+
+	benchROIs(rois.cpu<tensorROI>(), count);
+
+	for( auto _ : state )
+	{
+		cudaROIToTensor(ImageView<float4>(input.gpu<float4>(), 1920, 1080), rois.gpu<tensorROI>(), count, output.gpu<float>(), params);
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, benchROIBytes(count, true));
+}
+
+static void BM_ROIPerBox_CUDA( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+
+	const uint32_t count = state.range(0);
+
+	benchBuffer input(1920 * 1080 * sizeof(float4), true);
+	benchBuffer rois(count * sizeof(tensorROI));
+	benchBuffer resized(BENCH_ROI_SIZE * BENCH_ROI_SIZE * sizeof(float4), true);
+	benchBuffer output(BENCH_ROI_SIZE * BENCH_ROI_SIZE * sizeof(float4) * count, true);
+
+	benchROIs(rois.cpu<tensorROI>(), count);
+
+	const ImageView<float4> frame(input.gpu<float4>(), 1920, 1080);
+
+	for( auto _ : state )
+	{
+		for( uint32_t n=0; n < count; n++ )
+		{
+			cudaResize(tensorROICrop(frame, rois.cpu<tensorROI>()[n].box), ImageView<float4>(resized.gpu<float4>(), BENCH_ROI_SIZE, BENCH_ROI_SIZE), RESIZE_BILINEAR);
+			cudaNormalizeRGBA(resized.gpu<float4>(), make_float2(0.0f, 255.0f), output.gpu<float4>() + n * BENCH_ROI_SIZE * BENCH_ROI_SIZE,
+						   make_float2(0.0f, 1.0f), BENCH_ROI_SIZE, BENCH_ROI_SIZE);
+		}
+
+		cudaDeviceSynchronize();
+	}
+
+	benchReport(state, benchROIBytes(count, false));
+}
+
+// number of boxes
+#define BENCH_ROIS(func)	\
+	BENCHMARK(func)->Arg(8)->Arg(32)->Unit(benchmark::kMicrosecond)
+
+BENCH_ROIS(BM_ROIToTensor_Pool);
+BENCH_ROIS(BM_ROIPerBox_Pool);
+BENCH_ROIS(BM_ROIToTensor_CUDA);
+BENCH_ROIS(BM_ROIPerBox_CUDA);
+
+
+//-----------------------------------------------------------------------------------
+// image allocation (a new float4 frame per iteration, directly or through the pool)
+//-----------------------------------------------------------------------------------
+template<typename Allocator>
+static void benchImageAlloc( benchmark::State& state )
+{
+	const size_t width  = state.range(0);
+	const size_t height = state.range(1);
+
+	for( auto _ : state )
+	{
+		Image<float4, Allocator> image(width, height);
+
+		if( image.IsEmpty() )
+		{
+			state.SkipWithError("failed to allocate image");
+			break;
+		}
+
+		// touch every page, fresh memory from the system faults them in
+		uint8_t* cpu = (uint8_t*)image.GetCPU();
+
+		for( size_t n=0; n < image.GetSize(); n += 4096 )
+			cpu[n] = 0;
+
+		benchmark::DoNotOptimize(cpu);
+	}
+
+	imagePoolTrim();
+}
+
+static void BM_ImageAlloc_Host( benchmark::State& state )
+{
+	benchImageAlloc<imageAllocHost>(state);
+}
+
+static void BM_ImageAlloc_HostPool( benchmark::State& state )
+{
+	benchImageAlloc< imageAllocPool<imageAllocHost> >(state);
+}
+
+static void BM_ImageAlloc_Mapped( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+	benchImageAlloc<imageAllocMapped>(state);
+}
+
+static void BM_ImageAlloc_MappedPool( benchmark::State& state )
+{
+	BENCH_REQUIRE_GPU(state);
+	benchImageAlloc< imageAllocPool<imageAllocMapped> >(state);
+}
+
+BENCH_RESOLUTIONS(BM_ImageAlloc_Host);
+BENCH_RESOLUTIONS(BM_ImageAlloc_HostPool);
+BENCH_RESOLUTIONS(BM_ImageAlloc_Mapped);
+BENCH_RESOLUTIONS(BM_ImageAlloc_MappedPool);
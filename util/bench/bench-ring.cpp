@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "benchUtility.h"
+#include "gstRingbuffer.h"
+#include "imageOps.h"
+
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+
+// the decoders pad each plane to a 256-byte pitch, which checkBuffer() repacks
+static const size_t benchDecoderAlign = 256;
+
+
+// benchPlanes:  NV12 plane layout of a decoded frame, padded or packed
+static size_t benchPlanes( uint32_t width, uint32_t height, bool padded, size_t* strides, size_t* offsets )
+{
+	const size_t pitch = padded ? (width + benchDecoderAlign - 1) & ~(benchDecoderAlign - 1) : width;
+
+	strides[0] = pitch;
+	strides[1] = pitch;
+	offsets[0] = 0;
+	offsets[1] = pitch * height;
+
+	return pitch * (height + (height + 1) / 2);
+}
+
+
+// benchFrameInfo:  format of the packed NV12 frames in the ring
+static gstRingbuffer::frameInfo benchFrameInfo( uint32_t width, uint32_t height )
+{
+	gstRingbuffer::frameInfo info;
+
+	info.format = YUV_NV12;
+	info.width  = width;
+	info.height = height;
+	info.pitch  = yuvFormatPitch(YUV_NV12, width);
+
+	info.colorimetry = yuvColorimetry(YUV_MATRIX_BT709, YUV_RANGE_LIMITED);
+
+	return info;
+}
+
+
+// benchWarmRing:  allocate the slots and fault their pages in, outside of the timed loop
+static bool benchWarmRing( gstRingbuffer& ring, size_t size, const gstRingbuffer::frameInfo& info )
+{
+	for( uint32_t n=0; n < gstRingbuffer::NumSlots; n++ )
+	{
+		void* slot = ring.Next(size);
+
+		if( !slot )
+			return false;
+
+		memset(slot, 0, size);
+
+		gstRingbuffer::frameTiming timing;
+		memset(&timing, 0, sizeof(timing));
+
+		ring.Publish(size, info, timing, 0);
+	}
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------
+// checkBuffer() copy of a decoded NV12 frame into the ring, then published
+//-----------------------------------------------------------------------------------
+static void BM_RingCopy( benchmark::State& state, bool mapped, bool padded )
+{
+	if( mapped )
+		BENCH_REQUIRE_GPU(state);
+
+	const uint32_t width  = state.range(0);
+	const uint32_t height = state.range(1);
+	const size_t   size   = yuvFormatSize(YUV_NV12, yuvFormatPitch(YUV_NV12, width), height);
+
+	const gstRingbuffer::frameInfo info = benchFrameInfo(width, height);
+
+	size_t strides[2];
+	size_t offsets[2];
+
+	const size_t srcSize = benchPlanes(width, height, padded, strides, offsets);
+
+	benchBuffer frame(srcSize);
+	gstRingbuffer ring(imageOps::Get(mapped ? IMAGE_BACKEND_CUDA : IMAGE_BACKEND_CPU));
+
+	if( !benchWarmRing(ring, size, info) )
+	{
+		state.SkipWithError("failed to allocate the ringbuffer");
+		return;
+	}
+
+	for( auto _ : state )
+	{
+		uint8_t* slot = (uint8_t*)ring.Next(size);
+
+		if( !slot || !gstRingbuffer::CopyPlanes(YUV_NV12, width, height, frame.cpu<uint8_t>(), srcSize, strides, offsets, slot) )
+		{
+			state.SkipWithError("failed to copy into the ringbuffer");
+			break;
+		}
+
+		gstRingbuffer::frameTiming timing;
+		memset(&timing, 0, sizeof(timing));
+
+		ring.Publish(size, info, timing, 0);
+		benchmark::ClobberMemory();
+	}
+
+	benchReport(state, size * 2);
+}
+
+BENCHMARK_CAPTURE(BM_RingCopy, system, false, false)->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160})->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RingCopy, mapped, true, false)->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160})->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RingCopy, system_repack, false, true)->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160})->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RingCopy, mapped_repack, true, true)->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160})->Unit(benchmark::kMicrosecond);
+
+
+//-----------------------------------------------------------------------------------
+// publish/consume handoff, with the decoder thread publishing as fast as it can
+//-----------------------------------------------------------------------------------
+static void BM_RingPublishConsume( benchmark::State& state )
+{
+	const uint32_t width  = state.range(0);
+	const uint32_t height = state.range(1);
+	const size_t   size   = yuvFormatSize(YUV_NV12, yuvFormatPitch(YUV_NV12, width), height);
+
+	const gstRingbuffer::frameInfo info = benchFrameInfo(width, height);
+
+	benchBuffer frame(size);
+	gstRingbuffer ring(imageOps::Get(benchHasGPU() ? IMAGE_BACKEND_CUDA : IMAGE_BACKEND_CPU));
+
+	if( !benchWarmRing(ring, size, info) )
+	{
+		state.SkipWithError("failed to allocate the ringbuffer");
+		return;
+	}
+
+	std::atomic<bool> running(true);
+
+	std::thread producer([&]()
+	{
+		while( running.load(std::memory_order_relaxed) )
+		{
+			void* slot = ring.Next(size);
+
+			if( !slot )
+				break;
+
+			memcpy(slot, frame.cpu<void>(), size);
+
+			gstRingbuffer::frameTiming timing;
+			memset(&timing, 0, sizeof(timing));
+
+			ring.Publish(size, info, timing, 0);
+		}
+	});
+
+	uint64_t missed = 0;
+
+	for( auto _ : state )
+	{
+		gstRingbuffer::frame f;
+
+		while( !ring.Consume(&f, 1000) )
+			missed++;
+
+		benchmark::DoNotOptimize(f.cpu);
+	}
+
+	running = false;
+	producer.join();
+
+	state.counters["missed"] = benchmark::Counter(missed, benchmark::Counter::kAvgIterations);
+	benchReport(state, size);
+}
+
+BENCH_RESOLUTIONS(BM_RingPublishConsume)->UseRealTime();
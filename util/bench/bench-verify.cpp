@@ -0,0 +1,1848 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "benchUtility.h"
+
+#include "cudaYUV.h"
+#include "cudaYUV-NV12.h"
+#include "cpuYUV.h"
+#include "cpuFeatures.h"
+#include "cudaResize.h"
+#include "cudaNormalize.h"
+#include "cudaOverlay.h"
+#include "cudaLetterbox.h"
+#include "cudaMosaic.h"
+#include "cudaTensor-ROI.h"
+#include "cudaResize-Filter.h"
+#include "cpuResize.h"
+#include "cpuNormalize.h"
+#include "cpuOverlay.h"
+#include "cpuLetterbox.h"
+#include "cpuMosaic.h"
+#include "cpuTensor.h"
+
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+
+/*
+ * jetson-bench --verify
+ *
+ * Checks that the YUV conversions are bit-exact with the per-pixel reference
+ * (yuvSample + yuvToRGBFixed, the same as the CUDA fallback kernel), for
+ * every input yuvFormat and output imageFormat:
+ *
+ *   - the NV12/NV21 block kernel logic, run on the CPU over the same grid as on the GPU
+ *   - the CPU implementation (cpuYUVToFormat), with each instruction set this CPU supports
+ *   - the CUDA kernels, when a GPU is present
+ *
+ * The encode direction (RGB to NV12) is checked the same way, against
+ * nv12EncodeBlock() run over the grid of the CUDA kernel, and the luma
+ * downscale (cpuYUVToGray) against lumaBoxSum() per output sample.
+ * The batched conversion is checked on frames with and without ROI and resize,
+ * covering both the row kernel and the per-pixel path of the CPU.
+ * The profiles (several outputs from one pass) are checked against the batch
+ * reference of the whole frame, deinterleaved for the planar outputs.
+ * The resize, normalize and overlay ops are run on a crop of a padded image
+ * (ImageView), and must match the packed op on a copy of the crop.
+ * The bilinear and area resize are checked against resizeLinearPixel() and
+ * resizeAreaPixel() (the CUDA kernels) per output pixel, which also covers
+ * the 2x/3x/4x area paths against the generic box.
+ * The letterbox is checked against the same functions on the content crop of
+ * a canvas filled with the padding, and its transform must project the
+ * content back onto the whole source image.
+ * The mosaic is checked against the same functions on each tile, and the
+ * per-pixel NV12 encode for the NV12 output; a tile without a new frame
+ * must keep the previous output.
+ * The batched ROI crops are checked against cpuResize() of each crop into a
+ * packed image followed by tensorWriteRGB(), with the crop rectangles given
+ * in the table (boxes outside of the frame, of one pixel and upscaled); the
+ * tensor of a box with an invalid frame index must be left unwritten.
+ * The normalization into tensors is checked against tensorWriteRGB() per pixel
+ * (the fallback kernel): the 4-pixel vector kernel on the CPU over its grid,
+ * the CPU with each instruction set and CUDA, and the range normalization of
+ * float4 images against its formula.
+ *
+ * The sizes and pitches are picked to exercise the 4-wide, 2-wide and
+ * per-pixel kernels, odd heights and the last chroma row.
+ * Mismatches are printed, followed by the number of checks per input format.
+ */
+struct verifySize
+{
+	size_t width;
+	size_t height;
+	size_t pitch;	// of the 8-bit luma plane, in bytes (doubled for P010)
+};
+
+static const verifySize verifySizes[] = {
+	{ 1920, 1080, 1920 },
+	{ 1280,  720, 1344 },
+	{ 1366,  768, 1366 },	// 2-wide blocks
+	{  642,  361,  644 },	// odd height
+	{  100,    2,  102 },
+	{   34,   17,   35 },	// unaligned pitch, per-pixel kernel
+	{   33,   17,   34 },	// odd width, packed (the overloads without a pitch)
+};
+
+static const yuvColorimetry verifyColorimetry[] = {
+	yuvColorimetry(YUV_MATRIX_BT601, YUV_RANGE_LIMITED),
+	yuvColorimetry(YUV_MATRIX_BT709, YUV_RANGE_FULL)
+};
+
+static const yuvFormat verifyInputs[] = { YUV_NV12, YUV_NV21, YUV_I420, YUV_P010 };
+
+
+// per-pixel reference
+template<yuvFormat layout, imageFormat format>
+static void verifyReference( const yuvCoeffs& k, const uint8_t* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height )
+{
+	for( uint32_t y=0; y < height; y++ )
+	{
+		for( uint32_t x=0; x < width; x++ )
+		{
+			uint32_t luma, u, v;
+			int32_t  r, g, b;
+
+			yuvSample<layout>(input, inputPitch, height, x, y, luma, u, v);
+			yuvToRGBFixed(k, luma, u, v, r, g, b);
+
+			imageStoreRGBFixed<format>(output + y * outputPitch, x, r, g, b);
+		}
+	}
+}
+
+
+// the block kernel, one call per thread of the grid
+template<yuvFormat layout, imageFormat format, int blockWidth>
+static void verifyBlocks( const yuvCoeffs& k, const uint8_t* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height )
+{
+	for( uint32_t y=0; y < height; y += NV12_BLOCK_HEIGHT )
+		for( uint32_t x=0; x < width; x += blockWidth )
+			nv12ConvertBlock<format, blockWidth, layout == YUV_NV21>(k, input, inputPitch, output, outputPitch, x, y, height);
+}
+
+
+// returns the first differing pixel, or -1
+static long verifyCompare( const uint8_t* a, const uint8_t* b, size_t size, size_t pixelSize )
+{
+	for( size_t n=0; n < size; n++ )
+	{
+		if( a[n] != b[n] )
+			return n / pixelSize;
+	}
+
+	return -1;
+}
+
+
+// print a mismatch, returns true if there was none
+static bool verifyReport( const char* name, yuvFormat layout, const verifySize& s, imageFormat format, const yuvColorimetry& cs, int blockWidth, long mismatch )
+{
+	if( mismatch < 0 )
+		return true;
+
+	char block[16];
+
+	if( blockWidth > 0 )
+		snprintf(block, sizeof(block), "%dx%d", blockWidth, NV12_BLOCK_HEIGHT);
+	else
+		snprintf(block, sizeof(block), (blockWidth == 0) ? "pixel" : "-");
+
+	printf("  %-6s %-9s %4zux%-4zu %-8s %-6s %-7s %-6s  MISMATCH at pixel (%ld, %ld)\n", name, yuvFormatToStr(layout), s.width, s.height, imageFormatToStr(format),
+		  yuvMatrixToStr(cs.matrix), (cs.range == YUV_RANGE_FULL) ? "full" : "limited", block, mismatch % (long)s.width, mismatch / (long)s.width);
+
+	return false;
+}
+
+
+template<yuvFormat layout, imageFormat format>
+static int verifyFormat( const verifySize& s, const yuvColorimetry& cs, bool gpu, int& checks )
+{
+	const size_t pitch       = (layout == YUV_P010) ? s.pitch * 2 : s.pitch;
+	const size_t pixelSize   = imageFormatSize(format);
+	const size_t outputPitch = s.width * pixelSize;
+	const size_t inputSize   = pitch * s.height * 3 / 2 + pitch;
+	const size_t outputSize  = outputPitch * s.height;
+
+	benchBuffer input(inputSize, gpu);
+	benchBuffer output(outputSize, gpu);
+
+	std::vector<uint8_t> reference(outputSize);
+	std::vector<uint8_t> result(outputSize);
+
+	const yuvCoeffs k = yuvCoeffsInit(cs, yuvFormatDepth(layout));
+	int failures = 0;
+
+	verifyReference<layout, format>(k, input.cpu<uint8_t>(), pitch, &reference[0], outputPitch, s.width, s.height);
+
+	// block kernel on the CPU
+	int blockWidth = 0;
+
+	if( layout == YUV_NV12 || layout == YUV_NV21 )
+		blockWidth = nv12BlockWidth(input.cpu<uint8_t>(), pitch, output.cpu<uint8_t>(), outputPitch, s.width, format);
+
+	if( blockWidth > 0 )
+	{
+		memset(&result[0], 0xCD, outputSize);
+
+		if( blockWidth == 4 )
+			verifyBlocks<layout, format, 4>(k, input.cpu<uint8_t>(), pitch, &result[0], outputPitch, s.width, s.height);
+		else
+			verifyBlocks<layout, format, 2>(k, input.cpu<uint8_t>(), pitch, &result[0], outputPitch, s.width, s.height);
+
+		if( !verifyReport("block", layout, s, format, cs, blockWidth, verifyCompare(&reference[0], &result[0], outputSize, pixelSize)) )
+			failures++;
+
+		checks++;
+	}
+
+	// CPU, with every instruction set that is supported
+	const cpuISA detected = cpuGetISA();
+
+	for( int isa=CPU_ISA_SCALAR; isa <= CPU_ISA_NEON; isa++ )
+	{
+		if( cpuSetISA((cpuISA)isa) != isa )
+			continue;
+
+		memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+		cpuYUVToFormat(input.cpu<uint8_t>(), pitch, layout, output.cpu<uint8_t>(), outputPitch, s.width, s.height, format, cs);
+
+		if( !verifyReport(cpuISAName((cpuISA)isa), layout, s, format, cs, -1, verifyCompare(&reference[0], output.cpu<uint8_t>(), outputSize, pixelSize)) )
+			failures++;
+
+		checks++;
+	}
+
+	cpuSetISA(detected);
+
+	// the NV12 overloads without a pitch, on packed sizes
+	const bool packed = (layout == YUV_NV12 && s.pitch == yuvFormatPitch(YUV_NV12, s.width));
+
+	if( packed )
+	{
+		memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+		cpuNV12ToFormat(input.cpu<uint8_t>(), output.cpu<uint8_t>(), s.width, s.height, format, cs);
+
+		if( !verifyReport("packed", layout, s, format, cs, -1, verifyCompare(&reference[0], output.cpu<uint8_t>(), outputSize, pixelSize)) )
+			failures++;
+
+		checks++;
+	}
+
+	// CUDA
+	if( gpu )
+	{
+		memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+
+		if( CUDA_FAILED(cudaYUVToFormat(input.gpu<uint8_t>(), pitch, layout, output.gpu<uint8_t>(), outputPitch, s.width, s.height, format, cs))
+		    || CUDA_FAILED(cudaDeviceSynchronize()) )
+		{
+			printf("  CUDA   %-9s %4zux%-4zu %-8s  FAILED\n", yuvFormatToStr(layout), s.width, s.height, imageFormatToStr(format));
+			failures++;
+		}
+		else if( !verifyReport("CUDA", layout, s, format, cs, blockWidth, verifyCompare(&reference[0], output.cpu<uint8_t>(), outputSize, pixelSize)) )
+		{
+			failures++;
+		}
+
+		checks++;
+
+		if( packed )
+		{
+			memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+
+			if( CUDA_FAILED(cudaNV12ToFormat(input.gpu<uint8_t>(), output.gpu<uint8_t>(), s.width, s.height, format, cs))
+			    || CUDA_FAILED(cudaDeviceSynchronize()) )
+			{
+				printf("  CUDA   %-9s %4zux%-4zu %-8s  packed FAILED\n", yuvFormatToStr(layout), s.width, s.height, imageFormatToStr(format));
+				failures++;
+			}
+			else if( !verifyReport("CUDA", layout, s, format, cs, blockWidth, verifyCompare(&reference[0], output.cpu<uint8_t>(), outputSize, pixelSize)) )
+			{
+				failures++;
+			}
+
+			checks++;
+		}
+	}
+
+	return failures;
+}
+
+
+template<yuvFormat layout>
+static int verifyInput( bool gpu, int& checks )
+{
+	int failures = 0;
+
+	for( size_t s=0; s < sizeof(verifySizes) / sizeof(verifySize); s++ )
+	{
+		for( size_t c=0; c < sizeof(verifyColorimetry) / sizeof(yuvColorimetry); c++ )
+		{
+			const verifySize& size = verifySizes[s];
+			const yuvColorimetry& cs = verifyColorimetry[c];
+
+			failures += verifyFormat<layout, IMAGE_RGBA32F>(size, cs, gpu, checks);
+			failures += verifyFormat<layout, IMAGE_RGBA16F>(size, cs, gpu, checks);
+			failures += verifyFormat<layout, IMAGE_RGBA8>(size, cs, gpu, checks);
+			failures += verifyFormat<layout, IMAGE_RGB8>(size, cs, gpu, checks);
+			failures += verifyFormat<layout, IMAGE_BGR8>(size, cs, gpu, checks);
+		}
+	}
+
+	return failures;
+}
+
+
+// frames of the batch check, from the two inputs of verifyBatch()
+struct verifyBatchFrame
+{
+	int      input;
+	uint32_t roi[4];		// left, top, width, height (0 = to the edge)
+	uint32_t outputWidth;
+	uint32_t outputHeight;
+};
+
+static const verifyBatchFrame verifyBatchFrames[] = {
+	{ 0, {   0,  0,   0,   0 }, 642, 361 },	// whole frame, row kernels
+	{ 0, { 100, 51, 320, 181 }, 320, 181 },	// ROI from an odd row, row kernels
+	{ 0, {  33, 10, 200, 100 }, 200, 100 },	// ROI from an odd column, per pixel
+	{ 0, {   0,  0,   0,   0 }, 300, 200 },	// downscale
+	{ 0, {  64, 32, 256, 128 }, 512, 257 },	// upscale of a ROI
+	{ 0, { 600,  0,   0,   0 },  42, 361 },	// ROI to the right edge
+	{ 1, {   0,  0,   0,   0 },  34,  17 },
+	{ 1, {   1,  1,  33,  16 },   7,   5 },
+};
+
+#define VERIFY_BATCH_FRAMES (sizeof(verifyBatchFrames) / sizeof(verifyBatchFrame))
+
+
+// batch reference, sampling the source pixel of each output pixel
+template<yuvFormat layout, imageFormat format>
+static void verifyBatchReference( const yuvBatchFrame& f, uint8_t* output )
+{
+	const yuvCoeffs k = yuvCoeffsInit(f.colorimetry, yuvFormatDepth(layout));
+
+	const uint32_t roiWidth  = f.roiWidth ? f.roiWidth : f.inputWidth - f.roiLeft;
+	const uint32_t roiHeight = f.roiHeight ? f.roiHeight : f.inputHeight - f.roiTop;
+
+	const float scaleX = float(roiWidth) / float(f.outputWidth);
+	const float scaleY = float(roiHeight) / float(f.outputHeight);
+
+	for( uint32_t y=0; y < f.outputHeight; y++ )
+	{
+		for( uint32_t x=0; x < f.outputWidth; x++ )
+		{
+			const uint32_t sx = f.roiLeft + std::min(uint32_t(float(x) * scaleX), roiWidth - 1);
+			const uint32_t sy = f.roiTop + std::min(uint32_t(float(y) * scaleY), roiHeight - 1);
+
+			uint32_t luma, u, v;
+			int32_t  r, g, b;
+
+			yuvSample<layout>(f.input, f.inputPitch, f.inputHeight, sx, sy, luma, u, v);
+			yuvToRGBFixed(k, luma, u, v, r, g, b);
+			imageStoreRGBFixed<format>(output + y * f.outputPitch, x, r, g, b);
+		}
+	}
+}
+
+
+// compare each frame of the batch, returns the number of mismatching frames
+static int verifyBatchReport( const char* name, yuvFormat layout, imageFormat format, const yuvBatchFrame* frames, const uint8_t* reference, const uint8_t* output )
+{
+	int failures = 0;
+
+	for( size_t n=0; n < VERIFY_BATCH_FRAMES; n++ )
+	{
+		const size_t offset = (uint8_t*)frames[n].output - (uint8_t*)frames[0].output;
+		const long mismatch = verifyCompare(reference + offset, output + offset, frames[n].outputPitch * frames[n].outputHeight, imageFormatSize(format));
+
+		if( mismatch < 0 )
+			continue;
+
+		printf("  %-6s %-9s batch frame %zu  %-8s  MISMATCH at pixel (%ld, %ld)\n", name, yuvFormatToStr(layout), n, imageFormatToStr(format),
+			  mismatch % (long)frames[n].outputWidth, mismatch / (long)frames[n].outputWidth);
+
+		failures++;
+	}
+
+	return failures;
+}
+
+
+template<yuvFormat layout, imageFormat format>
+static int verifyBatch( bool gpu, int& checks )
+{
+	const verifySize sizes[] = { verifySizes[3], verifySizes[5] };
+
+	const size_t pixelSize = imageFormatSize(format);
+	const size_t bytes     = (layout == YUV_P010) ? 2 : 1;
+
+	std::unique_ptr<benchBuffer> inputs[2];
+
+	for( int n=0; n < 2; n++ )
+		inputs[n].reset(new benchBuffer(sizes[n].pitch * bytes * sizes[n].height * 3 / 2 + sizes[n].pitch * bytes, gpu));
+
+	size_t outputSize = 0;
+
+	for( size_t n=0; n < VERIFY_BATCH_FRAMES; n++ )
+		outputSize += verifyBatchFrames[n].outputWidth * verifyBatchFrames[n].outputHeight * pixelSize;
+
+	benchBuffer output(outputSize, gpu);
+	std::vector<uint8_t> reference(outputSize, 0xCD);
+
+	// the frames for the reference, for the CPU and for CUDA
+	yuvBatchFrame frames[VERIFY_BATCH_FRAMES];
+	yuvBatchFrame framesCPU[VERIFY_BATCH_FRAMES];
+	yuvBatchFrame framesGPU[VERIFY_BATCH_FRAMES];
+
+	size_t offset = 0;
+
+	for( size_t n=0; n < VERIFY_BATCH_FRAMES; n++ )
+	{
+		const verifyBatchFrame& v = verifyBatchFrames[n];
+		yuvBatchFrame& f = frames[n];
+
+		f.inputPitch   = sizes[v.input].pitch * bytes;
+		f.inputWidth   = sizes[v.input].width;
+		f.inputHeight  = sizes[v.input].height;
+		f.roiLeft      = v.roi[0];
+		f.roiTop       = v.roi[1];
+		f.roiWidth     = v.roi[2];
+		f.roiHeight    = v.roi[3];
+		f.outputPitch  = v.outputWidth * pixelSize;
+		f.outputWidth  = v.outputWidth;
+		f.outputHeight = v.outputHeight;
+		f.colorimetry  = verifyColorimetry[n % (sizeof(verifyColorimetry) / sizeof(yuvColorimetry))];
+
+		framesCPU[n] = f;
+		framesCPU[n].input  = inputs[v.input]->cpu<uint8_t>();
+		framesCPU[n].output = output.cpu<uint8_t>() + offset;
+
+		framesGPU[n] = f;
+		framesGPU[n].input  = inputs[v.input]->gpu<uint8_t>();
+		framesGPU[n].output = output.gpu<uint8_t>() + offset;
+
+		f.input = framesCPU[n].input;
+		verifyBatchReference<layout, format>(f, &reference[offset]);
+		offset += f.outputPitch * f.outputHeight;
+	}
+
+	int failures = 0;
+
+	// CPU, with every instruction set that is supported
+	const cpuISA detected = cpuGetISA();
+
+	for( int isa=CPU_ISA_SCALAR; isa <= CPU_ISA_NEON; isa++ )
+	{
+		if( cpuSetISA((cpuISA)isa) != isa )
+			continue;
+
+		memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+
+		if( !cpuYUVToFormatBatch(framesCPU, VERIFY_BATCH_FRAMES, layout, format) )
+		{
+			printf("  %-6s %-9s batch  %-8s  FAILED\n", cpuISAName((cpuISA)isa), yuvFormatToStr(layout), imageFormatToStr(format));
+			failures++;
+		}
+		else
+		{
+			failures += verifyBatchReport(cpuISAName((cpuISA)isa), layout, format, framesCPU, &reference[0], output.cpu<uint8_t>());
+		}
+
+		checks++;
+	}
+
+	cpuSetISA(detected);
+
+	// CUDA
+	if( gpu )
+	{
+		memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+
+		if( CUDA_FAILED(cudaYUVToFormatBatch(framesGPU, VERIFY_BATCH_FRAMES, layout, format)) || CUDA_FAILED(cudaDeviceSynchronize()) )
+		{
+			printf("  CUDA   %-9s batch  %-8s  FAILED\n", yuvFormatToStr(layout), imageFormatToStr(format));
+			failures++;
+		}
+		else
+		{
+			failures += verifyBatchReport("CUDA", layout, format, framesCPU, &reference[0], output.cpu<uint8_t>());
+		}
+
+		checks++;
+	}
+
+	return failures;
+}
+
+
+template<yuvFormat layout>
+static int verifyBatch( bool gpu, int& checks )
+{
+	int failures = 0;
+
+	failures += verifyBatch<layout, IMAGE_RGBA32F>(gpu, checks);
+	failures += verifyBatch<layout, IMAGE_RGBA16F>(gpu, checks);
+	failures += verifyBatch<layout, IMAGE_RGBA8>(gpu, checks);
+	failures += verifyBatch<layout, IMAGE_RGB8>(gpu, checks);
+	failures += verifyBatch<layout, IMAGE_BGR8>(gpu, checks);
+
+	return failures;
+}
+
+
+// outputs of the profiles check, from the 642x361 input
+static const yuvProfile verifyProfiles[] = {
+	yuvProfile(300, 200, IMAGE_RGBA32F, IMAGE_PLANAR),	// downscale
+	yuvProfile(642, 361, IMAGE_RGBA8),			// full resolution
+	yuvProfile(1000, 555, IMAGE_RGBA16F, IMAGE_PLANAR),	// upscale
+	yuvProfile(41, 23, IMAGE_BGR8, IMAGE_PLANAR),
+	yuvProfile(77, 50, IMAGE_RGB8),
+	yuvProfile(642, 17, IMAGE_RGBA32F),			// rows only
+	yuvProfile(642, 700, IMAGE_BGR8),			// rows only, upscaled
+	yuvProfile(900, 180, IMAGE_RGBA8),			// picked from a converted row, upscaled
+};
+
+#define VERIFY_PROFILES (sizeof(verifyProfiles) / sizeof(yuvProfile))
+
+
+// profile reference, the batch reference of the whole frame deinterleaved into planes
+template<yuvFormat layout>
+static void verifyProfileReference( const yuvBatchFrame& f, const yuvProfile& p, uint8_t* output )
+{
+	const size_t pixelSize = imageFormatSize(p.format);
+	std::vector<uint8_t> interleaved(p.width * p.height * pixelSize);
+
+	uint8_t* dst = (p.layout == IMAGE_PLANAR) ? &interleaved[0] : output;
+
+	switch(p.format)
+	{
+		case IMAGE_RGBA32F:	verifyBatchReference<layout, IMAGE_RGBA32F>(f, dst); break;
+		case IMAGE_RGBA16F:	verifyBatchReference<layout, IMAGE_RGBA16F>(f, dst); break;
+		case IMAGE_RGBA8:	verifyBatchReference<layout, IMAGE_RGBA8>(f, dst); break;
+		case IMAGE_RGB8:	verifyBatchReference<layout, IMAGE_RGB8>(f, dst); break;
+		case IMAGE_BGR8:	verifyBatchReference<layout, IMAGE_BGR8>(f, dst); break;
+		default:		return;
+	}
+
+	if( p.layout != IMAGE_PLANAR )
+		return;
+
+	const size_t channels    = imageFormatChannels(p.format);
+	const size_t elementSize = pixelSize / channels;
+	const size_t planeSize   = p.width * p.height;
+
+	for( size_t n=0; n < planeSize; n++ )
+		for( size_t c=0; c < channels; c++ )
+			memcpy(output + (c * planeSize + n) * elementSize, &interleaved[n * pixelSize + c * elementSize], elementSize);
+}
+
+
+// compare each output of the profiles, returns the number of mismatching outputs
+static int verifyProfilesReport( const char* name, yuvFormat layout, const size_t* offsets, const uint8_t* reference, const uint8_t* output )
+{
+	int failures = 0;
+
+	for( size_t n=0; n < VERIFY_PROFILES; n++ )
+	{
+		const yuvProfile& p = verifyProfiles[n];
+		const size_t pixelSize = imageFormatSize(p.format);
+
+		// planes are compared per element, and the mismatch is reported in the first plane
+		const size_t elementSize = (p.layout == IMAGE_PLANAR) ? pixelSize / imageFormatChannels(p.format) : pixelSize;
+		const long mismatch = verifyCompare(reference + offsets[n], output + offsets[n], p.width * p.height * pixelSize, elementSize);
+
+		if( mismatch < 0 )
+			continue;
+
+		const long pixel = mismatch % long(p.width * p.height);
+
+		printf("  %-6s %-9s profile %zu  %4ux%-4u %-8s %-11s  MISMATCH at pixel (%ld, %ld)\n", name, yuvFormatToStr(layout), n, p.width, p.height,
+			  imageFormatToStr(p.format), imageLayoutToStr(p.layout), pixel % (long)p.width, pixel / (long)p.width);
+
+		failures++;
+	}
+
+	return failures;
+}
+
+
+template<yuvFormat layout>
+static int verifyProfilesInput( bool gpu, int& checks )
+{
+	const verifySize& size = verifySizes[3];
+	const yuvColorimetry& cs = verifyColorimetry[1];
+
+	const size_t bytes = (layout == YUV_P010) ? 2 : 1;
+
+	benchBuffer input(size.pitch * bytes * size.height * 3 / 2 + size.pitch * bytes, gpu);
+
+	// the outputs at 256-byte offsets of one buffer, like gstCamera::ConvertProfiles()
+	size_t offsets[VERIFY_PROFILES];
+	size_t outputSize = 0;
+
+	for( size_t n=0; n < VERIFY_PROFILES; n++ )
+	{
+		offsets[n] = outputSize;
+		outputSize = (outputSize + verifyProfiles[n].width * verifyProfiles[n].height * imageFormatSize(verifyProfiles[n].format) + 255) & ~(size_t)255;
+	}
+
+	benchBuffer output(outputSize, gpu);
+	std::vector<uint8_t> reference(outputSize, 0xCD);
+
+	yuvProfile profilesCPU[VERIFY_PROFILES];
+	yuvProfile profilesGPU[VERIFY_PROFILES];
+
+	for( size_t n=0; n < VERIFY_PROFILES; n++ )
+	{
+		yuvBatchFrame f;
+
+		f.input        = input.cpu<uint8_t>();
+		f.inputPitch   = size.pitch * bytes;
+		f.inputWidth   = size.width;
+		f.inputHeight  = size.height;
+		f.outputPitch  = verifyProfiles[n].width * imageFormatSize(verifyProfiles[n].format);
+		f.outputWidth  = verifyProfiles[n].width;
+		f.outputHeight = verifyProfiles[n].height;
+		f.colorimetry  = cs;
+
+		verifyProfileReference<layout>(f, verifyProfiles[n], &reference[offsets[n]]);
+
+		profilesCPU[n] = verifyProfiles[n];
+		profilesCPU[n].output = output.cpu<uint8_t>() + offsets[n];
+
+		profilesGPU[n] = verifyProfiles[n];
+		profilesGPU[n].output = output.gpu<uint8_t>() + offsets[n];
+	}
+
+	int failures = 0;
+
+	// CPU
+	memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+
+	if( !cpuYUVToProfiles(input.cpu<uint8_t>(), size.pitch * bytes, layout, size.width, size.height, profilesCPU, VERIFY_PROFILES, cs) )
+	{
+		printf("  CPU    %-9s profiles  FAILED\n", yuvFormatToStr(layout));
+		failures++;
+	}
+	else
+	{
+		failures += verifyProfilesReport("CPU", layout, offsets, &reference[0], output.cpu<uint8_t>());
+	}
+
+	checks++;
+
+	// CUDA
+	if( gpu )
+	{
+		memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+
+		if( CUDA_FAILED(cudaYUVToProfiles(input.gpu<uint8_t>(), size.pitch * bytes, layout, size.width, size.height, profilesGPU, VERIFY_PROFILES, cs)) || CUDA_FAILED(cudaDeviceSynchronize()) )
+		{
+			printf("  CUDA   %-9s profiles  FAILED\n", yuvFormatToStr(layout));
+			failures++;
+		}
+		else
+		{
+			failures += verifyProfilesReport("CUDA", layout, offsets, &reference[0], output.cpu<uint8_t>());
+		}
+
+		checks++;
+	}
+
+	return failures;
+}
+
+
+// RGB to NV12 reference, one 2x2 block per thread of the grid
+template<imageFormat format>
+static void verifyEncodeReference( const rgbCoeffs& k, const uint8_t* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height )
+{
+	for( uint32_t y=0; y < height; y += 2 )
+	{
+		const uint32_t y1 = (y + 1 < height) ? y + 1 : y;
+
+		for( uint32_t x=0; x < width; x += 2 )
+			nv12EncodeBlock<format>(k, input + y * inputPitch, input + y1 * inputPitch, output + y * outputPitch, output + y1 * outputPitch,
+							    output + outputPitch * height + (y >> 1) * outputPitch, x, width);
+	}
+}
+
+
+// print a mismatch of the RGB to NV12 output (rows past the height are chroma), returns true if there was none
+static bool verifyEncodeReport( const char* name, const verifySize& s, imageFormat format, const yuvColorimetry& cs, long mismatch )
+{
+	if( mismatch < 0 )
+		return true;
+
+	printf("  %-6s %4zux%-4zu %-8s %-6s %-7s  MISMATCH at byte %ld of row %ld\n", name, s.width, s.height, imageFormatToStr(format),
+		  yuvMatrixToStr(cs.matrix), (cs.range == YUV_RANGE_FULL) ? "full" : "limited", mismatch % (long)s.pitch, mismatch / (long)s.pitch);
+
+	return false;
+}
+
+
+template<imageFormat format>
+static int verifyEncode( const verifySize& s, const yuvColorimetry& cs, bool gpu, int& checks )
+{
+	const size_t inputPitch = s.pitch * imageFormatSize(format);
+	const size_t inputSize  = inputPitch * s.height;
+	const size_t outputSize = yuvFormatSize(YUV_NV12, s.pitch, s.height);
+
+	benchBuffer input(inputSize, gpu);
+	benchBuffer output(outputSize, gpu);
+
+	// floats past both ends of [0,255], halves and NaN, to check the clamping and rounding
+	if( format == IMAGE_RGBA32F )
+	{
+		for( size_t n=0; n < inputSize / sizeof(float); n++ )
+			input.cpu<float>()[n] = (n % 997 == 0) ? NAN : float(int((n * 37) % 640) - 64) * 0.5f;
+	}
+
+	std::vector<uint8_t> reference(outputSize, 0xCD);
+
+	const rgbCoeffs k = rgbCoeffsInit(cs);
+	int failures = 0;
+
+	verifyEncodeReference<format>(k, input.cpu<uint8_t>(), inputPitch, &reference[0], s.pitch, s.width, s.height);
+
+	// CPU, with every instruction set that is supported
+	const cpuISA detected = cpuGetISA();
+
+	for( int isa=CPU_ISA_SCALAR; isa <= CPU_ISA_NEON; isa++ )
+	{
+		if( cpuSetISA((cpuISA)isa) != isa )
+			continue;
+
+		memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+		cpuFormatToNV12(input.cpu<uint8_t>(), inputPitch, format, output.cpu<uint8_t>(), s.pitch, s.width, s.height, cs);
+
+		if( !verifyEncodeReport(cpuISAName((cpuISA)isa), s, format, cs, verifyCompare(&reference[0], output.cpu<uint8_t>(), outputSize, 1)) )
+			failures++;
+
+		checks++;
+	}
+
+	cpuSetISA(detected);
+
+	// CUDA
+	if( gpu )
+	{
+		memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+
+		if( CUDA_FAILED(cudaFormatToNV12(input.gpu<uint8_t>(), inputPitch, format, output.gpu<uint8_t>(), s.pitch, s.width, s.height, cs))
+		    || CUDA_FAILED(cudaDeviceSynchronize()) )
+		{
+			printf("  CUDA   %4zux%-4zu %-8s  FAILED\n", s.width, s.height, imageFormatToStr(format));
+			failures++;
+		}
+		else if( !verifyEncodeReport("CUDA", s, format, cs, verifyCompare(&reference[0], output.cpu<uint8_t>(), outputSize, 1)) )
+		{
+			failures++;
+		}
+
+		checks++;
+	}
+
+	return failures;
+}
+
+
+// luma downscale reference, one output sample per thread of the grid
+template<yuvFormat layout, typename T>
+static void verifyGrayReference( const uint8_t* input, size_t inputPitch, size_t inputWidth, size_t inputHeight, T* output, size_t outputWidth, size_t outputHeight )
+{
+	for( uint32_t y=0; y < outputHeight; y++ )
+	{
+		for( uint32_t x=0; x < outputWidth; x++ )
+		{
+			uint32_t x0, x1, y0, y1;
+
+			lumaBoxRange(x, outputWidth, inputWidth, x0, x1);
+			lumaBoxRange(y, outputHeight, inputHeight, y0, y1);
+
+			lumaBoxStore<layout>(output[y * outputWidth + x], lumaBoxSum<layout>(input, inputPitch, x0, x1, y0, y1), (x1 - x0) * (y1 - y0));
+		}
+	}
+}
+
+
+static bool verifyGrayReport( const char* name, yuvFormat layout, const verifySize& s, size_t outputWidth, size_t outputHeight, size_t depth, long mismatch )
+{
+	if( mismatch < 0 )
+		return true;
+
+	printf("  %-6s %-9s %4zux%-4zu -> %4zux%-4zu %-5s  MISMATCH at pixel (%ld, %ld)\n", name, yuvFormatToStr(layout), s.width, s.height,
+		  outputWidth, outputHeight, (depth == 1) ? "uint8" : "float", mismatch % (long)outputWidth, mismatch / (long)outputWidth);
+
+	return false;
+}
+
+
+template<yuvFormat layout, typename T>
+static int verifyGray( const verifySize& s, size_t outputWidth, size_t outputHeight, bool gpu, int& checks )
+{
+	const size_t inputPitch = (layout == YUV_P010) ? s.pitch * 2 : s.pitch;
+	const size_t outputSize = outputWidth * outputHeight * sizeof(T);
+
+	benchBuffer input(inputPitch * s.height, gpu);
+	benchBuffer output(outputSize, gpu);
+
+	std::vector<T> reference(outputWidth * outputHeight);
+	verifyGrayReference<layout>(input.cpu<uint8_t>(), inputPitch, s.width, s.height, &reference[0], outputWidth, outputHeight);
+
+	int failures = 0;
+
+	// CPU
+	memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+
+	if( !cpuYUVToGray(input.cpu<uint8_t>(), inputPitch, layout, s.width, s.height, output.cpu<T>(), outputWidth * sizeof(T), outputWidth, outputHeight) )
+	{
+		printf("  CPU    %-9s %4zux%-4zu -> %4zux%-4zu  FAILED\n", yuvFormatToStr(layout), s.width, s.height, outputWidth, outputHeight);
+		failures++;
+	}
+	else if( !verifyGrayReport("CPU", layout, s, outputWidth, outputHeight, sizeof(T), verifyCompare((uint8_t*)&reference[0], output.cpu<uint8_t>(), outputSize, sizeof(T))) )
+	{
+		failures++;
+	}
+
+	checks++;
+
+	// CUDA
+	if( gpu )
+	{
+		memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+
+		if( CUDA_FAILED(cudaYUVToGray(input.gpu<uint8_t>(), inputPitch, layout, s.width, s.height, output.gpu<T>(), outputWidth * sizeof(T), outputWidth, outputHeight))
+		    || CUDA_FAILED(cudaDeviceSynchronize()) )
+		{
+			printf("  CUDA   %-9s %4zux%-4zu -> %4zux%-4zu  FAILED\n", yuvFormatToStr(layout), s.width, s.height, outputWidth, outputHeight);
+			failures++;
+		}
+		else if( !verifyGrayReport("CUDA", layout, s, outputWidth, outputHeight, sizeof(T), verifyCompare((uint8_t*)&reference[0], output.cpu<uint8_t>(), outputSize, sizeof(T))) )
+		{
+			failures++;
+		}
+
+		checks++;
+	}
+
+	return failures;
+}
+
+
+// views of the ImageView check:  a crop of a padded input, written to a padded output
+static const uint32_t verifyViewWidth  = 61;
+static const uint32_t verifyViewHeight = 37;
+static const uint32_t verifyViewPitch  = 67;	// in pixels, for the input and output
+
+static const uint32_t verifyViewCrop[] = { 5, 3, 41, 29 };	// left, top, width, height
+
+
+// compare the rows of a view with a packed reference, and check that the padding kept its 0xCD fill
+static bool verifyViewReport( const char* name, const char* op, const float4* reference, const ImageView<float4>& view )
+{
+	for( uint32_t y=0; y < view.height; y++ )
+	{
+		const long x = verifyCompare((const uint8_t*)(reference + y * view.width), (const uint8_t*)view.Row(y), view.width * sizeof(float4), sizeof(float4));
+
+		if( x >= 0 )
+		{
+			printf("  %-6s %-9s %ux%u view  MISMATCH at pixel (%ld, %u)\n", name, op, view.width, view.height, x, y);
+			return false;
+		}
+
+		const uint8_t* padding = (const uint8_t*)(view.Row(y) + view.width);
+
+		for( size_t n=0; n < view.pitch - view.width * sizeof(float4); n++ )
+		{
+			if( padding[n] != 0xCD )
+			{
+				printf("  %-6s %-9s %ux%u view  padding of row %u overwritten\n", name, op, view.width, view.height, y);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+static int verifyViews( bool gpu, int& checks )
+{
+	const size_t pitch = verifyViewPitch * sizeof(float4);
+	const size_t size  = pitch * verifyViewHeight;
+
+	const uint32_t cropWidth  = verifyViewCrop[2];
+	const uint32_t cropHeight = verifyViewCrop[3];
+	const uint32_t outWidth   = 23;	// resize output
+	const uint32_t outHeight  = 17;
+
+	benchBuffer input(size, gpu);
+	benchBuffer packed(cropWidth * cropHeight * sizeof(float4), gpu);
+	benchBuffer reference(cropWidth * cropHeight * sizeof(float4), gpu);
+	benchBuffer output(size, gpu);
+	benchBuffer rects(2 * sizeof(float4), gpu);
+
+	input.fillFloat(size / sizeof(float));
+
+	rects.cpu<float4>()[0] = make_float4(2, 3, 20, 11);
+	rects.cpu<float4>()[1] = make_float4(15, -4, 60, 25);
+
+	// the packed copy of the crop, the input of the reference ops
+	const ImageView<float4> inputCPU = ImageView<float4>(input.cpu<float4>(), verifyViewWidth, verifyViewHeight, pitch).Crop(verifyViewCrop[0], verifyViewCrop[1], cropWidth, cropHeight);
+
+	for( uint32_t y=0; y < cropHeight; y++ )
+		memcpy(packed.cpu<float4>() + y * cropWidth, inputCPU.Row(y), cropWidth * sizeof(float4));
+
+	const float2 inputRange  = make_float2(0.0f, 255.0f);
+	const float2 outputRange = make_float2(0.0f, 1.0f);
+	const float4 color       = make_float4(0, 255, 0, 120);
+
+	const char* ops[] = { "resize", "normalize", "overlay" };
+	int failures = 0;
+
+	for( int backend=0; backend < (gpu ? 2 : 1); backend++ )
+	{
+		const bool cuda = (backend == 1);
+		const char* name = cuda ? "CUDA" : "CPU";
+
+		float4* inputPtr  = cuda ? input.gpu<float4>() : input.cpu<float4>();
+		float4* outputPtr = cuda ? output.gpu<float4>() : output.cpu<float4>();
+		float4* packedPtr = cuda ? packed.gpu<float4>() : packed.cpu<float4>();
+		float4* refPtr    = cuda ? reference.gpu<float4>() : reference.cpu<float4>();
+		float4* rectsPtr  = cuda ? rects.gpu<float4>() : rects.cpu<float4>();
+
+		const ImageView<float4> crop = ImageView<float4>(inputPtr, verifyViewWidth, verifyViewHeight, pitch).Crop(verifyViewCrop[0], verifyViewCrop[1], cropWidth, cropHeight);
+
+		for( int op=0; op < 3; op++ )
+		{
+			const uint32_t width  = (op == 0) ? outWidth : cropWidth;
+			const uint32_t height = (op == 0) ? outHeight : cropHeight;
+
+			const ImageView<float4> view(outputPtr + verifyViewPitch + 1, width, height, pitch);
+
+			memset(output.cpu<uint8_t>(), 0xCD, size);
+			memset(reference.cpu<uint8_t>(), 0xCD, cropWidth * cropHeight * sizeof(float4));
+
+			bool result = false;
+
+			if( cuda )
+			{
+				if( op == 0 )
+					result = CUDA_SUCCESS(cudaResizeRGBA(packedPtr, cropWidth, cropHeight, refPtr, width, height)) && CUDA_SUCCESS(cudaResizeRGBA(crop, view));
+				else if( op == 1 )
+					result = CUDA_SUCCESS(cudaNormalizeRGBA(packedPtr, inputRange, refPtr, outputRange, width, height)) && CUDA_SUCCESS(cudaNormalizeRGBA(crop, inputRange, view, outputRange));
+				else
+					result = CUDA_SUCCESS(cudaRectOutlineOverlay(packedPtr, refPtr, width, height, rectsPtr, 2, color)) && CUDA_SUCCESS(cudaRectOutlineOverlay(crop, view, rectsPtr, 2, color));
+
+				result = result && CUDA_SUCCESS(cudaDeviceSynchronize());
+			}
+			else
+			{
+				if( op == 0 )
+					result = cpuResizeRGBA(packedPtr, cropWidth, cropHeight, refPtr, width, height) && cpuResizeRGBA(crop, view);
+				else if( op == 1 )
+					result = cpuNormalizeRGBA(packedPtr, inputRange, refPtr, outputRange, width, height) && cpuNormalizeRGBA(crop, inputRange, view, outputRange);
+				else
+					result = cpuRectOutlineOverlay(packedPtr, refPtr, width, height, rectsPtr, 2, color) && cpuRectOutlineOverlay(crop, view, rectsPtr, 2, color);
+			}
+
+			const ImageView<float4> viewCPU(output.cpu<float4>() + verifyViewPitch + 1, width, height, pitch);
+
+			if( !result )
+			{
+				printf("  %-6s %-9s %ux%u view  FAILED\n", name, ops[op], width, height);
+				failures++;
+			}
+			else if( !verifyViewReport(name, ops[op], reference.cpu<float4>(), viewCPU) )
+			{
+				failures++;
+			}
+
+			checks++;
+		}
+	}
+
+	return failures;
+}
+
+
+// sizes of the resize check (input, output), with integer, fractional and upscaling ratios
+static const uint32_t verifyResizeSizes[][4] = {
+	{ 64, 48, 32, 24 }, { 63, 45, 21, 15 }, { 64, 48, 16, 12 },
+	{ 97, 61, 30, 30 }, { 37, 23, 80, 50 }, { 50, 40, 50, 40 }, { 1, 9, 3, 2 }
+};
+
+
+template<typename T>
+static int verifyResize( const uint32_t* size, resizeFilter filter, bool gpu, int& checks )
+{
+	const size_t inputPitch  = (size[0] + 3) * sizeof(T);	// padded rows, aligned to the pixel
+	const size_t outputPitch = size[2] * sizeof(T);
+	const size_t outputSize  = outputPitch * size[3];
+
+	benchBuffer input(inputPitch * size[1], gpu);
+	benchBuffer output(outputSize, gpu);
+
+	if( (typename resizePixel<T>::scalar)0.5f != 0 )	// float pixels
+		input.fillFloat(inputPitch * size[1] / sizeof(float));
+
+	// reference, per output pixel like the kernels (always the generic box for area)
+	std::vector<T> reference(size[2] * size[3]);
+
+	const ImageView<T> inputCPU(input.cpu<T>(), size[0], size[1], inputPitch);
+	const ImageView<T> referenceView(&reference[0], size[2], size[3]);
+
+	for( uint32_t y=0; y < size[3]; y++ )
+	{
+		for( uint32_t x=0; x < size[2]; x++ )
+		{
+			if( filter == RESIZE_BILINEAR )
+				resizeLinearPixel(inputCPU, referenceView, x, y);
+			else
+				resizeAreaPixel<T, 0>(inputCPU, referenceView, x, y);
+		}
+	}
+
+	int failures = 0;
+
+	for( int backend=0; backend < (gpu ? 2 : 1); backend++ )
+	{
+		const char* name = (backend == 1) ? "CUDA" : "CPU";
+		memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+
+		bool result = false;
+
+		if( backend == 1 )
+			result = CUDA_SUCCESS(cudaResize(ImageView<T>(input.gpu<T>(), size[0], size[1], inputPitch), ImageView<T>(output.gpu<T>(), size[2], size[3]), filter))
+				    && CUDA_SUCCESS(cudaDeviceSynchronize());
+		else
+			result = cpuResize(inputCPU, ImageView<T>(output.cpu<T>(), size[2], size[3]), filter);
+
+		if( !result )
+		{
+			printf("  %-6s %-8s %ux%u -> %ux%u %zu-byte pixels  FAILED\n", name, resizeFilterToStr(filter), size[0], size[1], size[2], size[3], sizeof(T));
+			failures++;
+		}
+		else
+		{
+			const long mismatch = verifyCompare((const uint8_t*)&reference[0], output.cpu<uint8_t>(), outputSize, sizeof(T));
+
+			if( mismatch >= 0 )
+			{
+				printf("  %-6s %-8s %ux%u -> %ux%u %zu-byte pixels  MISMATCH at pixel (%ld, %ld)\n", name, resizeFilterToStr(filter), size[0], size[1], size[2], size[3],
+					  sizeof(T), mismatch % (long)size[2], mismatch / (long)size[2]);
+				failures++;
+			}
+		}
+
+		checks++;
+	}
+
+	return failures;
+}
+
+
+// sizes of the letterbox check (input, canvas), padded vertically, horizontally or not at all
+static const uint32_t verifyLetterboxSizes[][4] = {
+	{ 64, 48, 40, 40 }, { 30, 50, 48, 32 }, { 33, 33, 20, 20 }, { 25, 14, 96, 96 }
+};
+
+
+template<typename T>
+static int verifyLetterbox( const uint32_t* size, resizeFilter filter, const T& padding, bool gpu, int& checks )
+{
+	const size_t inputSize  = size[0] * size[1] * sizeof(T);
+	const size_t outputSize = size[2] * size[3] * sizeof(T);
+
+	benchBuffer input(inputSize, gpu);
+	benchBuffer output(outputSize, gpu);
+
+	if( (typename resizePixel<T>::scalar)0.5f != 0 )	// float pixels
+		input.fillFloat(inputSize / sizeof(float));
+
+	// reference, the padding and then the kernels' per-pixel functions on the content crop
+	const letterboxTransform t = letterboxCompute(size[0], size[1], size[2], size[3]);
+	std::vector<T> reference(size[2] * size[3], padding);
+
+	const ImageView<T> inputCPU(input.cpu<T>(), size[0], size[1]);
+	const ImageView<T> content = ImageView<T>(&reference[0], size[2], size[3]).Crop(t.left, t.top, t.width, t.height);
+	const float2 scale = make_float2(float(size[0]) / float(content.width), float(size[1]) / float(content.height));
+
+	for( uint32_t y=0; y < content.height; y++ )
+	{
+		for( uint32_t x=0; x < content.width; x++ )
+		{
+			if( filter == RESIZE_NEAREST )
+				resizeNearestPixel(inputCPU, content, scale, x, y);
+			else if( filter == RESIZE_BILINEAR )
+				resizeLinearPixel(inputCPU, content, x, y);
+			else
+				resizeAreaPixel<T, 0>(inputCPU, content, x, y);
+		}
+	}
+
+	// the content box must project back onto the whole source
+	const float4 box = letterboxProject(t, make_float4(t.left, t.top, t.left + t.width, t.top + t.height));
+
+	int failures = 0;
+
+	if( fabsf(box.x) > 1e-3f || fabsf(box.y) > 1e-3f || fabsf(box.z - size[0]) > 1e-3f || fabsf(box.w - size[1]) > 1e-3f )
+	{
+		printf("  %-6s %ux%u -> %ux%u  projected (%g, %g, %g, %g)\n", "box", size[0], size[1], size[2], size[3], box.x, box.y, box.z, box.w);
+		failures++;
+	}
+
+	for( int backend=0; backend < (gpu ? 2 : 1); backend++ )
+	{
+		const char* name = (backend == 1) ? "CUDA" : "CPU";
+		memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+
+		letterboxTransform result;
+		memset(&result, 0, sizeof(result));
+
+		bool success = false;
+
+		if( backend == 1 )
+			success = CUDA_SUCCESS(cudaLetterbox(ImageView<T>(input.gpu<T>(), size[0], size[1]), ImageView<T>(output.gpu<T>(), size[2], size[3]), filter, padding, &result))
+				     && CUDA_SUCCESS(cudaDeviceSynchronize());
+		else
+			success = cpuLetterbox(inputCPU, ImageView<T>(output.cpu<T>(), size[2], size[3]), filter, padding, &result);
+
+		if( !success || result.left != t.left || result.top != t.top || result.width != t.width || result.height != t.height )
+		{
+			printf("  %-6s %-8s %ux%u -> %ux%u %zu-byte pixels  FAILED\n", name, resizeFilterToStr(filter), size[0], size[1], size[2], size[3], sizeof(T));
+			failures++;
+		}
+		else
+		{
+			const long mismatch = verifyCompare((const uint8_t*)&reference[0], output.cpu<uint8_t>(), outputSize, sizeof(T));
+
+			if( mismatch >= 0 )
+			{
+				printf("  %-6s %-8s %ux%u -> %ux%u %zu-byte pixels  MISMATCH at pixel (%ld, %ld)\n", name, resizeFilterToStr(filter), size[0], size[1], size[2], size[3],
+					  sizeof(T), mismatch % (long)size[2], mismatch / (long)size[2]);
+				failures++;
+			}
+		}
+
+		checks++;
+	}
+
+	return failures;
+}
+
+
+// mosaics of the check: a partly filled 3x3 grid of RGBA with an odd size, and a 2x2 grid of NV12
+static const uint32_t verifyMosaicSizes[][3] = {
+	{ 7, 647, 365 }, { 4, 642, 362 }
+};
+
+
+template<typename T, imageFormat format>
+static int verifyMosaic( const uint32_t* size, bool nv12, resizeFilter filter, bool gpu, int& checks )
+{
+	const uint32_t count  = size[0];
+	const uint32_t width  = size[1];
+	const uint32_t height = size[2];
+
+	// the inputs are larger than the tiles (area is for downscaling), except one for the
+	// other filters, and input 2 has no new frame
+	uint32_t inputSizes[MOSAIC_MAX_TILES][2];
+	size_t inputOffsets[MOSAIC_MAX_TILES];
+	size_t inputTotal = 0;
+
+	for( uint32_t n=0; n < count; n++ )
+	{
+		inputSizes[n][0] = (n == 1 && filter != RESIZE_AREA) ? 40 : 330 + 31 * n;
+		inputSizes[n][1] = (n == 1 && filter != RESIZE_AREA) ? 30 : 190 + 17 * n;
+		inputOffsets[n]  = inputTotal;
+		inputTotal += inputSizes[n][0] * inputSizes[n][1] * sizeof(T);
+	}
+
+	const size_t canvasSize = width * height * sizeof(T);
+	const size_t outputSize = nv12 ? width * height * 3 / 2 : canvasSize;
+
+	benchBuffer input(inputTotal, gpu);
+	benchBuffer output(outputSize, gpu);
+	benchBuffer background(canvasSize);
+
+	if( (typename resizePixel<T>::scalar)0.5f != 0 )	// float pixels
+	{
+		input.fillFloat(inputTotal / sizeof(float));
+		background.fillFloat(canvasSize / sizeof(float));
+	}
+
+	ImageView<T> inputsCPU[MOSAIC_MAX_TILES];
+	ImageView<T> inputsGPU[MOSAIC_MAX_TILES];
+
+	for( uint32_t n=0; n < count; n++ )
+	{
+		if( n == 2 )
+			continue;
+
+		inputsCPU[n] = ImageView<T>((T*)(input.cpu<uint8_t>() + inputOffsets[n]), inputSizes[n][0], inputSizes[n][1]);
+		inputsGPU[n] = ImageView<T>((T*)(input.gpu<uint8_t>() + inputOffsets[n]), inputSizes[n][0], inputSizes[n][1]);
+	}
+
+	// reference, the kernels' per-pixel resize functions on each tile of the background
+	std::vector<T> canvas(background.cpu<T>(), background.cpu<T>() + width * height);
+
+	for( uint32_t n=0; n < count; n++ )
+	{
+		if( !inputsCPU[n].ptr )
+			continue;
+
+		const mosaicTile t = mosaicTileRect(n, count, width, height, nv12);
+		const ImageView<T> tile = ImageView<T>(&canvas[0], width, height).Crop(t.left, t.top, t.width, t.height);
+		const float2 scale = make_float2(float(inputsCPU[n].width) / float(t.width), float(inputsCPU[n].height) / float(t.height));
+
+		for( uint32_t y=0; y < t.height; y++ )
+		{
+			for( uint32_t x=0; x < t.width; x++ )
+			{
+				if( filter == RESIZE_NEAREST )
+					resizeNearestPixel(inputsCPU[n], tile, scale, x, y);
+				else if( filter == RESIZE_BILINEAR )
+					resizeLinearPixel(inputsCPU[n], tile, x, y);
+				else
+					resizeAreaPixel<T, 0>(inputsCPU[n], tile, x, y);
+			}
+		}
+	}
+
+	// the output starts as the background, which the skipped tile must keep
+	std::vector<uint8_t> initial(outputSize);
+	std::vector<uint8_t> reference(outputSize);
+
+	if( nv12 )
+	{
+		const rgbCoeffs k = rgbCoeffsInit(yuvColorimetry());
+
+		verifyEncodeReference<format>(k, background.cpu<uint8_t>(), width * sizeof(T), &initial[0], width, width, height);
+		verifyEncodeReference<format>(k, (const uint8_t*)&canvas[0], width * sizeof(T), &reference[0], width, width, height);
+	}
+	else
+	{
+		memcpy(&initial[0], background.cpu<uint8_t>(), outputSize);
+		memcpy(&reference[0], &canvas[0], outputSize);
+	}
+
+	int failures = 0;
+
+	for( int backend=0; backend < (gpu ? 2 : 1); backend++ )
+	{
+		const char* name = (backend == 1) ? "CUDA" : "CPU";
+		memcpy(output.cpu<uint8_t>(), &initial[0], outputSize);
+
+		bool success = false;
+
+		if( backend == 1 && nv12 )
+			success = CUDA_SUCCESS(cudaMosaicNV12(inputsGPU, count, output.gpu<uint8_t>(), width, width, height, filter)) && CUDA_SUCCESS(cudaDeviceSynchronize());
+		else if( backend == 1 )
+			success = CUDA_SUCCESS(cudaMosaic(inputsGPU, count, ImageView<T>(output.gpu<T>(), width, height), filter)) && CUDA_SUCCESS(cudaDeviceSynchronize());
+		else if( nv12 )
+			success = cpuMosaicNV12(inputsCPU, count, output.cpu<uint8_t>(), width, width, height, filter);
+		else
+			success = cpuMosaic(inputsCPU, count, ImageView<T>(output.cpu<T>(), width, height), filter);
+
+		if( !success )
+		{
+			printf("  %-6s %-8s %u tiles %ux%u %-4s %zu-byte pixels  FAILED\n", name, resizeFilterToStr(filter), count, width, height, nv12 ? "NV12" : "RGBA", sizeof(T));
+			failures++;
+		}
+		else
+		{
+			// NV12 is compared per byte, rows past the height are chroma
+			const long mismatch = verifyCompare(&reference[0], output.cpu<uint8_t>(), outputSize, nv12 ? 1 : sizeof(T));
+
+			if( mismatch >= 0 )
+			{
+				printf("  %-6s %-8s %u tiles %ux%u %-4s %zu-byte pixels  MISMATCH at pixel (%ld, %ld)\n", name, resizeFilterToStr(filter), count, width, height,
+					  nv12 ? "NV12" : "RGBA", sizeof(T), mismatch % (long)width, mismatch / (long)width);
+				failures++;
+			}
+		}
+
+		checks++;
+	}
+
+	return failures;
+}
+
+
+// boxes of the check, and the crop each one must be rounded to (left, top, width, height),
+// in frames of 163x97 and 211x131
+static const uint32_t verifyROIFrames[][2] = { { 163, 97 }, { 211, 131 } };
+
+static const struct { tensorROI roi; uint32_t rect[4]; } verifyROIs[] = {
+	{ { { 10.3f, 5.7f, 60.2f, 40.0f }, 0 },		{ 10, 5, 51, 35 } },
+	{ { { -12.0f, -3.5f, 30.5f, 20.1f }, 1 },	{ 0, 0, 31, 21 } },
+	{ { { 150.5f, 80.2f, 400.0f, 300.0f }, 0 },	{ 150, 80, 13, 17 } },
+	{ { { 0.0f, 0.0f, 211.0f, 131.0f }, 1 },	{ 0, 0, 211, 131 } },
+	{ { { 100.4f, 60.6f, 100.6f, 60.8f }, 1 },	{ 100, 60, 1, 1 } },
+	{ { { 20.0f, 30.0f, 25.0f, 33.0f }, 0 },	{ 20, 30, 5, 3 } },
+	{ { { 5.0f, 5.0f, 50.0f, 50.0f }, 7 },		{ 0, 0, 0, 0 } },	// invalid frame
+	{ { { 300.0f, 200.0f, 310.0f, 210.0f }, 0 },	{ 162, 96, 1, 1 } },
+};
+
+static const uint32_t verifyROICount = sizeof(verifyROIs) / sizeof(verifyROIs[0]);
+
+
+template<typename T>
+static int verifyROI( tensorFormat format, tensorLayout layout, bool gpu, int& checks )
+{
+	// an odd tensor size, with the normalization of ImageNet models
+	tensorParams params(29, 23);
+
+	params.format = format;
+	params.layout = layout;
+	params.bgr    = (layout == TENSOR_LAYOUT_HWC);
+	params.scale  = 1.0f / 255.0f;
+	params.mean   = make_float3(0.485f, 0.456f, 0.406f);
+	params.stdDev = make_float3(0.229f, 0.224f, 0.225f);
+	params.int8Scale = 0.025f;
+
+	const size_t size = tensorSize(params);
+	const size_t outputSize = size * verifyROICount;
+
+	size_t frameOffsets[2];
+	size_t frameTotal = 0;
+
+	for( int n=0; n < 2; n++ )
+	{
+		frameOffsets[n] = frameTotal;
+		frameTotal += verifyROIFrames[n][0] * verifyROIFrames[n][1] * sizeof(T);
+	}
+
+	benchBuffer frames(frameTotal, gpu);
+	benchBuffer rois(sizeof(tensorROI) * verifyROICount, gpu);
+	benchBuffer output(outputSize, gpu);
+
+	if( (typename resizePixel<T>::scalar)0.5f != 0 )	// float pixels
+		frames.fillFloat(frameTotal / sizeof(float));
+
+	ImageView<T> framesCPU[2];
+	ImageView<T> framesGPU[2];
+
+	for( int n=0; n < 2; n++ )
+	{
+		framesCPU[n] = ImageView<T>((T*)(frames.cpu<uint8_t>() + frameOffsets[n]), verifyROIFrames[n][0], verifyROIFrames[n][1]);
+		framesGPU[n] = ImageView<T>((T*)(frames.gpu<uint8_t>() + frameOffsets[n]), verifyROIFrames[n][0], verifyROIFrames[n][1]);
+	}
+
+	for( uint32_t n=0; n < verifyROICount; n++ )
+		rois.cpu<tensorROI>()[n] = verifyROIs[n].roi;
+
+	// reference, cpuResize() of each crop and then the normalization of each pixel
+	const tensorWriter writer = tensorWriterInit(params, params.width, params.height);
+
+	std::vector<uint8_t> reference(outputSize, 0xAB);
+	std::vector<T> resized(params.width * params.height);
+
+	for( uint32_t n=0; n < verifyROICount; n++ )
+	{
+		const uint32_t* r = verifyROIs[n].rect;
+
+		if( verifyROIs[n].roi.frame >= 2 )
+			continue;
+
+		cpuResize(framesCPU[verifyROIs[n].roi.frame].Crop(r[0], r[1], r[2], r[3]), ImageView<T>(&resized[0], params.width, params.height), RESIZE_BILINEAR);
+
+		for( uint32_t y=0; y < params.height; y++ )
+		{
+			for( uint32_t x=0; x < params.width; x++ )
+			{
+				float cr, cg, cb;
+				tensorPixelRGB(resized[y * params.width + x], cr, cg, cb);
+
+				if( format == TENSOR_FORMAT_FP32 && layout == TENSOR_LAYOUT_CHW )
+					tensorWriteRGB<TENSOR_FORMAT_FP32, TENSOR_LAYOUT_CHW>(writer, &reference[n * size], x, y, cr, cg, cb);
+				else if( format == TENSOR_FORMAT_FP16 && layout == TENSOR_LAYOUT_CHW )
+					tensorWriteRGB<TENSOR_FORMAT_FP16, TENSOR_LAYOUT_CHW>(writer, &reference[n * size], x, y, cr, cg, cb);
+				else if( format == TENSOR_FORMAT_INT8 && layout == TENSOR_LAYOUT_CHW )
+					tensorWriteRGB<TENSOR_FORMAT_INT8, TENSOR_LAYOUT_CHW>(writer, &reference[n * size], x, y, cr, cg, cb);
+				else if( format == TENSOR_FORMAT_FP32 )
+					tensorWriteRGB<TENSOR_FORMAT_FP32, TENSOR_LAYOUT_HWC>(writer, &reference[n * size], x, y, cr, cg, cb);
+				else if( format == TENSOR_FORMAT_FP16 )
+					tensorWriteRGB<TENSOR_FORMAT_FP16, TENSOR_LAYOUT_HWC>(writer, &reference[n * size], x, y, cr, cg, cb);
+				else
+					tensorWriteRGB<TENSOR_FORMAT_INT8, TENSOR_LAYOUT_HWC>(writer, &reference[n * size], x, y, cr, cg, cb);
+			}
+		}
+	}
+
+	static const char* formats[] = { "FP32", "FP16", "INT8" };
+	static const char* layouts[] = { "CHW", "HWC" };
+
+	int failures = 0;
+
+	for( int backend=0; backend < (gpu ? 2 : 1); backend++ )
+	{
+		const char* name = (backend == 1) ? "CUDA" : "CPU";
+		memset(output.cpu<uint8_t>(), 0xAB, outputSize);
+
+		bool success = false;
+
+		if( backend == 1 )
+			success = CUDA_SUCCESS(cudaROIToTensor(framesGPU, 2, rois.gpu<tensorROI>(), verifyROICount, output.gpu<uint8_t>(), params)) && CUDA_SUCCESS(cudaDeviceSynchronize());
+		else
+			success = cpuROIToTensor(framesCPU, 2, rois.cpu<tensorROI>(), verifyROICount, output.cpu<uint8_t>(), params);
+
+		if( !success )
+		{
+			printf("  %-6s %u boxes %ux%u %s %s %zu-byte pixels  FAILED\n", name, verifyROICount, params.width, params.height, formats[format], layouts[layout], sizeof(T));
+			failures++;
+		}
+		else
+		{
+			const long mismatch = verifyCompare(&reference[0], output.cpu<uint8_t>(), outputSize, tensorFormatSize(format));
+
+			if( mismatch >= 0 )
+			{
+				const long elements = size / tensorFormatSize(format);
+
+				printf("  %-6s %u boxes %ux%u %s %s %zu-byte pixels  MISMATCH in box %ld at element %ld\n", name, verifyROICount, params.width, params.height,
+					  formats[format], layouts[layout], sizeof(T), mismatch / elements, mismatch % elements);
+				failures++;
+			}
+		}
+
+		checks++;
+	}
+
+	return failures;
+}
+
+
+// images of the normalization check: with a tail after the SIMD rows (and the per-pixel
+// kernel), and a multiple of 8 wide (the vector kernel), both with padded rows
+static const uint32_t verifyNormalizeSizes[][2] = { { 61, 37 }, { 64, 36 } };
+
+
+// tensorWriteRGB() per pixel, or tensorWriteRGB4() per 4 pixels (the vector kernel)
+template<typename T>
+struct verifyTensorPixels
+{
+	const tensorWriter& writer;
+	const ImageView<T>& input;
+	void* output;
+	bool  vector;
+
+	verifyTensorPixels( const tensorWriter& w, const ImageView<T>& in, void* out, bool vec ) : writer(w), input(in), output(out), vector(vec)	{ }
+
+	template<tensorFormat format, tensorLayout layout>
+	void run()
+	{
+		for( uint32_t y=0; y < writer.height; y++ )
+		{
+			for( uint32_t x=0; x < writer.width; x += (vector ? 4 : 1) )
+			{
+				if( vector )
+				{
+					tensorWriteRGB4<T, format, layout>(writer, input.Row(y) + x, output, x, y);
+				}
+				else
+				{
+					float r, g, b;
+					tensorPixelRGB(input(x, y), r, g, b);
+					tensorWriteRGB<format, layout>(writer, output, x, y, r, g, b);
+				}
+			}
+		}
+	}
+};
+
+
+// print a mismatch of the normalization, returns true if there was none
+static bool verifyNormalizeReport( const char* name, const uint32_t* size, size_t pixelSize, const tensorParams& params, long mismatch )
+{
+	static const char* formats[] = { "FP32", "FP16", "INT8" };
+	static const char* layouts[] = { "CHW", "HWC" };
+
+	if( mismatch < 0 )
+		return true;
+
+	printf("  %-6s %ux%u %zu-byte pixels to %s %s%s  MISMATCH at element %ld\n", name, size[0], size[1], pixelSize,
+		  formats[params.format], layouts[params.layout], params.bgr ? " BGR" : "", mismatch);
+
+	return false;
+}
+
+
+template<typename T>
+static int verifyNormalize( const uint32_t* size, tensorFormat format, tensorLayout layout, bool bgr, bool gpu, int& checks )
+{
+	const uint32_t width  = size[0];
+	const uint32_t height = size[1];
+	const size_t   pitch  = (width + 3) * sizeof(T);
+
+	// ImageNet normalization, with an asymmetric quantization that saturates at both ends
+	tensorParams params(width, height);
+
+	params.format = format;
+	params.layout = layout;
+	params.bgr    = bgr;
+	params.scale  = 1.0f / 255.0f;
+	params.mean   = make_float3(0.485f, 0.456f, 0.406f);
+	params.stdDev = make_float3(0.229f, 0.224f, 0.225f);
+	params.int8Scale     = 0.015f;
+	params.int8ZeroPoint = -5;
+
+	const size_t outputSize = tensorSize(params);
+
+	benchBuffer input(pitch * height, gpu);
+	benchBuffer output(outputSize, gpu);
+	benchBuffer block(outputSize);
+
+	if( (typename resizePixel<T>::scalar)0.5f != 0 )	// float pixels
+		input.fillFloat(pitch * height / sizeof(float));
+
+	const ImageView<T> inputCPU(input.cpu<T>(), width, height, pitch);
+	const ImageView<T> inputGPU(input.gpu<T>(), width, height, pitch);
+
+	// reference, tensorWriteRGB() per pixel
+	const tensorWriter writer = tensorWriterInit(params, width, height);
+	std::vector<uint8_t> reference(outputSize);
+
+	verifyTensorPixels<T> pixels(writer, inputCPU, &reference[0], false);
+	tensorDispatch(writer, pixels);
+
+	const size_t elementSize = tensorFormatSize(format);
+	int failures = 0;
+
+	// the vector kernel on the CPU, over its grid
+	if( (width % 4) == 0 )
+	{
+		memset(block.cpu<uint8_t>(), 0xCD, outputSize);
+
+		verifyTensorPixels<T> vector(writer, inputCPU, block.cpu<uint8_t>(), true);
+		tensorDispatch(writer, vector);
+
+		if( !verifyNormalizeReport("vector", size, sizeof(T), params, verifyCompare(&reference[0], block.cpu<uint8_t>(), outputSize, elementSize)) )
+			failures++;
+
+		checks++;
+	}
+
+	// CPU, with every instruction set that is supported
+	const cpuISA detected = cpuGetISA();
+
+	for( int isa=CPU_ISA_SCALAR; isa <= CPU_ISA_NEON; isa++ )
+	{
+		if( cpuSetISA((cpuISA)isa) != isa )
+			continue;
+
+		memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+
+		if( !cpuNormalizeRGBA(inputCPU, output.cpu<uint8_t>(), params) )
+		{
+			printf("  %-6s %ux%u %zu-byte pixels to tensor  FAILED\n", cpuISAName((cpuISA)isa), width, height, sizeof(T));
+			failures++;
+		}
+		else if( !verifyNormalizeReport(cpuISAName((cpuISA)isa), size, sizeof(T), params, verifyCompare(&reference[0], output.cpu<uint8_t>(), outputSize, elementSize)) )
+		{
+			failures++;
+		}
+
+		checks++;
+	}
+
+	cpuSetISA(detected);
+
+	// CUDA
+	if( gpu )
+	{
+		memset(output.cpu<uint8_t>(), 0xCD, outputSize);
+
+		if( CUDA_FAILED(cudaNormalizeRGBA(inputGPU, output.gpu<uint8_t>(), params)) || CUDA_FAILED(cudaDeviceSynchronize()) )
+		{
+			printf("  %-6s %ux%u %zu-byte pixels to tensor  FAILED\n", "CUDA", width, height, sizeof(T));
+			failures++;
+		}
+		else if( !verifyNormalizeReport("CUDA", size, sizeof(T), params, verifyCompare(&reference[0], output.cpu<uint8_t>(), outputSize, elementSize)) )
+		{
+			failures++;
+		}
+
+		checks++;
+	}
+
+	return failures;
+}
+
+
+// the range normalization, against out = (in - input.x) * (output.y - output.x) / (input.y - input.x) + output.x
+static int verifyNormalizeRange( bool gpu, int& checks )
+{
+	const uint32_t width  = verifyNormalizeSizes[0][0];
+	const uint32_t height = verifyNormalizeSizes[0][1];
+	const size_t   count  = width * height * 4;
+
+	const float2 inputRange  = make_float2(16.0f, 235.0f);
+	const float2 outputRange = make_float2(-1.0f, 1.0f);
+
+	benchBuffer input(count * sizeof(float), gpu);
+	benchBuffer output(count * sizeof(float), gpu);
+
+	input.fillFloat(count);
+
+	const float multiplier = (outputRange.y - outputRange.x) / (inputRange.y - inputRange.x);
+	std::vector<float> reference(count);
+
+	for( size_t n=0; n < count; n++ )
+		reference[n] = (input.cpu<float>()[n] - inputRange.x) * multiplier + outputRange.x;
+
+	int failures = 0;
+
+	for( int backend=0; backend < (gpu ? 2 : 1); backend++ )
+	{
+		const char* name = (backend == 1) ? "CUDA" : "CPU";
+		memset(output.cpu<uint8_t>(), 0xCD, count * sizeof(float));
+
+		bool success = false;
+
+		if( backend == 1 )
+			success = CUDA_SUCCESS(cudaNormalizeRGBA(input.gpu<float4>(), inputRange, output.gpu<float4>(), outputRange, width, height)) && CUDA_SUCCESS(cudaDeviceSynchronize());
+		else
+			success = cpuNormalizeRGBA(input.cpu<float4>(), inputRange, output.cpu<float4>(), outputRange, width, height);
+
+		if( !success )
+		{
+			printf("  %-6s %ux%u range (%g, %g) -> (%g, %g)  FAILED\n", name, width, height, inputRange.x, inputRange.y, outputRange.x, outputRange.y);
+			failures++;
+		}
+		else
+		{
+			const long mismatch = verifyCompare((const uint8_t*)&reference[0], output.cpu<uint8_t>(), count * sizeof(float), sizeof(float4));
+
+			if( mismatch >= 0 )
+			{
+				printf("  %-6s %ux%u range (%g, %g) -> (%g, %g)  MISMATCH at pixel (%ld, %ld)\n", name, width, height,
+					  inputRange.x, inputRange.y, outputRange.x, outputRange.y, mismatch % (long)width, mismatch / (long)width);
+				failures++;
+			}
+		}
+
+		checks++;
+	}
+
+	return failures;
+}
+
+
+// benchVerify
+int benchVerify()
+{
+	const bool gpu = benchHasGPU();
+	int failures = 0;
+
+	printf("jetson-bench -- verifying the YUV conversions against the per-pixel reference (%s)\n", gpu ? "CPU and CUDA" : "CPU only, no CUDA device");
+
+	for( size_t n=0; n < sizeof(verifyInputs) / sizeof(yuvFormat); n++ )
+	{
+		int checks = 0;
+		int inputFailures = 0;
+
+		switch(verifyInputs[n])
+		{
+			case YUV_NV12:	inputFailures = verifyInput<YUV_NV12>(gpu, checks); break;
+			case YUV_NV21:	inputFailures = verifyInput<YUV_NV21>(gpu, checks); break;
+			case YUV_I420:	inputFailures = verifyInput<YUV_I420>(gpu, checks); break;
+			case YUV_P010:	inputFailures = verifyInput<YUV_P010>(gpu, checks); break;
+		}
+
+		printf("  %-9s %4d checks  %s\n", yuvFormatToStr(verifyInputs[n]), checks, (inputFailures == 0) ? "OK" : "MISMATCH");
+		failures += inputFailures;
+	}
+
+	// RGB to NV12
+	int checks = 0;
+	int encodeFailures = 0;
+
+	for( size_t s=0; s < sizeof(verifySizes) / sizeof(verifySize); s++ )
+	{
+		for( size_t c=0; c < sizeof(verifyColorimetry) / sizeof(yuvColorimetry); c++ )
+		{
+			encodeFailures += verifyEncode<IMAGE_RGBA32F>(verifySizes[s], verifyColorimetry[c], gpu, checks);
+			encodeFailures += verifyEncode<IMAGE_RGBA8>(verifySizes[s], verifyColorimetry[c], gpu, checks);
+			encodeFailures += verifyEncode<IMAGE_RGB8>(verifySizes[s], verifyColorimetry[c], gpu, checks);
+			encodeFailures += verifyEncode<IMAGE_BGR8>(verifySizes[s], verifyColorimetry[c], gpu, checks);
+		}
+	}
+
+	printf("  %-9s %4d checks  %s\n", "to NV12", checks, (encodeFailures == 0) ? "OK" : "MISMATCH");
+	failures += encodeFailures;
+
+	// luma downscale, by 1, 2, 3 and 4 and to an odd size
+	int grayFailures = 0;
+	checks = 0;
+
+	for( size_t s=0; s < sizeof(verifySizes) / sizeof(verifySize); s++ )
+	{
+		const verifySize& size = verifySizes[s];
+
+		const size_t outputSizes[][2] = { { size.width, size.height }, { (size.width + 1) / 2, (size.height + 1) / 2 },
+								    { (size.width + 2) / 3, (size.height + 2) / 3 }, { (size.width + 3) / 4, (size.height + 3) / 4 }, { 13, 7 } };
+
+		for( size_t n=0; n < sizeof(outputSizes) / sizeof(outputSizes[0]); n++ )
+		{
+			grayFailures += verifyGray<YUV_NV12, uint8_t>(size, outputSizes[n][0], outputSizes[n][1], gpu, checks);
+			grayFailures += verifyGray<YUV_NV12, float>(size, outputSizes[n][0], outputSizes[n][1], gpu, checks);
+			grayFailures += verifyGray<YUV_P010, uint8_t>(size, outputSizes[n][0], outputSizes[n][1], gpu, checks);
+			grayFailures += verifyGray<YUV_P010, float>(size, outputSizes[n][0], outputSizes[n][1], gpu, checks);
+		}
+	}
+
+	printf("  %-9s %4d checks  %s\n", "to gray", checks, (grayFailures == 0) ? "OK" : "MISMATCH");
+	failures += grayFailures;
+
+	// batched conversion, with ROIs and resize
+	int batchFailures = 0;
+	checks = 0;
+
+	batchFailures += verifyBatch<YUV_NV12>(gpu, checks);
+	batchFailures += verifyBatch<YUV_NV21>(gpu, checks);
+	batchFailures += verifyBatch<YUV_I420>(gpu, checks);
+	batchFailures += verifyBatch<YUV_P010>(gpu, checks);
+
+	printf("  %-9s %4d checks  %s\n", "batch", checks, (batchFailures == 0) ? "OK" : "MISMATCH");
+	failures += batchFailures;
+
+	// several outputs from one pass over the frame
+	int profileFailures = 0;
+	checks = 0;
+
+	profileFailures += verifyProfilesInput<YUV_NV12>(gpu, checks);
+	profileFailures += verifyProfilesInput<YUV_NV21>(gpu, checks);
+	profileFailures += verifyProfilesInput<YUV_I420>(gpu, checks);
+	profileFailures += verifyProfilesInput<YUV_P010>(gpu, checks);
+
+	printf("  %-9s %4d checks  %s\n", "profiles", checks, (profileFailures == 0) ? "OK" : "MISMATCH");
+	failures += profileFailures;
+
+	// resize, normalize and overlay on pitched views
+	checks = 0;
+	const int viewFailures = verifyViews(gpu, checks);
+
+	printf("  %-9s %4d checks  %s\n", "views", checks, (viewFailures == 0) ? "OK" : "MISMATCH");
+	failures += viewFailures;
+
+	// bilinear and area resize
+	int resizeFailures = 0;
+	checks = 0;
+
+	for( size_t s=0; s < sizeof(verifyResizeSizes) / sizeof(verifyResizeSizes[0]); s++ )
+	{
+		for( int f=RESIZE_BILINEAR; f <= RESIZE_AREA; f++ )
+		{
+			resizeFailures += verifyResize<uint8_t>(verifyResizeSizes[s], (resizeFilter)f, gpu, checks);
+			resizeFailures += verifyResize<uchar4>(verifyResizeSizes[s], (resizeFilter)f, gpu, checks);
+			resizeFailures += verifyResize<float>(verifyResizeSizes[s], (resizeFilter)f, gpu, checks);
+			resizeFailures += verifyResize<float4>(verifyResizeSizes[s], (resizeFilter)f, gpu, checks);
+		}
+	}
+
+	printf("  %-9s %4d checks  %s\n", "resize", checks, (resizeFailures == 0) ? "OK" : "MISMATCH");
+	failures += resizeFailures;
+
+	// letterbox
+	int letterboxFailures = 0;
+	checks = 0;
+
+	for( size_t s=0; s < sizeof(verifyLetterboxSizes) / sizeof(verifyLetterboxSizes[0]); s++ )
+	{
+		for( int f=RESIZE_NEAREST; f <= RESIZE_AREA; f++ )
+		{
+			if( f == RESIZE_AREA && verifyLetterboxSizes[s][2] > verifyLetterboxSizes[s][0] )
+				continue;	// area is for downscaling
+
+			letterboxFailures += verifyLetterbox<uchar4>(verifyLetterboxSizes[s], (resizeFilter)f, make_uchar4(114, 114, 114, 255), gpu, checks);
+			letterboxFailures += verifyLetterbox<float4>(verifyLetterboxSizes[s], (resizeFilter)f, make_float4(114.0f, 114.0f, 114.0f, 255.0f), gpu, checks);
+		}
+	}
+
+	printf("  %-9s %4d checks  %s\n", "letterbox", checks, (letterboxFailures == 0) ? "OK" : "MISMATCH");
+	failures += letterboxFailures;
+
+	// mosaic
+	int mosaicFailures = 0;
+	checks = 0;
+
+	for( int f=RESIZE_NEAREST; f <= RESIZE_AREA; f++ )
+	{
+		for( int nv12=0; nv12 < 2; nv12++ )
+		{
+			mosaicFailures += verifyMosaic<uchar4, IMAGE_RGBA8>(verifyMosaicSizes[nv12], nv12, (resizeFilter)f, gpu, checks);
+			mosaicFailures += verifyMosaic<float4, IMAGE_RGBA32F>(verifyMosaicSizes[nv12], nv12, (resizeFilter)f, gpu, checks);
+		}
+	}
+
+	printf("  %-9s %4d checks  %s\n", "mosaic", checks, (mosaicFailures == 0) ? "OK" : "MISMATCH");
+	failures += mosaicFailures;
+
+	// batched ROI crops
+	int roiFailures = 0;
+	checks = 0;
+
+	for( int f=TENSOR_FORMAT_FP32; f <= TENSOR_FORMAT_INT8; f++ )
+	{
+		for( int l=TENSOR_LAYOUT_CHW; l <= TENSOR_LAYOUT_HWC; l++ )
+		{
+			roiFailures += verifyROI<uchar4>((tensorFormat)f, (tensorLayout)l, gpu, checks);
+			roiFailures += verifyROI<float4>((tensorFormat)f, (tensorLayout)l, gpu, checks);
+		}
+	}
+
+	printf("  %-9s %4d checks  %s\n", "ROI crops", checks, (roiFailures == 0) ? "OK" : "MISMATCH");
+	failures += roiFailures;
+
+	// normalization into tensors
+	int normalizeFailures = 0;
+	checks = 0;
+
+	for( int s=0; s < 2; s++ )
+	{
+		for( int f=TENSOR_FORMAT_FP32; f <= TENSOR_FORMAT_INT8; f++ )
+		{
+			for( int l=TENSOR_LAYOUT_CHW; l <= TENSOR_LAYOUT_HWC; l++ )
+			{
+				normalizeFailures += verifyNormalize<uchar4>(verifyNormalizeSizes[s], (tensorFormat)f, (tensorLayout)l, s == 1, gpu, checks);
+				normalizeFailures += verifyNormalize<float4>(verifyNormalizeSizes[s], (tensorFormat)f, (tensorLayout)l, s == 1, gpu, checks);
+			}
+		}
+	}
+
+	normalizeFailures += verifyNormalizeRange(gpu, checks);
+
+	printf("  %-9s %4d checks  %s\n", "normalize", checks, (normalizeFailures == 0) ? "OK" : "MISMATCH");
+	failures += normalizeFailures;
+
+	printf("jetson-bench -- %s (%d failures)\n", (failures == 0) ? "all conversions are bit-exact" : "verification FAILED", failures);
+	return (failures == 0) ? 0 : 1;
+}
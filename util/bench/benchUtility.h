@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+ 
+#ifndef __BENCH_UTILITY_H_
+#define __BENCH_UTILITY_H_
+
+
+#include <benchmark/benchmark.h>
+
+#include "cudaMappedMemory.h"
+
+#include <stdlib.h>
+
+
+/**
+ * Register the benchmark at 720p, 1080p and 4K.
+ * @ingroup util
+ */
+#define BENCH_RESOLUTIONS(func)	\
+	BENCHMARK(func)->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160})->Unit(benchmark::kMicrosecond)
+
+
+/**
+ * Register a CUDA benchmark, timed by wallclock since the kernels run asynchronously.
+ * @ingroup util
+ */
+#define BENCH_RESOLUTIONS_CUDA(func)	\
+	BENCH_RESOLUTIONS(func)->UseRealTime()
+
+
+/**
+ * Returns true if a CUDA device is present.
+ * @ingroup util
+ */
+inline bool benchHasGPU()
+{
+	int devices = 0;
+
+	if( cudaGetDeviceCount(&devices) != cudaSuccess )
+		return false;
+
+	return devices > 0;
+}
+
+
+/**
+ * Skip the benchmark if there is no CUDA device.
+ * @ingroup util
+ */
+#define BENCH_REQUIRE_GPU(state)							\
+	if( !benchHasGPU() )									\
+	{														\
+		state.SkipWithError("no CUDA device available");	\
+		return;												\
+	}
+
+
+/**
+ * Report throughput given the bytes read and written per frame.
+ * Shown as GB=<x>/s (decimal gigabytes) and frame=<time>, the time per frame
+ * (in seconds in the JSON output, so multiply by 1e9 for ns/frame).
+ * @ingroup util
+ */
+inline void benchReport( benchmark::State& state, size_t bytesPerFrame )
+{
+	const double frames = state.iterations();
+
+	state.counters["GB"]    = benchmark::Counter(frames * bytesPerFrame * 1e-9, benchmark::Counter::kIsRate);
+	state.counters["frame"] = benchmark::Counter(frames, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+
+/**
+ * Run the bit-exactness checks of jetson-bench --verify (bench-verify.cpp).
+ * Returns 0 if all the conversions match.
+ * @ingroup util
+ */
+int benchVerify();
+
+
+/**
+ * Buffer used by a benchmark, either system memory (CPU reference)
+ * or shared CPU/GPU memory from cudaAllocMapped() (CUDA).
+ * @ingroup util
+ */
+class benchBuffer
+{
+public:
+	benchBuffer( size_t size, bool mapped=false ) : mCPU(NULL), mGPU(NULL), mMapped(mapped)
+	{
+		if( mapped )
+		{
+			if( !cudaAllocMapped(&mCPU, &mGPU, size) )
+				mCPU = mGPU = NULL;
+		}
+		else if( posix_memalign(&mCPU, 64, size) == 0 )
+		{
+			mGPU = mCPU;
+		}
+
+		if( mCPU != NULL )
+		{
+			// deterministic pattern, so that conversions don't see all-zero input
+			for( size_t n=0; n < size; n++ )
+				((uint8_t*)mCPU)[n] = (n * 7 + (n >> 11)) & 0xFF;
+		}
+	}
+
+	~benchBuffer()
+	{
+		if( mMapped && mCPU != NULL )
+			cudaFreeHost(mCPU);
+		else
+			free(mCPU);
+	}
+
+	// overwrite with floats in [0,255], random bytes would contain NaNs and denormals
+	void fillFloat( size_t count )
+	{
+		for( size_t n=0; n < count; n++ )
+			((float*)mCPU)[n] = float((n * 7 + (n >> 11)) & 0xFF);
+	}
+
+	template<typename T> inline T* cpu() const	{ return (T*)mCPU; }
+	template<typename T> inline T* gpu() const	{ return (T*)mGPU; }
+
+private:
+	benchBuffer( const benchBuffer& );
+	benchBuffer& operator=( const benchBuffer& );
+
+	void* mCPU;
+	void* mGPU;
+	bool  mMapped;
+};
+
+
+#endif
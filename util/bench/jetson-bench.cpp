@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "benchUtility.h"
+
+#include <string.h>
+
+
+/*
+ * jetson-bench
+ *
+ *   ./jetson-bench                              run everything (CUDA benchmarks are skipped without a GPU)
+ *   ./jetson-bench --benchmark_filter=NV12      run a subset
+ *   ./jetson-bench --benchmark_format=json      machine-readable baseline
+ *   ./jetson-bench --verify                     check the kernels for bit-exactness instead (see bench-verify.cpp)
+ *
+ * Each benchmark reports GB/s (bytes read + written per frame) and the time
+ * per frame, at 1280x720, 1920x1080 and 3840x2160.
+ */
+int main( int argc, char** argv )
+{
+	for( int i=1; i < argc; i++ )
+	{
+		if( strcmp(argv[i], "--verify") == 0 )
+			return benchVerify();
+	}
+
+	benchmark::Initialize(&argc, argv);
+
+	if( benchmark::ReportUnrecognizedArguments(argc, argv) )
+		return 1;
+
+	benchmark::RunSpecifiedBenchmarks();
+	return 0;
+}
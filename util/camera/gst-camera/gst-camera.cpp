@@ -9,15 +9,17 @@
 #include <unistd.h>
 #include "loadImage.h"
 #include "cudaNormalize.h"
+#include "cpuYUV.h"
+#include "trace.h"
 #include "opencv2/opencv.hpp"
 #include "opencv2/highgui/highgui.hpp"
 using namespace cv;
 bool signal_recieved = false;
-Mat nv12tomat(unsigned char*yuvdata,unsigned int width,unsigned int height)
+Mat yuvtomat(unsigned char*yuvdata,yuvFormat format,unsigned int width,unsigned int height)
 {
-	Mat nv12_img=Mat(height*3/2,width,CV_8UC1,yuvdata);
-	Mat rgb_img;
-	cvtColor(nv12_img,rgb_img,CV_YUV2BGR_NV12);
+	// SIMD conversion of the decoder's YUV format, same colors as cudaYUVToFormat()
+	Mat rgb_img(height,width,CV_8UC3);
+	cpuYUVToFormat(yuvdata,yuvFormatPitch(format,width),format,rgb_img.data,rgb_img.step,width,height,IMAGE_BGR8);
 	return rgb_img;
 }
 void sig_handler(int signo)
@@ -87,9 +89,12 @@ int main( int argc, char** argv )
 		//Mat img(1280,720,CV_8U,imgCPU);
 		
 		//nv12tomat((unsigned char *)imgCPU,m_Width,m_Height
+		gstCamera::frameInfo info;
+		if(!camera->GetFrameInfo(imgCPU,&info))
+			continue;
 		namedWindow("outimg",CV_WINDOW_AUTOSIZE);
 		double now=gettimeofday(&tvs,NULL);
-		Mat img=nv12tomat((unsigned char *)imgCPU,m_Width,m_Height);
+		Mat img=yuvtomat((unsigned char *)imgCPU,info.format,info.width,info.height);
 		gettimeofday(&tve,NULL);
         double span = tve.tv_sec-tvs.tv_sec + (tve.tv_usec-tvs.tv_usec)/1000000.0;
 		printf("gettimeofday time: %.12f\n",span);
@@ -99,6 +104,10 @@ int main( int argc, char** argv )
 		//printf("img width=%d\n",img.rows);
 		//imwrite("1.bmp",img);
 	}
+#ifdef ENABLE_TRACE
+	traceDump("gst-camera-trace.json");
+#endif
+
 	//shutdown the camera device
 	if( camera != NULL )
 	{
@@ -25,11 +25,18 @@
 
 #include <gst/gst.h>
 #include <string>
+#include <vector>
+
+#include "imageFormat.h"
+#include "cudaYUV.h"
+#include "gstRingbuffer.h"
 
 
 struct _GstAppSink;//声明结构体和类
 class QWaitCondition;
 class QMutex;
+class gstStats;
+class imageOps;
 /*** gstreamer CSI camera using nvcamerasrc (or optionally v4l2src)
  * @ingroup util
  */
@@ -47,27 +54,147 @@ public:
 	bool Open();
 	void Close();
 	
-	// 采集YUV(NV12格式)
+	// 采集YUV(按cudaColorspace.h中的紧凑平面布局, 格式和大小见GetFrameInfo())
 	bool Capture( void** cpu, void** cuda, unsigned long timeout=ULONG_MAX );
 	
-	// 抓取YUV-NV12 CUDA image, 转换成 float4 RGBA (像素范围在 0-255)
-	// 转换如果在CPU上进行，设置zeroCopy=true,默认只在CUDA上.
-	bool ConvertRGBA( void* input, void** output, bool zeroCopy=false );
+	// 帧的格式, 从解码该帧时的caps获取, 见gstRingbuffer.h
+	typedef gstRingbuffer::frameInfo frameInfo;
+	
+	// Capture()或Peek()返回的帧(CPU或CUDA指针)的格式和序号, caps中途改变时每帧仍按自己的格式
+	// 不是环形缓冲区中的帧, 或该帧已经被覆盖时返回false
+	bool GetFrameInfo( const void* frame, frameInfo* info, uint64_t* sequence=NULL );
+	
+	// Y(亮度)平面的视图, 无转换, 指向环形缓冲区中的帧
+	// 8位格式每个样本为uint8_t, P010为uint16_t(10位在高位), 行间距为stride字节
+	struct lumaView
+	{
+		uint8_t* cpu;		// Y plane, CPU pointer
+		uint8_t* cuda;		// Y plane, device pointer (for the GetImageOps() backend)
+		uint32_t width;
+		uint32_t height;
+		size_t   stride;	// bytes between rows
+		uint32_t depth;		// bits per sample:  8, or 16 for P010
+	};
+	
+	// 采集一帧, 只返回Y平面的视图(运动检测等灰度分析用), 有效期同Capture()
+	bool Capture( lumaView* luma, unsigned long timeout=ULONG_MAX );
+	
+	// 缩小的灰度图(面积平均, 只读取Y平面), uint8为[0,255], float为[0,1]
+	// output需要能被GetImageOps()的后端访问, 大小为 width*height*sizeof(T)
+	bool ConvertLuma( const lumaView& luma, uint8_t* output, uint32_t width, uint32_t height, cudaStream_t stream=NULL );
+	bool ConvertLuma( const lumaView& luma, float* output, uint32_t width, uint32_t height, cudaStream_t stream=NULL );
+	
+	// 取最新一帧YUV(不等待, 也不标记为已读取), 供快照等旁路使用, sequence返回帧序号
+	bool Peek( void** cpu, void** cuda, uint64_t* sequence );
+	
+	// 在环形缓冲区锁内复制出序号为sequence的YUV帧和它的格式, 之后可以慢慢处理而不会被新帧覆盖
+	// 该帧已经被覆盖时返回false
+	bool CopyFrame( uint64_t sequence, std::vector<uint8_t>& yuv, frameInfo* info=NULL );
+	
+	// 抓取YUV CUDA image, 转换成SetConvertFormat()设置的格式(默认float4 RGBA, 像素范围在 0-255)
+	// 结果在一个小的环形缓冲区中, 在之后的GetConvertBuffers()次调用中有效
+	// 转换如果在CPU上进行，设置zeroCopy=true,默认只在CUDA上. zeroCopy改变时重新分配缓冲区
+	// 转换在stream上异步进行(NULL为默认流), 读取结果前需要GetImageOps()->Synchronize(stream)
+	bool ConvertRGBA( void* input, void** output, bool zeroCopy=false, cudaStream_t stream=NULL );
+	
+	// 转换到调用者提供的缓冲区(需要能被GetImageOps()的后端访问), 大小为 width*height*imageFormatSize(format)
+	// 宽高和YUV格式为input这一帧的(见GetFrameInfo()), input不在环形缓冲区中时为最新一帧的
+	bool Convert( void* input, void* output, imageFormat format, cudaStream_t stream=NULL );
+	
+	// 设置ConvertRGBA()的输出格式和环形缓冲区数量(1 ~ MaxConvertBuffers), 已分配的缓冲区会被释放
+	// 例如IMAGE_RGBA8 + 2个缓冲区, 1080p只需16MB, 而不是float4的16 x 33MB
+	// 不影响ConvertProfiles()的缓冲区, 它们的数量由SetProfiles()设置
+	bool SetConvertFormat( imageFormat format, uint32_t numBuffers=DefaultConvertBuffers );
+	
+	inline imageFormat GetConvertFormat() const  { return mRGBAFormat; }
+	inline uint32_t GetConvertBuffers() const    { return mRGBACount; }
+	
+	// 多输出配置: 一路解码同时供给多个使用者(检测器输入, 分类裁剪, 预览, 全分辨率快照)
+	// 宽高为0表示摄像机的分辨率, 缩放为最近邻(同cudaResizeRGBA)
+	struct outputProfile
+	{
+		uint32_t    width;
+		uint32_t    height;
+		imageFormat format;
+		imageLayout layout;	// IMAGE_INTERLEAVED或IMAGE_PLANAR(每个通道一个平面)
+	};
+	
+	static const uint32_t MaxProfiles = YUV_PROFILES_MAX;
+	
+	// 一帧的所有输出, 顺序同SetProfiles(), profiles中为实际大小
+	struct frameBundle
+	{
+		uint64_t      sequence;		// input这一帧的序号, 同frameTiming::sequence (input不在环形缓冲区中时为0)
+		uint32_t      count;
+		void*         images[MaxProfiles];
+		outputProfile profiles[MaxProfiles];
+	};
+	
+	// 设置ConvertProfiles()的输出(1 ~ MaxProfiles个)和bundle环形缓冲区的数量(1 ~ MaxConvertBuffers)
+	// 已分配的缓冲区会被释放
+	bool SetProfiles( const outputProfile* profiles, uint32_t count, uint32_t numBuffers=DefaultConvertBuffers );
+	inline uint32_t GetProfileCount() const    { return mProfileCount; }
+	inline uint32_t GetProfileBuffers() const  { return mProfileBufferCount; }
+	
+	// 把Capture()得到的YUV帧一次转换成所有输出(cudaYUVToProfiles, 每个源像素只读取一次), 只支持YUV摄像机
+	// 输出在一个环形缓冲区中, 在之后的GetProfileBuffers()次调用中有效, zeroCopy和stream同ConvertRGBA()
+	bool ConvertProfiles( void* input, frameBundle* bundle, bool zeroCopy=false, cudaStream_t stream=NULL );
+	
+	// 图像处理后端(CUDA或CPU, 见imageOps.h), 默认为imageOps::Get()
+	// 决定ringbuffer的分配方式, 必须在收到第一帧之前设置
+	bool SetImageOps( imageOps* ops );
+	inline imageOps* GetImageOps() const  { return mOps; }
 	
-	// 图像大小信息 inline(内联函数，适合简单的函数)
+	// NV12的色彩空间(BT.601/709/2020矩阵和limited/full范围), 默认从caps的colorimetry获取
+	// caps没有colorimetry时按GStreamer的默认值: 高度>576为BT.709, 否则BT.601, limited range
+	// SetColorimetry()覆盖caps中的值(用于colorimetry标记错误的摄像机), 从之后解码的帧开始生效
+	// 每帧按解码时的colorimetry转换(见frameInfo), GetColorimetry()返回最新一帧的
+	void SetColorimetry( const yuvColorimetry& colorimetry );
+	yuvColorimetry GetColorimetry() const;
+	
+	// 图像大小信息 inline(内联函数，适合简单的函数), 为最新发布的一帧的, 某一帧的见GetFrameInfo()
 	inline uint32_t GetWidth() const	  { return mWidth; }
 	inline uint32_t GetHeight() const	  { return mHeight; }
 	inline uint32_t GetPixelDepth() const { return mDepth; }
 	inline uint32_t GetSize() const		  { return mSize; }
 	
+	// 流编号(创建时分配, 每个camera唯一)
+	inline uint32_t GetStreamID() const	  { return mStreamID; }
+	
+	// 是否为YUV格式(onboard/rtsp解码), 否则为RGB
+	inline bool IsYUV() const			  { return onboardCamera(); }
+	inline bool IsNV12() const			  { return onboardCamera() && mYUVFormat == YUV_NV12; }
+	
+	// 解码器输出的YUV格式(NV12, NV21, I420或P010), 从caps获取, 无需videoconvert
+	inline yuvFormat GetYUVFormat() const { return mYUVFormat; }
+	
+	// 运行统计(帧率, 延迟, 丢帧等), 见gstStats.h
+	inline gstStats* GetStats() const	  { return mStats; }
+	
+	// 帧的时间信息, CLOCK_REALTIME纳秒 (0表示未知), 见gstRingbuffer.h
+	typedef gstRingbuffer::frameTiming frameTiming;
+	
+	// 最近一次Capture()返回的帧的时间信息
+	bool GetFrameTiming( frameTiming* timing );
+	
+	// 使用摄像机SEI时间戳(H.264或H.265): user_data_unregistered SEI, 以该UUID开头, 后跟64位NTP时间
+	void SetTimestampSEI( const uint8_t uuid[16] );
+	
 	// 默认图像大小，可以在create时改变
 	static const uint32_t DefaultWidth  = 1280;
 	static const uint32_t DefaultHeight = 720;
 	
+	// ConvertRGBA()环形缓冲区的默认/最大数量
+	static const uint32_t DefaultConvertBuffers = 4;
+	static const uint32_t MaxConvertBuffers     = 16;
+	
 private:
 	static void onEOS(_GstAppSink* sink, void* user_data);
 	static GstFlowReturn onPreroll(_GstAppSink* sink, void* user_data);//GstFlowReturn 传递流
 	static GstFlowReturn onBuffer(_GstAppSink* sink, void* user_data);
+	static void onNewManager(_GstElement* src, _GstElement* manager, void* user_data);
+	static void onNewJitterBuffer(_GstElement* rtpbin, _GstElement* jitterbuffer, uint32_t session, uint32_t ssrc, void* user_data);
+	static GstPadProbeReturn onDecoderInput(_GstPad* pad, GstPadProbeInfo* info, void* user_data);
 
 	gstCamera();
 	
@@ -75,6 +202,15 @@ private:
 	bool buildLaunchStr();
 	void checkMsgBus();
 	void checkBuffer();
+	void checkJitterBuffer();
+	yuvColorimetry checkColorimetry( _GstCaps* caps, int width, int height );
+	bool capture( gstRingbuffer::frame* frame, unsigned long timeout );
+	void lookupFrame( const void* input, frameInfo* info, uint64_t* sequence=NULL );
+	bool convert( void* input, const frameInfo& info, void* output, imageFormat format, cudaStream_t stream );
+	void freeRGBA();
+	void freeProfiles();
+	bool allocBuffers( void** buffers, uint32_t count, size_t size, bool mapped, const char* name );
+	void freeBuffers( void** buffers, uint32_t count, bool mapped );
 	//GstBus
 	_GstBus*     mBus;//GstBus 异步同步消息
 	_GstAppSink* mAppSink;
@@ -86,23 +222,59 @@ private:
 	uint32_t mDepth;
 	uint32_t mSize;
 	
-	static const uint32_t NUM_RINGBUFFERS = 16;//环形队列来解决数据阻塞问题
+	gstRingbuffer* mRing;	//环形队列来解决数据阻塞问题
+	
+	// decoder input times, matched to the decoder output by PTS
+	struct decoderEntry
+	{
+		uint64_t pts;
+		uint64_t time;
+		uint64_t capture;
+	};
 	
-	void* mRingbufferCPU[NUM_RINGBUFFERS];
-	void* mRingbufferGPU[NUM_RINGBUFFERS];
+	static const uint32_t NUM_DECODER_ENTRIES = 64;
+	
+	decoderEntry mDecoderEntries[NUM_DECODER_ENTRIES];
+	uint32_t     mDecoderNext;
+	QMutex*      mTimingMutex;
+	_GstCaps*    mNtpCaps;
+	uint8_t      mTimestampUUID[16];
+	bool         mTimestampSEI;
 	
-	QWaitCondition* mWaitEvent;
 	//mutex.lock() //锁住互斥量（mutex）。如果互斥量是解锁的，那么当前线程就立即占用并锁定它。否则，当前线程就会被阻塞，知道掌握这个互斥量的线程对它解锁为止。
 	//mutex.unlock()//解锁
 	//mutex.tryLock()//尝试解锁，如果该互斥量已经锁住，它就会立即返回
-	QMutex* mWaitMutex;
 	QMutex* mRingMutex;
 	
 	uint32_t mLatestRGBA;
-	uint32_t mLatestRingbuffer;
-	bool     mLatestRetrieved;
+	uint32_t mStreamID;
+	bool     mOpened;
+	
+	gstStats*    mStats;
+	_GstElement* mJitterBuffer;
+	uint64_t     mJitterPollTime;
+	
+	void*       mRGBA[MaxConvertBuffers];
+	imageFormat mRGBAFormat;
+	uint32_t    mRGBACount;
+	size_t      mRGBASize;
+	bool        mRGBAMapped;	// allocated with mOps->Alloc(), otherwise cudaMalloc()
+	
+	outputProfile mProfiles[MaxProfiles];
+	uint32_t      mProfileCount;
+	void*         mProfileBuffers[MaxConvertBuffers];	// the outputs of a bundle, one after the other
+	uint32_t      mProfileBufferCount;
+	size_t        mProfileSize;
+	bool          mProfileMapped;
+	uint32_t      mLatestProfile;
+	
+	imageOps*   mOps;
+	
+	yuvColorimetry mColorimetry;			// guarded by mRingMutex, with mColorimetryOverride
+	bool           mColorimetryOverride;
+	_GstCaps*      mColorimetryCaps;	// caps that mColorimetry was parsed from (streaming thread only)
+	yuvFormat      mYUVFormat;
 	
-	void* mRGBA[NUM_RINGBUFFERS];
 	int   mV4L2Device;	// -1 for onboard, >=0 for V4L2 device
 	
 	inline bool onboardCamera() const		{ return (mV4L2Device < 0); }
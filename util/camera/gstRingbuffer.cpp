@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+ 
+
+#include "gstRingbuffer.h"
+#include "gstStats.h"
+#include "imageOps.h"
+#include "logging.h"
+
+#include <string.h>
+
+#include <QMutex>
+#include <QWaitCondition>
+
+
+// constructor
+gstRingbuffer::gstRingbuffer( imageOps* ops )
+{
+	mOps        = ops;
+	mSlotSize   = 0;
+	mLatest     = 0;
+	mRetrieved  = false;
+	mFrameCount = 0;
+
+	mMutex     = new QMutex();
+	mWaitMutex = new QMutex();
+	mWaitEvent = new QWaitCondition();
+
+	memset(mSlots, 0, sizeof(mSlots));
+	memset(&mDelivered, 0, sizeof(frameTiming));
+}
+
+
+// destructor
+gstRingbuffer::~gstRingbuffer()
+{
+	for( uint32_t n=0; n < NumSlots; n++ )
+	{
+		if( mSlots[n].cpu != NULL )
+			mOps->Free(mSlots[n].cpu);
+	}
+
+	delete mWaitEvent;
+	delete mWaitMutex;
+	delete mMutex;
+}
+
+
+// SetImageOps
+bool gstRingbuffer::SetImageOps( imageOps* ops )
+{
+	if( !ops || IsAllocated() )
+		return false;
+
+	mOps = ops;
+	return true;
+}
+
+
+// Next
+void* gstRingbuffer::Next( size_t size )
+{
+	if( !IsAllocated() )
+	{
+		for( uint32_t n=0; n < NumSlots; n++ )
+		{
+			if( !mOps->Alloc(&mSlots[n].cpu, &mSlots[n].cuda, size) )
+			{
+				LogError(LOG_CATEGORY_GSTREAMER, LOG_CUDA "gstreamer camera -- failed to allocate ringbuffer %u  (size=%zu)\n", n, size);
+
+				// free the slots allocated so far, so the next frame tries again
+				for( uint32_t m=0; m < n; m++ )
+				{
+					mOps->Free(mSlots[m].cpu);
+					mSlots[m].cpu  = NULL;
+					mSlots[m].cuda = NULL;
+				}
+
+				mSlots[n].cpu  = NULL;
+				mSlots[n].cuda = NULL;
+				return NULL;
+			}
+
+			mSlots[n].capacity = size;
+		}
+
+		mSlotSize = size;
+		LogInfo(LOG_CATEGORY_GSTREAMER, LOG_CUDA "gstreamer camera -- allocated %u ringbuffers, %zu bytes each\n", NumSlots, size);
+	}
+	else if( size > mSlotSize )
+	{
+		// the caps changed to larger frames, each slot grows when it is reused
+		LogInfo(LOG_CATEGORY_GSTREAMER, LOG_CUDA "gstreamer camera -- frames grew from %zu to %zu bytes, reallocating the ringbuffers\n", mSlotSize, size);
+		mSlotSize = size;
+	}
+
+	slot& s = mSlots[(mLatest + 1) % NumSlots];
+
+	if( s.capacity < size )
+	{
+		void* cpu  = NULL;
+		void* cuda = NULL;
+
+		if( !mOps->Alloc(&cpu, &cuda, size) )
+		{
+			LogError(LOG_CATEGORY_GSTREAMER, LOG_CUDA "gstreamer camera -- failed to reallocate ringbuffer %u  (size=%zu)\n", (mLatest + 1) % NumSlots, size);
+			return NULL;
+		}
+
+		// the slot holds the oldest frame, which Find() and Copy() no longer return,
+		// but they walk the slots under the lock
+		void* prev = s.cpu;
+
+		mMutex->lock();
+
+		s.cpu      = cpu;
+		s.cuda     = cuda;
+		s.capacity = size;
+		s.size     = 0;
+
+		memset(&s.timing, 0, sizeof(frameTiming));
+		mMutex->unlock();
+
+		mOps->Free(prev);
+	}
+
+	return s.cpu;
+}
+
+
+// Publish
+bool gstRingbuffer::Publish( size_t size, const frameInfo& info, frameTiming& timing, uint64_t timestamp )
+{
+	const uint32_t next = (mLatest + 1) % NumSlots;
+
+	mMutex->lock();
+
+	const bool overwrote = !mRetrieved && (mFrameCount > 0);
+
+	mFrameCount++;
+	timing.sequence = mFrameCount;
+
+	mSlots[next].size      = size;
+	mSlots[next].timestamp = timestamp;
+	mSlots[next].info      = info;
+	mSlots[next].timing    = timing;
+
+	mLatest    = next;
+	mRetrieved = false;
+
+	mMutex->unlock();
+
+	mWaitEvent->wakeAll();
+	return overwrote;
+}
+
+
+// getFrame
+void gstRingbuffer::getFrame( uint32_t index, frame* f ) const
+{
+	const slot& s = mSlots[index];
+
+	f->cpu       = s.cpu;
+	f->cuda      = s.cuda;
+	f->size      = s.size;
+	f->sequence  = s.timing.sequence;
+	f->timestamp = s.timestamp;
+	f->info      = s.info;
+	f->timing    = s.timing;
+}
+
+
+// isValid
+bool gstRingbuffer::isValid( uint32_t index ) const
+{
+	// the producer may already be writing the slot after the latest one, which held
+	// frame (mFrameCount - NumSlots + 1).  While the lock is held it can't publish,
+	// so it can't move on to any of the other slots.
+	const uint64_t sequence = mSlots[index].timing.sequence;
+
+	return (sequence > 0) && (mFrameCount - sequence < NumSlots - 1);
+}
+
+
+// Consume
+bool gstRingbuffer::Consume( frame* f, unsigned long timeout )
+{
+	if( !f )
+		return false;
+
+	mWaitMutex->lock();
+	const bool signaled = mWaitEvent->wait(mWaitMutex, timeout);
+	mWaitMutex->unlock();
+
+	if( !signaled )
+		return false;
+
+	mMutex->lock();
+
+	// skip if it was already retrieved
+	const bool retrieved = mRetrieved;
+
+	if( !retrieved )
+	{
+		getFrame(mLatest, f);
+
+		f->timing.delivered = gstStats::WallTime();
+		mDelivered = f->timing;
+		mRetrieved = true;
+	}
+
+	mMutex->unlock();
+	return !retrieved;
+}
+
+
+// Peek
+bool gstRingbuffer::Peek( frame* f )
+{
+	if( !f )
+		return false;
+
+	mMutex->lock();
+
+	// nothing has been published yet
+	const bool valid = (mFrameCount > 0);
+
+	if( valid )
+		getFrame(mLatest, f);
+
+	mMutex->unlock();
+	return valid;
+}
+
+
+// Find
+bool gstRingbuffer::Find( const void* ptr, frame* f )
+{
+	if( !ptr || !f )
+		return false;
+
+	bool found = false;
+
+	mMutex->lock();
+
+	for( uint32_t n=0; n < NumSlots && !found; n++ )
+	{
+		if( (mSlots[n].cpu == ptr || mSlots[n].cuda == ptr) && isValid(n) )
+		{
+			getFrame(n, f);
+			found = true;
+		}
+	}
+
+	mMutex->unlock();
+	return found;
+}
+
+
+// Copy
+bool gstRingbuffer::Copy( uint64_t sequence, std::vector<uint8_t>& data, frameInfo* info )
+{
+	mMutex->lock();
+
+	const uint64_t age   = mFrameCount - sequence;
+	const uint32_t index = (mLatest + NumSlots - (uint32_t)(age % NumSlots)) % NumSlots;
+	const bool     valid = (sequence <= mFrameCount) && (mSlots[index].timing.sequence == sequence) && isValid(index);
+
+	if( valid )
+	{
+		const slot& s = mSlots[index];
+
+		data.resize(s.size);
+		memcpy(&data[0], s.cpu, s.size);
+
+		if( info != NULL )
+			*info = s.info;
+	}
+
+	mMutex->unlock();
+	return valid;
+}
+
+
+// GetDelivered
+bool gstRingbuffer::GetDelivered( frameTiming* timing )
+{
+	if( !timing )
+		return false;
+
+	mMutex->lock();
+	*timing = mDelivered;
+	mMutex->unlock();
+
+	return (timing->sequence != 0);
+}
+
+
+// CopyPlanes
+bool gstRingbuffer::CopyPlanes( yuvFormat format, uint32_t width, uint32_t height, const uint8_t* src, size_t srcSize,
+						  const size_t* strides, const size_t* offsets, uint8_t* dst )
+{
+	const size_t pitch  = yuvFormatPitch(format, width);
+	const int    planes = (format == YUV_I420) ? 3 : 2;
+
+	for( int p=0; p < planes; p++ )
+	{
+		const size_t rows      = (p == 0) ? height : (height + 1) / 2;
+		const size_t rowSize   = (p == 0) ? pitch : yuvChromaPitch(format, pitch);
+		const size_t srcPitch  = strides[p];
+		const size_t srcOffset = offsets[p];
+
+		if( srcPitch < rowSize || srcOffset + srcPitch * (rows - 1) + rowSize > srcSize )
+			return false;
+
+		if( srcPitch == rowSize )
+		{
+			memcpy(dst, src + srcOffset, rowSize * rows);
+		}
+		else
+		{
+			for( size_t y=0; y < rows; y++ )
+				memcpy(dst + y * rowSize, src + srcOffset + y * srcPitch, rowSize);
+		}
+
+		dst += rowSize * rows;
+	}
+
+	return true;
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __GSTREAMER_RINGBUFFER_H__
+#define __GSTREAMER_RINGBUFFER_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include "cudaColorspace.h"
+
+
+class QMutex;
+class QWaitCondition;
+class imageOps;
+
+
+/**
+ * Ringbuffer of decoded frames, handing them from the GStreamer streaming thread to the consumers.
+ *
+ * The streaming thread copies each frame into the slot returned by Next() outside of the lock,
+ * then Publish() makes it the latest frame and wakes up the threads waiting in Consume().
+ * The slot of a frame is reused NumSlots-1 frames after it was published, so the pointers
+ * handed out stay valid until then.  Each slot keeps the format and size of its frame, so a
+ * caps change mid-stream doesn't affect the frames already published, and a slot is
+ * reallocated when it is reused for a larger frame.  gstCamera owns one per stream,
+ * jetson-bench measures the same code without a live stream.
+ * @ingroup util
+ */
+class gstRingbuffer
+{
+public:
+	/**
+	 * Number of slots.
+	 */
+	static const uint32_t NumSlots = 16;
+
+	/**
+	 * Timing of a frame, CLOCK_REALTIME nanoseconds (0 when unknown).
+	 */
+	struct frameTiming
+	{
+		uint64_t sequence;
+		uint64_t capture;		/**< camera capture time (RTCP SR mapped NTP time, or SEI timestamp) */
+		uint64_t decoderInput;	/**< buffer entered the decoder */
+		uint64_t decoderOutput;	/**< buffer reached the appsink */
+		uint64_t published;		/**< copied into the ringbuffer */
+		uint64_t delivered;		/**< returned by Consume() */
+	};
+
+	/**
+	 * Format of a frame, from the caps it was decoded with.
+	 */
+	struct frameInfo
+	{
+		yuvFormat format;		/**< YUV streams only, the packed plane layout of cudaColorspace.h */
+		uint32_t  width;
+		uint32_t  height;
+		size_t    pitch;		/**< bytes between the rows of the first plane */
+
+		yuvColorimetry colorimetry;	/**< YUV streams only, the caps' or the one set by gstCamera::SetColorimetry() */
+	};
+
+	/**
+	 * A published frame.
+	 */
+	struct frame
+	{
+		void*       cpu;
+		void*       cuda;
+		size_t      size;		/**< bytes written into the slot */
+		uint64_t    sequence;	/**< 1 for the first frame published */
+		uint64_t    timestamp;	/**< when it was published, in the time base passed to Publish() */
+		frameInfo   info;
+		frameTiming timing;
+	};
+
+	/**
+	 * Create an empty ringbuffer, the slots are allocated from ops on the first Next().
+	 */
+	gstRingbuffer( imageOps* ops );
+
+	/**
+	 * Destructor, frees the slots.
+	 */
+	~gstRingbuffer();
+
+	/**
+	 * Change the backend the slots are allocated from, fails once they are allocated.
+	 */
+	bool SetImageOps( imageOps* ops );
+
+	/**
+	 * True once the slots have been allocated.
+	 */
+	inline bool IsAllocated() const				{ return mSlots[0].cpu != NULL; }
+
+	/**
+	 * Number of frames published so far, only meaningful on the producer thread.
+	 */
+	inline uint64_t GetFrameCount() const		{ return mFrameCount; }
+
+	/**
+	 * Producer:  the CPU pointer of the slot the next frame is written to, with room for
+	 * size bytes.  The slots are allocated the first time, and a slot smaller than size is
+	 * reallocated (it holds the oldest frame, which is no longer handed out).
+	 * Returns NULL if the allocation fails, the frame should be dropped then.
+	 */
+	void* Next( size_t size );
+
+	/**
+	 * Producer:  make the slot from Next() the latest frame and wake up the consumers.
+	 * timing.sequence is set to the frame's sequence number.  Returns true if the
+	 * previous frame was overwritten before anyone consumed it.
+	 */
+	bool Publish( size_t size, const frameInfo& info, frameTiming& timing, uint64_t timestamp );
+
+	/**
+	 * Consumer:  wait for the next Publish(), then take the latest frame.  Returns false
+	 * on timeout, or if the latest frame was already consumed.
+	 */
+	bool Consume( frame* f, unsigned long timeout );
+
+	/**
+	 * The latest frame, without waiting or marking it as consumed.
+	 */
+	bool Peek( frame* f );
+
+	/**
+	 * The frame whose CPU or CUDA pointer is ptr, as returned by Consume() or Peek().
+	 * Returns false if ptr isn't a slot, or its frame has already been overwritten.
+	 */
+	bool Find( const void* ptr, frame* f );
+
+	/**
+	 * Copy the frame with the given sequence number out under the lock, so that it can be
+	 * processed at any pace.  Returns false if it has already been overwritten.
+	 */
+	bool Copy( uint64_t sequence, std::vector<uint8_t>& data, frameInfo* info=NULL );
+
+	/**
+	 * Timing of the last frame returned by Consume().
+	 */
+	bool GetDelivered( frameTiming* timing );
+
+	/**
+	 * Copy a YUV frame whose planes are padded (strides and offsets per plane, from the caps)
+	 * into the packed plane layout of cudaColorspace.h.  Returns false if the source buffer
+	 * is smaller than the strides and offsets describe.
+	 */
+	static bool CopyPlanes( yuvFormat format, uint32_t width, uint32_t height, const uint8_t* src, size_t srcSize,
+					    const size_t* strides, const size_t* offsets, uint8_t* dst );
+
+private:
+	struct slot
+	{
+		void*       cpu;
+		void*       cuda;
+		size_t      capacity;	// bytes allocated
+		size_t      size;
+		uint64_t    timestamp;
+		frameInfo   info;
+		frameTiming timing;
+	};
+
+	void getFrame( uint32_t index, frame* f ) const;
+	bool isValid( uint32_t index ) const;
+
+	imageOps* mOps;
+	slot      mSlots[NumSlots];
+	size_t    mSlotSize;
+
+	uint32_t    mLatest;
+	bool        mRetrieved;
+	uint64_t    mFrameCount;
+	frameTiming mDelivered;
+
+	QMutex*         mMutex;
+	QMutex*         mWaitMutex;
+	QWaitCondition* mWaitEvent;
+};
+
+#endif
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "gstSnapshot.h"
+#include "gstCamera.h"
+#include "gstUtility.h"
+
+#include <turbojpeg.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <QMutex>
+#include <QWaitCondition>
+
+
+// constructor
+gstSnapshot::gstSnapshot()
+{
+	mStreamsMutex = new QMutex();
+}
+
+
+// destructor
+gstSnapshot::~gstSnapshot()
+{
+	while( mStreams.size() > 0 )
+		RemoveStream(mStreams.begin()->first);
+
+	delete mStreamsMutex;
+}
+
+
+// Create
+gstSnapshot* gstSnapshot::Create()
+{
+	gstSnapshot* s = new gstSnapshot();
+
+	if( !s )
+		return NULL;
+
+	return s;
+}
+
+
+// AddStream
+bool gstSnapshot::AddStream( gstCamera* camera )
+{
+	if( !camera )
+		return false;
+
+	if( !camera->IsYUV() )
+	{
+		printf(LOG_GSTREAMER "gstSnapshot -- stream %u is not YUV, snapshots are unsupported\n", camera->GetStreamID());
+		return false;
+	}
+
+	stream* s = new stream();
+
+	s->camera  = camera;
+	s->mutex   = new QMutex();
+	s->encoded = new QWaitCondition();
+
+	mStreamsMutex->lock();
+	const bool exists = (mStreams.find(camera->GetStreamID()) != mStreams.end());
+
+	if( !exists )
+		mStreams[camera->GetStreamID()] = s;
+
+	mStreamsMutex->unlock();
+
+	if( exists )
+	{
+		delete s->mutex;
+		delete s->encoded;
+		delete s;
+		return false;
+	}
+
+	return true;
+}
+
+
+// RemoveStream
+void gstSnapshot::RemoveStream( uint32_t streamID )
+{
+	mStreamsMutex->lock();
+
+	std::map<uint32_t, stream*>::iterator iter = mStreams.find(streamID);
+	stream* s = NULL;
+
+	if( iter != mStreams.end() )
+	{
+		s = iter->second;
+		mStreams.erase(iter);
+	}
+
+	mStreamsMutex->unlock();
+
+	if( !s )
+		return;
+
+	// wait for any in-flight requests to drain before freeing the cache
+	s->mutex->lock();
+
+	for( size_t n=0; n < s->cache.size(); n++ )
+	{
+		while( s->cache[n]->encoding || s->cache[n]->waiters > 0 )
+			s->encoded->wait(s->mutex);
+
+		delete s->cache[n];
+	}
+
+	s->cache.clear();
+	s->mutex->unlock();
+
+	delete s->encoded;
+	delete s->mutex;
+	delete s;
+}
+
+
+// Snapshot
+bool gstSnapshot::Snapshot( uint32_t streamID, int quality, uint32_t maxWidth, std::vector<uint8_t>& jpeg, uint64_t* sequence )
+{
+	if( quality < 1 )
+		quality = 1;
+	else if( quality > 100 )
+		quality = 100;
+
+	mStreamsMutex->lock();
+	std::map<uint32_t, stream*>::iterator iter = mStreams.find(streamID);
+	stream* s = (iter != mStreams.end()) ? iter->second : NULL;
+	mStreamsMutex->unlock();
+
+	if( !s )
+		return false;
+
+	uint64_t seq = 0;
+
+	if( !s->camera->Peek(NULL, NULL, &seq) )
+		return false;
+
+	if( sequence != NULL )
+		*sequence = seq;
+
+	// look for this frame in the cache, or an encode of it already in flight
+	s->mutex->lock();
+
+	for( size_t n=0; n < s->cache.size(); n++ )
+	{
+		cacheEntry* e = s->cache[n];
+
+		if( e->sequence != seq || e->quality != quality || e->maxWidth != maxWidth )
+			continue;
+
+		e->waiters++;
+
+		while( e->encoding )
+			s->encoded->wait(s->mutex);
+
+		e->waiters--;
+
+		const bool result = !e->failed;
+		const bool last   = (e->waiters == 0);
+
+		if( result )
+			jpeg = e->jpeg;
+
+		s->mutex->unlock();
+
+		if( last )
+			s->encoded->wakeAll();	// RemoveStream() may be waiting on us
+
+		return result;
+	}
+
+	cacheEntry* entry = new cacheEntry();
+
+	entry->sequence = seq;
+	entry->quality  = quality;
+	entry->maxWidth = maxWidth;
+	entry->encoding = true;
+	entry->failed   = false;
+	entry->waiters  = 0;
+
+	s->cache.push_back(entry);
+	s->mutex->unlock();
+
+	// the decoder keeps writing into the ringbuffer, so copy the frame out first
+	// (this fails if frame seq has already been overwritten by the time we get to it)
+	// along with the format it was decoded with, which may differ from the latest caps
+	std::vector<uint8_t> frame;
+	std::vector<uint8_t> result;
+
+	gstCamera::frameInfo info;
+
+	const bool copied = s->camera->CopyFrame(seq, frame, &info) && frame.size() >= yuvFormatSize(info.format, info.pitch, info.height);
+
+	// encode outside of the lock, so other streams and sizes proceed in parallel
+	const bool encoded = copied && encode(&frame[0], info.format, info.width, info.height, quality, maxWidth, result);
+
+	s->mutex->lock();
+
+	entry->jpeg.swap(result);
+	entry->encoding = false;
+	entry->failed   = !encoded;
+
+	if( encoded )
+		jpeg = entry->jpeg;
+
+	// evict snapshots of older frames that nobody is waiting on
+	for( size_t n=0; n < s->cache.size(); )
+	{
+		cacheEntry* e = s->cache[n];
+
+		if( e->sequence < seq && !e->encoding && e->waiters == 0 )
+		{
+			delete e;
+			s->cache.erase(s->cache.begin() + n);
+		}
+		else
+			n++;
+	}
+
+	s->mutex->unlock();
+	s->encoded->wakeAll();
+
+	return encoded;
+}
+
+
+// downscale2x (box filter, output dimensions are width/2 x height/2)
+static void downscale2x( const uint8_t* in, uint32_t inPitch, uint8_t* out, uint32_t width, uint32_t height )
+{
+	for( uint32_t y=0; y < height; y++ )
+	{
+		const uint8_t* row0 = in + (y * 2) * inPitch;
+		const uint8_t* row1 = row0 + inPitch;
+
+		for( uint32_t x=0; x < width; x++ )
+			out[y * width + x] = (row0[x*2] + row0[x*2+1] + row1[x*2] + row1[x*2+1] + 2) >> 2;
+	}
+}
+
+
+// encode
+bool gstSnapshot::encode( const uint8_t* frame, yuvFormat format, uint32_t width, uint32_t height, int quality, uint32_t maxWidth, std::vector<uint8_t>& jpeg )
+{
+	if( !frame || width < 2 || height < 2 )
+		return false;
+
+	// 4:2:0 chroma covers odd edges with a partial sample, as TurboJPEG expects
+	uint32_t chromaWidth  = (width + 1) / 2;
+	uint32_t chromaHeight = (height + 1) / 2;
+
+	const size_t   pitch       = yuvFormatPitch(format, width);
+	const size_t   chromaPitch = yuvChromaPitch(format, pitch);
+	const uint8_t* chroma      = frame + pitch * height;
+
+	// copy the chroma into the 8-bit planar U & V that libjpeg-turbo expects
+	// (de-interleaved for NV12/NV21, the upper 8 bits of P010)
+	std::vector<uint8_t> planeY;
+	std::vector<uint8_t> planeU(chromaWidth * chromaHeight);
+	std::vector<uint8_t> planeV(chromaWidth * chromaHeight);
+
+	for( uint32_t y=0; y < chromaHeight; y++ )
+	{
+		const uint8_t* row = chroma + y * chromaPitch;
+		uint8_t*       u   = &planeU[y * chromaWidth];
+		uint8_t*       v   = &planeV[y * chromaWidth];
+
+		for( uint32_t x=0; x < chromaWidth; x++ )
+		{
+			if( format == YUV_I420 )
+			{
+				u[x] = row[x];
+				v[x] = row[x + chromaPitch * ((height + 1) / 2)];
+			}
+			else if( format == YUV_P010 )
+			{
+				u[x] = ((const uint16_t*)row)[x * 2] >> 8;
+				v[x] = ((const uint16_t*)row)[x * 2 + 1] >> 8;
+			}
+			else
+			{
+				const uint32_t iu = (format == YUV_NV21) ? 1 : 0;
+
+				u[x] = row[x * 2 + iu];
+				v[x] = row[x * 2 + (iu ^ 1)];
+			}
+		}
+	}
+
+	const uint8_t* lumaPtr   = frame;
+	uint32_t       lumaPitch = pitch;
+
+	if( format == YUV_P010 )
+	{
+		planeY.resize(width * height);
+
+		for( uint32_t y=0; y < height; y++ )
+		{
+			const uint16_t* row = (const uint16_t*)(frame + y * pitch);
+
+			for( uint32_t x=0; x < width; x++ )
+				planeY[y * width + x] = row[x] >> 8;
+		}
+
+		lumaPtr   = &planeY[0];
+		lumaPitch = width;
+	}
+
+	// halve the resolution until it fits within maxWidth
+	while( maxWidth > 0 && width > maxWidth && width >= 4 && height >= 4 )
+	{
+		const uint32_t w = (width / 2) & ~1;
+		const uint32_t h = (height / 2) & ~1;
+
+		std::vector<uint8_t> y(w * h);
+		std::vector<uint8_t> u(((w+1)/2) * ((h+1)/2));
+		std::vector<uint8_t> v(((w+1)/2) * ((h+1)/2));
+
+		downscale2x(lumaPtr, lumaPitch, &y[0], w, h);
+		downscale2x(&planeU[0], chromaWidth, &u[0], (w+1)/2, (h+1)/2);
+		downscale2x(&planeV[0], chromaWidth, &v[0], (w+1)/2, (h+1)/2);
+
+		planeY.swap(y);
+		planeU.swap(u);
+		planeV.swap(v);
+
+		width        = w;
+		height       = h;
+		chromaWidth  = (w + 1) / 2;
+		chromaHeight = (h + 1) / 2;
+		lumaPtr      = &planeY[0];
+		lumaPitch    = w;
+	}
+
+	tjhandle compressor = tjInitCompress();
+
+	if( !compressor )
+	{
+		printf(LOG_GSTREAMER "gstSnapshot -- tjInitCompress() failed (%s)\n", tjGetErrorStr());
+		return false;
+	}
+
+	const unsigned char* planes[] = { lumaPtr, &planeU[0], &planeV[0] };
+	const int strides[] = { (int)lumaPitch, (int)chromaWidth, (int)chromaWidth };
+
+	unsigned char* jpegBuf  = NULL;
+	unsigned long  jpegSize = 0;
+
+	const int result = tjCompressFromYUVPlanes(compressor, planes, width, strides, height, TJSAMP_420,
+									   &jpegBuf, &jpegSize, quality, TJFLAG_FASTDCT);
+
+	if( result == 0 )
+		jpeg.assign(jpegBuf, jpegBuf + jpegSize);
+	else
+		printf(LOG_GSTREAMER "gstSnapshot -- failed to encode %ux%u JPEG (%s)\n", width, height, tjGetErrorStr());
+
+	if( jpegBuf != NULL )
+		tjFree(jpegBuf);
+
+	tjDestroy(compressor);
+	return (result == 0);
+}
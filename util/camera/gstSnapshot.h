@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+ 
+#ifndef __GSTREAMER_SNAPSHOT_H__
+#define __GSTREAMER_SNAPSHOT_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <map>
+
+#include "cudaColorspace.h"
+
+
+class gstCamera;
+class QWaitCondition;
+class QMutex;
+
+
+/**
+ * JPEG snapshot service for a set of gstCamera streams.
+ *
+ * Snapshots are encoded directly from the YUV ringbuffer with libjpeg-turbo
+ * (4:2:0 YUV input of any yuvFormat, so no RGB pass is needed).  Results are cached per frame
+ * sequence number, quality and size, so concurrent requests for the same frame
+ * only encode once - later callers wait for the encode already in flight.
+ * @ingroup util
+ */
+class gstSnapshot
+{
+public:
+	/**
+	 * Create the snapshot service.
+	 */
+	static gstSnapshot* Create();
+
+	/**
+	 * Destructor
+	 */
+	~gstSnapshot();
+
+	/**
+	 * Register a camera, under the ID returned by gstCamera::GetStreamID().
+	 */
+	bool AddStream( gstCamera* camera );
+
+	/**
+	 * Unregister a camera and release its cached snapshots.
+	 */
+	void RemoveStream( uint32_t streamID );
+
+	/**
+	 * Get a JPEG of the latest frame decoded by the stream.
+	 * @param quality JPEG quality (1-100)
+	 * @param maxWidth if non-zero, the frame is downscaled by powers of two until it fits
+	 * @param jpeg receives the compressed image
+	 * @param sequence optionally receives the frame sequence number that was encoded
+	 */
+	bool Snapshot( uint32_t streamID, int quality, uint32_t maxWidth,
+				std::vector<uint8_t>& jpeg, uint64_t* sequence=NULL );
+
+protected:
+	gstSnapshot();
+
+	struct cacheEntry
+	{
+		uint64_t sequence;
+		int      quality;
+		uint32_t maxWidth;
+		bool     encoding;
+		bool     failed;
+		uint32_t waiters;
+
+		std::vector<uint8_t> jpeg;
+	};
+
+	struct stream
+	{
+		gstCamera*      camera;
+		QMutex*         mutex;
+		QWaitCondition* encoded;
+
+		std::vector<cacheEntry*> cache;
+	};
+
+	bool encode( const uint8_t* frame, yuvFormat format, uint32_t width, uint32_t height,
+			   int quality, uint32_t maxWidth, std::vector<uint8_t>& jpeg );
+
+	std::map<uint32_t, stream*> mStreams;
+	QMutex* mStreamsMutex;
+};
+
+#endif
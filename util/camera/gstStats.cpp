@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "gstStats.h"
+#include "gstUtility.h"
+
+#include <sstream>
+#include <thread>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+
+static std::atomic<gstStats*> gRegistry[gstStats::MaxStreams];
+
+static std::thread*      gServerThread = NULL;
+static std::atomic<bool> gServerStop(false);
+static int               gServerSocket = -1;
+
+
+// update an exponential moving average with a weight of 1/16
+static inline uint64_t ewma( uint64_t avg, uint64_t sample )
+{
+	if( avg == 0 )
+		return sample;
+
+	return avg + (int64_t(sample) - int64_t(avg)) / 16;
+}
+
+
+// constructor
+gstStats::gstStats()
+{
+	mActive.store(false);
+	reset(0);
+}
+
+
+// reset
+void gstStats::reset( uint32_t streamID )
+{
+	mStreamID.store(streamID);
+
+	mFramesDecoded.store(0);
+	mFramesDelivered.store(0);
+	mFramesOverwritten.store(0);
+	mFramesDropped.store(0);
+	mFramesConverted.store(0);
+	mReconnects.store(0);
+	mBytesCopied.store(0);
+	mBytesConverted.store(0);
+	mPacketsReceived.store(0);
+	mPacketsLost.store(0);
+	mRingOccupancy.store(0);
+
+	mInputInterval.store(0);
+	mInputJitter.store(0);
+	mDeliveredInterval.store(0);
+
+	mLastInput     = 0;
+	mLastDelivered = 0;
+
+	for( uint32_t s=0; s < LATENCY_NUM_STAGES; s++ )
+	{
+		mLatency[s].count.store(0);
+		mLatency[s].sum.store(0);
+
+		for( uint32_t n=0; n < LatencyBins; n++ )
+			mLatency[s].bins[n].store(0);
+	}
+}
+
+
+// Register
+gstStats* gstStats::Register( uint32_t streamID )
+{
+	for( uint32_t n=0; n < MaxStreams; n++ )
+	{
+		gstStats* stats = gRegistry[n].load();
+
+		// reuse a slot that was released by a previous stream
+		if( stats != NULL )
+		{
+			bool inactive = false;
+
+			if( stats->mActive.compare_exchange_strong(inactive, true) )
+			{
+				stats->reset(streamID);
+				return stats;
+			}
+
+			continue;
+		}
+
+		gstStats* newStats = new gstStats();
+
+		newStats->reset(streamID);
+		newStats->mActive.store(true);
+
+		if( gRegistry[n].compare_exchange_strong(stats, newStats) )
+			return newStats;
+
+		delete newStats;	// lost the race for this slot, keep looking
+	}
+
+	printf(LOG_GSTREAMER "gstStats -- registry is full (%u streams), stream %u will not be tracked\n", MaxStreams, streamID);
+	return NULL;
+}
+
+
+// Release
+void gstStats::Release()
+{
+	mActive.store(false);
+}
+
+
+// Time
+uint64_t gstStats::Time()
+{
+	timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return uint64_t(t.tv_sec) * 1000000000ULL + uint64_t(t.tv_nsec);
+}
+
+
+// WallTime
+uint64_t gstStats::WallTime()
+{
+	timespec t;
+	clock_gettime(CLOCK_REALTIME, &t);
+	return uint64_t(t.tv_sec) * 1000000000ULL + uint64_t(t.tv_nsec);
+}
+
+
+// FrameDecoded
+void gstStats::FrameDecoded( uint64_t timestamp, uint32_t bytes, bool overwrote )
+{
+	mFramesDecoded.fetch_add(1, std::memory_order_relaxed);
+	mBytesCopied.fetch_add(bytes, std::memory_order_relaxed);
+
+	if( overwrote )
+	{
+		mFramesOverwritten.fetch_add(1, std::memory_order_relaxed);
+		mRingOccupancy.fetch_add(1, std::memory_order_relaxed);
+	}
+	else
+		mRingOccupancy.store(1, std::memory_order_relaxed);
+
+	if( mLastInput != 0 && timestamp > mLastInput )
+	{
+		const uint64_t interval = timestamp - mLastInput;
+		const uint64_t average  = ewma(mInputInterval.load(std::memory_order_relaxed), interval);
+		const uint64_t deviation = (interval > average) ? (interval - average) : (average - interval);
+
+		mInputInterval.store(average, std::memory_order_relaxed);
+		mInputJitter.store(ewma(mInputJitter.load(std::memory_order_relaxed), deviation), std::memory_order_relaxed);
+	}
+
+	mLastInput = timestamp;
+}
+
+
+// FrameDelivered
+void gstStats::FrameDelivered( uint64_t timestamp, uint64_t latency )
+{
+	mFramesDelivered.fetch_add(1, std::memory_order_relaxed);
+	mRingOccupancy.store(0, std::memory_order_relaxed);
+
+	if( mLastDelivered != 0 && timestamp > mLastDelivered )
+		mDeliveredInterval.store(ewma(mDeliveredInterval.load(std::memory_order_relaxed), timestamp - mLastDelivered), std::memory_order_relaxed);
+
+	mLastDelivered = timestamp;
+
+	Latency(LATENCY_CONSUMER, latency);
+}
+
+
+// Latency
+void gstStats::Latency( LatencyStage stage, uint64_t latency )
+{
+	if( stage >= LATENCY_NUM_STAGES )
+		return;
+
+	// histogram bin is the log2 of the latency in microseconds
+	const uint64_t usec = latency / 1000;
+	uint32_t bin = 0;
+
+	while( bin < LatencyBins - 1 && (usec >> (bin + 1)) != 0 )
+		bin++;
+
+	mLatency[stage].bins[bin].fetch_add(1, std::memory_order_relaxed);
+	mLatency[stage].count.fetch_add(1, std::memory_order_relaxed);
+	mLatency[stage].sum.fetch_add(usec, std::memory_order_relaxed);
+}
+
+
+// GetSnapshot
+void gstStats::GetSnapshot( std::vector<snapshot>& streams )
+{
+	streams.clear();
+
+	for( uint32_t n=0; n < MaxStreams; n++ )
+	{
+		gstStats* stats = gRegistry[n].load();
+
+		if( !stats || !stats->mActive.load() )
+			continue;
+
+		snapshot s;
+		memset(&s, 0, sizeof(snapshot));
+
+		s.streamID = stats->mStreamID.load();
+
+		const uint64_t inputInterval     = stats->mInputInterval.load(std::memory_order_relaxed);
+		const uint64_t deliveredInterval = stats->mDeliveredInterval.load(std::memory_order_relaxed);
+
+		s.inputFPS     = (inputInterval > 0) ? 1000000000.0f / float(inputInterval) : 0.0f;
+		s.deliveredFPS = (deliveredInterval > 0) ? 1000000000.0f / float(deliveredInterval) : 0.0f;
+		s.jitterMs     = float(stats->mInputJitter.load(std::memory_order_relaxed)) / 1000000.0f;
+
+		s.framesDecoded     = stats->mFramesDecoded.load(std::memory_order_relaxed);
+		s.framesDelivered   = stats->mFramesDelivered.load(std::memory_order_relaxed);
+		s.framesOverwritten = stats->mFramesOverwritten.load(std::memory_order_relaxed);
+		s.framesDropped     = stats->mFramesDropped.load(std::memory_order_relaxed);
+		s.framesConverted   = stats->mFramesConverted.load(std::memory_order_relaxed);
+		s.reconnects        = stats->mReconnects.load(std::memory_order_relaxed);
+		s.bytesCopied       = stats->mBytesCopied.load(std::memory_order_relaxed);
+		s.bytesConverted    = stats->mBytesConverted.load(std::memory_order_relaxed);
+		s.packetsReceived   = stats->mPacketsReceived.load(std::memory_order_relaxed);
+		s.packetsLost       = stats->mPacketsLost.load(std::memory_order_relaxed);
+		s.ringOccupancy     = stats->mRingOccupancy.load(std::memory_order_relaxed);
+
+		for( uint32_t l=0; l < LATENCY_NUM_STAGES; l++ )
+		{
+			s.latency[l].count = stats->mLatency[l].count.load(std::memory_order_relaxed);
+			s.latency[l].sum   = stats->mLatency[l].sum.load(std::memory_order_relaxed);
+
+			for( uint32_t b=0; b < LatencyBins; b++ )
+				s.latency[l].bins[b] = stats->mLatency[l].bins[b].load(std::memory_order_relaxed);
+		}
+
+		streams.push_back(s);
+	}
+}
+
+
+// Export
+std::string gstStats::Export()
+{
+	std::vector<snapshot> streams;
+	GetSnapshot(streams);
+
+	std::ostringstream ss;
+
+#define EXPORT_METRIC(name, type, help, member)							\
+	ss << "# HELP " name " " help "\n# TYPE " name " " type "\n";			\
+	for( size_t n=0; n < streams.size(); n++ )							\
+		ss << name "{stream=\"" << streams[n].streamID << "\"} " << streams[n].member << "\n";
+
+	EXPORT_METRIC("jetson_stream_input_fps", "gauge", "Frames per second arriving from the decoder.", inputFPS);
+	EXPORT_METRIC("jetson_stream_delivered_fps", "gauge", "Frames per second returned by Capture().", deliveredFPS);
+	EXPORT_METRIC("jetson_stream_jitter_ms", "gauge", "Mean deviation of the decoder inter-arrival time.", jitterMs);
+	EXPORT_METRIC("jetson_stream_frames_decoded_total", "counter", "Frames copied into the ringbuffer.", framesDecoded);
+	EXPORT_METRIC("jetson_stream_frames_delivered_total", "counter", "Frames returned by Capture().", framesDelivered);
+	EXPORT_METRIC("jetson_stream_frames_overwritten_total", "counter", "Frames replaced before being captured.", framesOverwritten);
+	EXPORT_METRIC("jetson_stream_frames_dropped_total", "counter", "Frames lost before reaching the ringbuffer.", framesDropped);
+	EXPORT_METRIC("jetson_stream_frames_converted_total", "counter", "Frames converted by ConvertRGBA().", framesConverted);
+	EXPORT_METRIC("jetson_stream_reconnects_total", "counter", "Pipeline restarts.", reconnects);
+	EXPORT_METRIC("jetson_stream_copied_bytes_total", "counter", "Bytes copied into the ringbuffer.", bytesCopied);
+	EXPORT_METRIC("jetson_stream_converted_bytes_total", "counter", "Bytes written by color conversion.", bytesConverted);
+	EXPORT_METRIC("jetson_stream_rtp_packets_received_total", "counter", "RTP packets pushed by the jitterbuffer.", packetsReceived);
+	EXPORT_METRIC("jetson_stream_rtp_packets_lost_total", "counter", "RTP packets lost according to the jitterbuffer.", packetsLost);
+	EXPORT_METRIC("jetson_stream_ring_occupancy", "gauge", "Frames published since the last Capture().", ringOccupancy);
+
+#undef EXPORT_METRIC
+
+	static const char* stageNames[] = { "network", "decode", "copy", "consumer", "total" };
+
+	ss << "# HELP jetson_stream_latency_seconds Glass-to-consumer latency, broken down by stage.\n";
+	ss << "# TYPE jetson_stream_latency_seconds histogram\n";
+
+	for( size_t n=0; n < streams.size(); n++ )
+	{
+		for( uint32_t l=0; l < LATENCY_NUM_STAGES; l++ )
+		{
+			const histogram& h = streams[n].latency[l];
+
+			// the network and total stages need capture times from the camera
+			if( h.count == 0 && (l == LATENCY_NETWORK || l == LATENCY_TOTAL) )
+				continue;
+
+			uint64_t cumulative = 0;
+
+			for( uint32_t b=0; b < LatencyBins; b++ )
+			{
+				cumulative += h.bins[b];
+				ss << "jetson_stream_latency_seconds_bucket{stream=\"" << streams[n].streamID << "\",stage=\"" << stageNames[l] << "\",le=\"" << (double(2ULL << b) * 0.000001) << "\"} " << cumulative << "\n";
+			}
+
+			ss << "jetson_stream_latency_seconds_bucket{stream=\"" << streams[n].streamID << "\",stage=\"" << stageNames[l] << "\",le=\"+Inf\"} " << h.count << "\n";
+			ss << "jetson_stream_latency_seconds_sum{stream=\"" << streams[n].streamID << "\",stage=\"" << stageNames[l] << "\"} " << (double(h.sum) * 0.000001) << "\n";
+			ss << "jetson_stream_latency_seconds_count{stream=\"" << streams[n].streamID << "\",stage=\"" << stageNames[l] << "\"} " << h.count << "\n";
+		}
+	}
+
+	return ss.str();
+}
+
+
+// serverThread
+static void serverThread( int sock )
+{
+	while( !gServerStop.load() )
+	{
+		pollfd fd;
+
+		fd.fd      = sock;
+		fd.events  = POLLIN;
+		fd.revents = 0;
+
+		if( poll(&fd, 1, 250) <= 0 )
+			continue;
+
+		const int client = accept(sock, NULL, NULL);
+
+		if( client < 0 )
+			continue;
+
+		const std::string text = gstStats::Export();
+
+		size_t written = 0;
+
+		while( written < text.size() )
+		{
+			// MSG_NOSIGNAL:  a scraper that already hung up would otherwise raise
+			// SIGPIPE, whose default action terminates the whole process
+			const ssize_t result = send(client, text.c_str() + written, text.size() - written, MSG_NOSIGNAL);
+
+			if( result <= 0 )
+				break;
+
+			written += result;
+		}
+
+		close(client);
+	}
+}
+
+
+// StartServer
+bool gstStats::StartServer( const char* path )
+{
+	if( gServerThread != NULL )
+		return true;
+
+	if( !path || strlen(path) >= sizeof(((sockaddr_un*)0)->sun_path) )
+		return false;
+
+	const int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if( sock < 0 )
+	{
+		printf(LOG_GSTREAMER "gstStats -- failed to create socket\n");
+		return false;
+	}
+
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(sockaddr_un));
+
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+
+	unlink(path);
+
+	if( bind(sock, (sockaddr*)&addr, sizeof(sockaddr_un)) != 0 || listen(sock, 8) != 0 )
+	{
+		printf(LOG_GSTREAMER "gstStats -- failed to bind socket %s\n", path);
+		close(sock);
+		return false;
+	}
+
+	gServerStop.store(false);
+	gServerSocket = sock;
+	gServerThread = new std::thread(serverThread, sock);
+
+	printf(LOG_GSTREAMER "gstStats -- serving statistics on %s\n", path);
+	return true;
+}
+
+
+// StopServer
+void gstStats::StopServer()
+{
+	if( !gServerThread )
+		return;
+
+	gServerStop.store(true);
+	gServerThread->join();
+
+	delete gServerThread;
+	gServerThread = NULL;
+
+	close(gServerSocket);
+	gServerSocket = -1;
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef __GSTREAMER_STATS_H__
+#define __GSTREAMER_STATS_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+
+/**
+ * Per-stream runtime statistics.
+ *
+ * Each gstCamera registers one gstStats object in a fixed-size global registry.
+ * The streaming and consumer threads only perform relaxed atomic updates, while
+ * readers take a snapshot at any time through GetSnapshot() / Export(), or over
+ * the local socket started with StartServer() (Prometheus text format).
+ * @ingroup util
+ */
+class gstStats
+{
+public:
+	/**
+	 * Maximum number of streams in the registry.
+	 */
+	static const uint32_t MaxStreams = 64;
+
+	/**
+	 * Number of latency histogram bins, bin N counts [2^N, 2^(N+1)) microseconds.
+	 */
+	static const uint32_t LatencyBins = 24;
+
+	/**
+	 * Stages of the glass-to-consumer latency breakdown.
+	 */
+	enum LatencyStage
+	{
+		LATENCY_NETWORK = 0,	/**< camera capture (RTCP/NTP or SEI time) to decoder input, includes the jitterbuffer */
+		LATENCY_DECODE,			/**< decoder input to appsink */
+		LATENCY_COPY,			/**< appsink to published in the ringbuffer */
+		LATENCY_CONSUMER,		/**< published to returned by Capture() */
+		LATENCY_TOTAL,			/**< camera capture to returned by Capture() */
+		LATENCY_NUM_STAGES
+	};
+
+	/**
+	 * Latency histogram for one stage.
+	 */
+	struct histogram
+	{
+		uint64_t count;
+		uint64_t sum;			/**< in microseconds */
+		uint64_t bins[LatencyBins];
+	};
+
+	/**
+	 * Point-in-time copy of a stream's statistics.
+	 */
+	struct snapshot
+	{
+		uint32_t streamID;
+
+		float inputFPS;			/**< rate of frames arriving from the decoder */
+		float deliveredFPS;		/**< rate of frames handed out by Capture() */
+		float jitterMs;			/**< mean deviation of the decoder inter-arrival time */
+
+		uint64_t framesDecoded;
+		uint64_t framesDelivered;
+		uint64_t framesOverwritten;	/**< replaced in the ringbuffer before anyone captured them */
+		uint64_t framesDropped;		/**< lost in checkBuffer() (map failures, bad caps, ...) */
+		uint64_t framesConverted;
+		uint64_t reconnects;
+
+		uint64_t bytesCopied;		/**< ringbuffer memcpy traffic */
+		uint64_t bytesConverted;	/**< ConvertRGBA() output traffic */
+
+		uint64_t packetsReceived;	/**< from the rtspsrc jitterbuffer */
+		uint64_t packetsLost;
+
+		uint32_t ringOccupancy;		/**< frames published since the last Capture() */
+
+		histogram latency[LATENCY_NUM_STAGES];
+	};
+
+	/**
+	 * Register a stream, returns NULL if the registry is full.
+	 */
+	static gstStats* Register( uint32_t streamID );
+
+	/**
+	 * Release the stream's slot in the registry (the object stays valid).
+	 */
+	void Release();
+
+	/**
+	 * Copy the statistics of all registered streams.
+	 */
+	static void GetSnapshot( std::vector<snapshot>& streams );
+
+	/**
+	 * Format the statistics of all registered streams as Prometheus text.
+	 */
+	static std::string Export();
+
+	/**
+	 * Serve Export() on a local (UNIX domain) socket, one dump per connection.
+	 */
+	static bool StartServer( const char* path="/tmp/jetson-stats.sock" );
+
+	/**
+	 * Stop the socket server.
+	 */
+	static void StopServer();
+
+	/**
+	 * Monotonic timestamp in nanoseconds.
+	 */
+	static uint64_t Time();
+
+	/**
+	 * Wallclock (CLOCK_REALTIME) timestamp in nanoseconds since the UNIX epoch,
+	 * comparable with the NTP capture times reported by the camera.
+	 */
+	static uint64_t WallTime();
+
+	/**
+	 * A frame was copied into the ringbuffer (streaming thread).
+	 */
+	void FrameDecoded( uint64_t timestamp, uint32_t bytes, bool overwrote );
+
+	/**
+	 * A frame was handed to the consumer by Capture(), after latency nanoseconds.
+	 */
+	void FrameDelivered( uint64_t timestamp, uint64_t latency );
+
+	/**
+	 * Record a latency sample (in nanoseconds) for one stage of the breakdown.
+	 */
+	void Latency( LatencyStage stage, uint64_t latency );
+
+	/**
+	 * A frame was lost before reaching the ringbuffer.
+	 */
+	inline void FrameDropped()					{ mFramesDropped.fetch_add(1, std::memory_order_relaxed); }
+
+	/**
+	 * A frame was color-converted, producing the given number of bytes.
+	 */
+	inline void FrameConverted( uint64_t bytes )	{ mFramesConverted.fetch_add(1, std::memory_order_relaxed); mBytesConverted.fetch_add(bytes, std::memory_order_relaxed); }
+
+	/**
+	 * The pipeline was restarted.
+	 */
+	inline void Reconnected()					{ mReconnects.fetch_add(1, std::memory_order_relaxed); }
+
+	/**
+	 * Update the RTP packet counters (totals reported by the jitterbuffer).
+	 */
+	inline void PacketStats( uint64_t received, uint64_t lost )	{ mPacketsReceived.store(received, std::memory_order_relaxed); mPacketsLost.store(lost, std::memory_order_relaxed); }
+
+protected:
+	gstStats();
+	void reset( uint32_t streamID );
+
+	std::atomic<uint32_t> mStreamID;
+	std::atomic<bool>     mActive;
+
+	std::atomic<uint64_t> mFramesDecoded;
+	std::atomic<uint64_t> mFramesDelivered;
+	std::atomic<uint64_t> mFramesOverwritten;
+	std::atomic<uint64_t> mFramesDropped;
+	std::atomic<uint64_t> mFramesConverted;
+	std::atomic<uint64_t> mReconnects;
+	std::atomic<uint64_t> mBytesCopied;
+	std::atomic<uint64_t> mBytesConverted;
+	std::atomic<uint64_t> mPacketsReceived;
+	std::atomic<uint64_t> mPacketsLost;
+	std::atomic<uint32_t> mRingOccupancy;
+
+	// exponential moving averages (in ns), each written by a single thread
+	std::atomic<uint64_t> mInputInterval;
+	std::atomic<uint64_t> mInputJitter;
+	std::atomic<uint64_t> mDeliveredInterval;
+
+	uint64_t mLastInput;		// owned by the streaming thread
+	uint64_t mLastDelivered;	// owned by the consumer thread
+
+	struct atomicHistogram
+	{
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> sum;
+		std::atomic<uint64_t> bins[LatencyBins];
+	};
+
+	atomicHistogram mLatency[LATENCY_NUM_STAGES];
+};
+
+#endif
@@ -21,10 +21,12 @@
  */
 
 #include "gstUtility.h"
+#include "logging.h"
 
 #include <gst/gst.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 
 inline const char* gst_debug_level_str( GstDebugLevel level )
@@ -56,6 +58,11 @@ void rilog_debug_function(GstDebugCategory* category, GstDebugLevel level,
 	if( level > GST_LEVEL_WARNING /*GST_LEVEL_INFO*/ )
 		return;
 
+	const int logLevel = (level <= GST_LEVEL_ERROR) ? LOG_LEVEL_ERROR : LOG_LEVEL_WARNING;
+
+	if( !logEnabled(LOG_CATEGORY_GSTREAMER, logLevel) )
+		return;
+
 	//gchar* name = NULL;
 	//if( object != NULL )
 	//	g_object_get(object, "name", &name, NULL);
@@ -69,7 +76,9 @@ void rilog_debug_function(GstDebugCategory* category, GstDebugLevel level,
 		className = G_OBJECT_CLASS_NAME(object);
 	}
 
-	printf(LOG_GSTREAMER "%s %s %s\n" SEP "%s:%i  %s\n" SEP "%s\n", 
+	// rate-limited by the location of the GStreamer message, not this function
+	logWrite(LOG_CATEGORY_GSTREAMER, logLevel, file, line,
+		    LOG_GSTREAMER "%s %s %s\n" SEP "%s:%i  %s\n" SEP "%s\n", 
 		  	gst_debug_level_str(level), typeName,
 		  	gst_debug_category_get_name(category), file, line, function, 
             	gst_debug_message_get(message));
@@ -173,8 +182,8 @@ gboolean gst_message_print(GstBus* bus, GstMessage* message, gpointer user_data)
 			gchar *dbg_info = NULL;
  
 			gst_message_parse_error (message, &err, &dbg_info);
-			printf(LOG_GSTREAMER "gstreamer %s ERROR %s\n", GST_OBJECT_NAME (message->src), err->message);
-        		printf(LOG_GSTREAMER "gstreamer Debugging info: %s\n", (dbg_info) ? dbg_info : "none");
+			LogError(LOG_CATEGORY_GSTREAMER, LOG_GSTREAMER "gstreamer %s ERROR %s\n", GST_OBJECT_NAME (message->src), err->message);
+        		LogError(LOG_CATEGORY_GSTREAMER, LOG_GSTREAMER "gstreamer Debugging info: %s\n", (dbg_info) ? dbg_info : "none");
         
 			g_error_free(err);
         		g_free(dbg_info);
@@ -183,7 +192,7 @@ gboolean gst_message_print(GstBus* bus, GstMessage* message, gpointer user_data)
 		}
 		case GST_MESSAGE_EOS:
 		{
-			printf(LOG_GSTREAMER "gstreamer %s recieved EOS signal...\n", GST_OBJECT_NAME(message->src));
+			LogInfo(LOG_CATEGORY_GSTREAMER, LOG_GSTREAMER "gstreamer %s recieved EOS signal...\n", GST_OBJECT_NAME(message->src));
 			//g_main_loop_quit (app->loop);		// TODO trigger plugin Close() upon error
 			break;
 		}
@@ -193,7 +202,7 @@ gboolean gst_message_print(GstBus* bus, GstMessage* message, gpointer user_data)
     
 			gst_message_parse_state_changed(message, &old_state, &new_state, NULL);
 			
-			printf(LOG_GSTREAMER "gstreamer changed state from %s to %s ==> %s\n",
+			LogInfo(LOG_CATEGORY_GSTREAMER, LOG_GSTREAMER "gstreamer changed state from %s to %s ==> %s\n",
 							gst_element_state_get_name(old_state),
 							gst_element_state_get_name(new_state),
 						     GST_OBJECT_NAME(message->src));
@@ -204,7 +213,7 @@ gboolean gst_message_print(GstBus* bus, GstMessage* message, gpointer user_data)
 			GstStreamStatusType streamStatus;
 			gst_message_parse_stream_status(message, &streamStatus, NULL);
 			
-			printf(LOG_GSTREAMER "gstreamer stream status %s ==> %s\n",
+			LogVerbose(LOG_CATEGORY_GSTREAMER, LOG_GSTREAMER "gstreamer stream status %s ==> %s\n",
 							gst_stream_status_string(streamStatus), 
 							GST_OBJECT_NAME(message->src));
 			break;
@@ -221,7 +230,7 @@ gboolean gst_message_print(GstBus* bus, GstMessage* message, gpointer user_data)
 //			gchar* txt = "missing gst_tag_list_to_string()";
 //#endif
 
-			printf(LOG_GSTREAMER "gstreamer %s %s\n", GST_OBJECT_NAME(message->src), txt);
+			LogVerbose(LOG_CATEGORY_GSTREAMER, LOG_GSTREAMER "gstreamer %s %s\n", GST_OBJECT_NAME(message->src), txt);
 
 			g_free(txt);			
 			//gst_tag_list_foreach(tags, gst_print_one_tag, NULL);
@@ -230,7 +239,7 @@ gboolean gst_message_print(GstBus* bus, GstMessage* message, gpointer user_data)
 		}
 		default:
 		{
-			printf(LOG_GSTREAMER "gstreamer msg %s ==> %s\n", gst_message_type_get_name(GST_MESSAGE_TYPE(message)), GST_OBJECT_NAME(message->src));
+			LogVerbose(LOG_CATEGORY_GSTREAMER, LOG_GSTREAMER "gstreamer msg %s ==> %s\n", gst_message_type_get_name(GST_MESSAGE_TYPE(message)), GST_OBJECT_NAME(message->src));
 			break;
 		}
 	}
@@ -238,3 +247,85 @@ gboolean gst_message_print(GstBus* bus, GstMessage* message, gpointer user_data)
 	return TRUE;
 }
 
+
+// match elements by factory name
+static bool gst_match_factory(GstElementFactory* factory, const char* name)
+{
+	return (strcmp(gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory)), name) == 0);
+}
+
+// match elements by klass metadata (ie "Codec/Decoder/Video")
+static bool gst_match_klass(GstElementFactory* factory, const char* klass)
+{
+	const char* metadata = gst_element_factory_get_metadata(factory, GST_ELEMENT_METADATA_KLASS);
+
+	if( !metadata )
+		return false;
+
+	return (strstr(metadata, "Decoder") != NULL && strstr(metadata, klass) != NULL);
+}
+
+// iterate over the bin and return the first match
+static GstElement* gst_find_matching(GstBin* bin, bool (*match)(GstElementFactory*, const char*), const char* arg)
+{
+	GstIterator* iter  = gst_bin_iterate_recurse(bin);
+	GstElement*  found = NULL;
+	GValue       item  = G_VALUE_INIT;
+	bool         done  = false;
+
+	while( !done )
+	{
+		switch( gst_iterator_next(iter, &item) )
+		{
+			case GST_ITERATOR_OK:
+			{
+				GstElement* element = GST_ELEMENT(g_value_get_object(&item));
+				GstElementFactory* elementFactory = gst_element_get_factory(element);
+
+				if( elementFactory != NULL && match(elementFactory, arg) )
+				{
+					found = GST_ELEMENT(gst_object_ref(element));
+					done  = true;
+				}
+
+				g_value_reset(&item);
+				break;
+			}
+			case GST_ITERATOR_RESYNC:
+			{
+				gst_iterator_resync(iter);
+				break;
+			}
+			default:
+			{
+				done = true;
+				break;
+			}
+		}
+	}
+
+	g_value_unset(&item);
+	gst_iterator_free(iter);
+	return found;
+}
+
+
+// gst_find_element
+GstElement* gst_find_element(GstBin* bin, const char* factory)
+{
+	if( !bin || !factory )
+		return NULL;
+
+	return gst_find_matching(bin, gst_match_factory, factory);
+}
+
+
+// gst_find_decoder
+GstElement* gst_find_decoder(GstBin* bin)
+{
+	if( !bin )
+		return NULL;
+
+	return gst_find_matching(bin, gst_match_klass, "Video");
+}
+
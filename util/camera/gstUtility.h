@@ -48,6 +48,22 @@ bool gstreamerInit();
 gboolean gst_message_print(_GstBus* bus, _GstMessage* message, void* user_data);
 
 
+/**
+ * Find the first element in the bin (searched recursively) created by the named factory.
+ * The returned element has an extra reference, release it with gst_object_unref().
+ * @ingroup util
+ */
+GstElement* gst_find_element(GstBin* bin, const char* factory);
+
+
+/**
+ * Find the first video decoder element in the bin (searched recursively),
+ * based on the element klass metadata.  Release it with gst_object_unref().
+ * @ingroup util
+ */
+GstElement* gst_find_decoder(GstBin* bin);
+
+
 
 #endif
 
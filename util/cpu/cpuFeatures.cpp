@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuFeatures.h"
+
+#include <atomic>
+
+
+static std::atomic<int> gISA(-1);
+
+
+// cpuSupportsISA
+static bool cpuSupportsISA( cpuISA isa )
+{
+	switch(isa)
+	{
+		case CPU_ISA_SCALAR:	return true;
+#if defined(__x86_64__) || defined(__i386__)
+		case CPU_ISA_SSE41:		return __builtin_cpu_supports("sse4.1");
+		case CPU_ISA_AVX2:		return __builtin_cpu_supports("avx2");
+#endif
+#if defined(__aarch64__) || defined(__ARM_NEON)
+		case CPU_ISA_NEON:		return true;
+#endif
+		default:				return false;
+	}
+}
+
+
+// cpuDetectISA
+cpuISA cpuDetectISA()
+{
+	if( cpuSupportsISA(CPU_ISA_AVX2) )
+		return CPU_ISA_AVX2;
+
+	if( cpuSupportsISA(CPU_ISA_SSE41) )
+		return CPU_ISA_SSE41;
+
+	if( cpuSupportsISA(CPU_ISA_NEON) )
+		return CPU_ISA_NEON;
+
+	return CPU_ISA_SCALAR;
+}
+
+
+// cpuGetISA
+cpuISA cpuGetISA()
+{
+	int isa = gISA.load(std::memory_order_relaxed);
+
+	if( isa < 0 )
+	{
+		isa = cpuDetectISA();
+		gISA.store(isa, std::memory_order_relaxed);
+	}
+
+	return (cpuISA)isa;
+}
+
+
+// cpuSetISA
+cpuISA cpuSetISA( cpuISA isa )
+{
+	if( !cpuSupportsISA(isa) )
+	{
+		// AVX2 falls back to SSE4.1, everything else to the best available
+		isa = (isa == CPU_ISA_AVX2 && cpuSupportsISA(CPU_ISA_SSE41)) ? CPU_ISA_SSE41 : cpuDetectISA();
+	}
+
+	gISA.store(isa, std::memory_order_relaxed);
+	return isa;
+}
+
+
+// cpuISAName
+const char* cpuISAName( cpuISA isa )
+{
+	switch(isa)
+	{
+		case CPU_ISA_SCALAR:	return "scalar";
+		case CPU_ISA_SSE41:		return "SSE4.1";
+		case CPU_ISA_AVX2:		return "AVX2";
+		case CPU_ISA_NEON:		return "NEON";
+	}
+
+	return "unknown";
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CPU_FEATURES_H_
+#define __CPU_FEATURES_H_
+
+
+/**
+ * SIMD instruction sets used by the CPU image kernels.
+ * @ingroup util
+ */
+enum cpuISA
+{
+	CPU_ISA_SCALAR = 0,	/**< portable C++ */
+	CPU_ISA_SSE41,		/**< x86 SSE4.1 */
+	CPU_ISA_AVX2,		/**< x86 AVX2 */
+	CPU_ISA_NEON		/**< ARM NEON (AArch64 / ARMv7 with NEON) */
+};
+
+
+/**
+ * Detect the best instruction set supported by this CPU and compiled into the library.
+ * @ingroup util
+ */
+cpuISA cpuDetectISA();
+
+
+/**
+ * Instruction set currently used by the CPU kernels (cpuDetectISA() unless overridden).
+ * @ingroup util
+ */
+cpuISA cpuGetISA();
+
+
+/**
+ * Override the instruction set used by the CPU kernels, for example to compare
+ * the SIMD paths against the scalar one.  Requests for an instruction set that
+ * isn't supported fall back to the best one that is.
+ * @returns the instruction set actually selected.
+ * @ingroup util
+ */
+cpuISA cpuSetISA( cpuISA isa );
+
+
+/**
+ * Name of the instruction set, for logging.
+ * @ingroup util
+ */
+const char* cpuISAName( cpuISA isa );
+
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuLetterbox.h"
+#include "cpuResize.h"
+#include "cpuThreadPool.h"
+#include "trace.h"
+
+#include <algorithm>
+
+
+// letterbox
+//  the image is resized into its crop of the canvas, then only the pixels
+//  around it are padded, so every pixel of the canvas is written once
+template <typename T>
+static bool letterbox( const ImageView<T>& input, const ImageView<T>& output, resizeFilter filter, const T& padding, letterboxTransform* transform )
+{
+	if( !input.IsValid() || !output.IsValid() )
+		return false;
+
+	const letterboxTransform t = letterboxCompute(input.width, input.height, output.width, output.height);
+
+	if( !cpuResize(input, output.Crop(t.left, t.top, t.width, t.height), filter) )
+		return false;
+
+	if( transform != NULL )
+		*transform = t;
+
+	const uint32_t right = t.left + t.width;
+	const uint32_t bottom = t.top + t.height;
+
+	cpuParallelRows(output.height, output.width, [&](size_t begin, size_t end)
+	{
+		for( size_t y=begin; y < end; y++ )
+		{
+			T* row = output.Row(y);
+
+			if( y < t.top || y >= bottom )
+			{
+				std::fill(row, row + output.width, padding);
+				continue;
+			}
+
+			std::fill(row, row + t.left, padding);
+			std::fill(row + right, row + output.width, padding);
+		}
+	});
+
+	return true;
+}
+
+
+// cpuLetterbox
+bool cpuLetterbox( const ImageView<uchar4>& input, const ImageView<uchar4>& output, resizeFilter filter, const uchar4& padding, letterboxTransform* transform )
+{
+	TRACE_SCOPE("cpuLetterbox");
+	return letterbox(input, output, filter, padding, transform);
+}
+
+bool cpuLetterbox( const ImageView<float4>& input, const ImageView<float4>& output, resizeFilter filter, const float4& padding, letterboxTransform* transform )
+{
+	TRACE_SCOPE("cpuLetterbox");
+	return letterbox(input, output, filter, padding, transform);
+}
+
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuMosaic.h"
+#include "cpuResize.h"
+#include "cpuYUV.h"
+#include "cudaResize-Filter.h"
+#include "trace.h"
+
+#include <vector>
+
+
+// mosaicCheck
+//  check every tile first, so an invalid one doesn't leave the mosaic half-done
+template <typename T>
+static bool mosaicCheck( const ImageView<T>* inputs, uint32_t count, uint32_t width, uint32_t height, bool even, resizeFilter filter )
+{
+	if( !inputs || count == 0 || count > MOSAIC_MAX_TILES || width == 0 || height == 0 || filter > RESIZE_AREA )
+		return false;
+
+	for( uint32_t n=0; n < count; n++ )
+	{
+		if( !inputs[n].ptr )
+			continue;
+
+		const mosaicTile t = mosaicTileRect(n, count, width, height, even);
+
+		if( !inputs[n].IsValid() || t.width == 0 || t.height == 0 )
+			return false;
+
+		if( filter == RESIZE_AREA && !resizeAreaValid(inputs[n].width, inputs[n].height, t.width, t.height) )
+			return false;
+	}
+
+	return true;
+}
+
+
+// mosaic
+//  each tile is resized into its crop of the output, the tiles without a new frame are skipped
+template <typename T>
+static bool mosaic( const ImageView<T>* inputs, uint32_t count, const ImageView<T>& output, resizeFilter filter )
+{
+	if( !output.IsValid() || !mosaicCheck(inputs, count, output.width, output.height, false, filter) )
+		return false;
+
+	for( uint32_t n=0; n < count; n++ )
+	{
+		if( !inputs[n].ptr )
+			continue;
+
+		const mosaicTile t = mosaicTileRect(n, count, output.width, output.height);
+
+		if( !cpuResize(inputs[n], output.Crop(t.left, t.top, t.width, t.height), filter) )
+			return false;
+	}
+
+	return true;
+}
+
+
+// mosaicNV12
+//  each tile is resized into a scratch image, which is then encoded into the tile
+template <typename T>
+static bool mosaicNV12( const ImageView<T>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height,
+				    imageFormat format, resizeFilter filter, const yuvColorimetry& colorimetry )
+{
+	if( !output || (width & 1) || (height & 1) || outputPitch < width || !mosaicCheck(inputs, count, width, height, true, filter) )
+		return false;
+
+	std::vector<T> scratch;
+
+	for( uint32_t n=0; n < count; n++ )
+	{
+		if( !inputs[n].ptr )
+			continue;
+
+		const mosaicTile t = mosaicTileRect(n, count, width, height, true);
+		scratch.resize(size_t(t.width) * t.height);
+
+		if( !cpuResize(inputs[n], ImageView<T>(&scratch[0], t.width, t.height), filter) )
+			return false;
+
+		if( !cpuFormatToNV12Rect(&scratch[0], t.width * sizeof(T), format, output, outputPitch, height, t.left, t.top, t.width, t.height, colorimetry) )
+			return false;
+	}
+
+	return true;
+}
+
+
+// cpuMosaic
+bool cpuMosaic( const ImageView<uchar4>* inputs, uint32_t count, const ImageView<uchar4>& output, resizeFilter filter )
+{
+	TRACE_SCOPE("cpuMosaic");
+	return mosaic(inputs, count, output, filter);
+}
+
+bool cpuMosaic( const ImageView<float4>* inputs, uint32_t count, const ImageView<float4>& output, resizeFilter filter )
+{
+	TRACE_SCOPE("cpuMosaic");
+	return mosaic(inputs, count, output, filter);
+}
+
+
+// cpuMosaicNV12
+bool cpuMosaicNV12( const ImageView<uchar4>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height,
+				resizeFilter filter, const yuvColorimetry& colorimetry )
+{
+	TRACE_SCOPE("cpuMosaicNV12");
+	return mosaicNV12(inputs, count, output, outputPitch, width, height, IMAGE_RGBA8, filter, colorimetry);
+}
+
+bool cpuMosaicNV12( const ImageView<float4>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height,
+				resizeFilter filter, const yuvColorimetry& colorimetry )
+{
+	TRACE_SCOPE("cpuMosaicNV12");
+	return mosaicNV12(inputs, count, output, outputPitch, width, height, IMAGE_RGBA32F, filter, colorimetry);
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+ 
+
+#include "cpuNormalize-row.h"
+
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+
+// load 8 pixels as r, g and b vectors of 4 pixels each
+static inline void load8( imageFormat format, const void* input, size_t x, float32x4_t* r, float32x4_t* g, float32x4_t* b )
+{
+	if( format == IMAGE_RGBA8 )
+	{
+		const uint8x8x4_t px = vld4_u8((const uint8_t*)input + x * 4);
+
+		const uint16x8_t r16 = vmovl_u8(px.val[0]);
+		const uint16x8_t g16 = vmovl_u8(px.val[1]);
+		const uint16x8_t b16 = vmovl_u8(px.val[2]);
+
+		r[0] = vcvtq_f32_u32(vmovl_u16(vget_low_u16(r16)));   r[1] = vcvtq_f32_u32(vmovl_u16(vget_high_u16(r16)));
+		g[0] = vcvtq_f32_u32(vmovl_u16(vget_low_u16(g16)));   g[1] = vcvtq_f32_u32(vmovl_u16(vget_high_u16(g16)));
+		b[0] = vcvtq_f32_u32(vmovl_u16(vget_low_u16(b16)));   b[1] = vcvtq_f32_u32(vmovl_u16(vget_high_u16(b16)));
+	}
+	else
+	{
+		for( int n=0; n < 2; n++ )
+		{
+			const float32x4x4_t px = vld4q_f32((const float*)input + (x + n * 4) * 4);
+
+			r[n] = px.val[0];
+			g[n] = px.val[1];
+			b[n] = px.val[2];
+		}
+	}
+}
+
+#if defined(__aarch64__)
+// tensorQuantize() for 8 values, vmaxnm / vminnm handle NaN the same as fmaxf() / fminf()
+static inline int8x8_t quantize8( float32x4_t lo, float32x4_t hi, float invScale, float zeroPoint )
+{
+	const float32x4_t zp  = vdupq_n_f32(zeroPoint);
+	const float32x4_t min = vdupq_n_f32(-128.0f);
+	const float32x4_t max = vdupq_n_f32(127.0f);
+
+	lo = vminnmq_f32(vmaxnmq_f32(vaddq_f32(vrndnq_f32(vmulq_n_f32(lo, invScale)), zp), min), max);
+	hi = vminnmq_f32(vmaxnmq_f32(vaddq_f32(vrndnq_f32(vmulq_n_f32(hi, invScale)), zp), min), max);
+
+	return vmovn_s16(vcombine_s16(vmovn_s32(vcvtq_s32_f32(lo)), vmovn_s32(vcvtq_s32_f32(hi))));
+}
+#endif
+
+
+// cpuNormalizeRowNEON
+size_t cpuNormalizeRowNEON( const tensorWriter& w, imageFormat format, const void* input, void* output, uint32_t y )
+{
+	if( w.format == TENSOR_FORMAT_FP16 )
+		return 0;
+
+#if !defined(__aarch64__)
+	if( w.format == TENSOR_FORMAT_INT8 )
+		return 0;	// no round-to-nearest-even or IEEE min/max on ARMv7
+#endif
+
+	const size_t width = w.width;
+	const size_t plane = size_t(w.width) * w.height;
+	const size_t row   = size_t(y) * width;
+
+	size_t x = 0;
+
+	for( ; x + 8 <= width; x += 8 )
+	{
+		float32x4_t r[2], g[2], b[2];
+		load8(format, input, x, r, g, b);
+
+		// tensorNormalize(), the multiply isn't fused with the subtract
+		float32x4_t c[3][2];
+
+		for( int n=0; n < 2; n++ )
+		{
+			r[n] = vmulq_n_f32(vsubq_f32(r[n], vdupq_n_f32(w.mean.x)), w.mult.x);
+			g[n] = vmulq_n_f32(vsubq_f32(g[n], vdupq_n_f32(w.mean.y)), w.mult.y);
+			b[n] = vmulq_n_f32(vsubq_f32(b[n], vdupq_n_f32(w.mean.z)), w.mult.z);
+
+			c[0][n] = w.bgr ? b[n] : r[n];
+			c[1][n] = g[n];
+			c[2][n] = w.bgr ? r[n] : b[n];
+		}
+
+		if( w.format == TENSOR_FORMAT_FP32 )
+		{
+			float* dst = (float*)output;
+
+			for( int n=0; n < 2; n++ )
+			{
+				if( w.layout == TENSOR_LAYOUT_CHW )
+				{
+					for( int k=0; k < 3; k++ )
+						vst1q_f32(dst + plane * k + row + x + n * 4, c[k][n]);
+				}
+				else
+				{
+					float32x4x3_t px;
+
+					px.val[0] = c[0][n];
+					px.val[1] = c[1][n];
+					px.val[2] = c[2][n];
+
+					vst3q_f32(dst + (row + x + n * 4) * 3, px);
+				}
+			}
+		}
+#if defined(__aarch64__)
+		else
+		{
+			int8_t* dst = (int8_t*)output;
+
+			if( w.layout == TENSOR_LAYOUT_CHW )
+			{
+				for( int k=0; k < 3; k++ )
+					vst1_s8(dst + plane * k + row + x, quantize8(c[k][0], c[k][1], w.invInt8Scale, w.int8ZeroPoint));
+			}
+			else
+			{
+				int8x8x3_t px;
+
+				for( int k=0; k < 3; k++ )
+					px.val[k] = quantize8(c[k][0], c[k][1], w.invInt8Scale, w.int8ZeroPoint);
+
+				vst3_s8(dst + (row + x) * 3, px);
+			}
+		}
+#endif
+	}
+
+	return x;
+}
+
+#else
+
+size_t cpuNormalizeRowNEON( const tensorWriter& w, imageFormat format, const void* input, void* output, uint32_t y )
+{
+	return 0;
+}
+
+#endif
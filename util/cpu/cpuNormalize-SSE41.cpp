@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+ 
+
+#include "cpuNormalize-row.h"
+
+#include <string.h>
+
+
+#if defined(__SSE4_1__)
+
+#include <smmintrin.h>
+
+
+// load 4 pixels as (r,g,b,a) vectors
+static inline void load4( imageFormat format, const void* input, size_t x, __m128* px )
+{
+	if( format == IMAGE_RGBA8 )
+	{
+		const __m128i v = _mm_loadu_si128((const __m128i*)((const uint32_t*)input + x));
+
+		px[0] = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(v));
+		px[1] = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 4)));
+		px[2] = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+		px[3] = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 12)));
+	}
+	else
+	{
+		const float* src = (const float*)input + x * 4;
+
+		px[0] = _mm_loadu_ps(src);
+		px[1] = _mm_loadu_ps(src + 4);
+		px[2] = _mm_loadu_ps(src + 8);
+		px[3] = _mm_loadu_ps(src + 12);
+	}
+}
+
+// tensorQuantize() for 4 values
+static inline __m128i quantize4( __m128 v, __m128 invScale, __m128 zeroPoint )
+{
+	v = _mm_add_ps(_mm_round_ps(_mm_mul_ps(v, invScale), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), zeroPoint);
+
+	// maxps returns its second operand for NaN, the same as fmaxf()
+	v = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-128.0f)), _mm_set1_ps(127.0f));
+
+	return _mm_cvtps_epi32(v);
+}
+
+// low 4 bytes of 4 quantized values
+static inline int32_t pack4( __m128i q )
+{
+	const __m128i w = _mm_packs_epi32(q, q);
+	return _mm_cvtsi128_si32(_mm_packs_epi16(w, w));
+}
+
+
+// cpuNormalizeRowSSE41
+size_t cpuNormalizeRowSSE41( const tensorWriter& w, imageFormat format, const void* input, void* output, uint32_t y )
+{
+	if( w.format == TENSOR_FORMAT_FP16 )
+		return 0;
+
+	// the means and multipliers in the order of the tensor channels (tensorNormalize)
+	const __m128 mean = w.bgr ? _mm_setr_ps(w.mean.z, w.mean.y, w.mean.x, 0.0f) : _mm_setr_ps(w.mean.x, w.mean.y, w.mean.z, 0.0f);
+	const __m128 mult = w.bgr ? _mm_setr_ps(w.mult.z, w.mult.y, w.mult.x, 0.0f) : _mm_setr_ps(w.mult.x, w.mult.y, w.mult.z, 0.0f);
+
+	const __m128 invScale  = _mm_set1_ps(w.invInt8Scale);
+	const __m128 zeroPoint = _mm_set1_ps(w.int8ZeroPoint);
+
+	const size_t width = w.width;
+	const size_t plane = size_t(w.width) * w.height;
+	const size_t row   = size_t(y) * width;
+
+	size_t x = 0;
+
+	for( ; x + 4 <= width; x += 4 )
+	{
+		__m128 px[4];
+		load4(format, input, x, px);
+
+		for( int n=0; n < 4; n++ )
+		{
+			if( w.bgr )
+				px[n] = _mm_shuffle_ps(px[n], px[n], _MM_SHUFFLE(3, 0, 1, 2));
+
+			px[n] = _mm_mul_ps(_mm_sub_ps(px[n], mean), mult);
+		}
+
+		if( w.layout == TENSOR_LAYOUT_CHW )
+		{
+			// channels of the 4 pixels, px[3] is the unused alpha
+			_MM_TRANSPOSE4_PS(px[0], px[1], px[2], px[3]);
+
+			if( w.format == TENSOR_FORMAT_FP32 )
+			{
+				float* dst = (float*)output + row + x;
+
+				_mm_storeu_ps(dst, px[0]);
+				_mm_storeu_ps(dst + plane, px[1]);
+				_mm_storeu_ps(dst + plane * 2, px[2]);
+			}
+			else
+			{
+				int8_t* dst = (int8_t*)output + row + x;
+
+				for( int c=0; c < 3; c++ )
+				{
+					const int32_t q = pack4(quantize4(px[c], invScale, zeroPoint));
+					memcpy(dst + plane * c, &q, sizeof(q));
+				}
+			}
+		}
+		else
+		{
+			// interleave the first 3 channels of the 4 pixels into 12 elements
+			const __m128 v0 = _mm_blend_ps(px[0], _mm_shuffle_ps(px[1], px[1], _MM_SHUFFLE(0, 0, 0, 0)), 0x8);
+			const __m128 v1 = _mm_shuffle_ps(px[1], px[2], _MM_SHUFFLE(1, 0, 2, 1));
+			const __m128 v2 = _mm_blend_ps(_mm_shuffle_ps(px[3], px[3], _MM_SHUFFLE(2, 1, 0, 0)), _mm_shuffle_ps(px[2], px[2], _MM_SHUFFLE(2, 2, 2, 2)), 0x1);
+
+			if( w.format == TENSOR_FORMAT_FP32 )
+			{
+				float* dst = (float*)output + (row + x) * 3;
+
+				_mm_storeu_ps(dst, v0);
+				_mm_storeu_ps(dst + 4, v1);
+				_mm_storeu_ps(dst + 8, v2);
+			}
+			else
+			{
+				const __m128i q01 = _mm_packs_epi32(quantize4(v0, invScale, zeroPoint), quantize4(v1, invScale, zeroPoint));
+				const __m128i q2  = quantize4(v2, invScale, zeroPoint);
+				const __m128i q   = _mm_packs_epi16(q01, _mm_packs_epi32(q2, q2));
+
+				int8_t* dst = (int8_t*)output + (row + x) * 3;
+				const int32_t last = _mm_extract_epi32(q, 2);
+
+				_mm_storel_epi64((__m128i*)dst, q);
+				memcpy(dst + 8, &last, sizeof(last));
+			}
+		}
+	}
+
+	return x;
+}
+
+#else
+
+size_t cpuNormalizeRowSSE41( const tensorWriter& w, imageFormat format, const void* input, void* output, uint32_t y )
+{
+	return 0;
+}
+
+#endif
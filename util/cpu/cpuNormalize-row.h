@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+ 
+
+#ifndef __CPU_NORMALIZE_ROW_H
+#define __CPU_NORMALIZE_ROW_H
+
+
+#include "cudaTensor.h"
+#include "imageFormat.h"
+
+
+/*
+ * Internal to cpuNormalize.cpp:  SIMD row kernels of the tensor normalization
+ * (cudaNormalizeRGBA() with tensorParams).  They convert row y of the image, whose
+ * pixels start at input and are IMAGE_RGBA8 (uchar4) or IMAGE_RGBA32F (float4),
+ * into the tensor at output, and return
+ * the number of leading pixels they converted (a multiple of 4 or 8).  The rest of
+ * the row is finished with tensorWriteRGB().
+ *
+ * FP32 and INT8 are vectorized, FP16 is scalar only (the kernels return 0),
+ * and they return 0 when the instruction set wasn't compiled in.  The AVX2
+ * level uses the SSE4.1 kernel, the op is bound by memory.
+ */
+size_t cpuNormalizeRowSSE41( const tensorWriter& w, imageFormat format, const void* input, void* output, uint32_t y );
+size_t cpuNormalizeRowNEON( const tensorWriter& w, imageFormat format, const void* input, void* output, uint32_t y );
+
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuNormalize.h"
+#include "cpuNormalize-row.h"
+#include "cpuFeatures.h"
+#include "cpuThreadPool.h"
+#include "trace.h"
+
+
+// cpuNormalizeRGBA
+bool cpuNormalizeRGBA( const ImageView<float4>& input, const float2& input_range,
+				   const ImageView<float4>& output, const float2& output_range )
+{
+	TRACE_SCOPE("cpuNormalizeRGBA");
+
+	if( !input.IsValid() || !output.IsValid() || input.width != output.width || input.height != output.height || input_range.x == input_range.y )
+		return false;
+
+	const float inputMin   = input_range.x;
+	const float outputMin  = output_range.x;
+	const float multiplier = (output_range.y - output_range.x) / (input_range.y - input_range.x);
+
+	// packed images are processed as one span per chunk of rows, views row by row
+	const bool   packed = input.IsPacked() && output.IsPacked();
+	const size_t width  = output.width;
+
+	cpuParallelRows(output.height, width, [&](size_t begin, size_t end)
+	{
+		const size_t rows  = packed ? 1 : (end - begin);
+		const size_t count = (packed ? (end - begin) : 1) * width * 4;
+
+		for( size_t y=0; y < rows; y++ )
+		{
+			// operate on the flat float array so the loop vectorizes
+			const float* src = (float*)input.Row(begin + y);
+			float* dst = (float*)output.Row(begin + y);
+
+			for( size_t n=0; n < count; n++ )
+				dst[n] = (src[n] - inputMin) * multiplier + outputMin;
+		}
+	});
+
+	return true;
+}
+
+
+// cpuNormalizeRowSIMD
+//  run the SIMD row kernel of the ISA, returning the number of pixels it converted
+static inline size_t cpuNormalizeRowSIMD( cpuISA isa, const tensorWriter& w, imageFormat format, const void* input, void* output, uint32_t y )
+{
+	if( isa == CPU_ISA_AVX2 || isa == CPU_ISA_SSE41 )
+		return cpuNormalizeRowSSE41(w, format, input, output, y);
+	else if( isa == CPU_ISA_NEON )
+		return cpuNormalizeRowNEON(w, format, input, output, y);
+
+	return 0;
+}
+
+
+// convertNormalize
+template <typename T>
+struct convertNormalize
+{
+	const tensorWriter writer;
+	const ImageView<T>& input;
+	void* output;
+
+	convertNormalize( const tensorWriter& w, const ImageView<T>& in, void* out ) : writer(w), input(in), output(out)	{ }
+
+	template<tensorFormat format, tensorLayout layout>
+	void run()
+	{
+		const cpuISA isa = cpuGetISA();
+		const imageFormat inputFormat = (sizeof(T) == sizeof(uchar4)) ? IMAGE_RGBA8 : IMAGE_RGBA32F;
+
+		cpuParallelRows(writer.height, writer.width, [&](size_t begin, size_t end)
+		{
+			for( size_t y=begin; y < end; y++ )
+			{
+				const T* row = input.Row(y);
+				uint32_t x = cpuNormalizeRowSIMD(isa, writer, inputFormat, row, output, y);
+
+				for( ; x < writer.width; x++ )
+				{
+					float r, g, b;
+					tensorPixelRGB(row[x], r, g, b);
+					tensorWriteRGB<format, layout>(writer, output, x, y, r, g, b);
+				}
+			}
+		});
+	}
+};
+
+
+// normalizeTensor
+template <typename T>
+static bool normalizeTensor( const ImageView<T>& input, void* output, const tensorParams& params )
+{
+	if( !input.ptr || !output || !input.IsValid() || input.width != params.width || input.height != params.height )
+		return false;
+
+	if( params.scale == 0.0f || params.stdDev.x == 0.0f || params.stdDev.y == 0.0f || params.stdDev.z == 0.0f || params.int8Scale == 0.0f )
+		return false;
+
+	convertNormalize<T> convert(tensorWriterInit(params, params.width, params.height), input, output);
+	tensorDispatch(convert.writer, convert);
+
+	return true;
+}
+
+
+// cpuNormalizeRGBA (tensor)
+bool cpuNormalizeRGBA( const ImageView<uchar4>& input, void* output, const tensorParams& params )
+{
+	TRACE_SCOPE("cpuNormalizeRGBA");
+	return normalizeTensor(input, output, params);
+}
+
+bool cpuNormalizeRGBA( const ImageView<float4>& input, void* output, const tensorParams& params )
+{
+	TRACE_SCOPE("cpuNormalizeRGBA");
+	return normalizeTensor(input, output, params);
+}
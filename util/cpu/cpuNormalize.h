@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CPU_NORMALIZE_H__
+#define __CPU_NORMALIZE_H__
+
+
+#include "cudaUtility.h"
+#include "cudaTensor.h"
+#include "imageView.h"
+
+
+/**
+ * CPU equivalent of cudaNormalizeRGBA().
+ * @ingroup util
+ */
+bool cpuNormalizeRGBA( const ImageView<float4>& input,  const float2& input_range,
+				   const ImageView<float4>& output, const float2& output_range );
+
+
+/**
+ * CPU equivalent of cudaNormalizeRGBA().
+ * @ingroup util
+ */
+inline bool cpuNormalizeRGBA( float4* input,  const float2& input_range,
+					     float4* output, const float2& output_range,
+					     size_t  width,  size_t height )
+{
+	return cpuNormalizeRGBA(ImageView<float4>(input, width, height), input_range, ImageView<float4>(output, width, height), output_range);
+}
+
+
+/**
+ * CPU equivalent of cudaNormalizeRGBA() into a tensor, bit-exact with the CUDA kernels.
+ * FP32 and INT8 rows are converted with SSE4.1 or NEON (see cpuGetISA()), FP16 is scalar.
+ * @ingroup util
+ */
+bool cpuNormalizeRGBA( const ImageView<uchar4>& input, void* output, const tensorParams& params );
+bool cpuNormalizeRGBA( const ImageView<float4>& input, void* output, const tensorParams& params );
+
+
+#endif
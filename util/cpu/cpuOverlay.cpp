@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuOverlay.h"
+#include "cpuThreadPool.h"
+#include "cudaColorspace.h"
+#include "trace.h"
+
+#include <string.h>
+
+
+// cpuRectOutlineOverlay
+bool cpuRectOutlineOverlay( const ImageView<float4>& input, const ImageView<float4>& output, float4* boundingBoxes, int numBoxes, const float4& color )
+{
+	TRACE_SCOPE("cpuRectOutlineOverlay");
+
+	if( !input.IsValid() || !output.IsValid() || !boundingBoxes || numBoxes == 0 )
+		return false;
+
+	if( input.width != output.width || input.height != output.height )
+		return false;
+
+	const uint32_t width  = output.width;
+	const uint32_t height = output.height;
+
+	const float alpha = color.w / 255.0f;
+	const float ialph = 1.0f - alpha;
+
+	cpuParallelRows(height, width, [&](size_t begin, size_t end)
+	{
+		for( size_t y=begin; y < end; y++ )
+		{
+			const float fy = y;
+
+			const float4* src = input.Row(y);
+			float4* dst = output.Row(y);
+
+			if( src != dst )
+				memcpy(dst, src, width * sizeof(float4));
+
+			// blend each box in order, over the span of the row it covers
+			for( int nr=0; nr < numBoxes; nr++ )
+			{
+				const float4 r = boundingBoxes[nr];
+
+				if( fy < r.y || fy > r.w )
+					continue;
+
+				for( uint32_t x=0; x < width; x++ )
+				{
+					const float fx = x;
+
+					if( fx < r.x || fx > r.z )
+						continue;
+
+					dst[x].x = colorBlend(color.x, dst[x].x, alpha, ialph);
+					dst[x].y = colorBlend(color.y, dst[x].y, alpha, ialph);
+					dst[x].z = colorBlend(color.z, dst[x].z, alpha, ialph);
+				}
+			}
+		}
+	});
+
+	return true;
+}
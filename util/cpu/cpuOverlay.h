@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CPU_OVERLAY_H__
+#define __CPU_OVERLAY_H__
+
+#include "cudaUtility.h"
+#include "imageView.h"
+
+
+/**
+ * CPU equivalent of cudaRectOutlineOverlay(), bit-exact with the CUDA kernel.
+ * @ingroup util
+ */
+bool cpuRectOutlineOverlay( const ImageView<float4>& input, const ImageView<float4>& output, float4* boundingBoxes, int numBoxes, const float4& color );
+
+
+/**
+ * CPU equivalent of cudaRectOutlineOverlay(), bit-exact with the CUDA kernel.
+ * @ingroup util
+ */
+inline bool cpuRectOutlineOverlay( float4* input, float4* output, uint32_t width, uint32_t height, float4* boundingBoxes, int numBoxes, const float4& color )
+{
+	return cpuRectOutlineOverlay(ImageView<float4>(input, width, height), ImageView<float4>(output, width, height), boundingBoxes, numBoxes, color);
+}
+
+
+#endif
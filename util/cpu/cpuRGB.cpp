@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuRGB.h"
+#include "cpuThreadPool.h"
+#include "trace.h"
+
+
+// cpuRGBToRGBAf
+bool cpuRGBToRGBAf( uchar3* input, float4* output, size_t width, size_t height )
+{
+	TRACE_SCOPE("cpuRGBToRGBAf");
+
+	if( !input || !output || width == 0 || height == 0 )
+		return false;
+
+	cpuParallelRows(height, width, [&](size_t begin, size_t end)
+	{
+		const size_t last = end * width;
+
+		for( size_t n=begin * width; n < last; n++ )
+		{
+			const uchar3 px = input[n];
+			output[n] = make_float4(px.x, px.y, px.z, 255.0f);
+		}
+	});
+
+	return true;
+}
+
+
+// convertRGB
+template<imageFormat format>
+static void convertRGB( uchar3* input, void* output, size_t width, size_t height )
+{
+	cpuParallelRows(height, width, [&](size_t begin, size_t end)
+	{
+		for( size_t y=begin; y < end; y++ )
+		{
+			const uchar3* src = input + y * width;
+			uint8_t* dst = (uint8_t*)output + y * width * imageFormatSize(format);
+
+			for( size_t x=0; x < width; x++ )
+				imageStoreRGB8<format>(dst, x, src[x]);
+		}
+	});
+}
+
+
+// cpuRGBToFormat
+bool cpuRGBToFormat( uchar3* input, void* output, size_t width, size_t height, imageFormat format )
+{
+	TRACE_SCOPE("cpuRGBToFormat");
+
+	if( !input || !output || width == 0 || height == 0 )
+		return false;
+
+	switch(format)
+	{
+		case IMAGE_RGBA32F:	convertRGB<IMAGE_RGBA32F>(input, output, width, height); return true;
+		case IMAGE_RGBA16F:	convertRGB<IMAGE_RGBA16F>(input, output, width, height); return true;
+		case IMAGE_RGBA8:	convertRGB<IMAGE_RGBA8>(input, output, width, height);   return true;
+		case IMAGE_RGB8:	convertRGB<IMAGE_RGB8>(input, output, width, height);    return true;
+		case IMAGE_BGR8:	convertRGB<IMAGE_BGR8>(input, output, width, height);    return true;
+	}
+
+	return false;
+}
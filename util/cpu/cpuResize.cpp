@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuResize.h"
+#include "cpuThreadPool.h"
+#include "cudaResize-Filter.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <vector>
+
+
+// resize (samples the same source pixels as gpuResize)
+template <typename T>
+static bool resize( const ImageView<T>& input, const ImageView<T>& output )
+{
+	if( !input.IsValid() || !output.IsValid() )
+		return false;
+
+	const float2 scale = make_float2( float(input.width) / float(output.width),
+							    float(input.height) / float(output.height) );
+
+	cpuParallelRows(output.height, output.width, [&](size_t begin, size_t end)
+	{
+		for( size_t y=begin; y < end; y++ )
+		{
+			const int dy = ((float)y * scale.y);
+
+			const T* src = input.Row(dy);
+			T* dst = output.Row(y);
+
+			for( size_t x=0; x < output.width; x++ )
+			{
+				const int dx = ((float)x * scale.x);
+				dst[x] = src[dx];
+			}
+		}
+	});
+
+	return true;
+}
+
+
+// cpuResize
+bool cpuResize( const ImageView<float>& input, const ImageView<float>& output )
+{
+	TRACE_SCOPE("cpuResize");
+	return resize<float>(input, output);
+}
+
+
+// cpuResizeRGBA
+bool cpuResizeRGBA( const ImageView<float4>& input, const ImageView<float4>& output )
+{
+	TRACE_SCOPE("cpuResizeRGBA");
+	return resize<float4>(input, output);
+}
+
+
+// resizeLinear
+//  the rows of source pixels are blended horizontally once (each is used by
+//  up to two consecutive output rows), then each output row blends two of them
+template <typename T>
+static void resizeLinear( const ImageView<T>& input, const ImageView<T>& output )
+{
+	typedef typename resizePixel<T>::scalar S;
+	typedef typename resizePixel<T>::accum A;
+	const int C = resizePixel<T>::channels;
+
+	const uint32_t width = output.width;
+
+	// source columns and weight of each output column
+	std::vector<uint32_t> cols(width * 3);
+
+	for( uint32_t x=0; x < width; x++ )
+	{
+		resizeLinearRange(x, width, input.width, cols[x*3], cols[x*3+1], cols[x*3+2]);
+		cols[x*3]   *= C;
+		cols[x*3+1] *= C;
+	}
+
+	cpuParallelRows(output.height, width, [&](size_t begin, size_t end)
+	{
+		// local sizes, as the stores of uint8 pixels could alias the captures
+		const uint32_t outputWidth = width;
+		const uint32_t rowSize = width * C;
+		const uint32_t* blendCols = &cols[0];
+
+		std::vector<A> buffer(rowSize * 2);
+
+		A* rows[2] = { &buffer[0], &buffer[rowSize] };
+		int64_t rowIndex[2] = { -1, -1 };
+
+		// horizontal pass of source row y
+		auto blendRow = [&]( uint32_t y, A* dst )
+		{
+			const S* src = (const S*)input.Row(y);
+
+			for( uint32_t x=0; x < outputWidth; x++ )
+			{
+				const uint32_t* c = blendCols + x * 3;
+
+				for( int n=0; n < C; n++ )
+					dst[x*C+n] = resizeLinearH(src[c[0]+n], src[c[1]+n], c[2]);
+			}
+		};
+
+		for( size_t y=begin; y < end; y++ )
+		{
+			uint32_t y0, y1, wy;
+			resizeLinearRange(y, output.height, input.height, y0, y1, wy);
+
+			if( rowIndex[0] != y0 )
+			{
+				if( rowIndex[1] == y0 )
+				{
+					std::swap(rows[0], rows[1]);
+					std::swap(rowIndex[0], rowIndex[1]);
+				}
+				else
+				{
+					blendRow(y0, rows[0]);
+					rowIndex[0] = y0;
+				}
+			}
+
+			if( rowIndex[1] != y1 )
+			{
+				blendRow(y1, rows[1]);
+				rowIndex[1] = y1;
+			}
+
+			// vertical pass
+			const A* h0 = rows[0];
+			const A* h1 = rows[1];
+			S* dst = (S*)output.Row(y);
+
+			for( uint32_t n=0; n < rowSize; n++ )
+				dst[n] = resizeLinearV(h0[n], h1[n], wy);
+		}
+	});
+}
+
+
+// resizeArea
+//  the box rows are added into column sums over the whole input row (which
+//  vectorizes), then each output pixel adds up the columns of its box.
+//  With an integer ratio the box size is a constant, so the loops unroll.
+template <typename T, int ratio>
+static void resizeArea( const ImageView<T>& input, const ImageView<T>& output )
+{
+	typedef typename resizePixel<T>::scalar S;
+	typedef typename resizePixel<T>::accum A;
+	const int C = resizePixel<T>::channels;
+
+	const uint32_t width = output.width;
+
+	// source columns [begin, end) of each output column
+	std::vector<uint32_t> cols(width * 2);
+
+	for( uint32_t x=0; x < width; x++ )
+	{
+		if( ratio != 0 )
+		{
+			cols[x*2]   = x * ratio;
+			cols[x*2+1] = x * ratio + ratio;
+		}
+		else
+		{
+			lumaBoxRange(x, width, input.width, cols[x*2], cols[x*2+1]);
+		}
+	}
+
+	cpuParallelRows(output.height, width, [&](size_t begin, size_t end)
+	{
+		// local sizes, as the stores of uint8 pixels could alias the captures
+		const uint32_t outputWidth = width;
+		const uint32_t inputWidth = input.width * C;
+		const uint32_t* boxCols = &cols[0];
+
+		std::vector<A> buffer(inputWidth);
+		A* colSum = &buffer[0];
+
+		for( size_t y=begin; y < end; y++ )
+		{
+			uint32_t y0, y1;
+
+			if( ratio != 0 )
+			{
+				y0 = y * ratio;
+				y1 = y0 + ratio;
+			}
+			else
+			{
+				lumaBoxRange(y, output.height, input.height, y0, y1);
+			}
+
+			// vertical pass
+			for( uint32_t n=0; n < inputWidth; n++ )
+				colSum[n] = 0;
+
+			for( uint32_t sy=y0; sy < y1; sy++ )
+			{
+				const S* src = (const S*)input.Row(sy);
+
+				for( uint32_t n=0; n < inputWidth; n++ )
+					colSum[n] = resizeAreaAdd(colSum[n], src[n]);
+			}
+
+			// horizontal pass
+			S* dst = (S*)output.Row(y);
+
+			if( ratio != 0 )
+			{
+				for( uint32_t x=0; x < outputWidth; x++ )
+				{
+					const A* px = colSum + x * ratio * C;
+
+					for( int n=0; n < C; n++ )
+					{
+						A sum = 0;
+
+						for( int k=0; k < ratio; k++ )
+							sum = resizeAreaAdd(sum, px[k*C+n]);
+
+						resizeAreaStore(dst[x*C+n], sum, ratio * ratio);
+					}
+				}
+			}
+			else
+			{
+				for( uint32_t x=0; x < outputWidth; x++ )
+				{
+					const uint32_t x0 = boxCols[x*2];
+					const uint32_t x1 = boxCols[x*2+1];
+					const uint32_t area = (x1 - x0) * (y1 - y0);
+
+					for( int n=0; n < C; n++ )
+					{
+						A sum = 0;
+
+						for( uint32_t sx=x0; sx < x1; sx++ )
+							sum = resizeAreaAdd(sum, colSum[sx*C+n]);
+
+						resizeAreaStore(dst[x*C+n], sum, area);
+					}
+				}
+			}
+		}
+	});
+}
+
+
+// resizeFiltered
+template <typename T>
+static bool resizeFiltered( const ImageView<T>& input, const ImageView<T>& output, resizeFilter filter )
+{
+	if( !input.IsValid() || !output.IsValid() )
+		return false;
+
+	if( filter == RESIZE_NEAREST )
+		return resize<T>(input, output);
+
+	if( filter == RESIZE_BILINEAR )
+	{
+		resizeLinear<T>(input, output);
+		return true;
+	}
+
+	if( filter != RESIZE_AREA || !resizeAreaValid(input.width, input.height, output.width, output.height) )
+		return false;
+
+	switch( resizeAreaRatio(input.width, input.height, output.width, output.height) )
+	{
+		case 2:	 resizeArea<T, 2>(input, output); break;
+		case 3:	 resizeArea<T, 3>(input, output); break;
+		case 4:	 resizeArea<T, 4>(input, output); break;
+		default: resizeArea<T, 0>(input, output); break;
+	}
+
+	return true;
+}
+
+
+// cpuResize (filtered)
+bool cpuResize( const ImageView<uint8_t>& input, const ImageView<uint8_t>& output, resizeFilter filter )
+{
+	TRACE_SCOPE("cpuResize");
+	return resizeFiltered<uint8_t>(input, output, filter);
+}
+
+bool cpuResize( const ImageView<uchar4>& input, const ImageView<uchar4>& output, resizeFilter filter )
+{
+	TRACE_SCOPE("cpuResize");
+	return resizeFiltered<uchar4>(input, output, filter);
+}
+
+bool cpuResize( const ImageView<float>& input, const ImageView<float>& output, resizeFilter filter )
+{
+	TRACE_SCOPE("cpuResize");
+	return resizeFiltered<float>(input, output, filter);
+}
+
+bool cpuResize( const ImageView<float4>& input, const ImageView<float4>& output, resizeFilter filter )
+{
+	TRACE_SCOPE("cpuResize");
+	return resizeFiltered<float4>(input, output, filter);
+}
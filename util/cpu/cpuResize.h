@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CPU_RESIZE_H__
+#define __CPU_RESIZE_H__
+
+
+#include "cudaUtility.h"
+#include "cudaResize.h"
+#include "imageView.h"
+
+
+/**
+ * CPU equivalent of cudaResize() (nearest-neighbor, single-channel float).
+ * @ingroup util
+ */
+bool cpuResize( const ImageView<float>& input, const ImageView<float>& output );
+
+
+/**
+ * CPU equivalent of cudaResizeRGBA() (nearest-neighbor, float4).
+ * @ingroup util
+ */
+bool cpuResizeRGBA( const ImageView<float4>& input, const ImageView<float4>& output );
+
+
+/**
+ * CPU equivalent of the filtered cudaResize(), bit-exact with the CUDA kernels.
+ * Bilinear and area are separable, area downscales by 2, 3 and 4
+ * have specialized loops.
+ * @ingroup util
+ */
+bool cpuResize( const ImageView<uint8_t>& input, const ImageView<uint8_t>& output, resizeFilter filter );
+bool cpuResize( const ImageView<uchar4>& input, const ImageView<uchar4>& output, resizeFilter filter );
+bool cpuResize( const ImageView<float>& input, const ImageView<float>& output, resizeFilter filter );
+bool cpuResize( const ImageView<float4>& input, const ImageView<float4>& output, resizeFilter filter );
+
+
+/**
+ * CPU equivalent of cudaResize() (nearest-neighbor, single-channel float).
+ * @ingroup util
+ */
+inline bool cpuResize( float* input,  size_t inputWidth,  size_t inputHeight,
+				   float* output, size_t outputWidth, size_t outputHeight )
+{
+	return cpuResize(ImageView<float>(input, inputWidth, inputHeight), ImageView<float>(output, outputWidth, outputHeight));
+}
+
+
+/**
+ * CPU equivalent of cudaResizeRGBA() (nearest-neighbor, float4).
+ * @ingroup util
+ */
+inline bool cpuResizeRGBA( float4* input,  size_t inputWidth,  size_t inputHeight,
+				       float4* output, size_t outputWidth, size_t outputHeight )
+{
+	return cpuResizeRGBA(ImageView<float4>(input, inputWidth, inputHeight), ImageView<float4>(output, outputWidth, outputHeight));
+}
+
+
+#endif
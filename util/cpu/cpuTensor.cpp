@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuTensor.h"
+#include "cpuThreadPool.h"
+#include "trace.h"
+
+
+// convertTensor
+struct convertTensor
+{
+	const tensorWriter writer;
+	uint8_t* input;
+	size_t   inputPitch;
+	uint32_t inputHeight;
+	void*    output;
+
+	convertTensor( const tensorWriter& w, uint8_t* in, size_t pitch, uint32_t height, void* out ) : writer(w), input(in), inputPitch(pitch), inputHeight(height), output(out)	{ }
+
+	template<tensorFormat format, tensorLayout layout>
+	void run()
+	{
+		cpuParallelRows(writer.height, writer.width, [&](size_t begin, size_t end)
+		{
+			for( size_t y=begin; y < end; y++ )
+				for( uint32_t x=0; x < writer.width; x++ )
+					tensorWriteNV12<format, layout>(writer, input, inputPitch, inputHeight, output, x, y);
+		});
+	}
+};
+
+
+// cpuNV12ToTensor
+bool cpuNV12ToTensor( uint8_t* input, size_t inputPitch, size_t inputWidth, size_t inputHeight, void* output, const tensorParams& params )
+{
+	TRACE_SCOPE("cpuNV12ToTensor");
+
+	if( !input || !output || inputPitch == 0 || inputWidth == 0 || inputHeight == 0 || params.width == 0 || params.height == 0 )
+		return false;
+
+	if( params.scale == 0.0f || params.stdDev.x == 0.0f || params.stdDev.y == 0.0f || params.stdDev.z == 0.0f || params.int8Scale == 0.0f )
+		return false;
+
+	convertTensor convert(tensorWriterInit(params, inputWidth, inputHeight), input, inputPitch, inputHeight, output);
+	tensorDispatch(convert.writer, convert);
+
+	return true;
+}
+
+
+// convertROI
+template <typename T>
+struct convertROI
+{
+	const tensorWriter writer;
+	const ImageView<T>* frames;
+	uint32_t frameCount;
+	const tensorROI* rois;
+	uint32_t count;
+	uint8_t* output;
+
+	convertROI( const tensorWriter& w, const ImageView<T>* f, uint32_t fc, const tensorROI* r, uint32_t n, void* out ) : writer(w), frames(f), frameCount(fc), rois(r), count(n), output((uint8_t*)out)	{ }
+
+	template<tensorFormat format, tensorLayout layout>
+	void run()
+	{
+		const size_t size = size_t(writer.width) * writer.height * 3 * tensorFormatSize(format);
+
+		// rows of the whole batch, box n is rows n * height to (n + 1) * height
+		cpuParallelRows(size_t(count) * writer.height, writer.width, [&](size_t begin, size_t end)
+		{
+			for( size_t row=begin; row < end; row++ )
+			{
+				const size_t   n = row / writer.height;
+				const uint32_t y = row % writer.height;
+
+				if( rois[n].frame >= frameCount )
+					continue;
+
+				const ImageView<T> crop = tensorROICrop(frames[rois[n].frame], rois[n].box);
+
+				for( uint32_t x=0; x < writer.width; x++ )
+					tensorWriteROI<T, format, layout>(writer, crop, output + n * size, x, y);
+			}
+		});
+	}
+};
+
+
+// roiToTensor
+template <typename T>
+static bool roiToTensor( const ImageView<T>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count, void* output, const tensorParams& params )
+{
+	if( !frames || !rois || !output || frameCount == 0 || frameCount > TENSOR_ROI_MAX_FRAMES || params.width == 0 || params.height == 0 )
+		return false;
+
+	if( params.scale == 0.0f || params.stdDev.x == 0.0f || params.stdDev.y == 0.0f || params.stdDev.z == 0.0f || params.int8Scale == 0.0f )
+		return false;
+
+	for( uint32_t n=0; n < frameCount; n++ )
+	{
+		if( !frames[n].ptr || !frames[n].IsValid() )
+			return false;
+	}
+
+	convertROI<T> convert(tensorWriterInit(params, params.width, params.height), frames, frameCount, rois, count, output);
+	tensorDispatch(convert.writer, convert);
+
+	return true;
+}
+
+
+// cpuROIToTensor
+bool cpuROIToTensor( const ImageView<uchar4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count, void* output, const tensorParams& params )
+{
+	TRACE_SCOPE("cpuROIToTensor");
+	return roiToTensor(frames, frameCount, rois, count, output, params);
+}
+
+bool cpuROIToTensor( const ImageView<float4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count, void* output, const tensorParams& params )
+{
+	TRACE_SCOPE("cpuROIToTensor");
+	return roiToTensor(frames, frameCount, rois, count, output, params);
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CPU_TENSOR_H__
+#define __CPU_TENSOR_H__
+
+
+#include "cudaTensor.h"
+#include "cudaTensor-ROI.h"
+
+
+/**
+ * CPU equivalent of cudaNV12ToTensor(), bit-exact with the CUDA kernel.
+ * @ingroup util
+ */
+bool cpuNV12ToTensor( uint8_t* input, size_t inputPitch, size_t inputWidth, size_t inputHeight, void* output, const tensorParams& params );
+
+
+/**
+ * CPU equivalent of cudaROIToTensor(), bit-exact with the CUDA kernel.
+ * The rows of all of the tensors of the batch are split between the threads.
+ * @ingroup util
+ */
+bool cpuROIToTensor( const ImageView<uchar4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count, void* output, const tensorParams& params );
+bool cpuROIToTensor( const ImageView<float4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count, void* output, const tensorParams& params );
+
+
+#endif
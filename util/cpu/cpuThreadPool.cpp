@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuThreadPool.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+
+// set on threads that are executing a task, so that nested Run() calls don't deadlock
+static thread_local bool tInsideTask = false;
+
+
+// constructor
+cpuThreadPool::cpuThreadPool( uint32_t numThreads )
+{
+	mTask       = NULL;
+	mCount      = 0;
+	mChunk      = 0;
+	mNext       = 0;
+	mPending    = 0;
+	mGeneration = 0;
+	mShutdown   = false;
+
+	for( uint32_t n=1; n < numThreads; n++ )
+		mWorkers.push_back(std::thread(&cpuThreadPool::worker, this));
+}
+
+
+// destructor
+cpuThreadPool::~cpuThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mShutdown = true;
+	}
+
+	mWakeEvent.notify_all();
+
+	for( size_t n=0; n < mWorkers.size(); n++ )
+		mWorkers[n].join();
+}
+
+
+// Create
+cpuThreadPool* cpuThreadPool::Create( uint32_t numThreads )
+{
+	if( numThreads == 0 )
+		numThreads = std::thread::hardware_concurrency();
+
+	if( numThreads == 0 )
+		numThreads = 1;
+
+	return new cpuThreadPool(numThreads);
+}
+
+
+// Global
+cpuThreadPool* cpuThreadPool::Global()
+{
+	static cpuThreadPool* pool = NULL;
+	static std::once_flag flag;
+
+	std::call_once(flag, []()
+	{
+		const char* env = getenv("JETSON_CPU_THREADS");
+		uint32_t numThreads = 0;
+
+		if( env != NULL && *env != '\0' )
+		{
+			// anything that isn't a positive count falls back to the hardware concurrency
+			char* end = NULL;
+			const long value = strtol(env, &end, 10);
+
+			if( *end == '\0' && value > 0 && value <= 1024 )
+				numThreads = (uint32_t)value;
+			else
+				printf("cpuThreadPool -- ignoring invalid JETSON_CPU_THREADS=%s\n", env);
+		}
+
+		pool = Create(numThreads);
+	});
+
+	return pool;
+}
+
+
+// process
+bool cpuThreadPool::process()
+{
+	const task* func = NULL;
+	size_t begin = 0;
+	size_t end = 0;
+
+	// claim the next chunk (chunks are coarse, so the lock is cheap)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		if( mTask == NULL || mNext >= mCount )
+			return false;
+
+		func  = mTask;
+		begin = mNext;
+		end   = (begin + mChunk < mCount) ? begin + mChunk : mCount;
+		mNext = end;
+	}
+
+	tInsideTask = true;
+	(*func)(begin, end);
+	tInsideTask = false;
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	if( --mPending == 0 )
+		mDoneEvent.notify_all();
+
+	return true;
+}
+
+
+// worker
+void cpuThreadPool::worker()
+{
+	uint64_t generation = 0;
+
+	while( true )
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWakeEvent.wait(lock, [&]() { return mShutdown || mGeneration != generation; });
+
+			if( mShutdown )
+				return;
+
+			generation = mGeneration;
+		}
+
+		while( process() );
+	}
+}
+
+
+// Run
+void cpuThreadPool::Run( size_t count, const task& func, size_t minChunk )
+{
+	if( count == 0 )
+		return;
+
+	if( minChunk == 0 )
+		minChunk = 1;
+
+	// a few chunks per thread to balance the load
+	const size_t chunks = GetNumThreads() * 4;
+	size_t chunk = (count + chunks - 1) / chunks;
+
+	if( chunk < minChunk )
+		chunk = minChunk;
+
+	if( mWorkers.size() == 0 || chunk >= count || tInsideTask )
+	{
+		func(0, count);
+		return;
+	}
+
+	std::lock_guard<std::mutex> runLock(mRunMutex);
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		mTask    = &func;
+		mCount   = count;
+		mChunk   = chunk;
+		mNext    = 0;
+		mPending = (count + chunk - 1) / chunk;
+		mGeneration++;
+	}
+
+	mWakeEvent.notify_all();
+
+	while( process() );
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mDoneEvent.wait(lock, [&]() { return mPending == 0; });
+	mTask = NULL;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CPU_THREAD_POOL_H_
+#define __CPU_THREAD_POOL_H_
+
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Fixed-size pool of worker threads used by the CPU image kernels to split
+ * an image into bands of rows.  The calling thread works on the first band
+ * itself, and Run() returns once every band has been processed.
+ * @ingroup util
+ */
+class cpuThreadPool
+{
+public:
+	/**
+	 * Callback processing the range [begin, end).
+	 */
+	typedef std::function<void(size_t begin, size_t end)> task;
+
+	/**
+	 * Create a pool with the given number of threads, including the caller
+	 * (0 uses the number of CPU cores).
+	 */
+	static cpuThreadPool* Create( uint32_t numThreads=0 );
+
+	/**
+	 * The pool shared by the CPU kernels, sized from the JETSON_CPU_THREADS
+	 * environment variable or the number of CPU cores.
+	 */
+	static cpuThreadPool* Global();
+
+	/**
+	 * Destroy the pool, stopping the worker threads.
+	 */
+	~cpuThreadPool();
+
+	/**
+	 * Split [0, count) into chunks of at least minChunk items and process them in parallel.
+	 * Calls made from inside a task run serially on the calling thread.
+	 */
+	void Run( size_t count, const task& func, size_t minChunk=1 );
+
+	/**
+	 * Number of threads working on each Run(), including the caller.
+	 */
+	inline uint32_t GetNumThreads() const		{ return mWorkers.size() + 1; }
+
+private:
+	cpuThreadPool( uint32_t numThreads );
+
+	void worker();
+	bool process();
+
+	std::vector<std::thread> mWorkers;
+
+	std::mutex              mRunMutex;		// serializes Run() calls from different threads
+	std::mutex              mMutex;
+	std::condition_variable mWakeEvent;
+	std::condition_variable mDoneEvent;
+
+	const task*         mTask;
+	size_t              mCount;
+	size_t              mChunk;
+	size_t              mNext;
+	size_t              mPending;		// chunks not yet completed (protected by mMutex)
+	uint64_t            mGeneration;
+	bool                mShutdown;
+};
+
+
+/**
+ * Process the rows [0, height) of an image in parallel on the global pool,
+ * keeping at least ~16K pixels per chunk so that small images stay on the calling thread.
+ * @ingroup util
+ */
+inline void cpuParallelRows( size_t height, size_t width, const cpuThreadPool::task& func )
+{
+	const size_t minRows = (width > 0 && width < 16384) ? 16384 / width : 1;
+	cpuThreadPool::Global()->Run(height, func, minRows);
+}
+
+
+#endif
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuYUV-row.h"
+
+#include <string.h>
+
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+
+// yuvToRGBFixed() for 8 pixels
+static inline void yuvToRGB8( const yuvCoeffs& k, __m256i y, __m256i u, __m256i v, __m256i& r, __m256i& g, __m256i& b )
+{
+	const __m256i luma = _mm256_mullo_epi32(_mm256_sub_epi32(y, _mm256_set1_epi32(k.yOffset)), _mm256_set1_epi32(k.y));
+	const __m256i cb   = _mm256_sub_epi32(u, _mm256_set1_epi32(k.cOffset));
+	const __m256i cr   = _mm256_sub_epi32(v, _mm256_set1_epi32(k.cOffset));
+
+	r = _mm256_add_epi32(luma, _mm256_mullo_epi32(_mm256_set1_epi32(k.rv), cr));
+	g = _mm256_sub_epi32(_mm256_sub_epi32(luma, _mm256_mullo_epi32(_mm256_set1_epi32(k.gu), cb)), _mm256_mullo_epi32(_mm256_set1_epi32(k.gv), cr));
+	b = _mm256_add_epi32(luma, _mm256_mullo_epi32(_mm256_set1_epi32(k.bu), cb));
+}
+
+// yuvFixedToByte() for 8 components
+static inline __m256i toByte8( __m256i c )
+{
+	c = _mm256_max_epi32(_mm256_add_epi32(c, _mm256_set1_epi32(YUV_FIXED_ONE >> 1)), _mm256_setzero_si256());
+	return _mm256_min_epi32(_mm256_srli_epi32(c, YUV_FIXED_BITS), _mm256_set1_epi32(255));
+}
+
+
+// write 8 pixels
+static inline void store8( cpuNV12Format format, void* output, size_t x, __m256i r, __m256i g, __m256i b )
+{
+	if( format == CPU_NV12_RGBAF )
+	{
+		const __m256 scale = _mm256_set1_ps(YUV_FIXED_SCALE);
+
+		const __m256 pr = _mm256_mul_ps(_mm256_cvtepi32_ps(r), scale);
+		const __m256 pg = _mm256_mul_ps(_mm256_cvtepi32_ps(g), scale);
+		const __m256 pb = _mm256_mul_ps(_mm256_cvtepi32_ps(b), scale);
+		const __m256 pa = _mm256_set1_ps(1.0f);
+
+		// transpose to pixels:  p0 = px0|px4, p1 = px1|px5, p2 = px2|px6, p3 = px3|px7
+		const __m256 rgLo = _mm256_unpacklo_ps(pr, pg);
+		const __m256 rgHi = _mm256_unpackhi_ps(pr, pg);
+		const __m256 baLo = _mm256_unpacklo_ps(pb, pa);
+		const __m256 baHi = _mm256_unpackhi_ps(pb, pa);
+
+		const __m256 p0 = _mm256_shuffle_ps(rgLo, baLo, 0x44);
+		const __m256 p1 = _mm256_shuffle_ps(rgLo, baLo, 0xEE);
+		const __m256 p2 = _mm256_shuffle_ps(rgHi, baHi, 0x44);
+		const __m256 p3 = _mm256_shuffle_ps(rgHi, baHi, 0xEE);
+
+		float* dst = (float*)output + x * 4;
+
+		_mm256_storeu_ps(dst + 0,  _mm256_permute2f128_ps(p0, p1, 0x20));
+		_mm256_storeu_ps(dst + 8,  _mm256_permute2f128_ps(p2, p3, 0x20));
+		_mm256_storeu_ps(dst + 16, _mm256_permute2f128_ps(p0, p1, 0x31));
+		_mm256_storeu_ps(dst + 24, _mm256_permute2f128_ps(p2, p3, 0x31));
+	}
+	else if( format == CPU_NV12_RGBA8 )
+	{
+		const __m256i px = _mm256_or_si256(_mm256_or_si256(toByte8(r), _mm256_slli_epi32(toByte8(g), 8)),
+								     _mm256_or_si256(_mm256_slli_epi32(toByte8(b), 16), _mm256_set1_epi32(0xFF000000)));
+
+		_mm256_storeu_si256((__m256i*)((uint32_t*)output + x), px);
+	}
+	else
+	{
+		const bool    rgb = (format == CPU_NV12_RGB8);
+		const __m256i px  = _mm256_or_si256(_mm256_or_si256(toByte8(rgb ? r : b), _mm256_slli_epi32(toByte8(g), 8)), _mm256_slli_epi32(toByte8(rgb ? b : r), 16));
+		const __m256i bgr = _mm256_shuffle_epi8(px, _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+											    0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+
+		// 12 bytes from each 128-bit lane
+		const __m128i lo = _mm256_castsi256_si128(bgr);
+		const __m128i hi = _mm256_extracti128_si256(bgr, 1);
+
+		uint8_t* dst = (uint8_t*)output + x * 3;
+		const uint32_t loTail = _mm_extract_epi32(lo, 2);
+		const uint32_t hiTail = _mm_extract_epi32(hi, 2);
+
+		_mm_storel_epi64((__m128i*)dst, lo);
+		memcpy(dst + 8, &loTail, sizeof(uint32_t));
+		_mm_storel_epi64((__m128i*)(dst + 12), hi);
+		memcpy(dst + 20, &hiTail, sizeof(uint32_t));
+	}
+}
+
+
+// cpuNV12RowAVX2
+size_t cpuNV12RowAVX2( const yuvCoeffs& k, cpuNV12Format format, const uint8_t* luma, const uint8_t* chroma, const uint8_t* chromaNext, void* output, size_t width )
+{
+	const __m128i shuffleU = _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i shuffleV = _mm_setr_epi8(1, 1, 3, 3, 5, 5, 7, 7, -1, -1, -1, -1, -1, -1, -1, -1);
+
+	size_t x = 0;
+
+	for( ; x + 8 <= width; x += 8 )
+	{
+		__m128i c8 = _mm_loadl_epi64((const __m128i*)(chroma + x));
+
+		// _mm_avg_epu8 rounds up, same as chromaAverage()
+		if( chromaNext != NULL )
+			c8 = _mm_avg_epu8(c8, _mm_loadl_epi64((const __m128i*)(chromaNext + x)));
+
+		__m256i r, g, b;
+
+		yuvToRGB8(k, _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(luma + x))),
+				_mm256_cvtepu8_epi32(_mm_shuffle_epi8(c8, shuffleU)),
+				_mm256_cvtepu8_epi32(_mm_shuffle_epi8(c8, shuffleV)), r, g, b);
+
+		store8(format, output, x, r, g, b);
+	}
+
+	return x;
+}
+
+
+// cpuP010RowAVX2
+size_t cpuP010RowAVX2( const yuvCoeffs& k, cpuNV12Format format, const uint16_t* luma, const uint16_t* chroma, const uint16_t* chromaNext, void* output, size_t width )
+{
+	const __m128i shuffleU = _mm_setr_epi8(0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13);
+	const __m128i shuffleV = _mm_setr_epi8(2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15);
+
+	size_t x = 0;
+
+	for( ; x + 8 <= width; x += 8 )
+	{
+		__m128i c16 = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(chroma + x)), YUV_P010_SHIFT);
+
+		// _mm_avg_epu16 rounds up, same as chromaAverage()
+		if( chromaNext != NULL )
+			c16 = _mm_avg_epu16(c16, _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(chromaNext + x)), YUV_P010_SHIFT));
+
+		__m256i r, g, b;
+
+		yuvToRGB8(k, _mm256_cvtepu16_epi32(_mm_srli_epi16(_mm_loadu_si128((const __m128i*)(luma + x)), YUV_P010_SHIFT)),
+				_mm256_cvtepu16_epi32(_mm_shuffle_epi8(c16, shuffleU)),
+				_mm256_cvtepu16_epi32(_mm_shuffle_epi8(c16, shuffleV)), r, g, b);
+
+		store8(format, output, x, r, g, b);
+	}
+
+	return x;
+}
+
+
+// rgbClampByte() for 8 components
+static inline __m256i clampByte8( __m256i c )
+{
+	return _mm256_min_epi32(_mm256_max_epi32(c, _mm256_setzero_si256()), _mm256_set1_epi32(255));
+}
+
+// rgbFloatToByte() for 8 components (_mm256_max_ps returns the second operand for NaN)
+static inline __m256i floatToByte8( __m256 c )
+{
+	c = _mm256_min_ps(_mm256_max_ps(c, _mm256_setzero_ps()), _mm256_set1_ps(255.0f));
+	return _mm256_cvttps_epi32(_mm256_add_ps(c, _mm256_set1_ps(0.5f)));
+}
+
+// 12 bytes of RGB8/BGR8, one pixel per 32-bit lane
+static inline __m128i loadPacked4( const uint8_t* src )
+{
+	uint32_t tail;
+	memcpy(&tail, src + 8, sizeof(uint32_t));
+
+	return _mm_shuffle_epi8(_mm_insert_epi32(_mm_loadl_epi64((const __m128i*)src), tail, 2),
+					    _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1));
+}
+
+// read 8 pixels as 8-bit r, g, b in 32-bit lanes
+static inline void loadRGB8( imageFormat format, const uint8_t* row, size_t x, __m256i& r, __m256i& g, __m256i& b )
+{
+	if( format == IMAGE_RGBA32F )
+	{
+		const float* src = (const float*)row + x * 4;
+
+		__m128 r0 = _mm_loadu_ps(src + 0),  g0 = _mm_loadu_ps(src + 4),  b0 = _mm_loadu_ps(src + 8),  a0 = _mm_loadu_ps(src + 12);
+		__m128 r1 = _mm_loadu_ps(src + 16), g1 = _mm_loadu_ps(src + 20), b1 = _mm_loadu_ps(src + 24), a1 = _mm_loadu_ps(src + 28);
+
+		_MM_TRANSPOSE4_PS(r0, g0, b0, a0);
+		_MM_TRANSPOSE4_PS(r1, g1, b1, a1);
+
+		r = floatToByte8(_mm256_insertf128_ps(_mm256_castps128_ps256(r0), r1, 1));
+		g = floatToByte8(_mm256_insertf128_ps(_mm256_castps128_ps256(g0), g1, 1));
+		b = floatToByte8(_mm256_insertf128_ps(_mm256_castps128_ps256(b0), b1, 1));
+		return;
+	}
+
+	__m256i px;
+
+	if( format == IMAGE_RGBA8 )
+	{
+		px = _mm256_loadu_si256((const __m256i*)(row + x * 4));
+	}
+	else
+	{
+		const uint8_t* src = row + x * 3;
+		px = _mm256_inserti128_si256(_mm256_castsi128_si256(loadPacked4(src)), loadPacked4(src + 12), 1);
+	}
+
+	const __m256i mask = _mm256_set1_epi32(0xFF);
+	const __m256i c0   = _mm256_and_si256(px, mask);
+	const __m256i c2   = _mm256_and_si256(_mm256_srli_epi32(px, 16), mask);
+
+	r = (format == IMAGE_BGR8) ? c2 : c0;
+	g = _mm256_and_si256(_mm256_srli_epi32(px, 8), mask);
+	b = (format == IMAGE_BGR8) ? c0 : c2;
+}
+
+// rgbToLuma() for 8 pixels
+static inline __m256i rgbToLuma8( const rgbCoeffs& k, __m256i r, __m256i g, __m256i b )
+{
+	const __m256i offset = _mm256_set1_epi32((k.yOffset << RGB_FIXED_BITS) + (1 << (RGB_FIXED_BITS - 1)));
+
+	const __m256i sum = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(k.yr), r), _mm256_mullo_epi32(_mm256_set1_epi32(k.yg), g)),
+							       _mm256_add_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(k.yb), b), offset));
+
+	return clampByte8(_mm256_srai_epi32(sum, RGB_FIXED_BITS));
+}
+
+// rgbToChroma() for 8 blocks, returning U | (V << 8) in each lane
+static inline __m256i rgbToChroma8( const rgbCoeffs& k, __m256i r4, __m256i g4, __m256i b4 )
+{
+	const __m256i offset = _mm256_set1_epi32((128 << (RGB_FIXED_BITS + 2)) + (1 << (RGB_FIXED_BITS + 1)));
+
+	const __m256i u = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(k.ur), r4), _mm256_mullo_epi32(_mm256_set1_epi32(k.ug), g4)),
+							     _mm256_add_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(k.ub), b4), offset));
+
+	const __m256i v = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(k.vr), r4), _mm256_mullo_epi32(_mm256_set1_epi32(k.vg), g4)),
+							     _mm256_add_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(k.vb), b4), offset));
+
+	return _mm256_or_si256(clampByte8(_mm256_srai_epi32(u, RGB_FIXED_BITS + 2)), _mm256_slli_epi32(clampByte8(_mm256_srai_epi32(v, RGB_FIXED_BITS + 2)), 8));
+}
+
+// pack 2x8 values in [0,255] to 16 bytes (the packs work within 128-bit lanes)
+static inline __m128i packBytes16( __m256i a, __m256i b )
+{
+	const __m256i w  = _mm256_packus_epi32(a, b);
+	const __m256i px = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(w, w), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+
+	return _mm256_castsi256_si128(px);
+}
+
+
+// cpuRGBToNV12RowAVX2
+size_t cpuRGBToNV12RowAVX2( const rgbCoeffs& k, imageFormat format, const uint8_t* row0, const uint8_t* row1, uint8_t* luma0, uint8_t* luma1, uint8_t* chroma, size_t width )
+{
+	if( format == IMAGE_RGBA16F )
+		return 0;
+
+	size_t x = 0;
+
+	for( ; x + 16 <= width; x += 16 )
+	{
+		// pixels 0-7 and 8-15 of row0, then of row1
+		__m256i r[4], g[4], b[4];
+
+		loadRGB8(format, row0, x,     r[0], g[0], b[0]);
+		loadRGB8(format, row0, x + 8, r[1], g[1], b[1]);
+		loadRGB8(format, row1, x,     r[2], g[2], b[2]);
+		loadRGB8(format, row1, x + 8, r[3], g[3], b[3]);
+
+		_mm_storeu_si128((__m128i*)(luma0 + x), packBytes16(rgbToLuma8(k, r[0], g[0], b[0]), rgbToLuma8(k, r[1], g[1], b[1])));
+		_mm_storeu_si128((__m128i*)(luma1 + x), packBytes16(rgbToLuma8(k, r[2], g[2], b[2]), rgbToLuma8(k, r[3], g[3], b[3])));
+
+		// sums of the 8 blocks, vertically then horizontally (hadd leaves them in 0,1,4,5,2,3,6,7 order)
+		const __m256i r4 = _mm256_permute4x64_epi64(_mm256_hadd_epi32(_mm256_add_epi32(r[0], r[2]), _mm256_add_epi32(r[1], r[3])), _MM_SHUFFLE(3, 1, 2, 0));
+		const __m256i g4 = _mm256_permute4x64_epi64(_mm256_hadd_epi32(_mm256_add_epi32(g[0], g[2]), _mm256_add_epi32(g[1], g[3])), _MM_SHUFFLE(3, 1, 2, 0));
+		const __m256i b4 = _mm256_permute4x64_epi64(_mm256_hadd_epi32(_mm256_add_epi32(b[0], b[2]), _mm256_add_epi32(b[1], b[3])), _MM_SHUFFLE(3, 1, 2, 0));
+
+		const __m256i uv = rgbToChroma8(k, r4, g4, b4);
+		const __m256i uv16 = _mm256_permute4x64_epi64(_mm256_packus_epi32(uv, uv), _MM_SHUFFLE(3, 1, 2, 0));
+
+		_mm_storeu_si128((__m128i*)(chroma + x), _mm256_castsi256_si128(uv16));
+	}
+
+	return x;
+}
+
+#else
+
+size_t cpuNV12RowAVX2( const yuvCoeffs& k, cpuNV12Format format, const uint8_t* luma, const uint8_t* chroma, const uint8_t* chromaNext, void* output, size_t width )
+{
+	return 0;
+}
+
+size_t cpuP010RowAVX2( const yuvCoeffs& k, cpuNV12Format format, const uint16_t* luma, const uint16_t* chroma, const uint16_t* chromaNext, void* output, size_t width )
+{
+	return 0;
+}
+
+size_t cpuRGBToNV12RowAVX2( const rgbCoeffs& k, imageFormat format, const uint8_t* row0, const uint8_t* row1, uint8_t* luma0, uint8_t* luma1, uint8_t* chroma, size_t width )
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuYUV.h"
+#include "cpuThreadPool.h"
+#include "trace.h"
+
+#include <string.h>
+#include <vector>
+
+
+// convertLuma
+//  each output row first sums the input rows of its boxes per column, which
+//  the compiler vectorizes, then adds up the column sums of each box
+//  (whose ranges are the same for every row, so they're computed once)
+template<yuvFormat layout, typename T>
+static void convertLuma( uint8_t* input, size_t inputPitch, size_t inputWidth, size_t inputHeight, T* output, size_t outputPitch, size_t outputWidth, size_t outputHeight )
+{
+	const size_t boxHeight = (inputHeight + outputHeight - 1) / outputHeight;
+
+	std::vector<uint32_t> boxes(outputWidth * 2);
+
+	for( size_t x=0; x < outputWidth; x++ )
+		lumaBoxRange(x, outputWidth, inputWidth, boxes[x * 2], boxes[x * 2 + 1]);
+
+	cpuParallelRows(outputHeight, inputWidth * boxHeight, [&](size_t begin, size_t end)
+	{
+		std::vector<uint32_t> columns(inputWidth);
+
+		for( size_t y=begin; y < end; y++ )
+		{
+			uint32_t y0, y1;
+			lumaBoxRange(y, outputHeight, inputHeight, y0, y1);
+
+			memset(&columns[0], 0, inputWidth * sizeof(uint32_t));
+
+			for( uint32_t row=y0; row < y1; row++ )
+			{
+				const uint8_t* src = input + row * inputPitch;
+
+				if( layout == YUV_P010 )
+				{
+					for( size_t x=0; x < inputWidth; x++ )
+						columns[x] += ((const uint16_t*)src)[x] >> YUV_P010_SHIFT;
+				}
+				else
+				{
+					for( size_t x=0; x < inputWidth; x++ )
+						columns[x] += src[x];
+				}
+			}
+
+			T* dst = (T*)((uint8_t*)output + y * outputPitch);
+
+			for( size_t x=0; x < outputWidth; x++ )
+			{
+				const uint32_t x0 = boxes[x * 2];
+				const uint32_t x1 = boxes[x * 2 + 1];
+
+				uint32_t sum = 0;
+
+				for( uint32_t n=x0; n < x1; n++ )
+					sum += columns[n];
+
+				lumaBoxStore<layout>(dst[x], sum, (x1 - x0) * (y1 - y0));
+			}
+		}
+	});
+}
+
+template<typename T>
+static bool convertLuma( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, T* output, size_t outputPitch, size_t outputWidth, size_t outputHeight )
+{
+	if( !input || !inputPitch || !output || !outputPitch || !inputWidth || !inputHeight || !outputWidth || !outputHeight )
+		return false;
+
+	// P010 is read as 16-bit words
+	if( inputFormat == YUV_P010 && (inputPitch % sizeof(uint16_t) != 0 || (size_t)input % sizeof(uint16_t) != 0) )
+		return false;
+
+	if( !lumaBoxValid(inputFormat, inputWidth, inputHeight, outputWidth, outputHeight) )
+		return false;
+
+	// only the luma plane is read, the 8-bit layouts share it
+	if( inputFormat == YUV_P010 )
+		convertLuma<YUV_P010>(input, inputPitch, inputWidth, inputHeight, output, outputPitch, outputWidth, outputHeight);
+	else
+		convertLuma<YUV_NV12>(input, inputPitch, inputWidth, inputHeight, output, outputPitch, outputWidth, outputHeight);
+
+	return true;
+}
+
+
+// cpuYUVToGray
+bool cpuYUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, uint8_t* output, size_t outputPitch, size_t outputWidth, size_t outputHeight )
+{
+	TRACE_SCOPE("cpuYUVToGray");
+	return convertLuma(input, inputPitch, inputFormat, inputWidth, inputHeight, output, outputPitch, outputWidth, outputHeight);
+}
+
+bool cpuYUVToGray( uint8_t* input, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, uint8_t* output, size_t outputWidth, size_t outputHeight )
+{
+	return cpuYUVToGray(input, yuvFormatPitch(inputFormat, inputWidth), inputFormat, inputWidth, inputHeight, output, outputWidth * sizeof(uint8_t), outputWidth, outputHeight);
+}
+
+bool cpuYUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, float* output, size_t outputPitch, size_t outputWidth, size_t outputHeight )
+{
+	TRACE_SCOPE("cpuYUVToGray");
+	return convertLuma(input, inputPitch, inputFormat, inputWidth, inputHeight, output, outputPitch, outputWidth, outputHeight);
+}
+
+bool cpuYUVToGray( uint8_t* input, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, float* output, size_t outputWidth, size_t outputHeight )
+{
+	return cpuYUVToGray(input, yuvFormatPitch(inputFormat, inputWidth), inputFormat, inputWidth, inputHeight, output, outputWidth * sizeof(float), outputWidth, outputHeight);
+}
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuYUV-row.h"
+
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+
+// yuvToRGBFixed() for 4 pixels
+static inline void yuvToRGB4( const yuvCoeffs& k, uint16x4_t y, uint16x4_t u, uint16x4_t v, int32x4_t& r, int32x4_t& g, int32x4_t& b )
+{
+	const int32x4_t luma = vmulq_n_s32(vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(y)), vdupq_n_s32(k.yOffset)), k.y);
+	const int32x4_t cb   = vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(u)), vdupq_n_s32(k.cOffset));
+	const int32x4_t cr   = vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(v)), vdupq_n_s32(k.cOffset));
+
+	// integer multiply-accumulate is exact, so vmla matches the CUDA kernel
+	r = vmlaq_n_s32(luma, cr, k.rv);
+	g = vmlsq_n_s32(vmlsq_n_s32(luma, cb, k.gu), cr, k.gv);
+	b = vmlaq_n_s32(luma, cb, k.bu);
+}
+
+// yuvFixedToByte() for 4 components
+static inline uint16x4_t toByte4( int32x4_t c )
+{
+	// vqshrun saturates negative values to 0, and vqmovn in toByte8() saturates to 255
+	return vqshrun_n_s32(vaddq_s32(c, vdupq_n_s32(YUV_FIXED_ONE >> 1)), YUV_FIXED_BITS);
+}
+
+// yuvFixedToByte() for 8 components
+static inline uint8x8_t toByte8( int32x4_t lo, int32x4_t hi )
+{
+	return vqmovn_u16(vcombine_u16(toByte4(lo), toByte4(hi)));
+}
+
+
+// convert and write 16 pixels, from 16-bit samples
+static inline void convert16( const yuvCoeffs& k, cpuNV12Format format, const uint16x8_t* y16, const uint16x8_t* u16, const uint16x8_t* v16, void* output, size_t x )
+{
+	int32x4_t r[4], g[4], b[4];
+
+	for( int n=0; n < 2; n++ )
+	{
+		yuvToRGB4(k, vget_low_u16(y16[n]),  vget_low_u16(u16[n]),  vget_low_u16(v16[n]),  r[n*2],   g[n*2],   b[n*2]);
+		yuvToRGB4(k, vget_high_u16(y16[n]), vget_high_u16(u16[n]), vget_high_u16(v16[n]), r[n*2+1], g[n*2+1], b[n*2+1]);
+	}
+
+	if( format == CPU_NV12_RGBAF )
+	{
+		const float32x4_t scale = vdupq_n_f32(YUV_FIXED_SCALE);
+		float* dst = (float*)output + x * 4;
+
+		for( int n=0; n < 4; n++ )
+		{
+			float32x4x4_t px;
+
+			px.val[0] = vmulq_f32(vcvtq_f32_s32(r[n]), scale);
+			px.val[1] = vmulq_f32(vcvtq_f32_s32(g[n]), scale);
+			px.val[2] = vmulq_f32(vcvtq_f32_s32(b[n]), scale);
+			px.val[3] = vdupq_n_f32(1.0f);
+
+			vst4q_f32(dst + n * 16, px);
+		}
+	}
+	else
+	{
+		const uint8x16_t rb = vcombine_u8(toByte8(r[0], r[1]), toByte8(r[2], r[3]));
+		const uint8x16_t gb = vcombine_u8(toByte8(g[0], g[1]), toByte8(g[2], g[3]));
+		const uint8x16_t bb = vcombine_u8(toByte8(b[0], b[1]), toByte8(b[2], b[3]));
+
+		if( format == CPU_NV12_RGBA8 )
+		{
+			uint8x16x4_t px;
+
+			px.val[0] = rb;
+			px.val[1] = gb;
+			px.val[2] = bb;
+			px.val[3] = vdupq_n_u8(0xFF);
+
+			vst4q_u8((uint8_t*)output + x * 4, px);
+		}
+		else
+		{
+			uint8x16x3_t px;
+
+			const bool rgb = (format == CPU_NV12_RGB8);
+
+			px.val[0] = rgb ? rb : bb;
+			px.val[1] = gb;
+			px.val[2] = rgb ? bb : rb;
+
+			vst3q_u8((uint8_t*)output + x * 3, px);
+		}
+	}
+}
+
+
+// cpuNV12RowNEON
+size_t cpuNV12RowNEON( const yuvCoeffs& k, cpuNV12Format format, const uint8_t* luma, const uint8_t* chroma, const uint8_t* chromaNext, void* output, size_t width )
+{
+	size_t x = 0;
+
+	for( ; x + 16 <= width; x += 16 )
+	{
+		const uint8x16_t y8 = vld1q_u8(luma + x);
+		uint8x8x2_t c8 = vld2_u8(chroma + x);
+
+		// vrhadd rounds up, same as chromaAverage()
+		if( chromaNext != NULL )
+		{
+			const uint8x8x2_t n8 = vld2_u8(chromaNext + x);
+
+			c8.val[0] = vrhadd_u8(c8.val[0], n8.val[0]);
+			c8.val[1] = vrhadd_u8(c8.val[1], n8.val[1]);
+		}
+
+		// each chroma sample covers two pixels
+		const uint8x8x2_t u8 = vzip_u8(c8.val[0], c8.val[0]);
+		const uint8x8x2_t v8 = vzip_u8(c8.val[1], c8.val[1]);
+
+		const uint16x8_t y16[] = { vmovl_u8(vget_low_u8(y8)), vmovl_u8(vget_high_u8(y8)) };
+		const uint16x8_t u16[] = { vmovl_u8(u8.val[0]), vmovl_u8(u8.val[1]) };
+		const uint16x8_t v16[] = { vmovl_u8(v8.val[0]), vmovl_u8(v8.val[1]) };
+
+		convert16(k, format, y16, u16, v16, output, x);
+	}
+
+	return x;
+}
+
+
+// cpuP010RowNEON
+size_t cpuP010RowNEON( const yuvCoeffs& k, cpuNV12Format format, const uint16_t* luma, const uint16_t* chroma, const uint16_t* chromaNext, void* output, size_t width )
+{
+	size_t x = 0;
+
+	for( ; x + 16 <= width; x += 16 )
+	{
+		uint16x8x2_t c16 = vld2q_u16(chroma + x);
+
+		c16.val[0] = vshrq_n_u16(c16.val[0], YUV_P010_SHIFT);
+		c16.val[1] = vshrq_n_u16(c16.val[1], YUV_P010_SHIFT);
+
+		// vrhadd rounds up, same as chromaAverage()
+		if( chromaNext != NULL )
+		{
+			const uint16x8x2_t n16 = vld2q_u16(chromaNext + x);
+
+			c16.val[0] = vrhaddq_u16(c16.val[0], vshrq_n_u16(n16.val[0], YUV_P010_SHIFT));
+			c16.val[1] = vrhaddq_u16(c16.val[1], vshrq_n_u16(n16.val[1], YUV_P010_SHIFT));
+		}
+
+		// each chroma sample covers two pixels
+		const uint16x8x2_t u = vzipq_u16(c16.val[0], c16.val[0]);
+		const uint16x8x2_t v = vzipq_u16(c16.val[1], c16.val[1]);
+
+		const uint16x8_t y16[] = { vshrq_n_u16(vld1q_u16(luma + x), YUV_P010_SHIFT), vshrq_n_u16(vld1q_u16(luma + x + 8), YUV_P010_SHIFT) };
+		const uint16x8_t u16[] = { u.val[0], u.val[1] };
+		const uint16x8_t v16[] = { v.val[0], v.val[1] };
+
+		convert16(k, format, y16, u16, v16, output, x);
+	}
+
+	return x;
+}
+
+
+// rgbFloatToByte() for 4 components (vmax keeps NaN, which vcvt converts to 0)
+static inline int32x4_t floatToByte4( float32x4_t c )
+{
+	c = vminq_f32(vmaxq_f32(c, vdupq_n_f32(0.0f)), vdupq_n_f32(255.0f));
+	return vreinterpretq_s32_u32(vcvtq_u32_f32(vaddq_f32(c, vdupq_n_f32(0.5f))));
+}
+
+// widen 8 bytes to two 4-lane halves
+static inline void widen8( uint8x8_t c, int32x4_t* out )
+{
+	const uint16x8_t c16 = vmovl_u8(c);
+
+	out[0] = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(c16)));
+	out[1] = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(c16)));
+}
+
+// read 8 pixels as 8-bit r, g, b in two 4-lane halves
+static inline void loadRGB8( imageFormat format, const uint8_t* row, size_t x, int32x4_t* r, int32x4_t* g, int32x4_t* b )
+{
+	if( format == IMAGE_RGBA32F )
+	{
+		const float* src = (const float*)row + x * 4;
+
+		for( int n=0; n < 2; n++ )
+		{
+			const float32x4x4_t px = vld4q_f32(src + n * 16);
+
+			r[n] = floatToByte4(px.val[0]);
+			g[n] = floatToByte4(px.val[1]);
+			b[n] = floatToByte4(px.val[2]);
+		}
+
+		return;
+	}
+
+	uint8x8_t c0, c1, c2;
+
+	if( format == IMAGE_RGBA8 )
+	{
+		const uint8x8x4_t px = vld4_u8(row + x * 4);
+
+		c0 = px.val[0];
+		c1 = px.val[1];
+		c2 = px.val[2];
+	}
+	else
+	{
+		const uint8x8x3_t px = vld3_u8(row + x * 3);
+
+		c0 = px.val[0];
+		c1 = px.val[1];
+		c2 = px.val[2];
+	}
+
+	widen8((format == IMAGE_BGR8) ? c2 : c0, r);
+	widen8(c1, g);
+	widen8((format == IMAGE_BGR8) ? c0 : c2, b);
+}
+
+// rgbToLuma() for 4 pixels, before clamping
+static inline int32x4_t rgbToLuma4( const rgbCoeffs& k, int32x4_t r, int32x4_t g, int32x4_t b )
+{
+	int32x4_t sum = vdupq_n_s32((k.yOffset << RGB_FIXED_BITS) + (1 << (RGB_FIXED_BITS - 1)));
+
+	sum = vmlaq_n_s32(sum, r, k.yr);
+	sum = vmlaq_n_s32(sum, g, k.yg);
+	sum = vmlaq_n_s32(sum, b, k.yb);
+
+	return vshrq_n_s32(sum, RGB_FIXED_BITS);
+}
+
+// rgbClampByte() for 4 components:  vqmovun saturates negative values to 0
+static inline uint16x4_t clampByte4( int32x4_t c )
+{
+	return vmin_u16(vqmovun_s32(c), vdup_n_u16(255));
+}
+
+// rgbToChroma() for 4 blocks, returning U | (V << 8) in each lane
+static inline uint16x4_t rgbToChroma4( const rgbCoeffs& k, int32x4_t r4, int32x4_t g4, int32x4_t b4 )
+{
+	const int32x4_t offset = vdupq_n_s32((128 << (RGB_FIXED_BITS + 2)) + (1 << (RGB_FIXED_BITS + 1)));
+
+	const int32x4_t u = vmlaq_n_s32(vmlaq_n_s32(vmlaq_n_s32(offset, r4, k.ur), g4, k.ug), b4, k.ub);
+	const int32x4_t v = vmlaq_n_s32(vmlaq_n_s32(vmlaq_n_s32(offset, r4, k.vr), g4, k.vg), b4, k.vb);
+
+	return vorr_u16(clampByte4(vshrq_n_s32(u, RGB_FIXED_BITS + 2)), vshl_n_u16(clampByte4(vshrq_n_s32(v, RGB_FIXED_BITS + 2)), 8));
+}
+
+// sums of horizontal pairs of 8 lanes (vpadd works on 64-bit vectors on ARMv7)
+static inline int32x4_t pairSum8( int32x4_t lo, int32x4_t hi )
+{
+	return vcombine_s32(vpadd_s32(vget_low_s32(lo), vget_high_s32(lo)), vpadd_s32(vget_low_s32(hi), vget_high_s32(hi)));
+}
+
+
+// cpuRGBToNV12RowNEON
+size_t cpuRGBToNV12RowNEON( const rgbCoeffs& k, imageFormat format, const uint8_t* row0, const uint8_t* row1, uint8_t* luma0, uint8_t* luma1, uint8_t* chroma, size_t width )
+{
+	if( format == IMAGE_RGBA16F )
+		return 0;
+
+	size_t x = 0;
+
+	for( ; x + 8 <= width; x += 8 )
+	{
+		// pixels 0-3 and 4-7 of row0, then of row1
+		int32x4_t r[4], g[4], b[4];
+
+		loadRGB8(format, row0, x, r, g, b);
+		loadRGB8(format, row1, x, r + 2, g + 2, b + 2);
+
+		// vqmovun/vqmovn saturate to [0,255], the same as rgbClampByte()
+		vst1_u8(luma0 + x, vqmovn_u16(vcombine_u16(vqmovun_s32(rgbToLuma4(k, r[0], g[0], b[0])), vqmovun_s32(rgbToLuma4(k, r[1], g[1], b[1])))));
+		vst1_u8(luma1 + x, vqmovn_u16(vcombine_u16(vqmovun_s32(rgbToLuma4(k, r[2], g[2], b[2])), vqmovun_s32(rgbToLuma4(k, r[3], g[3], b[3])))));
+
+		// sums of the 4 blocks, vertically then horizontally
+		const int32x4_t r4 = pairSum8(vaddq_s32(r[0], r[2]), vaddq_s32(r[1], r[3]));
+		const int32x4_t g4 = pairSum8(vaddq_s32(g[0], g[2]), vaddq_s32(g[1], g[3]));
+		const int32x4_t b4 = pairSum8(vaddq_s32(b[0], b[2]), vaddq_s32(b[1], b[3]));
+
+		vst1_u8(chroma + x, vreinterpret_u8_u16(rgbToChroma4(k, r4, g4, b4)));
+	}
+
+	return x;
+}
+
+#else
+
+size_t cpuNV12RowNEON( const yuvCoeffs& k, cpuNV12Format format, const uint8_t* luma, const uint8_t* chroma, const uint8_t* chromaNext, void* output, size_t width )
+{
+	return 0;
+}
+
+size_t cpuP010RowNEON( const yuvCoeffs& k, cpuNV12Format format, const uint16_t* luma, const uint16_t* chroma, const uint16_t* chromaNext, void* output, size_t width )
+{
+	return 0;
+}
+
+size_t cpuRGBToNV12RowNEON( const rgbCoeffs& k, imageFormat format, const uint8_t* row0, const uint8_t* row1, uint8_t* luma0, uint8_t* luma1, uint8_t* chroma, size_t width )
+{
+	return 0;
+}
+
+#endif
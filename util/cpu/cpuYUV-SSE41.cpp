@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuYUV-row.h"
+
+#include <string.h>
+
+
+#if defined(__SSE4_1__)
+
+#include <smmintrin.h>
+
+
+// yuvToRGBFixed() for 4 pixels
+static inline void yuvToRGB4( const yuvCoeffs& k, __m128i y, __m128i u, __m128i v, __m128i& r, __m128i& g, __m128i& b )
+{
+	const __m128i luma = _mm_mullo_epi32(_mm_sub_epi32(y, _mm_set1_epi32(k.yOffset)), _mm_set1_epi32(k.y));
+	const __m128i cb   = _mm_sub_epi32(u, _mm_set1_epi32(k.cOffset));
+	const __m128i cr   = _mm_sub_epi32(v, _mm_set1_epi32(k.cOffset));
+
+	r = _mm_add_epi32(luma, _mm_mullo_epi32(_mm_set1_epi32(k.rv), cr));
+	g = _mm_sub_epi32(_mm_sub_epi32(luma, _mm_mullo_epi32(_mm_set1_epi32(k.gu), cb)), _mm_mullo_epi32(_mm_set1_epi32(k.gv), cr));
+	b = _mm_add_epi32(luma, _mm_mullo_epi32(_mm_set1_epi32(k.bu), cb));
+}
+
+// yuvFixedToByte() for 4 components
+static inline __m128i toByte4( __m128i c )
+{
+	c = _mm_max_epi32(_mm_add_epi32(c, _mm_set1_epi32(YUV_FIXED_ONE >> 1)), _mm_setzero_si128());
+	return _mm_min_epi32(_mm_srli_epi32(c, YUV_FIXED_BITS), _mm_set1_epi32(255));
+}
+
+// write 4 pixels
+static inline void store4( cpuNV12Format format, void* output, size_t x, __m128i r, __m128i g, __m128i b )
+{
+	if( format == CPU_NV12_RGBAF )
+	{
+		const __m128 scale = _mm_set1_ps(YUV_FIXED_SCALE);
+
+		__m128 pr = _mm_mul_ps(_mm_cvtepi32_ps(r), scale);
+		__m128 pg = _mm_mul_ps(_mm_cvtepi32_ps(g), scale);
+		__m128 pb = _mm_mul_ps(_mm_cvtepi32_ps(b), scale);
+		__m128 pa = _mm_set1_ps(1.0f);
+
+		_MM_TRANSPOSE4_PS(pr, pg, pb, pa);
+
+		float* dst = (float*)output + x * 4;
+
+		_mm_storeu_ps(dst + 0,  pr);
+		_mm_storeu_ps(dst + 4,  pg);
+		_mm_storeu_ps(dst + 8,  pb);
+		_mm_storeu_ps(dst + 12, pa);
+	}
+	else if( format == CPU_NV12_RGBA8 )
+	{
+		const __m128i px = _mm_or_si128(_mm_or_si128(toByte4(r), _mm_slli_epi32(toByte4(g), 8)),
+								   _mm_or_si128(_mm_slli_epi32(toByte4(b), 16), _mm_set1_epi32(0xFF000000)));
+
+		_mm_storeu_si128((__m128i*)((uint32_t*)output + x), px);
+	}
+	else
+	{
+		const bool    rgb = (format == CPU_NV12_RGB8);
+		const __m128i px  = _mm_or_si128(_mm_or_si128(toByte4(rgb ? r : b), _mm_slli_epi32(toByte4(g), 8)), _mm_slli_epi32(toByte4(rgb ? b : r), 16));
+		const __m128i bgr = _mm_shuffle_epi8(px, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+
+		uint8_t* dst = (uint8_t*)output + x * 3;
+		const uint32_t tail = _mm_extract_epi32(bgr, 2);
+
+		_mm_storel_epi64((__m128i*)dst, bgr);
+		memcpy(dst + 8, &tail, sizeof(uint32_t));
+	}
+}
+
+
+// cpuNV12RowSSE41
+size_t cpuNV12RowSSE41( const yuvCoeffs& k, cpuNV12Format format, const uint8_t* luma, const uint8_t* chroma, const uint8_t* chromaNext, void* output, size_t width )
+{
+	const __m128i shuffleU = _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i shuffleV = _mm_setr_epi8(1, 1, 3, 3, 5, 5, 7, 7, -1, -1, -1, -1, -1, -1, -1, -1);
+
+	size_t x = 0;
+
+	for( ; x + 8 <= width; x += 8 )
+	{
+		const __m128i y8 = _mm_loadl_epi64((const __m128i*)(luma + x));
+		__m128i c8 = _mm_loadl_epi64((const __m128i*)(chroma + x));
+
+		// _mm_avg_epu8 rounds up, same as chromaAverage()
+		if( chromaNext != NULL )
+			c8 = _mm_avg_epu8(c8, _mm_loadl_epi64((const __m128i*)(chromaNext + x)));
+
+		const __m128i u8 = _mm_shuffle_epi8(c8, shuffleU);
+		const __m128i v8 = _mm_shuffle_epi8(c8, shuffleV);
+
+		__m128i r, g, b;
+
+		yuvToRGB4(k, _mm_cvtepu8_epi32(y8), _mm_cvtepu8_epi32(u8), _mm_cvtepu8_epi32(v8), r, g, b);
+		store4(format, output, x, r, g, b);
+
+		yuvToRGB4(k, _mm_cvtepu8_epi32(_mm_srli_si128(y8, 4)), _mm_cvtepu8_epi32(_mm_srli_si128(u8, 4)), _mm_cvtepu8_epi32(_mm_srli_si128(v8, 4)), r, g, b);
+		store4(format, output, x + 4, r, g, b);
+	}
+
+	return x;
+}
+
+
+// cpuP010RowSSE41
+size_t cpuP010RowSSE41( const yuvCoeffs& k, cpuNV12Format format, const uint16_t* luma, const uint16_t* chroma, const uint16_t* chromaNext, void* output, size_t width )
+{
+	const __m128i shuffleU = _mm_setr_epi8(0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13);
+	const __m128i shuffleV = _mm_setr_epi8(2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15);
+
+	size_t x = 0;
+
+	for( ; x + 8 <= width; x += 8 )
+	{
+		const __m128i y16 = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(luma + x)), YUV_P010_SHIFT);
+		__m128i c16 = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(chroma + x)), YUV_P010_SHIFT);
+
+		// _mm_avg_epu16 rounds up, same as chromaAverage()
+		if( chromaNext != NULL )
+			c16 = _mm_avg_epu16(c16, _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(chromaNext + x)), YUV_P010_SHIFT));
+
+		const __m128i u16 = _mm_shuffle_epi8(c16, shuffleU);
+		const __m128i v16 = _mm_shuffle_epi8(c16, shuffleV);
+
+		__m128i r, g, b;
+
+		yuvToRGB4(k, _mm_cvtepu16_epi32(y16), _mm_cvtepu16_epi32(u16), _mm_cvtepu16_epi32(v16), r, g, b);
+		store4(format, output, x, r, g, b);
+
+		yuvToRGB4(k, _mm_cvtepu16_epi32(_mm_srli_si128(y16, 8)), _mm_cvtepu16_epi32(_mm_srli_si128(u16, 8)), _mm_cvtepu16_epi32(_mm_srli_si128(v16, 8)), r, g, b);
+		store4(format, output, x + 4, r, g, b);
+	}
+
+	return x;
+}
+
+
+// rgbClampByte() for 4 components
+static inline __m128i clampByte4( __m128i c )
+{
+	return _mm_min_epi32(_mm_max_epi32(c, _mm_setzero_si128()), _mm_set1_epi32(255));
+}
+
+// rgbFloatToByte() for 4 components (_mm_max_ps returns the second operand for NaN)
+static inline __m128i floatToByte4( __m128 c )
+{
+	c = _mm_min_ps(_mm_max_ps(c, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+	return _mm_cvttps_epi32(_mm_add_ps(c, _mm_set1_ps(0.5f)));
+}
+
+// read 4 pixels as 8-bit r, g, b in 32-bit lanes
+static inline void loadRGB4( imageFormat format, const uint8_t* row, size_t x, __m128i& r, __m128i& g, __m128i& b )
+{
+	if( format == IMAGE_RGBA32F )
+	{
+		const float* src = (const float*)row + x * 4;
+
+		__m128 pr = _mm_loadu_ps(src + 0);
+		__m128 pg = _mm_loadu_ps(src + 4);
+		__m128 pb = _mm_loadu_ps(src + 8);
+		__m128 pa = _mm_loadu_ps(src + 12);
+
+		_MM_TRANSPOSE4_PS(pr, pg, pb, pa);
+
+		r = floatToByte4(pr);
+		g = floatToByte4(pg);
+		b = floatToByte4(pb);
+		return;
+	}
+
+	__m128i px;
+
+	if( format == IMAGE_RGBA8 )
+	{
+		px = _mm_loadu_si128((const __m128i*)(row + x * 4));
+	}
+	else
+	{
+		// 12 bytes, spread to one pixel per lane
+		const uint8_t* src = row + x * 3;
+		uint32_t tail;
+
+		memcpy(&tail, src + 8, sizeof(uint32_t));
+
+		px = _mm_shuffle_epi8(_mm_insert_epi32(_mm_loadl_epi64((const __m128i*)src), tail, 2),
+						  _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1));
+	}
+
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i c0   = _mm_and_si128(px, mask);
+	const __m128i c2   = _mm_and_si128(_mm_srli_epi32(px, 16), mask);
+
+	r = (format == IMAGE_BGR8) ? c2 : c0;
+	g = _mm_and_si128(_mm_srli_epi32(px, 8), mask);
+	b = (format == IMAGE_BGR8) ? c0 : c2;
+}
+
+// rgbToLuma() for 4 pixels
+static inline __m128i rgbToLuma4( const rgbCoeffs& k, __m128i r, __m128i g, __m128i b )
+{
+	const __m128i offset = _mm_set1_epi32((k.yOffset << RGB_FIXED_BITS) + (1 << (RGB_FIXED_BITS - 1)));
+
+	const __m128i sum = _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi32(_mm_set1_epi32(k.yr), r), _mm_mullo_epi32(_mm_set1_epi32(k.yg), g)),
+							    _mm_add_epi32(_mm_mullo_epi32(_mm_set1_epi32(k.yb), b), offset));
+
+	return clampByte4(_mm_srai_epi32(sum, RGB_FIXED_BITS));
+}
+
+// rgbToChroma() for 4 blocks, returning U | (V << 8) in each lane
+static inline __m128i rgbToChroma4( const rgbCoeffs& k, __m128i r4, __m128i g4, __m128i b4 )
+{
+	const __m128i offset = _mm_set1_epi32((128 << (RGB_FIXED_BITS + 2)) + (1 << (RGB_FIXED_BITS + 1)));
+
+	const __m128i u = _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi32(_mm_set1_epi32(k.ur), r4), _mm_mullo_epi32(_mm_set1_epi32(k.ug), g4)),
+							  _mm_add_epi32(_mm_mullo_epi32(_mm_set1_epi32(k.ub), b4), offset));
+
+	const __m128i v = _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi32(_mm_set1_epi32(k.vr), r4), _mm_mullo_epi32(_mm_set1_epi32(k.vg), g4)),
+							  _mm_add_epi32(_mm_mullo_epi32(_mm_set1_epi32(k.vb), b4), offset));
+
+	return _mm_or_si128(clampByte4(_mm_srai_epi32(u, RGB_FIXED_BITS + 2)), _mm_slli_epi32(clampByte4(_mm_srai_epi32(v, RGB_FIXED_BITS + 2)), 8));
+}
+
+// pack 2x4 values in [0,255] to 8 bytes
+static inline __m128i packBytes8( __m128i a, __m128i b )
+{
+	const __m128i w = _mm_packus_epi32(a, b);
+	return _mm_packus_epi16(w, w);
+}
+
+
+// cpuRGBToNV12RowSSE41
+size_t cpuRGBToNV12RowSSE41( const rgbCoeffs& k, imageFormat format, const uint8_t* row0, const uint8_t* row1, uint8_t* luma0, uint8_t* luma1, uint8_t* chroma, size_t width )
+{
+	if( format == IMAGE_RGBA16F )
+		return 0;
+
+	size_t x = 0;
+
+	for( ; x + 8 <= width; x += 8 )
+	{
+		// pixels 0-3 and 4-7 of row0, then of row1
+		__m128i r[4], g[4], b[4];
+
+		loadRGB4(format, row0, x,     r[0], g[0], b[0]);
+		loadRGB4(format, row0, x + 4, r[1], g[1], b[1]);
+		loadRGB4(format, row1, x,     r[2], g[2], b[2]);
+		loadRGB4(format, row1, x + 4, r[3], g[3], b[3]);
+
+		_mm_storel_epi64((__m128i*)(luma0 + x), packBytes8(rgbToLuma4(k, r[0], g[0], b[0]), rgbToLuma4(k, r[1], g[1], b[1])));
+		_mm_storel_epi64((__m128i*)(luma1 + x), packBytes8(rgbToLuma4(k, r[2], g[2], b[2]), rgbToLuma4(k, r[3], g[3], b[3])));
+
+		// sums of the 4 blocks, vertically then horizontally
+		const __m128i r4 = _mm_hadd_epi32(_mm_add_epi32(r[0], r[2]), _mm_add_epi32(r[1], r[3]));
+		const __m128i g4 = _mm_hadd_epi32(_mm_add_epi32(g[0], g[2]), _mm_add_epi32(g[1], g[3]));
+		const __m128i b4 = _mm_hadd_epi32(_mm_add_epi32(b[0], b[2]), _mm_add_epi32(b[1], b[3]));
+
+		const __m128i uv = rgbToChroma4(k, r4, g4, b4);
+		_mm_storel_epi64((__m128i*)(chroma + x), _mm_packus_epi32(uv, uv));
+	}
+
+	return x;
+}
+
+#else
+
+size_t cpuNV12RowSSE41( const yuvCoeffs& k, cpuNV12Format format, const uint8_t* luma, const uint8_t* chroma, const uint8_t* chromaNext, void* output, size_t width )
+{
+	return 0;
+}
+
+size_t cpuP010RowSSE41( const yuvCoeffs& k, cpuNV12Format format, const uint16_t* luma, const uint16_t* chroma, const uint16_t* chromaNext, void* output, size_t width )
+{
+	return 0;
+}
+
+size_t cpuRGBToNV12RowSSE41( const rgbCoeffs& k, imageFormat format, const uint8_t* row0, const uint8_t* row1, uint8_t* luma0, uint8_t* luma1, uint8_t* chroma, size_t width )
+{
+	return 0;
+}
+
+#endif
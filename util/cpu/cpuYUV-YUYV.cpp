@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuYUV.h"
+#include "cpuThreadPool.h"
+#include "cudaColorspace.h"
+#include "trace.h"
+
+
+//-----------------------------------------------------------------------------------
+// YUYV/UYVY to RGBA
+//-----------------------------------------------------------------------------------
+template <bool formatUYVY>
+static bool convertYUYV( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height )
+{
+	if( !input || !inputPitch || !output || !outputPitch || !width || !height )
+		return false;
+
+	cpuParallelRows(height, width, [&](size_t begin, size_t end)
+	{
+		for( size_t y=begin; y < end; y++ )
+		{
+			const uint8_t* src = (uint8_t*)input + y * inputPitch;
+			uint8_t* dst = (uint8_t*)output + y * outputPitch;
+
+			// UYVY [ U0 | Y0 | V0 | Y1 ]
+			// YUYV [ Y0 | U0 | Y1 | V0 ]
+			for( size_t x=0; x < width / 2; x++, src += 4, dst += 8 )
+			{
+				const float y0 = formatUYVY ? src[1] : src[0];
+				const float y1 = formatUYVY ? src[3] : src[2];
+				const float u  = (formatUYVY ? src[0] : src[1]) - 128.0f;
+				const float v  = (formatUYVY ? src[2] : src[3]) - 128.0f;
+
+				float r, g, b;
+
+				yuv8ToRGB(y0, u, v, r, g, b);
+
+				dst[0] = rgb8ToByte(r);
+				dst[1] = rgb8ToByte(g);
+				dst[2] = rgb8ToByte(b);
+				dst[3] = 255;
+
+				yuv8ToRGB(y1, u, v, r, g, b);
+
+				dst[4] = rgb8ToByte(r);
+				dst[5] = rgb8ToByte(g);
+				dst[6] = rgb8ToByte(b);
+				dst[7] = 255;
+			}
+		}
+	});
+
+	return true;
+}
+
+bool cpuUYVYToRGBA( uchar2* input, uchar4* output, size_t width, size_t height )
+{
+	return cpuUYVYToRGBA(input, width * sizeof(uchar2), output, width * sizeof(uchar4), width, height);
+}
+
+bool cpuUYVYToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height )
+{
+	TRACE_SCOPE("cpuUYVYToRGBA");
+	return convertYUYV<true>(input, inputPitch, output, outputPitch, width, height);
+}
+
+bool cpuYUYVToRGBA( uchar2* input, uchar4* output, size_t width, size_t height )
+{
+	return cpuYUYVToRGBA(input, width * sizeof(uchar2), output, width * sizeof(uchar4), width, height);
+}
+
+bool cpuYUYVToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height )
+{
+	TRACE_SCOPE("cpuYUYVToRGBA");
+	return convertYUYV<false>(input, inputPitch, output, outputPitch, width, height);
+}
+
+
+//-----------------------------------------------------------------------------------
+// YUYV/UYVY to grayscale
+//-----------------------------------------------------------------------------------
+template <bool formatUYVY>
+static bool convertGrayYUYV( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height )
+{
+	if( !input || !inputPitch || !output || !outputPitch || !width || !height )
+		return false;
+
+	cpuParallelRows(height, width, [&](size_t begin, size_t end)
+	{
+		for( size_t y=begin; y < end; y++ )
+		{
+			const uint8_t* src = (uint8_t*)input + y * inputPitch;
+			float* dst = (float*)((uint8_t*)output + y * outputPitch);
+
+			for( size_t x=0; x < width; x++ )
+				dst[x] = float(src[x * 2 + (formatUYVY ? 1 : 0)]) / 255.0f;
+		}
+	});
+
+	return true;
+}
+
+bool cpuUYVYToGray( uchar2* input, float* output, size_t width, size_t height )
+{
+	return cpuUYVYToGray(input, width * sizeof(uchar2), output, width * sizeof(float), width, height);
+}
+
+bool cpuUYVYToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height )
+{
+	TRACE_SCOPE("cpuUYVYToGray");
+	return convertGrayYUYV<true>(input, inputPitch, output, outputPitch, width, height);
+}
+
+bool cpuYUYVToGray( uchar2* input, float* output, size_t width, size_t height )
+{
+	return cpuYUYVToGray(input, width * sizeof(uchar2), output, width * sizeof(float), width, height);
+}
+
+bool cpuYUYVToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height )
+{
+	TRACE_SCOPE("cpuYUYVToGray");
+	return convertGrayYUYV<false>(input, inputPitch, output, outputPitch, width, height);
+}
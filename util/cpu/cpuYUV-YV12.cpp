@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuYUV.h"
+#include "cpuThreadPool.h"
+#include "trace.h"
+
+
+static inline uint8_t rgb_to_y( uint8_t r, uint8_t g, uint8_t b )
+{
+	return static_cast<uint8_t>(((int)(30 * r) + (int)(59 * g) + (int)(11 * b)) / 100);
+}
+
+static inline uint8_t rgb_to_u( uint8_t r, uint8_t g, uint8_t b )
+{
+	return static_cast<uint8_t>(((int)(-17 * r) - (int)(33 * g) + (int)(50 * b) + 12800) / 100);
+}
+
+static inline uint8_t rgb_to_v( uint8_t r, uint8_t g, uint8_t b )
+{
+	return static_cast<uint8_t>(((int)(50 * r) - (int)(42 * g) - (int)(8 * b) + 12800) / 100);
+}
+
+
+// convert420 (the chroma is sampled from the bottom-right pixel of each 2x2 block, like the CUDA kernel)
+template <bool formatYV12>
+static bool convert420( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height )
+{
+	if( !input || !inputPitch || !output || !outputPitch || !width || !height )
+		return false;
+
+	const size_t planeSize = height * outputPitch;
+	const size_t uvPitch   = outputPitch / 2;
+
+	uint8_t* y_plane = output;
+	uint8_t* u_plane;
+	uint8_t* v_plane;
+
+	if( formatYV12 )
+	{
+		u_plane = y_plane + planeSize;
+		v_plane = u_plane + (planeSize / 4);
+	}
+	else
+	{
+		v_plane = y_plane + planeSize;
+		u_plane = v_plane + (planeSize / 4);
+	}
+
+	cpuParallelRows(height / 2, width, [&](size_t begin, size_t end)
+	{
+		for( size_t row=begin; row < end; row++ )
+		{
+			const size_t y = row * 2;
+
+			const uchar4* src0 = (uchar4*)((uint8_t*)input + y * inputPitch);
+			const uchar4* src1 = (uchar4*)((uint8_t*)input + (y + 1) * inputPitch);
+
+			uint8_t* dst0 = y_plane + y * outputPitch;
+			uint8_t* dst1 = dst0 + outputPitch;
+
+			for( size_t x=0; x + 1 < width; x += 2 )
+			{
+				dst0[x]   = rgb_to_y(src0[x].x, src0[x].y, src0[x].z);
+				dst0[x+1] = rgb_to_y(src0[x+1].x, src0[x+1].y, src0[x+1].z);
+				dst1[x]   = rgb_to_y(src1[x].x, src1[x].y, src1[x].z);
+
+				const uchar4 px = src1[x+1];
+				dst1[x+1] = rgb_to_y(px.x, px.y, px.z);
+
+				const size_t uvIndex = row * uvPitch + (x / 2);
+
+				u_plane[uvIndex] = rgb_to_u(px.x, px.y, px.z);
+				v_plane[uvIndex] = rgb_to_v(px.x, px.y, px.z);
+			}
+		}
+	});
+
+	return true;
+}
+
+
+// cpuRGBAToYV12
+bool cpuRGBAToYV12( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height )
+{
+	TRACE_SCOPE("cpuRGBAToYV12");
+	return convert420<false>(input, inputPitch, output, outputPitch, width, height);
+}
+
+// cpuRGBAToYV12
+bool cpuRGBAToYV12( uchar4* input, uint8_t* output, size_t width, size_t height )
+{
+	return cpuRGBAToYV12(input, width * sizeof(uchar4), output, width * sizeof(uint8_t), width, height);
+}
+
+// cpuRGBAToI420
+bool cpuRGBAToI420( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height )
+{
+	TRACE_SCOPE("cpuRGBAToI420");
+	return convert420<true>(input, inputPitch, output, outputPitch, width, height);
+}
+
+// cpuRGBAToI420
+bool cpuRGBAToI420( uchar4* input, uint8_t* output, size_t width, size_t height )
+{
+	return cpuRGBAToI420(input, width * sizeof(uchar4), output, width * sizeof(uint8_t), width, height);
+}
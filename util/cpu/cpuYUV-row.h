@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CPU_YUV_ROW_H
+#define __CPU_YUV_ROW_H
+
+
+#include "cudaYUV-NV12.h"
+
+
+/*
+ * Internal to the cpuYUV implementation:  per-row NV12 conversion kernels.
+ *
+ * Each row receives its luma, the chroma row it maps to, and the following
+ * chroma row when the chroma should be interpolated vertically (odd rows,
+ * same as the CUDA kernel), or NULL otherwise.  NV21 and I420 chroma is
+ * interleaved into an NV12 row first, P010 has its own 16-bit kernels.
+ */
+enum cpuNV12Format
+{
+	CPU_NV12_RGBA8 = 0,
+	CPU_NV12_BGR8,
+	CPU_NV12_RGB8,
+	CPU_NV12_RGBAF,
+	CPU_NV12_RGBAH		// half-float RGBA, scalar only
+};
+
+
+/*
+ * SIMD row kernels, returning the number of leading pixels they converted
+ * (always even).  The rest of the row is finished by cpuNV12RowScalar().
+ * They return 0 when the instruction set wasn't compiled in.
+ */
+size_t cpuNV12RowSSE41( const yuvCoeffs& k, cpuNV12Format format, const uint8_t* luma, const uint8_t* chroma, const uint8_t* chromaNext, void* output, size_t width );
+size_t cpuNV12RowAVX2( const yuvCoeffs& k, cpuNV12Format format, const uint8_t* luma, const uint8_t* chroma, const uint8_t* chromaNext, void* output, size_t width );
+size_t cpuNV12RowNEON( const yuvCoeffs& k, cpuNV12Format format, const uint8_t* luma, const uint8_t* chroma, const uint8_t* chromaNext, void* output, size_t width );
+
+size_t cpuP010RowSSE41( const yuvCoeffs& k, cpuNV12Format format, const uint16_t* luma, const uint16_t* chroma, const uint16_t* chromaNext, void* output, size_t width );
+size_t cpuP010RowAVX2( const yuvCoeffs& k, cpuNV12Format format, const uint16_t* luma, const uint16_t* chroma, const uint16_t* chromaNext, void* output, size_t width );
+size_t cpuP010RowNEON( const yuvCoeffs& k, cpuNV12Format format, const uint16_t* luma, const uint16_t* chroma, const uint16_t* chromaNext, void* output, size_t width );
+
+
+/*
+ * RGB to NV12 row kernels (the encode direction), converting a pair of rows:
+ * row0/row1 are the input rows, luma0/luma1 the luma rows they produce and
+ * chroma the chroma row they share.  On the last row of an odd height, row1
+ * and luma1 are the same as row0 and luma0.  They return the number of leading
+ * pixels they converted (a multiple of 8), like the NV12 row kernels.
+ */
+size_t cpuRGBToNV12RowSSE41( const rgbCoeffs& k, imageFormat format, const uint8_t* row0, const uint8_t* row1, uint8_t* luma0, uint8_t* luma1, uint8_t* chroma, size_t width );
+size_t cpuRGBToNV12RowAVX2( const rgbCoeffs& k, imageFormat format, const uint8_t* row0, const uint8_t* row1, uint8_t* luma0, uint8_t* luma1, uint8_t* chroma, size_t width );
+size_t cpuRGBToNV12RowNEON( const rgbCoeffs& k, imageFormat format, const uint8_t* row0, const uint8_t* row1, uint8_t* luma0, uint8_t* luma1, uint8_t* chroma, size_t width );
+
+
+/*
+ * Scalar RGB to NV12 row kernel, converts the 2x2 blocks of pixels [x, width), x even
+ */
+template<imageFormat format>
+inline void cpuRGBToNV12RowScalar( const rgbCoeffs& k, const uint8_t* row0, const uint8_t* row1, uint8_t* luma0, uint8_t* luma1, uint8_t* chroma, size_t x, size_t width )
+{
+	for( ; x < width; x += 2 )
+		nv12EncodeBlock<format>(k, row0, row1, luma0, luma1, chroma, x, width);
+}
+
+
+/*
+ * Scalar row kernel, converts pixels [x, width) of 8-bit (NV12) or 16-bit (P010) samples
+ */
+template<typename T>
+inline void cpuNV12RowScalar( const yuvCoeffs& k, cpuNV12Format format, const T* luma, const T* chroma, const T* chromaNext, void* output, size_t x, size_t width )
+{
+	const uint32_t shift = (sizeof(T) == sizeof(uint16_t)) ? YUV_P010_SHIFT : 0;
+
+	for( ; x < width; x++ )
+	{
+		const size_t c = x & ~size_t(1);
+
+		uint32_t u = chroma[c] >> shift;
+		uint32_t v = chroma[c+1] >> shift;
+
+		if( chromaNext != NULL )
+		{
+			u = chromaAverage(u, chromaNext[c] >> shift);
+			v = chromaAverage(v, chromaNext[c+1] >> shift);
+		}
+
+		int32_t r, g, b;
+		yuvToRGBFixed(k, luma[x] >> shift, u, v, r, g, b);
+
+		if( format == CPU_NV12_RGBA8 )
+		{
+			((uint32_t*)output)[x] = rgbaPack(yuvFixedToByte(r), yuvFixedToByte(g), yuvFixedToByte(b), 0xFF);
+		}
+		else if( format == CPU_NV12_BGR8 || format == CPU_NV12_RGB8 )
+		{
+			uint8_t* px = (uint8_t*)output + x * 3;
+
+			px[0] = yuvFixedToByte((format == CPU_NV12_BGR8) ? b : r);
+			px[1] = yuvFixedToByte(g);
+			px[2] = yuvFixedToByte((format == CPU_NV12_BGR8) ? r : b);
+		}
+		else if( format == CPU_NV12_RGBAH )
+		{
+			uint16_t* px = (uint16_t*)output + x * 4;
+
+			px[0] = floatToHalf(yuvFixedToFloat(r));
+			px[1] = floatToHalf(yuvFixedToFloat(g));
+			px[2] = floatToHalf(yuvFixedToFloat(b));
+			px[3] = floatToHalf(1.0f);
+		}
+		else
+		{
+			float* px = (float*)output + x * 4;
+
+			px[0] = yuvFixedToFloat(r);
+			px[1] = yuvFixedToFloat(g);
+			px[2] = yuvFixedToFloat(b);
+			px[3] = 1.0f;
+		}
+	}
+}
+
+
+#endif
@@ -0,0 +1,750 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cpuYUV.h"
+#include "cpuYUV-row.h"
+#include "cpuFeatures.h"
+#include "cpuThreadPool.h"
+#include "cudaYUV-Profiles.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+
+// cpuNV12RowSIMD
+//  run the SIMD row kernel of the ISA, returning the number of pixels it converted
+static inline size_t cpuNV12RowSIMD( cpuISA isa, const yuvCoeffs& k, cpuNV12Format format, const uint8_t* luma, const uint8_t* chroma, const uint8_t* chromaNext, void* output, size_t width )
+{
+	if( isa == CPU_ISA_AVX2 )
+		return cpuNV12RowAVX2(k, format, luma, chroma, chromaNext, output, width);
+	else if( isa == CPU_ISA_SSE41 )
+		return cpuNV12RowSSE41(k, format, luma, chroma, chromaNext, output, width);
+	else if( isa == CPU_ISA_NEON )
+		return cpuNV12RowNEON(k, format, luma, chroma, chromaNext, output, width);
+
+	return 0;
+}
+
+static inline size_t cpuNV12RowSIMD( cpuISA isa, const yuvCoeffs& k, cpuNV12Format format, const uint16_t* luma, const uint16_t* chroma, const uint16_t* chromaNext, void* output, size_t width )
+{
+	if( isa == CPU_ISA_AVX2 )
+		return cpuP010RowAVX2(k, format, luma, chroma, chromaNext, output, width);
+	else if( isa == CPU_ISA_SSE41 )
+		return cpuP010RowSSE41(k, format, luma, chroma, chromaNext, output, width);
+	else if( isa == CPU_ISA_NEON )
+		return cpuP010RowNEON(k, format, luma, chroma, chromaNext, output, width);
+
+	return 0;
+}
+
+
+// cpuNV12Row
+template<typename T>
+static inline void cpuNV12Row( cpuISA isa, const yuvCoeffs& k, cpuNV12Format format, const T* luma, const T* chroma, const T* chromaNext, void* output, size_t width )
+{
+	size_t x = 0;
+
+	// half-float RGBA only has the scalar kernel
+	if( format != CPU_NV12_RGBAH )
+		x = cpuNV12RowSIMD(isa, k, format, luma, chroma, chromaNext, output, width);
+
+	cpuNV12RowScalar(k, format, luma, chroma, chromaNext, output, x, width);
+}
+
+
+// cpuStageChroma
+//  interleave chroma row c of an NV21 or I420 frame into NV12 order (U V U V ...)
+static void cpuStageChroma( yuvFormat layout, const uint8_t* input, size_t inputPitch, size_t height, size_t c, size_t width, uint8_t* uv )
+{
+	const size_t   chromaPitch = yuvChromaPitch(layout, inputPitch);
+	const size_t   pairs       = (width + 1) / 2;
+	const uint8_t* chroma      = input + inputPitch * height + c * chromaPitch;
+
+	if( layout == YUV_NV21 )
+	{
+		for( size_t n=0; n < pairs; n++ )
+		{
+			uv[n * 2]     = chroma[n * 2 + 1];
+			uv[n * 2 + 1] = chroma[n * 2];
+		}
+	}
+	else
+	{
+		const uint8_t* v = chroma + chromaPitch * ((height + 1) / 2);
+
+		for( size_t n=0; n < pairs; n++ )
+		{
+			uv[n * 2]     = chroma[n];
+			uv[n * 2 + 1] = v[n];
+		}
+	}
+}
+
+
+// cpuYUVConvert
+static bool cpuYUVConvert( yuvFormat layout, cpuNV12Format format, uint8_t* input, size_t inputPitch, void* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	if( !input || !output || inputPitch == 0 || outputPitch == 0 || width == 0 || height == 0 )
+		return false;
+
+	// P010 is read as 16-bit words
+	if( layout == YUV_P010 && (inputPitch % sizeof(uint16_t) != 0 || (size_t)input % sizeof(uint16_t) != 0) )
+		return false;
+
+	const cpuISA isa = cpuGetISA();
+	const yuvCoeffs k = yuvCoeffsInit(colorimetry, yuvFormatDepth(layout));
+	const uint8_t* chromaPlane = input + inputPitch * height;
+	const bool staged = (layout == YUV_NV21 || layout == YUV_I420);
+
+	cpuParallelRows(height, width, [&](size_t begin, size_t end)
+	{
+		// NV21/I420 chroma rows reordered for the NV12 kernels, by chroma row parity
+		const size_t stagingSize = staged ? (width + 1) & ~size_t(1) : 0;
+
+		std::vector<uint8_t> staging(stagingSize * 2);
+		size_t stagedRow[] = { SIZE_MAX, SIZE_MAX };
+
+		auto stageChroma = [&](size_t c) -> const uint8_t*
+		{
+			uint8_t* uv = &staging[(c & 1) * stagingSize];
+
+			if( stagedRow[c & 1] != c )
+			{
+				cpuStageChroma(layout, input, inputPitch, height, c, width, uv);
+				stagedRow[c & 1] = c;
+			}
+
+			return uv;
+		};
+
+		for( size_t y=begin; y < end; y++ )
+		{
+			const size_t c = y >> 1;
+
+			// interpolate chroma vertically on odd rows, except for the last chroma row
+			const bool interpolate = (y & 1) && c + 1 < (height >> 1);
+			void* row = (uint8_t*)output + y * outputPitch;
+
+			if( layout == YUV_P010 )
+			{
+				const uint16_t* luma   = (const uint16_t*)(input + y * inputPitch);
+				const uint16_t* chroma = (const uint16_t*)(chromaPlane + c * inputPitch);
+				const uint16_t* next   = interpolate ? (const uint16_t*)(chromaPlane + (c + 1) * inputPitch) : NULL;
+
+				cpuNV12Row(isa, k, format, luma, chroma, next, row, width);
+				continue;
+			}
+
+			const uint8_t* luma   = input + y * inputPitch;
+			const uint8_t* chroma = staged ? stageChroma(c) : chromaPlane + c * inputPitch;
+			const uint8_t* next   = NULL;
+
+			if( interpolate )
+				next = staged ? stageChroma(c + 1) : chroma + inputPitch;
+
+			cpuNV12Row(isa, k, format, luma, chroma, next, row, width);
+		}
+	});
+
+	return true;
+}
+
+static bool cpuYUVConvert( yuvFormat layout, uint8_t* input, size_t inputPitch, void* output, size_t outputPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry )
+{
+	switch(format)
+	{
+		case IMAGE_RGBA32F:	return cpuYUVConvert(layout, CPU_NV12_RGBAF, input, inputPitch, output, outputPitch, width, height, colorimetry);
+		case IMAGE_RGBA16F:	return cpuYUVConvert(layout, CPU_NV12_RGBAH, input, inputPitch, output, outputPitch, width, height, colorimetry);
+		case IMAGE_RGBA8:	return cpuYUVConvert(layout, CPU_NV12_RGBA8, input, inputPitch, output, outputPitch, width, height, colorimetry);
+		case IMAGE_RGB8:	return cpuYUVConvert(layout, CPU_NV12_RGB8, input, inputPitch, output, outputPitch, width, height, colorimetry);
+		case IMAGE_BGR8:	return cpuYUVConvert(layout, CPU_NV12_BGR8, input, inputPitch, output, outputPitch, width, height, colorimetry);
+	}
+
+	return false;
+}
+
+
+// cpuNV12ToRGBA
+bool cpuNV12ToRGBA( uint8_t* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	TRACE_SCOPE("cpuNV12ToRGBA");
+	return cpuYUVConvert(YUV_NV12, CPU_NV12_RGBA8, input, inputPitch, output, outputPitch, width, height, colorimetry);
+}
+
+bool cpuNV12ToRGBA( uint8_t* input, uchar4* output, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	return cpuNV12ToRGBA(input, yuvFormatPitch(YUV_NV12, width), output, width * sizeof(uchar4), width, height, colorimetry);
+}
+
+
+// cpuNV12ToRGBAf
+bool cpuNV12ToRGBAf( uint8_t* input, size_t inputPitch, float4* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	TRACE_SCOPE("cpuNV12ToRGBAf");
+	return cpuYUVConvert(YUV_NV12, CPU_NV12_RGBAF, input, inputPitch, output, outputPitch, width, height, colorimetry);
+}
+
+bool cpuNV12ToRGBAf( uint8_t* input, float4* output, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	return cpuNV12ToRGBAf(input, yuvFormatPitch(YUV_NV12, width), output, width * sizeof(float4), width, height, colorimetry);
+}
+
+
+// cpuNV12ToBGR
+bool cpuNV12ToBGR( uint8_t* input, size_t inputPitch, uchar3* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	TRACE_SCOPE("cpuNV12ToBGR");
+	return cpuYUVConvert(YUV_NV12, CPU_NV12_BGR8, input, inputPitch, output, outputPitch, width, height, colorimetry);
+}
+
+bool cpuNV12ToBGR( uint8_t* input, uchar3* output, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	return cpuNV12ToBGR(input, yuvFormatPitch(YUV_NV12, width), output, width * sizeof(uchar3), width, height, colorimetry);
+}
+
+
+// cpuNV12ToFormat
+bool cpuNV12ToFormat( uint8_t* input, size_t inputPitch, void* output, size_t outputPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry )
+{
+	TRACE_SCOPE("cpuNV12ToFormat");
+	return cpuYUVConvert(YUV_NV12, input, inputPitch, output, outputPitch, width, height, format, colorimetry);
+}
+
+bool cpuNV12ToFormat( uint8_t* input, void* output, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry )
+{
+	return cpuNV12ToFormat(input, yuvFormatPitch(YUV_NV12, width), output, width * imageFormatSize(format), width, height, format, colorimetry);
+}
+
+
+// cpuYUVToFormat
+bool cpuYUVToFormat( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, void* output, size_t outputPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry )
+{
+	TRACE_SCOPE("cpuYUVToFormat");
+	return cpuYUVConvert(inputFormat, input, inputPitch, output, outputPitch, width, height, format, colorimetry);
+}
+
+bool cpuYUVToFormat( uint8_t* input, yuvFormat inputFormat, void* output, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry )
+{
+	return cpuYUVToFormat(input, yuvFormatPitch(inputFormat, width), inputFormat, output, width * imageFormatSize(format), width, height, format, colorimetry);
+}
+
+
+
+// cpuYUVBatchRow
+//  convert output row y of a batch frame.  When the ROI isn't resized horizontally
+//  and starts on an even column (so the chroma pairs line up), the source row goes
+//  through the row kernels, otherwise each pixel is sampled like the CUDA kernel.
+template<yuvFormat layout, imageFormat format>
+static void cpuYUVBatchRow( cpuISA isa, cpuNV12Format rowFormat, const yuvBatchParams& p, uint32_t y, std::vector<uint8_t>& staging )
+{
+	if( p.width != p.roiWidth || (p.roiLeft & 1) )
+	{
+		for( uint32_t x=0; x < p.width; x++ )
+			yuvBatchPixel<layout, format>(p, x, y);
+
+		return;
+	}
+
+	const uint32_t sy = yuvBatchSource(y, p.scale.y, p.roiTop, p.roiHeight);
+	const uint32_t c  = sy >> 1;
+
+	// interpolate chroma vertically on odd rows, except for the last chroma row
+	const bool interpolate = (sy & 1) && c + 1 < (p.inputHeight >> 1);
+
+	const uint8_t* chromaPlane = p.input + p.inputPitch * p.inputHeight;
+	void* row = p.output + y * p.outputPitch;
+
+	if( layout == YUV_P010 )
+	{
+		const uint16_t* luma   = (const uint16_t*)(p.input + sy * p.inputPitch) + p.roiLeft;
+		const uint16_t* chroma = (const uint16_t*)(chromaPlane + c * p.inputPitch) + p.roiLeft;
+		const uint16_t* next   = interpolate ? (const uint16_t*)(chromaPlane + (c + 1) * p.inputPitch) + p.roiLeft : NULL;
+
+		cpuNV12Row(isa, p.coeffs, rowFormat, luma, chroma, next, row, p.width);
+		return;
+	}
+
+	const uint8_t* luma   = p.input + sy * p.inputPitch + p.roiLeft;
+	const uint8_t* chroma = chromaPlane + c * p.inputPitch + p.roiLeft;
+	const uint8_t* next   = interpolate ? chroma + p.inputPitch : NULL;
+
+	// NV21/I420 chroma rows reordered for the NV12 kernels, up to the right edge of the ROI
+	if( layout == YUV_NV21 || layout == YUV_I420 )
+	{
+		const size_t stagedWidth = p.roiLeft + p.width;
+		const size_t stagingSize = (stagedWidth + 1) & ~size_t(1);
+
+		if( staging.size() < stagingSize * 2 )
+			staging.resize(stagingSize * 2);
+
+		cpuStageChroma(layout, p.input, p.inputPitch, p.inputHeight, c, stagedWidth, &staging[0]);
+		chroma = &staging[p.roiLeft];
+
+		if( interpolate )
+		{
+			cpuStageChroma(layout, p.input, p.inputPitch, p.inputHeight, c + 1, stagedWidth, &staging[stagingSize]);
+			next = &staging[stagingSize + p.roiLeft];
+		}
+	}
+
+	cpuNV12Row(isa, p.coeffs, rowFormat, luma, chroma, next, row, p.width);
+}
+
+
+// cpuYUVBatch
+//  the output rows of all the frames are split over the pool as one range
+template<yuvFormat layout, imageFormat format>
+static bool cpuYUVBatch( const yuvBatchFrame* frames, size_t count, cpuNV12Format rowFormat )
+{
+	if( !frames || count == 0 )
+		return false;
+
+	// check every frame first, so an invalid one doesn't leave the batch half-done
+	std::vector<yuvBatchParams> params(count);
+	std::vector<size_t> firstRow(count + 1, 0);		// of each frame in the range
+	size_t pixels = 0;
+
+	for( size_t n=0; n < count; n++ )
+	{
+		if( !yuvBatchParamsInit(frames[n], layout, params[n]) )
+			return false;
+
+		firstRow[n + 1] = firstRow[n] + params[n].height;
+		pixels += size_t(params[n].width) * params[n].height;
+	}
+
+	const cpuISA isa  = cpuGetISA();
+	const size_t rows = firstRow[count];
+
+	cpuParallelRows(rows, pixels / rows, [&](size_t begin, size_t end)
+	{
+		std::vector<uint8_t> staging;
+		size_t n = std::upper_bound(firstRow.begin(), firstRow.end(), begin) - firstRow.begin() - 1;
+
+		for( size_t r=begin; r < end; r++ )
+		{
+			while( r >= firstRow[n + 1] )
+				n++;
+
+			cpuYUVBatchRow<layout, format>(isa, rowFormat, params[n], r - firstRow[n], staging);
+		}
+	});
+
+	return true;
+}
+
+template<yuvFormat layout>
+static bool cpuYUVBatch( const yuvBatchFrame* frames, size_t count, imageFormat format )
+{
+	switch(format)
+	{
+		case IMAGE_RGBA32F:	return cpuYUVBatch<layout, IMAGE_RGBA32F>(frames, count, CPU_NV12_RGBAF);
+		case IMAGE_RGBA16F:	return cpuYUVBatch<layout, IMAGE_RGBA16F>(frames, count, CPU_NV12_RGBAH);
+		case IMAGE_RGBA8:	return cpuYUVBatch<layout, IMAGE_RGBA8>(frames, count, CPU_NV12_RGBA8);
+		case IMAGE_RGB8:	return cpuYUVBatch<layout, IMAGE_RGB8>(frames, count, CPU_NV12_RGB8);
+		case IMAGE_BGR8:	return cpuYUVBatch<layout, IMAGE_BGR8>(frames, count, CPU_NV12_BGR8);
+	}
+
+	return false;
+}
+
+
+// cpuYUVToFormatBatch
+bool cpuYUVToFormatBatch( const yuvBatchFrame* frames, size_t count, yuvFormat inputFormat, imageFormat format )
+{
+	TRACE_SCOPE("cpuYUVToFormatBatch");
+
+	switch(inputFormat)
+	{
+		case YUV_NV12:	return cpuYUVBatch<YUV_NV12>(frames, count, format);
+		case YUV_NV21:	return cpuYUVBatch<YUV_NV21>(frames, count, format);
+		case YUV_I420:	return cpuYUVBatch<YUV_I420>(frames, count, format);
+		case YUV_P010:	return cpuYUVBatch<YUV_P010>(frames, count, format);
+	}
+
+	return false;
+}
+
+
+// sampleProfileRow
+//  output row y of a profile, converted at the source columns that it samples
+template<yuvFormat layout, imageFormat format, imageLayout outputLayout>
+static void sampleProfileRow( const yuvProfilesLaunch& l, const yuvProfileParams& p, uint32_t sy, uint32_t y, const uint32_t* sources )
+{
+	const size_t planeSize = size_t(p.width) * p.height;
+	uint8_t*     row       = (outputLayout == IMAGE_PLANAR) ? p.output : p.output + size_t(y) * p.width * imageFormatSize(format);
+	const size_t index     = (outputLayout == IMAGE_PLANAR) ? size_t(y) * p.width : 0;
+
+	for( uint32_t x=0; x < p.width; x++ )
+	{
+		uint32_t luma, u, v;
+		int32_t  r, g, b;
+
+		yuvSample<layout>(l.input, l.inputPitch, l.height, sources[x], sy, luma, u, v);
+		yuvToRGBFixed(l.coeffs, luma, u, v, r, g, b);
+
+		if( outputLayout == IMAGE_PLANAR )
+			imageStorePlanarFixed<format>(row, planeSize, index + x, r, g, b);
+		else
+			imageStoreRGBFixed<format>(row, x, r, g, b);
+	}
+}
+
+template<yuvFormat layout, imageFormat format>
+static void sampleProfileRow( const yuvProfilesLaunch& l, const yuvProfileParams& p, uint32_t sy, uint32_t y, const uint32_t* sources )
+{
+	if( p.layout == IMAGE_PLANAR )
+		sampleProfileRow<layout, format, IMAGE_PLANAR>(l, p, sy, y, sources);
+	else
+		sampleProfileRow<layout, format, IMAGE_INTERLEAVED>(l, p, sy, y, sources);
+}
+
+template<yuvFormat layout>
+static void sampleProfileRow( const yuvProfilesLaunch& l, const yuvProfileParams& p, uint32_t sy, uint32_t y, const uint32_t* sources )
+{
+	switch(p.format)
+	{
+		case IMAGE_RGBA32F:	sampleProfileRow<layout, IMAGE_RGBA32F>(l, p, sy, y, sources); break;
+		case IMAGE_RGBA16F:	sampleProfileRow<layout, IMAGE_RGBA16F>(l, p, sy, y, sources); break;
+		case IMAGE_RGBA8:	sampleProfileRow<layout, IMAGE_RGBA8>(l, p, sy, y, sources); break;
+		case IMAGE_RGB8:	sampleProfileRow<layout, IMAGE_RGB8>(l, p, sy, y, sources); break;
+		case IMAGE_BGR8:	sampleProfileRow<layout, IMAGE_BGR8>(l, p, sy, y, sources); break;
+	}
+}
+
+
+// gatherProfileRow
+//  output row y of an interleaved profile, picked from the converted source row
+static void gatherProfileRow( const yuvProfileParams& p, uint32_t y, const uint32_t* sources, const uint8_t* row )
+{
+	const size_t pixelSize = imageFormatSize((imageFormat)p.format);
+	uint8_t* out = p.output + y * p.width * pixelSize;
+
+	if( pixelSize == 4 )
+	{
+		for( uint32_t x=0; x < p.width; x++ )
+			((uint32_t*)out)[x] = ((const uint32_t*)row)[sources[x]];
+	}
+	else
+	{
+		for( uint32_t x=0; x < p.width; x++ )
+			memcpy(out + x * 3, row + sources[x] * 3, 3);
+	}
+}
+
+
+// copyProfileRow
+//  duplicate output row y of a profile into row y+n, for vertical upscales
+static void copyProfileRow( const yuvProfileParams& p, uint32_t y, uint32_t n )
+{
+	const size_t pixelSize = imageFormatSize((imageFormat)p.format);
+
+	if( p.layout != IMAGE_PLANAR )
+	{
+		const size_t rowSize = p.width * pixelSize;
+		memcpy(p.output + (y + n) * rowSize, p.output + y * rowSize, rowSize);
+		return;
+	}
+
+	// one plane per channel
+	const size_t channelSize = pixelSize / 4;
+	const size_t rowSize     = p.width * channelSize;
+	const size_t planeSize   = rowSize * p.height;
+
+	for( size_t c=0; c < 4; c++ )
+		memcpy(p.output + c * planeSize + (y + n) * rowSize, p.output + c * planeSize + y * rowSize, rowSize);
+}
+
+
+// cpuYUVProfileRow
+//  output row y of a full-width interleaved profile, through the row kernels of the batch
+template<yuvFormat layout>
+static void cpuYUVProfileRow( cpuISA isa, const yuvBatchParams& p, imageFormat format, uint32_t y, std::vector<uint8_t>& staging )
+{
+	switch(format)
+	{
+		case IMAGE_RGBA32F:	cpuYUVBatchRow<layout, IMAGE_RGBA32F>(isa, CPU_NV12_RGBAF, p, y, staging); break;
+		case IMAGE_RGBA16F:	cpuYUVBatchRow<layout, IMAGE_RGBA16F>(isa, CPU_NV12_RGBAH, p, y, staging); break;
+		case IMAGE_RGBA8:	cpuYUVBatchRow<layout, IMAGE_RGBA8>(isa, CPU_NV12_RGBA8, p, y, staging); break;
+		case IMAGE_RGB8:	cpuYUVBatchRow<layout, IMAGE_RGB8>(isa, CPU_NV12_RGB8, p, y, staging); break;
+		case IMAGE_BGR8:	cpuYUVBatchRow<layout, IMAGE_BGR8>(isa, CPU_NV12_BGR8, p, y, staging); break;
+	}
+}
+
+
+// cpuYUVProfiles
+//  the source rows are split over the pool, so each one is read from memory once for
+//  all the profiles.  Profiles as wide as the frame and interleaved go through the row
+//  kernels.  Resized interleaved 8-bit profiles are picked from the source row
+//  converted by the row kernels, which is cheaper than converting the columns they
+//  sample one by one.  The others are converted at those columns (the same pixels as
+//  yuvProfilesPixel(), which goes the other way); the columns of different scales
+//  hardly ever coincide, so each profile converts its own.  Vertically upscaled rows
+//  are copied.
+template<yuvFormat layout>
+static bool cpuYUVProfiles( uint8_t* input, size_t inputPitch, size_t width, size_t height, const yuvProfile* profiles, size_t count, const yuvColorimetry& colorimetry )
+{
+	yuvProfilesLaunch l;
+
+	if( !yuvProfilesInit(input, inputPitch, layout, width, height, profiles, count, colorimetry, l) )
+		return false;
+
+	yuvBatchParams rowParams[YUV_PROFILES_MAX];
+	bool rowKernel[YUV_PROFILES_MAX];
+	bool rowGather[YUV_PROFILES_MAX];
+
+	std::vector<uint32_t> sources[YUV_PROFILES_MAX];
+
+	for( uint32_t n=0; n < l.count; n++ )
+	{
+		const yuvProfileParams& p = l.profiles[n];
+		rowKernel[n] = (p.width == l.width && p.layout == IMAGE_INTERLEAVED);
+		rowGather[n] = (!rowKernel[n] && p.layout == IMAGE_INTERLEAVED && imageFormatSize(profiles[n].format) <= 4);
+
+		if( rowKernel[n] || rowGather[n] )
+		{
+			yuvBatchFrame frame;
+
+			frame.input        = input;
+			frame.inputPitch   = inputPitch;
+			frame.inputWidth   = width;
+			frame.inputHeight  = height;
+			frame.output       = p.output;
+			frame.outputPitch  = l.width * imageFormatSize(profiles[n].format);
+			frame.outputWidth  = rowKernel[n] ? p.width : l.width;
+			frame.outputHeight = rowKernel[n] ? p.height : l.height;
+			frame.colorimetry  = colorimetry;
+
+			if( !yuvBatchParamsInit(frame, layout, rowParams[n]) )
+				return false;
+
+			// every source row is converted into the same per-thread row, then gathered
+			if( rowGather[n] )
+				rowParams[n].outputPitch = 0;
+
+			if( rowKernel[n] )
+				continue;
+		}
+
+		sources[n].resize(p.width);
+
+		for( uint32_t x=0; x < p.width; x++ )
+			sources[n][x] = yuvBatchSource(x, p.scale.x, 0, l.width);
+	}
+
+	const cpuISA isa = cpuGetISA();
+
+	cpuParallelRows(l.height, l.width, [&](size_t begin, size_t end)
+	{
+		std::vector<uint8_t> staging;
+		std::vector<uint8_t> converted(l.width * 4);
+
+		for( size_t sy=begin; sy < end; sy++ )
+		{
+			uint32_t convertedFormat = 0xFFFFFFFF;	// of the source row in converted
+
+			for( uint32_t n=0; n < l.count; n++ )
+			{
+				const yuvProfileParams& p = l.profiles[n];
+				uint32_t y0, y1;
+
+				yuvProfileRange(sy, p.scale.y, l.height, p.height, y0, y1);
+
+				if( y0 == y1 )
+					continue;
+
+				if( rowKernel[n] )
+				{
+					cpuYUVProfileRow<layout>(isa, rowParams[n], profiles[n].format, y0, staging);
+				}
+				else if( rowGather[n] )
+				{
+					if( p.format != convertedFormat )
+					{
+						yuvBatchParams row = rowParams[n];
+						row.output = &converted[0];
+
+						cpuYUVProfileRow<layout>(isa, row, profiles[n].format, sy, staging);
+						convertedFormat = p.format;
+					}
+
+					gatherProfileRow(p, y0, &sources[n][0], &converted[0]);
+				}
+				else
+				{
+					sampleProfileRow<layout>(l, p, sy, y0, &sources[n][0]);
+				}
+
+				for( uint32_t y=y0 + 1; y < y1; y++ )
+					copyProfileRow(p, y0, y - y0);
+			}
+		}
+	});
+
+	return true;
+}
+
+
+// cpuYUVToProfiles
+bool cpuYUVToProfiles( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t width, size_t height, const yuvProfile* profiles, size_t count,
+				   const yuvColorimetry& colorimetry )
+{
+	TRACE_SCOPE("cpuYUVToProfiles");
+
+	switch(inputFormat)
+	{
+		case YUV_NV12:	return cpuYUVProfiles<YUV_NV12>(input, inputPitch, width, height, profiles, count, colorimetry);
+		case YUV_NV21:	return cpuYUVProfiles<YUV_NV21>(input, inputPitch, width, height, profiles, count, colorimetry);
+		case YUV_I420:	return cpuYUVProfiles<YUV_I420>(input, inputPitch, width, height, profiles, count, colorimetry);
+		case YUV_P010:	return cpuYUVProfiles<YUV_P010>(input, inputPitch, width, height, profiles, count, colorimetry);
+	}
+
+	return false;
+}
+
+
+
+// cpuRGBToNV12RowSIMD
+//  run the SIMD encode kernel of the ISA, returning the number of pixels it converted
+static inline size_t cpuRGBToNV12RowSIMD( cpuISA isa, const rgbCoeffs& k, imageFormat format, const uint8_t* row0, const uint8_t* row1, uint8_t* luma0, uint8_t* luma1, uint8_t* chroma, size_t width )
+{
+	if( isa == CPU_ISA_AVX2 )
+		return cpuRGBToNV12RowAVX2(k, format, row0, row1, luma0, luma1, chroma, width);
+	else if( isa == CPU_ISA_SSE41 )
+		return cpuRGBToNV12RowSSE41(k, format, row0, row1, luma0, luma1, chroma, width);
+	else if( isa == CPU_ISA_NEON )
+		return cpuRGBToNV12RowNEON(k, format, row0, row1, luma0, luma1, chroma, width);
+
+	return 0;
+}
+
+
+// cpuRGBToNV12
+//  each task converts pairs of rows, which share a chroma row.  chromaPlane
+//  is the first chroma sample of the image, if it doesn't follow the luma rows.
+template<imageFormat format>
+static bool cpuRGBToNV12( uint8_t* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry,
+					 uint8_t* chromaPlane=NULL )
+{
+	// the chroma rows hold the U/V pair of the last odd column too
+	if( !input || !output || inputPitch == 0 || width == 0 || height == 0 || outputPitch < yuvFormatPitch(YUV_NV12, width) )
+		return false;
+
+	const cpuISA isa = cpuGetISA();
+	const rgbCoeffs k = rgbCoeffsInit(colorimetry);
+
+	if( !chromaPlane )
+		chromaPlane = output + outputPitch * height;
+
+	cpuParallelRows((height + 1) / 2, width * 2, [&](size_t begin, size_t end)
+	{
+		for( size_t c=begin; c < end; c++ )
+		{
+			const size_t y0 = c * 2;
+			const size_t y1 = (y0 + 1 < height) ? y0 + 1 : y0;
+
+			const uint8_t* row0 = input + y0 * inputPitch;
+			const uint8_t* row1 = input + y1 * inputPitch;
+
+			uint8_t* luma0  = output + y0 * outputPitch;
+			uint8_t* luma1  = output + y1 * outputPitch;
+			uint8_t* chroma = chromaPlane + c * outputPitch;
+
+			const size_t x = cpuRGBToNV12RowSIMD(isa, k, format, row0, row1, luma0, luma1, chroma, width);
+			cpuRGBToNV12RowScalar<format>(k, row0, row1, luma0, luma1, chroma, x, width);
+		}
+	});
+
+	return true;
+}
+
+
+// cpuRGBAToNV12
+bool cpuRGBAToNV12( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	TRACE_SCOPE("cpuRGBAToNV12");
+	return cpuRGBToNV12<IMAGE_RGBA8>((uint8_t*)input, inputPitch, output, outputPitch, width, height, colorimetry);
+}
+
+bool cpuRGBAToNV12( uchar4* input, uint8_t* output, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	return cpuRGBAToNV12(input, width * sizeof(uchar4), output, yuvFormatPitch(YUV_NV12, width), width, height, colorimetry);
+}
+
+bool cpuRGBAToNV12( float4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	TRACE_SCOPE("cpuRGBAToNV12");
+	return cpuRGBToNV12<IMAGE_RGBA32F>((uint8_t*)input, inputPitch, output, outputPitch, width, height, colorimetry);
+}
+
+bool cpuRGBAToNV12( float4* input, uint8_t* output, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	return cpuRGBAToNV12(input, width * sizeof(float4), output, yuvFormatPitch(YUV_NV12, width), width, height, colorimetry);
+}
+
+
+// cpuRGBToNV12
+static bool cpuRGBToNV12( uint8_t* input, size_t inputPitch, imageFormat format, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry,
+					 uint8_t* chromaPlane=NULL )
+{
+	switch(format)
+	{
+		case IMAGE_RGBA32F:	return cpuRGBToNV12<IMAGE_RGBA32F>(input, inputPitch, output, outputPitch, width, height, colorimetry, chromaPlane);
+		case IMAGE_RGBA8:	return cpuRGBToNV12<IMAGE_RGBA8>(input, inputPitch, output, outputPitch, width, height, colorimetry, chromaPlane);
+		case IMAGE_RGB8:	return cpuRGBToNV12<IMAGE_RGB8>(input, inputPitch, output, outputPitch, width, height, colorimetry, chromaPlane);
+		case IMAGE_BGR8:	return cpuRGBToNV12<IMAGE_BGR8>(input, inputPitch, output, outputPitch, width, height, colorimetry, chromaPlane);
+		case IMAGE_RGBA16F:	break;
+	}
+
+	return false;
+}
+
+
+// cpuFormatToNV12
+bool cpuFormatToNV12( void* input, size_t inputPitch, imageFormat format, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	TRACE_SCOPE("cpuFormatToNV12");
+	return cpuRGBToNV12((uint8_t*)input, inputPitch, format, output, outputPitch, width, height, colorimetry);
+}
+
+bool cpuFormatToNV12( void* input, imageFormat format, uint8_t* output, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	return cpuFormatToNV12(input, width * imageFormatSize(format), format, output, yuvFormatPitch(YUV_NV12, width), width, height, colorimetry);
+}
+
+
+// cpuFormatToNV12Rect
+bool cpuFormatToNV12Rect( void* input, size_t inputPitch, imageFormat format, uint8_t* output, size_t outputPitch, size_t frameHeight,
+					 size_t left, size_t top, size_t width, size_t height, const yuvColorimetry& colorimetry )
+{
+	TRACE_SCOPE("cpuFormatToNV12Rect");
+
+	// the chroma pairs and rows of the rectangle mustn't be shared with its neighbours
+	if( !output || (left & 1) || (top & 1) || (width & 1) || ((height & 1) && top + height != frameHeight) || top + height > frameHeight || left + width > outputPitch )
+		return false;
+
+	return cpuRGBToNV12((uint8_t*)input, inputPitch, format, output + top * outputPitch + left, outputPitch, width, height, colorimetry,
+				    output + outputPitch * frameHeight + (top / 2) * outputPitch + left);
+}
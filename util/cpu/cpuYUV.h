@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CPU_YUV_CONVERT_H
+#define __CPU_YUV_CONVERT_H
+
+
+#include "cudaUtility.h"
+#include "cudaYUV.h"
+#include "imageFormat.h"
+#include <stdint.h>
+
+
+//////////////////////////////////////////////////////////////////////////////////
+/// @name YUV NV12 to RGB on the CPU
+/// @ingroup util
+//////////////////////////////////////////////////////////////////////////////////
+
+///@{
+
+/**
+ * CPU equivalents of cudaNV12ToRGBA() / cudaNV12ToRGBAf(), for nodes without a GPU.
+ *
+ * The results are bit-exact with the CUDA kernels (integer fixed-point, see cudaColorspace.h)
+ * for the given colorimetry.
+ * The SIMD implementation (AVX2, SSE4.1 or NEON) is selected at runtime from
+ * the CPU features, see cpuFeatures.h, and the rows are split across the
+ * threads of cpuThreadPool::Global().  Pitches are in bytes.
+ */
+bool cpuNV12ToRGBA( uint8_t* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry() );
+bool cpuNV12ToRGBA( uint8_t* input, uchar4* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry() );
+
+bool cpuNV12ToRGBAf( uint8_t* input, size_t inputPitch, float4* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry() );
+bool cpuNV12ToRGBAf( uint8_t* input, float4* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry() );
+
+/**
+ * Convert NV12 to packed 8-bit BGR, as used by OpenCV (CV_8UC3).
+ * The values are the same as cpuNV12ToRGBA(), reordered and without alpha.
+ */
+bool cpuNV12ToBGR( uint8_t* input, size_t inputPitch, uchar3* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry() );
+bool cpuNV12ToBGR( uint8_t* input, uchar3* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry() );
+
+/**
+ * CPU equivalent of cudaNV12ToFormat().  IMAGE_RGBA16F uses the scalar path.
+ */
+bool cpuNV12ToFormat( uint8_t* input, size_t inputPitch, void* output, size_t outputPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry=yuvColorimetry() );
+bool cpuNV12ToFormat( uint8_t* input, void* output, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry=yuvColorimetry() );
+
+/**
+ * CPU equivalent of cudaYUVToFormat(), for NV12, NV21, I420 and P010 input.
+ * NV21 and I420 chroma rows are interleaved into NV12 order and converted by the
+ * NV12 kernels, P010 has its own 16-bit SIMD kernels.
+ */
+bool cpuYUVToFormat( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, void* output, size_t outputPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry=yuvColorimetry() );
+bool cpuYUVToFormat( uint8_t* input, yuvFormat inputFormat, void* output, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry=yuvColorimetry() );
+
+/**
+ * CPU equivalent of cudaYUVToFormatBatch().  The rows of all the frames are
+ * split over the thread pool as one parallel loop.  Frames whose ROI keeps its
+ * width and starts on an even column use the SIMD row kernels, the others are
+ * sampled per pixel.
+ */
+bool cpuYUVToFormatBatch( const yuvBatchFrame* frames, size_t count, yuvFormat inputFormat, imageFormat format );
+
+/**
+ * CPU equivalent of cudaYUVToProfiles().  The source rows are split over the
+ * thread pool, rows and columns that no profile samples are skipped.  Profiles
+ * as wide as the frame and interleaved use the SIMD row kernels of the batch,
+ * resized interleaved 8-bit ones are picked from a row converted by them.
+ */
+bool cpuYUVToProfiles( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t width, size_t height, const yuvProfile* profiles, size_t count,
+				   const yuvColorimetry& colorimetry=yuvColorimetry() );
+
+///@}
+
+//////////////////////////////////////////////////////////////////////////////////
+/// @name RGB to YUV 4:2:0 planar (I420, YV12) on the CPU
+/// @ingroup util
+//////////////////////////////////////////////////////////////////////////////////
+
+///@{
+
+/**
+ * CPU equivalents of cudaRGBAToI420() / cudaRGBAToYV12(), using the same integer math.
+ */
+bool cpuRGBAToI420( uchar4* input, uint8_t* output, size_t width, size_t height );
+bool cpuRGBAToI420( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height );
+
+bool cpuRGBAToYV12( uchar4* input, uint8_t* output, size_t width, size_t height );
+bool cpuRGBAToYV12( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height );
+
+///@}
+
+
+//////////////////////////////////////////////////////////////////////////////////
+/// @name RGB to YUV 4:2:0 semi-planar (NV12) on the CPU
+/// @ingroup util
+//////////////////////////////////////////////////////////////////////////////////
+
+///@{
+
+/**
+ * CPU equivalents of cudaRGBAToNV12() / cudaFormatToNV12(), bit-exact with the CUDA kernel.
+ * Each thread converts pairs of rows with the SIMD kernel of cpuGetISA().
+ */
+bool cpuRGBAToNV12( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry() );
+bool cpuRGBAToNV12( uchar4* input, uint8_t* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry() );
+
+bool cpuRGBAToNV12( float4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry() );
+bool cpuRGBAToNV12( float4* input, uint8_t* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry() );
+
+bool cpuFormatToNV12( void* input, size_t inputPitch, imageFormat format, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry() );
+bool cpuFormatToNV12( void* input, imageFormat format, uint8_t* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry() );
+
+/**
+ * Encode an image into the width x height rectangle at (left, top) of an NV12
+ * frame of frameHeight rows, leaving the rest of the frame as it is.  The result
+ * is the same as cpuFormatToNV12() of a whole frame holding the image there.
+ * left, top and width must be even, and height too unless the rectangle ends at the bottom.
+ */
+bool cpuFormatToNV12Rect( void* input, size_t inputPitch, imageFormat format, uint8_t* output, size_t outputPitch, size_t frameHeight,
+					 size_t left, size_t top, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry() );
+
+///@}
+
+
+//////////////////////////////////////////////////////////////////////////////////
+/// @name YUV 4:2:2 packed (UYVY, YUYV) to RGBA or grayscale on the CPU
+/// @ingroup util
+//////////////////////////////////////////////////////////////////////////////////
+
+///@{
+
+/**
+ * CPU equivalents of cudaUYVYToRGBA() / cudaYUYVToRGBA(), bit-exact with the CUDA kernels.
+ */
+bool cpuUYVYToRGBA( uchar2* input, uchar4* output, size_t width, size_t height );
+bool cpuUYVYToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height );
+
+bool cpuYUYVToRGBA( uchar2* input, uchar4* output, size_t width, size_t height );
+bool cpuYUYVToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height );
+
+/**
+ * CPU equivalents of cudaUYVYToGray() / cudaYUYVToGray(), with luma scaled to [0,1].
+ */
+bool cpuUYVYToGray( uchar2* input, float* output, size_t width, size_t height );
+bool cpuUYVYToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height );
+
+bool cpuYUYVToGray( uchar2* input, float* output, size_t width, size_t height );
+bool cpuYUYVToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height );
+
+///@}
+
+
+//////////////////////////////////////////////////////////////////////////////////
+/// @name YUV 4:2:0 luma to grayscale on the CPU
+/// @ingroup util
+//////////////////////////////////////////////////////////////////////////////////
+
+///@{
+
+/**
+ * CPU equivalents of cudaYUVToGray(), with the same results.
+ */
+bool cpuYUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, uint8_t* output, size_t outputPitch, size_t outputWidth, size_t outputHeight );
+bool cpuYUVToGray( uint8_t* input, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, uint8_t* output, size_t outputWidth, size_t outputHeight );
+
+bool cpuYUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, float* output, size_t outputPitch, size_t outputWidth, size_t outputHeight );
+bool cpuYUVToGray( uint8_t* input, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, float* output, size_t outputWidth, size_t outputHeight );
+
+///@}
+
+
+#endif
@@ -0,0 +1,725 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CUDA_COLORSPACE_H_
+#define __CUDA_COLORSPACE_H_
+
+
+#include "cudaUtility.h"
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+
+/**
+ * Color conversion math shared by the CUDA kernels and the CPU implementations in util/cpu.
+ *
+ * To keep both bit-exact, every multiply and add is rounded on its own:
+ * the device code uses the explicitly-rounded intrinsics (which nvcc never
+ * contracts into FMA), and the CPU sources are built with -ffp-contract=off.
+ * The SIMD kernels perform the same operations in the same order.
+ * @ingroup util
+ */
+#ifdef __CUDA_ARCH__
+	#define COLOR_MUL(a, b)		__fmul_rn(a, b)
+	#define COLOR_ADD(a, b)		__fadd_rn(a, b)
+	#define COLOR_SUB(a, b)		__fsub_rn(a, b)
+#else
+	#define COLOR_MUL(a, b)		((a) * (b))
+	#define COLOR_ADD(a, b)		((a) + (b))
+	#define COLOR_SUB(a, b)		((a) - (b))
+#endif
+
+
+/**
+ * YUV to RGB matrix of the NV12 conversion, from the colorimetry of the stream.
+ * @ingroup util
+ */
+enum yuvMatrix
+{
+	YUV_MATRIX_BT601 = 0,	/**< SD video and JPEG */
+	YUV_MATRIX_BT709,		/**< HD video */
+	YUV_MATRIX_BT2020		/**< UHD video (non-constant luminance) */
+};
+
+/**
+ * Quantization range of the YUV samples.
+ * @ingroup util
+ */
+enum yuvRange
+{
+	YUV_RANGE_LIMITED = 0,	/**< studio swing:  Y in [16,235], chroma in [16,240] */
+	YUV_RANGE_FULL		/**< Y and chroma in [0,255] */
+};
+
+/**
+ * Colorimetry of a YUV stream.  The default is BT.709 limited range, used by HD cameras and decoders.
+ * @ingroup util
+ */
+struct yuvColorimetry
+{
+	yuvMatrix matrix;
+	yuvRange  range;
+
+	yuvColorimetry( yuvMatrix m=YUV_MATRIX_BT709, yuvRange r=YUV_RANGE_LIMITED ) : matrix(m), range(r)	{}
+
+	inline bool operator == ( const yuvColorimetry& c ) const	{ return matrix == c.matrix && range == c.range; }
+	inline bool operator != ( const yuvColorimetry& c ) const	{ return !(*this == c); }
+};
+
+/**
+ * YUV 4:2:0 layouts of the decoder output, see yuvFormatFromStr() for the GStreamer names.
+ *
+ * The planes are contiguous:  the luma plane (height rows of pitch bytes) is followed
+ * by the chroma, (height+1)/2 rows of pitch bytes for the semi-planar formats (NV12,
+ * NV21, P010), or the U then the V plane with a pitch of yuvChromaPitch() for I420.
+ * @ingroup util
+ */
+enum yuvFormat
+{
+	YUV_NV12 = 0,	/**< 8-bit Y plane, interleaved U/V plane */
+	YUV_NV21,		/**< 8-bit Y plane, interleaved V/U plane */
+	YUV_I420,		/**< 8-bit Y, U and V planes */
+	YUV_P010		/**< 16-bit little-endian Y plane and interleaved U/V plane, 10 bits in the MSBs (HEVC Main10) */
+};
+
+/**
+ * Convert a yuvFormat to a string (the GStreamer format name)
+ * @ingroup util
+ */
+inline const char* yuvFormatToStr( yuvFormat format )
+{
+	switch(format)
+	{
+		case YUV_NV12:	return "NV12";
+		case YUV_NV21:	return "NV21";
+		case YUV_I420:	return "I420";
+		case YUV_P010:	return "P010_10LE";
+	}
+
+	return "unknown";
+}
+
+/**
+ * Parse a yuvFormat from the format of GStreamer caps, returning false if it isn't supported.
+ * @ingroup util
+ */
+inline bool yuvFormatFromStr( const char* str, yuvFormat& format )
+{
+	if( !str )
+		return false;
+
+	for( int n=YUV_NV12; n <= YUV_P010; n++ )
+	{
+		if( strcmp(str, yuvFormatToStr((yuvFormat)n)) == 0 )
+		{
+			format = (yuvFormat)n;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Bits per sample of a yuvFormat (8, or 10 for P010).
+ * @ingroup util
+ */
+inline __host__ __device__ uint32_t yuvFormatDepth( yuvFormat format )
+{
+	return (format == YUV_P010) ? 10 : 8;
+}
+
+/**
+ * Packed pitch of the luma plane, in bytes.  The semi-planar formats round
+ * odd widths up, so that the interleaved chroma rows fit in the same pitch.
+ * @ingroup util
+ */
+inline __host__ __device__ size_t yuvFormatPitch( yuvFormat format, size_t width )
+{
+	if( format == YUV_I420 )
+		return width;
+
+	const size_t evenWidth = (width + 1) & ~size_t(1);
+	return (format == YUV_P010) ? evenWidth * sizeof(uint16_t) : evenWidth;
+}
+
+/**
+ * Pitch of the chroma plane(s), in bytes, given the pitch of the luma plane.
+ * @ingroup util
+ */
+inline __host__ __device__ size_t yuvChromaPitch( yuvFormat format, size_t pitch )
+{
+	return (format == YUV_I420) ? (pitch + 1) / 2 : pitch;
+}
+
+/**
+ * Size of a frame, in bytes, given the pitch of the luma plane.
+ * @ingroup util
+ */
+inline __host__ __device__ size_t yuvFormatSize( yuvFormat format, size_t pitch, size_t height )
+{
+	const size_t chromaRows = (height + 1) / 2;
+
+	if( format == YUV_I420 )
+		return pitch * height + yuvChromaPitch(format, pitch) * chromaRows * 2;
+
+	return pitch * (height + chromaRows);
+}
+
+/**
+ * P010 samples hold 10 bits in the upper bits of each 16-bit word.
+ * @ingroup util
+ */
+#define YUV_P010_SHIFT		6
+
+
+/**
+ * Convert a yuvMatrix to a string (the GStreamer colorimetry name)
+ * @ingroup util
+ */
+inline const char* yuvMatrixToStr( yuvMatrix matrix )
+{
+	switch(matrix)
+	{
+		case YUV_MATRIX_BT601:	return "bt601";
+		case YUV_MATRIX_BT709:	return "bt709";
+		case YUV_MATRIX_BT2020:	return "bt2020";
+	}
+
+	return "unknown";
+}
+
+
+/**
+ * Fractional bits of the fixed-point YUV to RGB conversion.
+ * The intermediate RGB values are in the [0,255] range scaled by 2^YUV_FIXED_BITS,
+ * which stays well inside 32 bits and is exactly representable as float.
+ * @ingroup util
+ */
+#define YUV_FIXED_BITS		14
+#define YUV_FIXED_ONE		(1 << YUV_FIXED_BITS)
+
+/**
+ * Scale from the fixed-point RGB to the [0,255] float output of cudaNV12ToRGBAf().
+ * @ingroup util
+ */
+#define YUV_FIXED_SCALE		(1.0f / float(YUV_FIXED_ONE))
+
+
+/**
+ * Fixed-point YUV to RGB coefficients, see yuvCoeffsInit().
+ * Passed by value to the kernels, so every conversion can use its own colorimetry.
+ * @ingroup util
+ */
+struct yuvCoeffs
+{
+	int32_t y;			// luma gain
+	int32_t yOffset;	// luma black level (16 for limited range)
+	int32_t cOffset;	// chroma zero level (128)
+	int32_t rv;
+	int32_t gu;
+	int32_t gv;
+	int32_t bu;
+};
+
+/**
+ * The Kr and Kb luma constants of a matrix.
+ * @ingroup util
+ */
+inline void yuvMatrixConstants( yuvMatrix matrix, double& kr, double& kb )
+{
+	kr = 0.2126;	// BT.709
+	kb = 0.0722;
+
+	if( matrix == YUV_MATRIX_BT601 )
+	{
+		kr = 0.299;
+		kb = 0.114;
+	}
+	else if( matrix == YUV_MATRIX_BT2020 )
+	{
+		kr = 0.2627;
+		kb = 0.0593;
+	}
+}
+
+/**
+ * Compute the fixed-point coefficients of a colorimetry, from the Kr and Kb
+ * constants of the matrix and the quantization range.
+ *
+ * For samples deeper than 8 bits the offsets are scaled up and the gains down,
+ * so the output stays in the same [0,255] fixed-point range.
+ * @ingroup util
+ */
+inline yuvCoeffs yuvCoeffsInit( const yuvColorimetry& colorimetry, uint32_t depth=8 )
+{
+	double kr, kb;
+	yuvMatrixConstants(colorimetry.matrix, kr, kb);
+
+	const double kg = 1.0 - kr - kb;
+	const bool   limited = (colorimetry.range == YUV_RANGE_LIMITED);
+
+	const double depthScale = 1.0 / double(1 << (depth - 8));
+
+	const double yScale = (limited ? 255.0 / 219.0 : 1.0) * depthScale;
+	const double cScale = (limited ? 255.0 / 224.0 : 1.0) * depthScale;
+
+	#define YUV_FIXED(x)	int32_t(floor((x) * YUV_FIXED_ONE + 0.5))
+
+	yuvCoeffs k;
+
+	k.y       = YUV_FIXED(yScale);
+	k.yOffset = (limited ? 16 : 0) << (depth - 8);
+	k.cOffset = 128 << (depth - 8);
+	k.rv      = YUV_FIXED(2.0 * (1.0 - kr) * cScale);
+	k.gu      = YUV_FIXED(2.0 * kb * (1.0 - kb) / kg * cScale);
+	k.gv      = YUV_FIXED(2.0 * kr * (1.0 - kr) / kg * cScale);
+	k.bu      = YUV_FIXED(2.0 * (1.0 - kb) * cScale);
+
+	#undef YUV_FIXED
+	return k;
+}
+
+
+/**
+ * Convert one YUV pixel to fixed-point RGB (see YUV_FIXED_BITS), with samples
+ * of the depth that the coefficients were computed for.
+ * This is integer math only, so the CPU and the device results are identical.
+ * The results are unclamped.
+ * @ingroup util
+ */
+inline __host__ __device__ void yuvToRGBFixed( const yuvCoeffs& k, int32_t y, int32_t u, int32_t v, int32_t& r, int32_t& g, int32_t& b )
+{
+	const int32_t luma = (y - k.yOffset) * k.y;
+	const int32_t cb   = u - k.cOffset;
+	const int32_t cr   = v - k.cOffset;
+
+	r = luma + k.rv * cr;
+	g = luma - k.gu * cb - k.gv * cr;
+	b = luma + k.bu * cb;
+}
+
+
+/**
+ * Round a fixed-point color component to the nearest byte, clamping it to [0,255].
+ * @ingroup util
+ */
+inline __host__ __device__ uint32_t yuvFixedToByte( int32_t c )
+{
+	c += YUV_FIXED_ONE >> 1;
+
+	if( c < 0 )
+		return 0;
+
+	const uint32_t b = uint32_t(c) >> YUV_FIXED_BITS;
+	return (b > 255) ? 255 : b;
+}
+
+
+/**
+ * Convert a fixed-point color component to float in the [0,255] range (exact, unclamped).
+ * @ingroup util
+ */
+inline __host__ __device__ float yuvFixedToFloat( int32_t c )
+{
+	return float(c) * YUV_FIXED_SCALE;
+}
+
+
+/**
+ * Pack 8-bit components so that they land in R,G,B,A byte order in memory (uchar4).
+ * @ingroup util
+ */
+inline __host__ __device__ uint32_t rgbaPack( uint32_t r, uint32_t g, uint32_t b, uint32_t a )
+{
+	return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+
+/**
+ * Average two chroma samples, as done vertically on odd NV12 rows.
+ * @ingroup util
+ */
+inline __host__ __device__ uint32_t chromaAverage( uint32_t a, uint32_t b )
+{
+	return (a + b + 1) >> 1;
+}
+
+
+/**
+ * Sample pixel (x,y) of a YUV 4:2:0 frame, the way the YUV kernels do:
+ * chroma is shared by pixel pairs and interpolated vertically on odd rows
+ * (except for the last chroma row).  P010 samples are returned as 10-bit,
+ * and are shifted down before the chroma is interpolated.
+ * @ingroup util
+ */
+template<yuvFormat format>
+inline __host__ __device__ void yuvSample( const uint8_t* input, size_t pitch, uint32_t height, uint32_t x, uint32_t y, uint32_t& luma, uint32_t& u, uint32_t& v )
+{
+	const bool   interpolate = (y & 1) && (y >> 1) + 1 < (height >> 1);
+	const size_t chromaPitch = yuvChromaPitch(format, pitch);
+
+	const uint8_t* chromaRow = input + pitch * height + (y >> 1) * chromaPitch;
+
+	if( format == YUV_P010 )
+	{
+		const uint16_t* chroma = (const uint16_t*)chromaRow + (x & ~1u);
+
+		u = chroma[0] >> YUV_P010_SHIFT;
+		v = chroma[1] >> YUV_P010_SHIFT;
+
+		if( interpolate )
+		{
+			const uint16_t* next = (const uint16_t*)(chromaRow + chromaPitch) + (x & ~1u);
+
+			u = chromaAverage(u, next[0] >> YUV_P010_SHIFT);
+			v = chromaAverage(v, next[1] >> YUV_P010_SHIFT);
+		}
+
+		luma = ((const uint16_t*)(input + y * pitch))[x] >> YUV_P010_SHIFT;
+		return;
+	}
+
+	if( format == YUV_I420 )
+	{
+		const uint8_t* chromaU = chromaRow + (x >> 1);
+		const uint8_t* chromaV = chromaU + chromaPitch * ((height + 1) / 2);
+
+		u = chromaU[0];
+		v = chromaV[0];
+
+		if( interpolate )
+		{
+			u = chromaAverage(u, chromaU[chromaPitch]);
+			v = chromaAverage(v, chromaV[chromaPitch]);
+		}
+	}
+	else
+	{
+		const uint8_t* chroma = chromaRow + (x & ~1u);
+		const int      iu     = (format == YUV_NV21) ? 1 : 0;
+
+		u = chroma[iu];
+		v = chroma[iu ^ 1];
+
+		if( interpolate )
+		{
+			u = chromaAverage(u, chroma[pitch + iu]);
+			v = chromaAverage(v, chroma[pitch + (iu ^ 1)]);
+		}
+	}
+
+	luma = input[y * pitch + x];
+}
+
+
+/**
+ * Sample pixel (x,y) of an NV12 frame as 8-bit YUV, see yuvSample().
+ * @ingroup util
+ */
+inline __host__ __device__ void nv12Sample( const uint8_t* input, size_t pitch, uint32_t height, uint32_t x, uint32_t y, uint32_t& luma, uint32_t& u, uint32_t& v )
+{
+	yuvSample<YUV_NV12>(input, pitch, height, x, y, luma, u, v);
+}
+
+
+/**
+ * Maximum luma sample value of a yuvFormat (255, or 1023 for P010).
+ * @ingroup util
+ */
+inline __host__ __device__ uint32_t yuvLumaMax( yuvFormat format )
+{
+	return (1u << yuvFormatDepth(format)) - 1;
+}
+
+/**
+ * Source range [begin, end) of output sample n of count, when count samples
+ * cover size source samples (area downscale).  At least one sample wide.
+ * @ingroup util
+ */
+inline __host__ __device__ void lumaBoxRange( uint32_t n, uint32_t count, uint32_t size, uint32_t& begin, uint32_t& end )
+{
+	begin = uint32_t(uint64_t(n) * size / count);
+	end   = uint32_t(uint64_t(n + 1) * size / count);
+
+	if( end <= begin )
+		end = begin + 1;
+}
+
+/**
+ * Sum the luma samples of the box [x0,x1) x [y0,y1) of a luma plane,
+ * as 10-bit values for P010.
+ * @ingroup util
+ */
+template<yuvFormat format>
+inline __host__ __device__ uint32_t lumaBoxSum( const uint8_t* luma, size_t pitch, uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1 )
+{
+	uint32_t sum = 0;
+
+	for( uint32_t y=y0; y < y1; y++ )
+	{
+		const uint8_t* row = luma + y * pitch;
+
+		for( uint32_t x=x0; x < x1; x++ )
+			sum += (format == YUV_P010) ? ((const uint16_t*)row)[x] >> YUV_P010_SHIFT : row[x];
+	}
+
+	return sum;
+}
+
+/**
+ * Check that the luma boxes of a downscale can be summed in 32 bits.
+ * @ingroup util
+ */
+inline bool lumaBoxValid( yuvFormat format, size_t inputWidth, size_t inputHeight, size_t outputWidth, size_t outputHeight )
+{
+	const uint64_t boxWidth  = (inputWidth + outputWidth - 1) / outputWidth;
+	const uint64_t boxHeight = (inputHeight + outputHeight - 1) / outputHeight;
+
+	return boxWidth * boxHeight * yuvLumaMax(format) <= UINT32_MAX;
+}
+
+/**
+ * Store the average of a luma box, given its sum and area:  as a byte rounded
+ * to nearest (P010 is scaled from 10 bits), or as float in the [0,1] range like
+ * cudaUYVYToGray().  The float is one correctly-rounded division, so the CPU
+ * and the device agree.
+ * @ingroup util
+ */
+template<yuvFormat format>
+inline __host__ __device__ void lumaBoxStore( uint8_t& output, uint32_t sum, uint32_t area )
+{
+	const uint64_t den = uint64_t(area) * yuvLumaMax(format);
+	output = uint8_t((uint64_t(sum) * 255 + den / 2) / den);
+}
+
+template<yuvFormat format>
+inline __host__ __device__ void lumaBoxStore( float& output, uint32_t sum, uint32_t area )
+{
+	output = float(sum) / float(uint64_t(area) * yuvLumaMax(format));
+}
+
+
+/**
+ * Fractional bits of the fixed-point RGB to YUV conversion (the encode direction).
+ * @ingroup util
+ */
+#define RGB_FIXED_BITS		16
+
+/**
+ * Fixed-point RGB to YUV coefficients, see rgbCoeffsInit().
+ * @ingroup util
+ */
+struct rgbCoeffs
+{
+	int32_t yr, yg, yb;		// luma
+	int32_t ur, ug, ub;		// Cb
+	int32_t vr, vg, vb;		// Cr
+	int32_t yOffset;		// luma black level (16 for limited range)
+};
+
+/**
+ * Compute the fixed-point RGB to YUV coefficients of a colorimetry, the inverse
+ * of yuvCoeffsInit().  The chroma rows sum to zero, so grays have neutral chroma.
+ * @ingroup util
+ */
+inline rgbCoeffs rgbCoeffsInit( const yuvColorimetry& colorimetry )
+{
+	double kr, kb;
+	yuvMatrixConstants(colorimetry.matrix, kr, kb);
+
+	const double kg = 1.0 - kr - kb;
+	const bool   limited = (colorimetry.range == YUV_RANGE_LIMITED);
+
+	const double yScale = limited ? 219.0 / 255.0 : 1.0;
+	const double cScale = limited ? 224.0 / 255.0 : 1.0;
+
+	#define RGB_FIXED(x)	int32_t(floor((x) * (1 << RGB_FIXED_BITS) + 0.5))
+
+	rgbCoeffs k;
+
+	k.yr = RGB_FIXED(kr * yScale);
+	k.yg = RGB_FIXED(kg * yScale);
+	k.yb = RGB_FIXED(kb * yScale);
+
+	k.ub = RGB_FIXED(0.5 * cScale);
+	k.ur = RGB_FIXED(-kr / (2.0 * (1.0 - kb)) * cScale);
+	k.ug = -(k.ur + k.ub);
+
+	k.vr = RGB_FIXED(0.5 * cScale);
+	k.vb = RGB_FIXED(-kb / (2.0 * (1.0 - kr)) * cScale);
+	k.vg = -(k.vr + k.vb);
+
+	k.yOffset = limited ? 16 : 0;
+
+	#undef RGB_FIXED
+	return k;
+}
+
+
+/**
+ * Clamp an integer color component to a byte.
+ * @ingroup util
+ */
+inline __host__ __device__ uint32_t rgbClampByte( int32_t c )
+{
+	return (c < 0) ? 0 : (c > 255) ? 255 : c;
+}
+
+
+/**
+ * Convert a [0,255] float color component to a byte, clamping it and rounding half up.
+ * NaN becomes 0, the same as the SIMD implementations.
+ * @ingroup util
+ */
+inline __host__ __device__ uint32_t rgbFloatToByte( float c )
+{
+	return (uint32_t)COLOR_ADD(fminf(fmaxf(c, 0.0f), 255.0f), 0.5f);
+}
+
+
+/**
+ * Convert an 8-bit RGB pixel to its luma sample (integer math only).
+ * @ingroup util
+ */
+inline __host__ __device__ uint32_t rgbToLuma( const rgbCoeffs& k, int32_t r, int32_t g, int32_t b )
+{
+	const int32_t offset = (k.yOffset << RGB_FIXED_BITS) + (1 << (RGB_FIXED_BITS - 1));
+	return rgbClampByte((k.yr * r + k.yg * g + k.yb * b + offset) >> RGB_FIXED_BITS);
+}
+
+
+/**
+ * Convert the sums of a 2x2 block of 8-bit RGB pixels (each in [0,1020]) to the
+ * chroma of the block, which is the chroma of the averaged color.
+ * The intermediate value is never negative, the shift doesn't depend on its sign.
+ * @ingroup util
+ */
+inline __host__ __device__ void rgbToChroma( const rgbCoeffs& k, int32_t r4, int32_t g4, int32_t b4, uint32_t& u, uint32_t& v )
+{
+	const int32_t offset = (128 << (RGB_FIXED_BITS + 2)) + (1 << (RGB_FIXED_BITS + 1));
+
+	u = rgbClampByte((k.ur * r4 + k.ug * g4 + k.ub * b4 + offset) >> (RGB_FIXED_BITS + 2));
+	v = rgbClampByte((k.vr * r4 + k.vg * g4 + k.vb * b4 + offset) >> (RGB_FIXED_BITS + 2));
+}
+
+
+/**
+ * YUV to RGB coefficients applied by the YUYV/UYVY conversion (8-bit range).
+ * @ingroup util
+ */
+#define YUV422_COEFF_RV		1.4065f
+#define YUV422_COEFF_GU		0.3455f
+#define YUV422_COEFF_GV		0.7169f
+#define YUV422_COEFF_BU		1.7790f
+
+
+/**
+ * Convert one 8-bit YUYV/UYVY pixel to RGB in the [0,255] range.
+ * The chroma is centered on zero and the results are unclamped.
+ * @ingroup util
+ */
+inline __host__ __device__ void yuv8ToRGB( float y, float u, float v, float& r, float& g, float& b )
+{
+	r = COLOR_ADD(y, COLOR_MUL(YUV422_COEFF_RV, v));
+	g = COLOR_SUB(COLOR_SUB(y, COLOR_MUL(YUV422_COEFF_GU, u)), COLOR_MUL(YUV422_COEFF_GV, v));
+	b = COLOR_ADD(y, COLOR_MUL(YUV422_COEFF_BU, u));
+}
+
+
+/**
+ * Clamp an 8-bit range color component and convert it to a byte (truncating).
+ * @ingroup util
+ */
+inline __host__ __device__ uint8_t rgb8ToByte( float c )
+{
+	return (uint8_t)fmaxf(0.0f, fminf(c, 255.0f));
+}
+
+
+/**
+ * Blend a color component over a pixel component:  alpha * color + (1 - alpha) * px
+ * @ingroup util
+ */
+inline __host__ __device__ float colorBlend( float color, float px, float alpha, float ialpha )
+{
+	return COLOR_ADD(COLOR_MUL(alpha, color), COLOR_MUL(ialpha, px));
+}
+
+
+/**
+ * Convert a float to IEEE half with round-to-nearest-even.
+ * Done in software so that the CPU and the device produce the same bits
+ * (and so that the CPU doesn't depend on F16C).
+ * @ingroup util
+ */
+inline __host__ __device__ uint16_t floatToHalf( float value )
+{
+#ifdef __CUDA_ARCH__
+	uint32_t f = __float_as_uint(value);
+#else
+	uint32_t f;
+	memcpy(&f, &value, sizeof(f));
+#endif
+	const uint32_t sign = (f >> 16) & 0x8000;
+	f &= 0x7FFFFFFF;
+
+	if( f >= 0x7F800000 )		// Inf or NaN
+		return sign | ((f > 0x7F800000) ? 0x7E00 : 0x7C00);
+
+	if( f >= 0x477FF000 )		// rounds above 65504
+		return sign | 0x7C00;
+
+	if( f < 0x38800000 )		// half subnormal or zero
+	{
+		if( f < 0x33000000 )
+			return sign;
+
+		const uint32_t exponent = f >> 23;
+		const uint32_t mantissa = (f & 0x7FFFFF) | 0x800000;
+		const uint32_t shift    = 126 - exponent;
+		const uint32_t halfway  = 1u << (shift - 1);
+		const uint32_t rem      = mantissa & ((1u << shift) - 1);
+
+		uint32_t h = mantissa >> shift;
+
+		if( rem > halfway || (rem == halfway && (h & 1)) )
+			h++;
+
+		return sign | h;
+	}
+
+	// rebias the exponent from 127 to 15 and round off 13 bits of mantissa
+	uint32_t h = (f - 0x38000000) >> 13;
+	const uint32_t rem = f & 0x1FFF;
+
+	if( rem > 0x1000 || (rem == 0x1000 && (h & 1)) )
+		h++;
+
+	return sign | h;
+}
+
+
+
+#endif
@@ -21,6 +21,7 @@
  */
 
 #include "cudaFont.h"
+#include "trace.h"
 #include "cudaMappedMemory.h"
 
 #include "loadImage.h"
@@ -127,8 +128,10 @@ __global__ void gpuOverlayText( T* font, int fontWidth, short4* text,
 template<typename T>
 cudaError_t cudaOverlayText( T* font, const int2& fontCellSize, size_t fontMapWidth,
 					    const float4& fontColor, short4* text, size_t length,
-					    T* output, size_t width, size_t height)	
+					    T* output, size_t width, size_t height, cudaStream_t stream )	
 {
+	TRACE_SCOPE("cudaOverlayText");
+
 	if( !font || !text || !output || length == 0 || width == 0 || height == 0 )
 		return cudaErrorInvalidValue;
 
@@ -138,14 +141,14 @@ cudaError_t cudaOverlayText( T* font, const int2& fontCellSize, size_t fontMapWi
 	const dim3 block(fontCellSize.x, fontCellSize.y);
 	const dim3 grid(length);
 
-	gpuOverlayText<<<grid, block>>>(font, fontMapWidth, text, output, width, height, color_scale); 
+	gpuOverlayText<<<grid, block, 0, stream>>>(font, fontMapWidth, text, output, width, height, color_scale); 
 
 	return cudaGetLastError();
 }
 
 
 // RenderOverlay
-bool cudaFont::RenderOverlay( float4* input, float4* output, uint32_t width, uint32_t height, const std::vector< std::pair< std::string, int2 > >& text, const float4& color )
+bool cudaFont::RenderOverlay( float4* input, float4* output, uint32_t width, uint32_t height, const std::vector< std::pair< std::string, int2 > >& text, const float4& color, cudaStream_t stream )
 {
 	if( !input || !output || width == 0 || height == 0 || text.size() == 0 )
 		return false;
@@ -181,7 +184,7 @@ bool cudaFont::RenderOverlay( float4* input, float4* output, uint32_t width, uin
 
 	CUDA(cudaOverlayText<float4>( mFontMapGPU, mFontCellSize, mFontMapWidth, color,
 				        mCommandGPU, mCmdEntries, 
-				       output, width, height));
+				       output, width, height, stream));
 					   
 	mCmdEntries = 0;
 	return true;
@@ -189,7 +192,7 @@ bool cudaFont::RenderOverlay( float4* input, float4* output, uint32_t width, uin
 
 
 bool cudaFont::RenderOverlay( float4* input, float4* output, uint32_t width, uint32_t height, 
-							  const char* str, int x, int y, const float4& color )
+							  const char* str, int x, int y, const float4& color, cudaStream_t stream )
 {
 	if( !str )
 		return NULL;
@@ -198,7 +201,7 @@ bool cudaFont::RenderOverlay( float4* input, float4* output, uint32_t width, uin
 	
 	list.push_back( std::pair< std::string, int2 >( str, make_int2(x,y) ));
 	
-	return RenderOverlay(input, output, width, height, list, color);
+	return RenderOverlay(input, output, width, height, list, color, stream);
 }
 						
 	
@@ -50,14 +50,16 @@ public:
 	 * Draw font overlay onto image
 	 */
 	bool RenderOverlay( float4* input, float4* output, uint32_t width, uint32_t height, 
-						const char* str, int x, int y, const float4& color=make_float4(0, 0, 0, 255));
+						const char* str, int x, int y, const float4& color=make_float4(0, 0, 0, 255), cudaStream_t stream=NULL );
 						
 	/**
-	 * Draw font overlay onto image
+	 * Draw font overlay onto image.
+	 * The character list is kept in one mapped buffer that the next call overwrites,
+	 * so calls on different streams must not overlap.
 	 */
 	bool RenderOverlay( float4* input, float4* output, uint32_t width, uint32_t height, 
 						const std::vector< std::pair< std::string, int2 > >& text,
-						const float4& color=make_float4(0.0f, 0.0f, 0.0f, 255.0f));
+						const float4& color=make_float4(0.0f, 0.0f, 0.0f, 255.0f), cudaStream_t stream=NULL );
 	
 protected:
 	cudaFont();
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cudaLetterbox.h"
+#include "cudaResize-Filter.h"
+#include "trace.h"
+
+
+// gpuLetterbox
+//  pixels inside the letterbox are resized into the content crop, the rest are padding
+template <typename T, resizeFilter filter>
+__global__ void gpuLetterbox( ImageView<T> input, ImageView<T> output, ImageView<T> content, uint32_t left, uint32_t top, float2 scale, T padding )
+{
+	const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+	const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+
+	if( x >= output.width || y >= output.height )
+		return;
+
+	if( x < left || y < top || x - left >= content.width || y - top >= content.height )
+	{
+		output(x, y) = padding;
+		return;
+	}
+
+	if( filter == RESIZE_NEAREST )
+		resizeNearestPixel(input, content, scale, x - left, y - top);
+	else if( filter == RESIZE_BILINEAR )
+		resizeLinearPixel(input, content, x - left, y - top);
+	else
+		resizeAreaPixel<T, 0>(input, content, x - left, y - top);
+}
+
+
+// launchLetterbox
+template <typename T>
+static cudaError_t launchLetterbox( const ImageView<T>& input, const ImageView<T>& output, resizeFilter filter, const T& padding,
+							 letterboxTransform* transform, cudaStream_t stream )
+{
+	if( !input.ptr || !output.ptr )
+		return cudaErrorInvalidDevicePointer;
+
+	if( !input.IsValid() || !output.IsValid() )
+		return cudaErrorInvalidValue;
+
+	const letterboxTransform t = letterboxCompute(input.width, input.height, output.width, output.height);
+	const ImageView<T> content = output.Crop(t.left, t.top, t.width, t.height);
+
+	if( filter == RESIZE_AREA && !resizeAreaValid(input.width, input.height, content.width, content.height) )
+		return cudaErrorInvalidValue;
+
+	if( transform != NULL )
+		*transform = t;
+
+	const float2 scale = make_float2( float(input.width) / float(content.width),
+							    float(input.height) / float(content.height) );
+
+	// launch kernel
+	const dim3 blockDim(32, 8);
+	const dim3 gridDim(iDivUp(output.width,blockDim.x), iDivUp(output.height,blockDim.y));
+
+	if( filter == RESIZE_NEAREST )
+		gpuLetterbox<T, RESIZE_NEAREST><<<gridDim, blockDim, 0, stream>>>(input, output, content, t.left, t.top, scale, padding);
+	else if( filter == RESIZE_BILINEAR )
+		gpuLetterbox<T, RESIZE_BILINEAR><<<gridDim, blockDim, 0, stream>>>(input, output, content, t.left, t.top, scale, padding);
+	else if( filter == RESIZE_AREA )
+		gpuLetterbox<T, RESIZE_AREA><<<gridDim, blockDim, 0, stream>>>(input, output, content, t.left, t.top, scale, padding);
+	else
+		return cudaErrorInvalidValue;
+
+	return CUDA(cudaGetLastError());
+}
+
+
+// cudaLetterbox
+cudaError_t cudaLetterbox( const ImageView<uchar4>& input, const ImageView<uchar4>& output, resizeFilter filter, const uchar4& padding,
+					  letterboxTransform* transform, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaLetterbox");
+	return launchLetterbox(input, output, filter, padding, transform, stream);
+}
+
+cudaError_t cudaLetterbox( const ImageView<float4>& input, const ImageView<float4>& output, resizeFilter filter, const float4& padding,
+					  letterboxTransform* transform, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaLetterbox");
+	return launchLetterbox(input, output, filter, padding, transform, stream);
+}
+
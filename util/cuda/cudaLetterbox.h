@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CUDA_LETTERBOX_H__
+#define __CUDA_LETTERBOX_H__
+
+
+#include "cudaUtility.h"
+#include "cudaResize.h"
+#include "imageView.h"
+
+#include <math.h>
+
+
+/**
+ * Placement of a letterboxed image in its canvas, from letterboxCompute().
+ * The source is scaled by the same factor in both directions (up to rounding
+ * of the resized size) and centered, the rest of the canvas is padding.
+ * @ingroup util
+ */
+struct letterboxTransform
+{
+	float2   scale;		/**< canvas pixels per source pixel, in x and y */
+	uint32_t left;		/**< column of the resized image in the canvas */
+	uint32_t top;		/**< row of the resized image in the canvas */
+	uint32_t width;	/**< width of the resized image in the canvas */
+	uint32_t height;	/**< height of the resized image in the canvas */
+	uint32_t sourceWidth;	/**< width of the source image */
+	uint32_t sourceHeight;	/**< height of the source image */
+};
+
+
+/**
+ * Compute the letterbox of a sourceWidth x sourceHeight image in a canvas.
+ * @ingroup util
+ */
+inline letterboxTransform letterboxCompute( uint32_t sourceWidth, uint32_t sourceHeight, uint32_t canvasWidth, uint32_t canvasHeight )
+{
+	letterboxTransform t;
+
+	t.sourceWidth  = sourceWidth;
+	t.sourceHeight = sourceHeight;
+
+	if( sourceWidth == 0 || sourceHeight == 0 || canvasWidth == 0 || canvasHeight == 0 )
+	{
+		t.scale  = make_float2(0.0f, 0.0f);
+		t.left   = t.top = t.width = t.height = 0;
+		return t;
+	}
+
+	// the side that fills the canvas is exact, the other one is rounded
+	if( uint64_t(canvasWidth) * sourceHeight <= uint64_t(canvasHeight) * sourceWidth )
+	{
+		t.width  = canvasWidth;
+		t.height = uint32_t((uint64_t(canvasWidth) * sourceHeight * 2 + sourceWidth) / (uint64_t(sourceWidth) * 2));
+	}
+	else
+	{
+		t.height = canvasHeight;
+		t.width  = uint32_t((uint64_t(canvasHeight) * sourceWidth * 2 + sourceHeight) / (uint64_t(sourceHeight) * 2));
+	}
+
+	if( t.width == 0 )	t.width = 1;
+	if( t.height == 0 )	t.height = 1;
+
+	t.left  = (canvasWidth - t.width) / 2;
+	t.top   = (canvasHeight - t.height) / 2;
+	t.scale = make_float2(float(t.width) / float(sourceWidth), float(t.height) / float(sourceHeight));
+
+	return t;
+}
+
+
+/**
+ * Project a box (left, top, right, bottom) from canvas to source coordinates,
+ * clipped to the source image.
+ * @ingroup util
+ */
+inline float4 letterboxProject( const letterboxTransform& t, const float4& box )
+{
+	if( t.width == 0 || t.height == 0 )
+		return box;
+
+	float4 r;
+
+	r.x = fminf(fmaxf((box.x - float(t.left)) / t.scale.x, 0.0f), float(t.sourceWidth));
+	r.y = fminf(fmaxf((box.y - float(t.top))  / t.scale.y, 0.0f), float(t.sourceHeight));
+	r.z = fminf(fmaxf((box.z - float(t.left)) / t.scale.x, 0.0f), float(t.sourceWidth));
+	r.w = fminf(fmaxf((box.w - float(t.top))  / t.scale.y, 0.0f), float(t.sourceHeight));
+
+	return r;
+}
+
+
+/**
+ * Project detection boxes (left, top, right, bottom) from canvas to source
+ * coordinates in place, for example before cudaRectOutlineOverlay() on the source.
+ * @ingroup util
+ */
+inline void letterboxProject( const letterboxTransform& t, float4* boxes, int numBoxes )
+{
+	for( int n=0; n < numBoxes; n++ )
+		boxes[n] = letterboxProject(t, boxes[n]);
+}
+
+
+/**
+ * Resize an image into a canvas, keeping its aspect ratio, and fill the rest
+ * of the canvas with padding, in one kernel (no separate clear of the canvas).
+ * The resized image matches cudaResize() with the same filter into a crop of
+ * the canvas at the letterbox position.
+ *
+ * @param transform if not NULL, receives the placement (see letterboxProject()).
+ * @ingroup util
+ */
+cudaError_t cudaLetterbox( const ImageView<uchar4>& input, const ImageView<uchar4>& output, resizeFilter filter, const uchar4& padding,
+					  letterboxTransform* transform=NULL, cudaStream_t stream=NULL );
+
+cudaError_t cudaLetterbox( const ImageView<float4>& input, const ImageView<float4>& output, resizeFilter filter, const float4& padding,
+					  letterboxTransform* transform=NULL, cudaStream_t stream=NULL );
+
+
+#endif
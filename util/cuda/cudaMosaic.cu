@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cudaMosaic.h"
+#include "cudaResize-Filter.h"
+#include "cudaYUV-NV12.h"
+#include "trace.h"
+
+
+// the tiles of one launch, only those whose input has a new frame,
+// passed to the kernel by value (blockIdx.z is the index of the tile)
+template <typename T>
+struct mosaicLaunch
+{
+	ImageView<T> inputs[MOSAIC_MAX_TILES];
+	mosaicTile   tiles[MOSAIC_MAX_TILES];
+	float2       scale[MOSAIC_MAX_TILES];
+	uint32_t     count;
+	uint32_t     maxWidth;	// of the tiles, for the grid
+	uint32_t     maxHeight;
+};
+
+
+// mosaicInit
+template <typename T>
+static cudaError_t mosaicInit( const ImageView<T>* inputs, uint32_t count, uint32_t width, uint32_t height, bool even, resizeFilter filter, mosaicLaunch<T>& l )
+{
+	if( !inputs )
+		return cudaErrorInvalidDevicePointer;
+
+	if( count == 0 || count > MOSAIC_MAX_TILES || width == 0 || height == 0 || filter > RESIZE_AREA )
+		return cudaErrorInvalidValue;
+
+	l.count     = 0;
+	l.maxWidth  = 0;
+	l.maxHeight = 0;
+
+	for( uint32_t n=0; n < count; n++ )
+	{
+		if( !inputs[n].ptr )
+			continue;	// no new frame, keep the tile
+
+		const mosaicTile t = mosaicTileRect(n, count, width, height, even);
+
+		if( !inputs[n].IsValid() || t.width == 0 || t.height == 0 )
+			return cudaErrorInvalidValue;
+
+		if( filter == RESIZE_AREA && !resizeAreaValid(inputs[n].width, inputs[n].height, t.width, t.height) )
+			return cudaErrorInvalidValue;
+
+		l.inputs[l.count] = inputs[n];
+		l.tiles[l.count]  = t;
+		l.scale[l.count]  = make_float2(float(inputs[n].width) / float(t.width), float(inputs[n].height) / float(t.height));
+
+		if( t.width > l.maxWidth )	 l.maxWidth = t.width;
+		if( t.height > l.maxHeight )	 l.maxHeight = t.height;
+		l.count++;
+	}
+
+	return cudaSuccess;
+}
+
+
+// mosaicSample
+//  pixel (x,y) of tile n, the same as the resize kernels
+template <typename T, resizeFilter filter>
+inline __device__ T mosaicSample( const mosaicLaunch<T>& l, uint32_t n, uint32_t x, uint32_t y )
+{
+	if( filter == RESIZE_NEAREST )
+		return resizeNearestSample(l.inputs[n], l.scale[n], x, y);
+	else if( filter == RESIZE_BILINEAR )
+		return resizeLinearSample(l.inputs[n], l.tiles[n].width, l.tiles[n].height, x, y);
+	else
+		return resizeAreaSample<T, 0>(l.inputs[n], l.tiles[n].width, l.tiles[n].height, x, y);
+}
+
+
+// gpuMosaic
+template <typename T, resizeFilter filter>
+__global__ void gpuMosaic( mosaicLaunch<T> l, ImageView<T> output )
+{
+	const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+	const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+	const uint32_t n = blockIdx.z;
+
+	const mosaicTile& t = l.tiles[n];
+
+	if( x >= t.width || y >= t.height )
+		return;
+
+	output(t.left + x, t.top + y) = mosaicSample<T, filter>(l, n, x, y);
+}
+
+
+// gpuMosaicNV12
+//  each thread resizes a 2x2 block of a tile and encodes it with nv12EncodeBlock(),
+//  the tiles have even edges so the block is always whole
+template <typename T, imageFormat format, resizeFilter filter>
+__global__ void gpuMosaicNV12( mosaicLaunch<T> l, rgbCoeffs coeffs, uint8_t* output, size_t outputPitch, uint32_t height )
+{
+	const uint32_t x = (blockIdx.x * blockDim.x + threadIdx.x) * 2;
+	const uint32_t y = (blockIdx.y * blockDim.y + threadIdx.y) * 2;
+	const uint32_t n = blockIdx.z;
+
+	const mosaicTile& t = l.tiles[n];
+
+	if( x >= t.width || y >= t.height )
+		return;
+
+	const T row0[] = { mosaicSample<T, filter>(l, n, x, y), mosaicSample<T, filter>(l, n, x + 1, y) };
+	const T row1[] = { mosaicSample<T, filter>(l, n, x, y + 1), mosaicSample<T, filter>(l, n, x + 1, y + 1) };
+
+	uint8_t* luma   = output + (t.top + y) * outputPitch + t.left + x;
+	uint8_t* chroma = output + outputPitch * height + ((t.top + y) >> 1) * outputPitch + t.left + x;
+
+	nv12EncodeBlock<format>(coeffs, (const uint8_t*)row0, (const uint8_t*)row1, luma, luma + outputPitch, chroma, 0, 2);
+}
+
+
+// launchMosaic
+template <typename T>
+static cudaError_t launchMosaic( const ImageView<T>* inputs, uint32_t count, const ImageView<T>& output, resizeFilter filter, cudaStream_t stream )
+{
+	if( !output.ptr )
+		return cudaErrorInvalidDevicePointer;
+
+	if( !output.IsValid() )
+		return cudaErrorInvalidValue;
+
+	mosaicLaunch<T> l;
+	const cudaError_t result = mosaicInit(inputs, count, output.width, output.height, false, filter, l);
+
+	if( result != cudaSuccess || l.count == 0 )
+		return result;
+
+	// launch kernel
+	const dim3 blockDim(32, 8);
+	const dim3 gridDim(iDivUp(l.maxWidth,blockDim.x), iDivUp(l.maxHeight,blockDim.y), l.count);
+
+	if( filter == RESIZE_NEAREST )
+		gpuMosaic<T, RESIZE_NEAREST><<<gridDim, blockDim, 0, stream>>>(l, output);
+	else if( filter == RESIZE_BILINEAR )
+		gpuMosaic<T, RESIZE_BILINEAR><<<gridDim, blockDim, 0, stream>>>(l, output);
+	else
+		gpuMosaic<T, RESIZE_AREA><<<gridDim, blockDim, 0, stream>>>(l, output);
+
+	return CUDA(cudaGetLastError());
+}
+
+
+// launchMosaicNV12
+template <typename T, imageFormat format>
+static cudaError_t launchMosaicNV12( const ImageView<T>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height,
+							  resizeFilter filter, const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	if( !output )
+		return cudaErrorInvalidDevicePointer;
+
+	if( (width & 1) || (height & 1) || outputPitch < width )
+		return cudaErrorInvalidValue;
+
+	mosaicLaunch<T> l;
+	const cudaError_t result = mosaicInit(inputs, count, width, height, true, filter, l);
+
+	if( result != cudaSuccess || l.count == 0 )
+		return result;
+
+	const rgbCoeffs coeffs = rgbCoeffsInit(colorimetry);
+
+	// launch kernel
+	const dim3 blockDim(32, 8);
+	const dim3 gridDim(iDivUp(l.maxWidth/2,blockDim.x), iDivUp(l.maxHeight/2,blockDim.y), l.count);
+
+	if( filter == RESIZE_NEAREST )
+		gpuMosaicNV12<T, format, RESIZE_NEAREST><<<gridDim, blockDim, 0, stream>>>(l, coeffs, output, outputPitch, height);
+	else if( filter == RESIZE_BILINEAR )
+		gpuMosaicNV12<T, format, RESIZE_BILINEAR><<<gridDim, blockDim, 0, stream>>>(l, coeffs, output, outputPitch, height);
+	else
+		gpuMosaicNV12<T, format, RESIZE_AREA><<<gridDim, blockDim, 0, stream>>>(l, coeffs, output, outputPitch, height);
+
+	return CUDA(cudaGetLastError());
+}
+
+
+// cudaMosaic
+cudaError_t cudaMosaic( const ImageView<uchar4>* inputs, uint32_t count, const ImageView<uchar4>& output, resizeFilter filter, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaMosaic");
+	return launchMosaic(inputs, count, output, filter, stream);
+}
+
+cudaError_t cudaMosaic( const ImageView<float4>* inputs, uint32_t count, const ImageView<float4>& output, resizeFilter filter, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaMosaic");
+	return launchMosaic(inputs, count, output, filter, stream);
+}
+
+
+// cudaMosaicNV12
+cudaError_t cudaMosaicNV12( const ImageView<uchar4>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height,
+					   resizeFilter filter, const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaMosaicNV12");
+	return launchMosaicNV12<uchar4, IMAGE_RGBA8>(inputs, count, output, outputPitch, width, height, filter, colorimetry, stream);
+}
+
+cudaError_t cudaMosaicNV12( const ImageView<float4>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height,
+					   resizeFilter filter, const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaMosaicNV12");
+	return launchMosaicNV12<float4, IMAGE_RGBA32F>(inputs, count, output, outputPitch, width, height, filter, colorimetry, stream);
+}
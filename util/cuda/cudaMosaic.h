@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CUDA_MOSAIC_H__
+#define __CUDA_MOSAIC_H__
+
+
+#include "cudaUtility.h"
+#include "cudaColorspace.h"
+#include "cudaResize.h"
+#include "imageView.h"
+
+
+/**
+ * Maximum number of tiles of a mosaic (a 4x4 grid).
+ * @ingroup util
+ */
+#define MOSAIC_MAX_TILES	16
+
+
+/**
+ * Rectangle of a tile in the mosaic, from mosaicTileRect().
+ * @ingroup util
+ */
+struct mosaicTile
+{
+	uint32_t left;
+	uint32_t top;
+	uint32_t width;
+	uint32_t height;
+};
+
+
+/**
+ * Number of columns of the grid of a mosaic of count tiles (2x2, 3x3, 4x4),
+ * the tiles fill it row by row.
+ * @ingroup util
+ */
+inline uint32_t mosaicColumns( uint32_t count )
+{
+	uint32_t columns = 1;
+
+	while( columns * columns < count )
+		columns++;
+
+	return columns;
+}
+
+
+/**
+ * Rectangle of tile n of a width x height mosaic of count tiles.  The tiles
+ * split the mosaic evenly, with the remainder spread over them.  For NV12
+ * (even=true) the edges are rounded down to even columns and rows, so that
+ * no tile shares a chroma sample with its neighbours.
+ * @ingroup util
+ */
+inline mosaicTile mosaicTileRect( uint32_t n, uint32_t count, uint32_t width, uint32_t height, bool even=false )
+{
+	const uint32_t columns = mosaicColumns(count);
+	const uint32_t rows    = (count + columns - 1) / columns;
+	const uint32_t mask    = even ? ~1u : ~0u;
+
+	const uint32_t column = n % columns;
+	const uint32_t row    = n / columns;
+
+	const uint32_t x0 = uint32_t(uint64_t(width) * column / columns) & mask;
+	const uint32_t y0 = uint32_t(uint64_t(height) * row / rows) & mask;
+	const uint32_t x1 = (column + 1 == columns) ? width : uint32_t(uint64_t(width) * (column + 1) / columns) & mask;
+	const uint32_t y1 = (row + 1 == rows) ? height : uint32_t(uint64_t(height) * (row + 1) / rows) & mask;
+
+	mosaicTile t;
+
+	t.left   = x0;
+	t.top    = y0;
+	t.width  = x1 - x0;
+	t.height = y1 - y0;
+
+	return t;
+}
+
+
+/**
+ * Tile count images into a grid (see mosaicTileRect()), each one resized to
+ * its tile with the filter, in one kernel launch for all of the tiles.
+ * Every tile matches cudaResize() into a crop of the mosaic at that tile.
+ *
+ * An input with a NULL pointer leaves its tile as it is, so a stream that
+ * has no new frame keeps showing its previous one (the output is not cleared).
+ * The images are stretched to the tiles, letterbox them first to keep their
+ * aspect ratio.  The RGBA output can be rendered with glTexture like any image.
+ *
+ * @param count number of tiles, 1 to MOSAIC_MAX_TILES.
+ * @ingroup util
+ */
+cudaError_t cudaMosaic( const ImageView<uchar4>* inputs, uint32_t count, const ImageView<uchar4>& output, resizeFilter filter, cudaStream_t stream=NULL );
+cudaError_t cudaMosaic( const ImageView<float4>* inputs, uint32_t count, const ImageView<float4>& output, resizeFilter filter, cudaStream_t stream=NULL );
+
+
+/**
+ * Tile count RGBA images into an NV12 frame, for an encoder, in one kernel
+ * launch.  The tiles are rounded to even edges (mosaicTileRect() with even=true),
+ * and each one matches cudaResize() into that tile of an RGBA frame followed by
+ * cudaRGBAToNV12() of the whole frame.  width and height must be even.
+ *
+ * An input with a NULL pointer leaves its tile as it is, like cudaMosaic().
+ * @ingroup util
+ */
+cudaError_t cudaMosaicNV12( const ImageView<uchar4>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height,
+					   resizeFilter filter, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
+
+cudaError_t cudaMosaicNV12( const ImageView<float4>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height,
+					   resizeFilter filter, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
+
+
+#endif
@@ -21,51 +21,149 @@
  */
 
 #include "cudaNormalize.h"
+#include "trace.h"
 
 
 
 // gpuNormalize
 template <typename T>
-__global__ void gpuNormalize( T* input, T* output, int width, int height, float scaling_factor )
+__global__ void gpuNormalize( ImageView<T> input, ImageView<T> output, float input_min, float scaling_factor, float output_min )
 {
 	const int x = blockIdx.x * blockDim.x + threadIdx.x;
 	const int y = blockIdx.y * blockDim.y + threadIdx.y;
 
-	if( x >= width || y >= height )
+	if( x >= output.width || y >= output.height )
 		return;
 
-	const T px = input[ y * width + x ];
+	const T px = input(x, y);
 
-	output[y*width+x] = make_float4(px.x * scaling_factor,
-							  px.y * scaling_factor,
-							  px.z * scaling_factor,
-							  px.w * scaling_factor);
+	output(x, y) = make_float4(COLOR_ADD(COLOR_MUL(COLOR_SUB(px.x, input_min), scaling_factor), output_min),
+						  COLOR_ADD(COLOR_MUL(COLOR_SUB(px.y, input_min), scaling_factor), output_min),
+						  COLOR_ADD(COLOR_MUL(COLOR_SUB(px.z, input_min), scaling_factor), output_min),
+						  COLOR_ADD(COLOR_MUL(COLOR_SUB(px.w, input_min), scaling_factor), output_min));
 }
 
 
 // cudaNormalizeRGBA
-cudaError_t cudaNormalizeRGBA( float4* input, const float2& input_range,
-						 float4* output, const float2& output_range,
-						 size_t  width,  size_t height )
+cudaError_t cudaNormalizeRGBA( const ImageView<float4>& input,  const float2& input_range,
+						 const ImageView<float4>& output, const float2& output_range, cudaStream_t stream )
 {
-	if( !input || !output )
+	TRACE_SCOPE("cudaNormalizeRGBA");
+
+	if( !input.ptr || !output.ptr )
 		return cudaErrorInvalidDevicePointer;
 
-	if( width == 0 || height == 0  )
+	if( !input.IsValid() || !output.IsValid() || input.width != output.width || input.height != output.height || input_range.x == input_range.y )
 		return cudaErrorInvalidValue;
 
-	const float multiplier = output_range.y / input_range.y;
+	const float multiplier = (output_range.y - output_range.x) / (input_range.y - input_range.x);
 
 	// launch kernel
 	const dim3 blockDim(8, 8);
-	const dim3 gridDim(iDivUp(width,blockDim.x), iDivUp(height,blockDim.y));
+	const dim3 gridDim(iDivUp(output.width,blockDim.x), iDivUp(output.height,blockDim.y));
 
-	gpuNormalize<float4><<<gridDim, blockDim>>>(input, output, width, height, multiplier);
+	gpuNormalize<float4><<<gridDim, blockDim, 0, stream>>>(input, output, input_range.x, multiplier, output_range.x);
 
 	return CUDA(cudaGetLastError());
 }
 
 
+// gpuNormalizeTensor
+//  per-pixel fallback, for widths that aren't a multiple of 4 or unaligned outputs
+template <typename T, tensorFormat format, tensorLayout layout>
+__global__ void gpuNormalizeTensor( tensorWriter writer, ImageView<T> input, void* output )
+{
+	const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+	const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+
+	if( x >= writer.width || y >= writer.height )
+		return;
+
+	float r, g, b;
+	tensorPixelRGB(input(x, y), r, g, b);
+	tensorWriteRGB<format, layout>(writer, output, x, y, r, g, b);
+}
+
+
+// gpuNormalizeTensor4
+//  each thread converts 4 pixels and writes them with 3 vector stores
+template <typename T, tensorFormat format, tensorLayout layout>
+__global__ void gpuNormalizeTensor4( tensorWriter writer, ImageView<T> input, void* output )
+{
+	const uint32_t x = (blockIdx.x * blockDim.x + threadIdx.x) * 4;
+	const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+
+	if( x >= writer.width || y >= writer.height )
+		return;
+
+	tensorWriteRGB4<T, format, layout>(writer, input.Row(y) + x, output, x, y);
+}
+
+
+// launchNormalizeTensor
+template <typename T>
+struct launchNormalizeTensor
+{
+	const tensorWriter writer;
+	const ImageView<T>& input;
+	void* output;
+	cudaStream_t stream;
+
+	launchNormalizeTensor( const tensorWriter& w, const ImageView<T>& in, void* out, cudaStream_t s ) : writer(w), input(in), output(out), stream(s)	{ }
+
+	template<tensorFormat format, tensorLayout layout>
+	void run()
+	{
+		const dim3 blockDim(32, 8);
+
+		if( (writer.width % 4) == 0 && ((size_t)output % 16) == 0 )
+		{
+			const dim3 gridDim(iDivUp(writer.width/4,blockDim.x), iDivUp(writer.height,blockDim.y));
+			gpuNormalizeTensor4<T, format, layout><<<gridDim, blockDim, 0, stream>>>(writer, input, output);
+		}
+		else
+		{
+			const dim3 gridDim(iDivUp(writer.width,blockDim.x), iDivUp(writer.height,blockDim.y));
+			gpuNormalizeTensor<T, format, layout><<<gridDim, blockDim, 0, stream>>>(writer, input, output);
+		}
+	}
+};
+
+
+// normalizeTensor
+template <typename T>
+static cudaError_t normalizeTensor( const ImageView<T>& input, void* output, const tensorParams& params, cudaStream_t stream )
+{
+	if( !input.ptr || !output )
+		return cudaErrorInvalidDevicePointer;
+
+	if( !input.IsValid() || input.width != params.width || input.height != params.height )
+		return cudaErrorInvalidValue;
+
+	if( params.scale == 0.0f || params.stdDev.x == 0.0f || params.stdDev.y == 0.0f || params.stdDev.z == 0.0f || params.int8Scale == 0.0f )
+		return cudaErrorInvalidValue;
+
+	launchNormalizeTensor<T> launch(tensorWriterInit(params, params.width, params.height), input, output, stream);
+	tensorDispatch(launch.writer, launch);
+
+	return CUDA(cudaGetLastError());
+}
+
+
+// cudaNormalizeRGBA (tensor)
+cudaError_t cudaNormalizeRGBA( const ImageView<uchar4>& input, void* output, const tensorParams& params, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaNormalizeRGBA");
+	return normalizeTensor(input, output, params, stream);
+}
+
+cudaError_t cudaNormalizeRGBA( const ImageView<float4>& input, void* output, const tensorParams& params, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaNormalizeRGBA");
+	return normalizeTensor(input, output, params, stream);
+}
+
+
 
 
 
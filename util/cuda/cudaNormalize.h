@@ -25,6 +25,21 @@
 
 
 #include "cudaUtility.h"
+#include "cudaTensor.h"
+#include "imageView.h"
+
+
+/**
+ * Rebase the pixel intensities of an image between two scales.
+ * For example, convert an image with values 0.0-255 to 0.0-1.0, or to -1.0-1.0:
+ *
+ *    out = (in - input_range.x) * (output_range.y - output_range.x) / (input_range.y - input_range.x) + output_range.x
+ *
+ * The views must have the same size, they may be pitched, crops or the same image.
+ * @ingroup util
+ */
+cudaError_t cudaNormalizeRGBA( const ImageView<float4>& input,  const float2& input_range,
+						 const ImageView<float4>& output, const float2& output_range, cudaStream_t stream=NULL );
 
 
 /**
@@ -32,9 +47,30 @@
  * For example, convert an image with values 0.0-255 to 0.0-1.0.
  * @ingroup util
  */
-cudaError_t cudaNormalizeRGBA( float4* input,  const float2& input_range,
-						 float4* output, const float2& output_range,
-						 size_t  width,  size_t height );
+inline cudaError_t cudaNormalizeRGBA( float4* input,  const float2& input_range,
+						        float4* output, const float2& output_range,
+						        size_t  width,  size_t height, cudaStream_t stream=NULL )
+{
+	return cudaNormalizeRGBA(ImageView<float4>(input, width, height), input_range, ImageView<float4>(output, width, height), output_range, stream);
+}
+
+
+/**
+ * Normalize an image into a network input tensor of the same size, in one pass:
+ * per-channel mean and standard deviation, channel order, layout (HWC to CHW)
+ * and element type (FP32, FP16 or INT8 with scale and zero point), see tensorParams.
+ *
+ * The input is in the [0,255] range, params.width and params.height must be the
+ * size of the image, and params.colorimetry isn't used.  The values are the same
+ * as cudaNV12ToTensor() and cudaROIToTensor() store for these pixels.
+ *
+ * Each thread converts 4 pixels of a row and writes them with vector stores,
+ * when the width is a multiple of 4 and the output is 16-byte aligned.
+ * @ingroup util
+ */
+cudaError_t cudaNormalizeRGBA( const ImageView<uchar4>& input, void* output, const tensorParams& params, cudaStream_t stream=NULL );
+cudaError_t cudaNormalizeRGBA( const ImageView<float4>& input, void* output, const tensorParams& params, cudaStream_t stream=NULL );
+
 
 #endif
 
@@ -21,6 +21,8 @@
  */
 
 #include "cudaOverlay.h"
+#include "cudaColorspace.h"
+#include "trace.h"
 
 
 static inline __device__ __host__ bool eq_less( float a, float b, float epsilon )
@@ -29,16 +31,16 @@ static inline __device__ __host__ bool eq_less( float a, float b, float epsilon
 }
 
 template<typename T>
-__global__ void gpuRectOutlines( T* input, T* output, int width, int height,
+__global__ void gpuRectOutlines( ImageView<T> input, ImageView<T> output,
 						        float4* rects, int numRects, float4 color ) 
 {
 	const int x = blockIdx.x * blockDim.x + threadIdx.x;
 	const int y = blockIdx.y * blockDim.y + threadIdx.y;
 
-	if( x >= width || y >= height )
+	if( x >= output.width || y >= output.height )
 		return;
 
-	const T px_in = input[ y * width + x ];
+	const T px_in = input(x, y);
 	T px_out = px_in;
 	
 	const float fx = x;
@@ -60,27 +62,32 @@ __global__ void gpuRectOutlines( T* input, T* output, int width, int height,
 			{
 				//printf("cuda rect %i %i\n", x, y);
 
-				px_out.x = alpha * color.x + ialph * px_out.x;
-				px_out.y = alpha * color.y + ialph * px_out.y;
-				px_out.z = alpha * color.z + ialph * px_out.z;
+				px_out.x = colorBlend(color.x, px_out.x, alpha, ialph);
+				px_out.y = colorBlend(color.y, px_out.y, alpha, ialph);
+				px_out.z = colorBlend(color.z, px_out.z, alpha, ialph);
 			}
 		}
 	}
 	
-	output[y * width + x] = px_out;	 
+	output(x, y) = px_out;	 
 }
 
 
-cudaError_t cudaRectOutlineOverlay( float4* input, float4* output, uint32_t width, uint32_t height, float4* boundingBoxes, int numBoxes, const float4& color )
+cudaError_t cudaRectOutlineOverlay( const ImageView<float4>& input, const ImageView<float4>& output, float4* boundingBoxes, int numBoxes, const float4& color, cudaStream_t stream )
 {
-	if( !input || !output || width == 0 || height == 0 || !boundingBoxes || numBoxes == 0 )
+	TRACE_SCOPE("cudaRectOutlineOverlay");
+
+	if( !input.IsValid() || !output.IsValid() || !boundingBoxes || numBoxes == 0 )
+		return cudaErrorInvalidValue;
+
+	if( input.width != output.width || input.height != output.height )
 		return cudaErrorInvalidValue;
 
 	// launch kernel
 	const dim3 blockDim(8, 8);
-	const dim3 gridDim(iDivUp(width,blockDim.x), iDivUp(height,blockDim.y));
+	const dim3 gridDim(iDivUp(output.width,blockDim.x), iDivUp(output.height,blockDim.y));
 
-	gpuRectOutlines<float4><<<gridDim, blockDim>>>(input, output, width, height, boundingBoxes, numBoxes, color); 
+	gpuRectOutlines<float4><<<gridDim, blockDim, 0, stream>>>(input, output, boundingBoxes, numBoxes, color); 
 
 	return cudaGetLastError();
 }
@@ -24,13 +24,25 @@
 #define __CUDA_OVERLAY_H__
 
 #include "cudaUtility.h"
+#include "imageView.h"
 
 
 /**
  * cudaRectOutlineOverlay
+ * The views must have the same size, the boxes are in their coordinates (relative to the crop).
  * @ingroup util
  */
-cudaError_t cudaRectOutlineOverlay( float4* input, float4* output, uint32_t width, uint32_t height, float4* boundingBoxes, int numBoxes, const float4& color );
+cudaError_t cudaRectOutlineOverlay( const ImageView<float4>& input, const ImageView<float4>& output, float4* boundingBoxes, int numBoxes, const float4& color, cudaStream_t stream=NULL );
+
+
+/**
+ * cudaRectOutlineOverlay
+ * @ingroup util
+ */
+inline cudaError_t cudaRectOutlineOverlay( float4* input, float4* output, uint32_t width, uint32_t height, float4* boundingBoxes, int numBoxes, const float4& color, cudaStream_t stream=NULL )
+{
+	return cudaRectOutlineOverlay(ImageView<float4>(input, width, height), ImageView<float4>(output, width, height), boundingBoxes, numBoxes, color, stream);
+}
 
 
 /**
@@ -21,6 +21,7 @@
  */
 
 #include "cudaRGB.h"
+#include "trace.h"
 
 //-------------------------------------------------------------------------------------------------------------------------
 
@@ -49,16 +50,64 @@ __global__ void RGBToRGBAf(uchar3* srcImage,
 	dstImage[pixel] = make_float4(px.x * s, px.y * s, px.z * s, 255.0f * s);
 }
 
-cudaError_t cudaRGBToRGBAf( uchar3* srcDev, float4* destDev, size_t width, size_t height )
+cudaError_t cudaRGBToRGBAf( uchar3* srcDev, float4* destDev, size_t width, size_t height, cudaStream_t stream )
 {
+	TRACE_SCOPE("cudaRGBToRGBAf");
+
 	if( !srcDev || !destDev )
 		return cudaErrorInvalidDevicePointer;
 
 	const dim3 blockDim(8,8,1);
 	const dim3 gridDim(iDivUp(width,blockDim.x), iDivUp(height,blockDim.y), 1);
 
-	RGBToRGBAf<<<gridDim, blockDim>>>( srcDev, destDev, width, height );
+	RGBToRGBAf<<<gridDim, blockDim, 0, stream>>>( srcDev, destDev, width, height );
 	
 	return CUDA(cudaGetLastError());
 }
 
+//-------------------------------------------------------------------------------------------------------------------------
+
+template<imageFormat format>
+__global__ void RGBToFormat( uchar3* srcImage, uint8_t* dstImage, uint32_t width, uint32_t height )
+{
+	const int x = (blockIdx.x * blockDim.x) + threadIdx.x;
+	const int y = (blockIdx.y * blockDim.y) + threadIdx.y;
+
+	if( x >= width || y >= height )
+		return;
+
+	imageStoreRGB8<format>(dstImage + y * width * imageFormatSize(format), x, srcImage[y * width + x]);
+}
+
+template<imageFormat format>
+cudaError_t launchRGBToFormat( uchar3* srcDev, void* destDev, size_t width, size_t height, cudaStream_t stream )
+{
+	const dim3 blockDim(32,8,1);
+	const dim3 gridDim(iDivUp(width,blockDim.x), iDivUp(height,blockDim.y), 1);
+
+	RGBToFormat<format><<<gridDim, blockDim, 0, stream>>>( srcDev, (uint8_t*)destDev, width, height );
+
+	return CUDA(cudaGetLastError());
+}
+
+cudaError_t cudaRGBToFormat( uchar3* srcDev, void* destDev, size_t width, size_t height, imageFormat format, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaRGBToFormat");
+
+	if( !srcDev || !destDev )
+		return cudaErrorInvalidDevicePointer;
+
+	if( width == 0 || height == 0 )
+		return cudaErrorInvalidValue;
+
+	switch(format)
+	{
+		case IMAGE_RGBA32F:	return launchRGBToFormat<IMAGE_RGBA32F>(srcDev, destDev, width, height, stream);
+		case IMAGE_RGBA16F:	return launchRGBToFormat<IMAGE_RGBA16F>(srcDev, destDev, width, height, stream);
+		case IMAGE_RGBA8:	return launchRGBToFormat<IMAGE_RGBA8>(srcDev, destDev, width, height, stream);
+		case IMAGE_RGB8:	return launchRGBToFormat<IMAGE_RGB8>(srcDev, destDev, width, height, stream);
+		case IMAGE_BGR8:	return launchRGBToFormat<IMAGE_BGR8>(srcDev, destDev, width, height, stream);
+	}
+
+	return cudaErrorInvalidValue;
+}
@@ -25,6 +25,7 @@
 
 
 #include "cudaUtility.h"
+#include "imageFormat.h"
 #include <stdint.h>
 
 
@@ -32,7 +33,14 @@
  * Convert 8-bit fixed-point RGB image to 32-bit floating-point RGBA image
  * @ingroup util
  */
-cudaError_t cudaRGBToRGBAf( uchar3* input, float4* output, size_t width, size_t height );
+cudaError_t cudaRGBToRGBAf( uchar3* input, float4* output, size_t width, size_t height, cudaStream_t stream=NULL );
+
+
+/**
+ * Convert 8-bit RGB to any of the imageFormat layouts (IMAGE_RGBA32F is the same as cudaRGBToRGBAf).
+ * @ingroup util
+ */
+cudaError_t cudaRGBToFormat( uchar3* input, void* output, size_t width, size_t height, imageFormat format, cudaStream_t stream=NULL );
 
 
 #endif
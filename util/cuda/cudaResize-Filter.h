@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CUDA_RESIZE_FILTER_H
+#define __CUDA_RESIZE_FILTER_H
+
+
+#include "cudaColorspace.h"
+#include "imageView.h"
+
+
+/*
+ * Internal to cudaResize.cu and cpuResize.cpp:  the math of the bilinear and
+ * area filters, shared so that the CPU and CUDA results are bit-exact.
+ *
+ * Bilinear uses pixel centers ((x + 0.5) * scale - 0.5, clamped at the
+ * borders) with RESIZE_LINEAR_BITS of fractional position, computed with
+ * integers.  uint8 channels are blended in fixed-point and rounded once,
+ * float channels with two lerps rounded per operation (see COLOR_MUL).
+ *
+ * Area averages the box of source pixels covering each output pixel (see
+ * lumaBoxRange), summing each row of the box and then the rows, in order.
+ *
+ * The CPU runs the same operations separably (rows first), the kernels per
+ * output pixel with resizeLinearPixel() / resizeAreaPixel(), which
+ * jetson-bench --verify also runs on the CPU as the reference.
+ */
+#define RESIZE_LINEAR_BITS	11
+#define RESIZE_LINEAR_ONE	(1 << RESIZE_LINEAR_BITS)
+
+
+/*
+ * Channels of the pixel types, and the type of their intermediate sums
+ */
+template<typename T> struct resizePixel;
+
+template<> struct resizePixel<uint8_t>	{ typedef uint8_t scalar; typedef uint32_t accum; static const int channels = 1; };
+template<> struct resizePixel<uchar4>	{ typedef uint8_t scalar; typedef uint32_t accum; static const int channels = 4; };
+template<> struct resizePixel<float>	{ typedef float scalar;   typedef float accum;    static const int channels = 1; };
+template<> struct resizePixel<float4>	{ typedef float scalar;   typedef float accum;    static const int channels = 4; };
+
+
+/*
+ * Load a source pixel, through the read-only (texture) cache on the device
+ */
+template<typename T>
+inline __host__ __device__ T resizeLoad( const T* ptr )
+{
+#ifdef __CUDA_ARCH__
+	return __ldg(ptr);
+#else
+	return *ptr;
+#endif
+}
+
+
+/*
+ * Source samples i0, i1 and the weight of i1 (in 1/RESIZE_LINEAR_ONE) of
+ * output sample n of count, when count samples cover size source samples
+ */
+inline __host__ __device__ void resizeLinearRange( uint32_t n, uint32_t count, uint32_t size, uint32_t& i0, uint32_t& i1, uint32_t& weight )
+{
+	const int64_t pos = (int64_t(2 * n + 1) * size * RESIZE_LINEAR_ONE) / (2 * int64_t(count)) - RESIZE_LINEAR_ONE / 2;
+
+	if( pos <= 0 )
+	{
+		i0 = i1 = 0;
+		weight = 0;
+		return;
+	}
+
+	i0 = uint32_t(pos >> RESIZE_LINEAR_BITS);
+	weight = uint32_t(pos & (RESIZE_LINEAR_ONE - 1));
+
+	if( i0 >= size - 1 )
+	{
+		i0 = i1 = size - 1;
+		weight = 0;
+		return;
+	}
+
+	i1 = i0 + 1;
+}
+
+
+/*
+ * Blend two samples of a row (horizontal) and then two of those (vertical)
+ */
+inline __host__ __device__ uint32_t resizeLinearH( uint8_t a, uint8_t b, uint32_t weight )
+{
+	return a * (RESIZE_LINEAR_ONE - weight) + b * weight;
+}
+
+inline __host__ __device__ float resizeLinearH( float a, float b, uint32_t weight )
+{
+	return COLOR_ADD(a, COLOR_MUL(COLOR_SUB(b, a), float(weight) * (1.0f / RESIZE_LINEAR_ONE)));
+}
+
+inline __host__ __device__ uint8_t resizeLinearV( uint32_t a, uint32_t b, uint32_t weight )
+{
+	return uint8_t((a * (RESIZE_LINEAR_ONE - weight) + b * weight + (1u << (2 * RESIZE_LINEAR_BITS - 1))) >> (2 * RESIZE_LINEAR_BITS));
+}
+
+inline __host__ __device__ float resizeLinearV( float a, float b, uint32_t weight )
+{
+	return resizeLinearH(a, b, weight);
+}
+
+
+/*
+ * Sum of area samples, and their average
+ */
+inline __host__ __device__ uint32_t resizeAreaAdd( uint32_t sum, uint32_t value )	{ return sum + value; }
+inline __host__ __device__ float resizeAreaAdd( float sum, float value )			{ return COLOR_ADD(sum, value); }
+
+inline __host__ __device__ void resizeAreaStore( uint8_t& output, uint32_t sum, uint32_t area )	{ output = uint8_t((sum + area / 2) / area); }
+inline __host__ __device__ void resizeAreaStore( float& output, float sum, uint32_t area )		{ output = sum / float(area); }
+
+
+/*
+ * Check that the boxes of an area downscale can be summed in 32 bits
+ */
+inline bool resizeAreaValid( size_t inputWidth, size_t inputHeight, size_t outputWidth, size_t outputHeight )
+{
+	const uint64_t boxWidth  = (inputWidth + outputWidth - 1) / outputWidth;
+	const uint64_t boxHeight = (inputHeight + outputHeight - 1) / outputHeight;
+
+	return boxWidth * boxHeight * 255 <= UINT32_MAX;
+}
+
+
+/*
+ * Integer ratio of an area downscale with a specialized path (2, 3 or 4 in
+ * both directions), or 0
+ */
+inline int resizeAreaRatio( size_t inputWidth, size_t inputHeight, size_t outputWidth, size_t outputHeight )
+{
+	for( int k=2; k <= 4; k++ )
+	{
+		if( inputWidth == outputWidth * k && inputHeight == outputHeight * k )
+			return k;
+	}
+
+	return 0;
+}
+
+
+/*
+ * Nearest output pixel (x,y), scale is the input size over the output size
+ */
+template<typename T>
+inline __host__ __device__ T resizeNearestSample( const ImageView<T>& input, const float2& scale, uint32_t x, uint32_t y )
+{
+	const int dx = ((float)x * scale.x);
+	const int dy = ((float)y * scale.y);
+
+	return input(dx, dy);
+}
+
+template<typename T>
+inline __host__ __device__ void resizeNearestPixel( const ImageView<T>& input, const ImageView<T>& output, const float2& scale, uint32_t x, uint32_t y )
+{
+	output(x, y) = resizeNearestSample(input, scale, x, y);
+}
+
+
+/*
+ * Bilinear output pixel (x,y) of an outputWidth x outputHeight resize
+ */
+template<typename T>
+inline __host__ __device__ T resizeLinearSample( const ImageView<T>& input, uint32_t outputWidth, uint32_t outputHeight, uint32_t x, uint32_t y )
+{
+	typedef typename resizePixel<T>::scalar S;
+	const int C = resizePixel<T>::channels;
+
+	uint32_t x0, x1, wx;
+	uint32_t y0, y1, wy;
+
+	resizeLinearRange(x, outputWidth, input.width, x0, x1, wx);
+	resizeLinearRange(y, outputHeight, input.height, y0, y1, wy);
+
+	const T p00 = resizeLoad(input.Row(y0) + x0);
+	const T p01 = resizeLoad(input.Row(y0) + x1);
+	const T p10 = resizeLoad(input.Row(y1) + x0);
+	const T p11 = resizeLoad(input.Row(y1) + x1);
+
+	T px;
+
+	for( int c=0; c < C; c++ )
+	{
+		((S*)&px)[c] = resizeLinearV(resizeLinearH(((const S*)&p00)[c], ((const S*)&p01)[c], wx),
+							    resizeLinearH(((const S*)&p10)[c], ((const S*)&p11)[c], wx), wy);
+	}
+
+	return px;
+}
+
+template<typename T>
+inline __host__ __device__ void resizeLinearPixel( const ImageView<T>& input, const ImageView<T>& output, uint32_t x, uint32_t y )
+{
+	output(x, y) = resizeLinearSample(input, output.width, output.height, x, y);
+}
+
+
+/*
+ * Area output pixel (x,y) of an outputWidth x outputHeight resize, over a ratio x ratio box
+ * (or the box from lumaBoxRange if ratio is 0).  Each column of the box is summed first
+ * and then the columns, in the order the CPU adds them.
+ */
+template<typename T, int ratio>
+inline __host__ __device__ T resizeAreaSample( const ImageView<T>& input, uint32_t outputWidth, uint32_t outputHeight, uint32_t x, uint32_t y )
+{
+	typedef typename resizePixel<T>::scalar S;
+	typedef typename resizePixel<T>::accum A;
+	const int C = resizePixel<T>::channels;
+
+	uint32_t x0, x1, y0, y1;
+
+	if( ratio != 0 )
+	{
+		x0 = x * ratio;  x1 = x0 + ratio;
+		y0 = y * ratio;  y1 = y0 + ratio;
+	}
+	else
+	{
+		lumaBoxRange(x, outputWidth, input.width, x0, x1);
+		lumaBoxRange(y, outputHeight, input.height, y0, y1);
+	}
+
+	A sum[C];
+
+	for( int c=0; c < C; c++ )
+		sum[c] = 0;
+
+	for( uint32_t sx=x0; sx < x1; sx++ )
+	{
+		A colSum[C];
+
+		for( int c=0; c < C; c++ )
+			colSum[c] = 0;
+
+		for( uint32_t sy=y0; sy < y1; sy++ )
+		{
+			const T px = resizeLoad(input.Row(sy) + sx);
+
+			for( int c=0; c < C; c++ )
+				colSum[c] = resizeAreaAdd(colSum[c], ((const S*)&px)[c]);
+		}
+
+		for( int c=0; c < C; c++ )
+			sum[c] = resizeAreaAdd(sum[c], colSum[c]);
+	}
+
+	T px;
+
+	for( int c=0; c < C; c++ )
+		resizeAreaStore(((S*)&px)[c], sum[c], (x1 - x0) * (y1 - y0));
+
+	return px;
+}
+
+template<typename T, int ratio>
+inline __host__ __device__ void resizeAreaPixel( const ImageView<T>& input, const ImageView<T>& output, uint32_t x, uint32_t y )
+{
+	output(x, y) = resizeAreaSample<T, ratio>(input, output.width, output.height, x, y);
+}
+
+
+#endif
+
@@ -21,71 +21,144 @@
  */
 
 #include "cudaResize.h"
+#include "cudaResize-Filter.h"
+#include "trace.h"
 
 
 
 // gpuResample
 template <typename T>
-__global__ void gpuResize( float2 scale, T* input, int iWidth, T* output, int oWidth, int oHeight )
+__global__ void gpuResize( float2 scale, ImageView<T> input, ImageView<T> output )
 {
 	const int x = blockIdx.x * blockDim.x + threadIdx.x;
 	const int y = blockIdx.y * blockDim.y + threadIdx.y;
 
-	if( x >= oWidth || y >= oHeight )
+	if( x >= output.width || y >= output.height )
 		return;
 
-	const int dx = ((float)x * scale.x);
-	const int dy = ((float)y * scale.y);
+	resizeNearestPixel(input, output, scale, x, y);
+}
+
+
+// gpuResizeLinear
+template <typename T>
+__global__ void gpuResizeLinear( ImageView<T> input, ImageView<T> output )
+{
+	const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+	const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
 
-	const T px = input[ dy * iWidth + dx ];
+	if( x >= output.width || y >= output.height )
+		return;
 
-	output[y*oWidth+x] = px;
+	resizeLinearPixel(input, output, x, y);
 }
 
 
-// cudaResize
-cudaError_t cudaResize( float* input, size_t inputWidth, size_t inputHeight,
-				        float* output, size_t outputWidth, size_t outputHeight )
+// gpuResizeArea
+template <typename T, int ratio>
+__global__ void gpuResizeArea( ImageView<T> input, ImageView<T> output )
+{
+	const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+	const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+
+	if( x >= output.width || y >= output.height )
+		return;
+
+	resizeAreaPixel<T, ratio>(input, output, x, y);
+}
+
+
+// launchResize
+template <typename T>
+static cudaError_t launchResize( const ImageView<T>& input, const ImageView<T>& output, resizeFilter filter, cudaStream_t stream )
 {
-	if( !input || !output )
+	if( !input.ptr || !output.ptr )
 		return cudaErrorInvalidDevicePointer;
 
-	if( inputWidth == 0 || outputWidth == 0 || inputHeight == 0 || outputHeight == 0 )
+	if( !input.IsValid() || !output.IsValid() )
 		return cudaErrorInvalidValue;
 
-	const float2 scale = make_float2( float(inputWidth) / float(outputWidth),
-							          float(inputHeight) / float(outputHeight) );
+	if( filter == RESIZE_NEAREST )
+	{
+		const float2 scale = make_float2( float(input.width) / float(output.width),
+								    float(input.height) / float(output.height) );
+
+		// launch kernel
+		const dim3 blockDim(8, 8);
+		const dim3 gridDim(iDivUp(output.width,blockDim.x), iDivUp(output.height,blockDim.y));
+
+		gpuResize<T><<<gridDim, blockDim, 0, stream>>>(scale, input, output);
+		return CUDA(cudaGetLastError());
+	}
+
+	const dim3 blockDim(32, 8);
+	const dim3 gridDim(iDivUp(output.width,blockDim.x), iDivUp(output.height,blockDim.y));
+
+	if( filter == RESIZE_BILINEAR )
+	{
+		gpuResizeLinear<T><<<gridDim, blockDim, 0, stream>>>(input, output);
+	}
+	else if( filter == RESIZE_AREA )
+	{
+		if( !resizeAreaValid(input.width, input.height, output.width, output.height) )
+			return cudaErrorInvalidValue;
+
+		switch( resizeAreaRatio(input.width, input.height, output.width, output.height) )
+		{
+			case 2:	 gpuResizeArea<T, 2><<<gridDim, blockDim, 0, stream>>>(input, output); break;
+			case 3:	 gpuResizeArea<T, 3><<<gridDim, blockDim, 0, stream>>>(input, output); break;
+			case 4:	 gpuResizeArea<T, 4><<<gridDim, blockDim, 0, stream>>>(input, output); break;
+			default: gpuResizeArea<T, 0><<<gridDim, blockDim, 0, stream>>>(input, output); break;
+		}
+	}
+	else
+	{
+		return cudaErrorInvalidValue;
+	}
 
-	// launch kernel
-	const dim3 blockDim(8, 8);
-	const dim3 gridDim(iDivUp(outputWidth,blockDim.x), iDivUp(outputHeight,blockDim.y));
+	return CUDA(cudaGetLastError());
+}
 
-	gpuResize<float><<<gridDim, blockDim>>>(scale, input, inputWidth, output, outputWidth, outputHeight);
 
-	return CUDA(cudaGetLastError());
+// cudaResize
+cudaError_t cudaResize( const ImageView<float>& input, const ImageView<float>& output, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaResize");
+	return launchResize(input, output, RESIZE_NEAREST, stream);
 }
 
 
 // cudaResizeRGBA
-cudaError_t cudaResizeRGBA( float4* input,  size_t inputWidth, size_t inputHeight,
-				            float4* output, size_t outputWidth, size_t outputHeight )
+cudaError_t cudaResizeRGBA( const ImageView<float4>& input, const ImageView<float4>& output, cudaStream_t stream )
 {
-	if( !input || !output )
-		return cudaErrorInvalidDevicePointer;
+	TRACE_SCOPE("cudaResizeRGBA");
+	return launchResize(input, output, RESIZE_NEAREST, stream);
+}
 
-	if( inputWidth == 0 || outputWidth == 0 || inputHeight == 0 || outputHeight == 0 )
-		return cudaErrorInvalidValue;
 
-	const float2 scale = make_float2( float(inputWidth) / float(outputWidth),
-							    float(inputHeight) / float(outputHeight) );
+// cudaResize (filtered)
+cudaError_t cudaResize( const ImageView<uint8_t>& input, const ImageView<uint8_t>& output, resizeFilter filter, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaResize");
+	return launchResize(input, output, filter, stream);
+}
 
-	// launch kernel
-	const dim3 blockDim(8, 8);
-	const dim3 gridDim(iDivUp(outputWidth,blockDim.x), iDivUp(outputHeight,blockDim.y));
+cudaError_t cudaResize( const ImageView<uchar4>& input, const ImageView<uchar4>& output, resizeFilter filter, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaResize");
+	return launchResize(input, output, filter, stream);
+}
 
-	gpuResize<float4><<<gridDim, blockDim>>>(scale, input, inputWidth, output, outputWidth, outputHeight);
+cudaError_t cudaResize( const ImageView<float>& input, const ImageView<float>& output, resizeFilter filter, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaResize");
+	return launchResize(input, output, filter, stream);
+}
 
-	return CUDA(cudaGetLastError());
+cudaError_t cudaResize( const ImageView<float4>& input, const ImageView<float4>& output, resizeFilter filter, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaResize");
+	return launchResize(input, output, filter, stream);
 }
 
 
@@ -25,22 +25,89 @@
 
 
 #include "cudaUtility.h"
+#include "imageView.h"
+
+
+/**
+ * Interpolation used to resample an image.
+ * @ingroup util
+ */
+enum resizeFilter
+{
+	RESIZE_NEAREST = 0,	/**< nearest neighbor (the top-left source pixel of each output pixel) */
+	RESIZE_BILINEAR,	/**< bilinear, with pixel centers aligned like OpenCV's INTER_LINEAR */
+	RESIZE_AREA		/**< average of the source pixels covered by each output pixel, for downscaling */
+};
+
+/**
+ * Convert a resizeFilter to a string ("nearest", "bilinear", "area").
+ * @ingroup util
+ */
+inline const char* resizeFilterToStr( resizeFilter filter )
+{
+	switch(filter)
+	{
+		case RESIZE_NEAREST:	return "nearest";
+		case RESIZE_BILINEAR:	return "bilinear";
+		case RESIZE_AREA:		return "area";
+	}
+
+	return "unknown";
+}
+
+
+/**
+ * Function for increasing or decreasing the size of an image on the GPU.
+ * The views may be pitched or crops of a larger image (see ImageView).
+ * @ingroup util
+ */
+cudaError_t cudaResize( const ImageView<float>& input, const ImageView<float>& output, cudaStream_t stream=NULL );
+
+
+/**
+ * Function for increasing or decreasing the size of an image on the GPU.
+ * The views may be pitched or crops of a larger image (see ImageView).
+ * @ingroup util
+ */
+cudaError_t cudaResizeRGBA( const ImageView<float4>& input, const ImageView<float4>& output, cudaStream_t stream=NULL );
+
+
+/**
+ * Resize an image with the given filter, for 8-bit and float gray or RGBA pixels.
+ *
+ * Bilinear blends uint8 channels in fixed-point with one rounding, area averages
+ * the box of source pixels of each output pixel, rounded to nearest for uint8.
+ * Area downscales by 2, 3 and 4 in both directions use specialized kernels.
+ * The source is read through the read-only cache, the views may be pitched or crops.
+ * The CPU equivalents in cpuResize.h are bit-exact.
+ * @ingroup util
+ */
+cudaError_t cudaResize( const ImageView<uint8_t>& input, const ImageView<uint8_t>& output, resizeFilter filter, cudaStream_t stream=NULL );
+cudaError_t cudaResize( const ImageView<uchar4>& input, const ImageView<uchar4>& output, resizeFilter filter, cudaStream_t stream=NULL );
+cudaError_t cudaResize( const ImageView<float>& input, const ImageView<float>& output, resizeFilter filter, cudaStream_t stream=NULL );
+cudaError_t cudaResize( const ImageView<float4>& input, const ImageView<float4>& output, resizeFilter filter, cudaStream_t stream=NULL );
 
 
 /**
  * Function for increasing or decreasing the size of an image on the GPU.
  * @ingroup util
  */
-cudaError_t cudaResize( float* input,  size_t inputWidth,  size_t inputHeight,
-				    float* output, size_t outputWidth, size_t outputHeight );
+inline cudaError_t cudaResize( float* input,  size_t inputWidth,  size_t inputHeight,
+					     float* output, size_t outputWidth, size_t outputHeight, cudaStream_t stream=NULL )
+{
+	return cudaResize(ImageView<float>(input, inputWidth, inputHeight), ImageView<float>(output, outputWidth, outputHeight), stream);
+}
 
 
 /**
  * Function for increasing or decreasing the size of an image on the GPU.
  * @ingroup util
  */
-cudaError_t cudaResizeRGBA( float4* input,  size_t inputWidth,  size_t inputHeight,
-				        float4* output, size_t outputWidth, size_t outputHeight );
+inline cudaError_t cudaResizeRGBA( float4* input,  size_t inputWidth,  size_t inputHeight,
+					         float4* output, size_t outputWidth, size_t outputHeight, cudaStream_t stream=NULL )
+{
+	return cudaResizeRGBA(ImageView<float4>(input, inputWidth, inputHeight), ImageView<float4>(output, outputWidth, outputHeight), stream);
+}
 
 
 						
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+ 
+
+#include "cudaTensor-ROI.h"
+#include "trace.h"
+
+
+// the frames of one launch, passed to the kernel by value
+template <typename T>
+struct roiFrames
+{
+	ImageView<T> frames[TENSOR_ROI_MAX_FRAMES];
+	uint32_t     count;
+};
+
+
+// gpuROIToTensor
+//  blockIdx.z is the index of the box, each box is cropped from its frame
+template<typename T, tensorFormat format, tensorLayout layout>
+__global__ void gpuROIToTensor( tensorWriter writer, roiFrames<T> frames, const tensorROI* rois, uint8_t* output, size_t size )
+{
+	const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+	const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+	const uint32_t n = blockIdx.z;
+
+	if( x >= writer.width || y >= writer.height )
+		return;
+
+	const tensorROI roi = rois[n];
+
+	if( roi.frame >= frames.count )
+		return;
+
+	tensorWriteROI<T, format, layout>(writer, tensorROICrop(frames.frames[roi.frame], roi.box), output + n * size, x, y);
+}
+
+
+// launchROI
+template <typename T>
+struct launchROI
+{
+	const tensorWriter writer;
+	const roiFrames<T>& frames;
+	const tensorROI* rois;
+	uint32_t count;
+	uint8_t* output;
+	cudaStream_t stream;
+
+	launchROI( const tensorWriter& w, const roiFrames<T>& f, const tensorROI* r, uint32_t n, void* out, cudaStream_t s ) : writer(w), frames(f), rois(r), count(n), output((uint8_t*)out), stream(s)	{ }
+
+	template<tensorFormat format, tensorLayout layout>
+	void run()
+	{
+		const size_t size = size_t(writer.width) * writer.height * 3 * tensorFormatSize(format);
+		const uint32_t maxBoxes = 65535;	// of the grid z dimension
+
+		const dim3 blockDim(32, 8);
+
+		for( uint32_t first=0; first < count; first += maxBoxes )
+		{
+			const uint32_t boxes = (count - first < maxBoxes) ? count - first : maxBoxes;
+			const dim3 gridDim(iDivUp(writer.width,blockDim.x), iDivUp(writer.height,blockDim.y), boxes);
+
+			gpuROIToTensor<T, format, layout><<<gridDim, blockDim, 0, stream>>>(writer, frames, rois + first, output + first * size, size);
+		}
+	}
+};
+
+
+// launchROIToTensor
+template <typename T>
+static cudaError_t launchROIToTensor( const ImageView<T>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count,
+							   void* output, const tensorParams& params, cudaStream_t stream )
+{
+	if( !frames || !rois || !output )
+		return cudaErrorInvalidDevicePointer;
+
+	if( frameCount == 0 || frameCount > TENSOR_ROI_MAX_FRAMES || params.width == 0 || params.height == 0 )
+		return cudaErrorInvalidValue;
+
+	if( params.scale == 0.0f || params.stdDev.x == 0.0f || params.stdDev.y == 0.0f || params.stdDev.z == 0.0f || params.int8Scale == 0.0f )
+		return cudaErrorInvalidValue;
+
+	roiFrames<T> f;
+	f.count = frameCount;
+
+	for( uint32_t n=0; n < frameCount; n++ )
+	{
+		if( !frames[n].ptr )
+			return cudaErrorInvalidDevicePointer;
+
+		if( !frames[n].IsValid() )
+			return cudaErrorInvalidValue;
+
+		f.frames[n] = frames[n];
+	}
+
+	if( count == 0 )
+		return cudaSuccess;
+
+	launchROI<T> launch(tensorWriterInit(params, params.width, params.height), f, rois, count, output, stream);
+	tensorDispatch(launch.writer, launch);
+
+	return CUDA(cudaGetLastError());
+}
+
+
+// cudaROIToTensor
+cudaError_t cudaROIToTensor( const ImageView<uchar4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count,
+					    void* output, const tensorParams& params, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaROIToTensor");
+	return launchROIToTensor(frames, frameCount, rois, count, output, params, stream);
+}
+
+cudaError_t cudaROIToTensor( const ImageView<float4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count,
+					    void* output, const tensorParams& params, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaROIToTensor");
+	return launchROIToTensor(frames, frameCount, rois, count, output, params, stream);
+}
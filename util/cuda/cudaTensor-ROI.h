@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+ 
+
+#ifndef __CUDA_TENSOR_ROI_H__
+#define __CUDA_TENSOR_ROI_H__
+
+
+#include "cudaTensor.h"
+#include "cudaResize-Filter.h"
+#include "imageView.h"
+
+
+/**
+ * Maximum number of frames the boxes of one cudaROIToTensor() call can come from.
+ * @ingroup util
+ */
+#define TENSOR_ROI_MAX_FRAMES 16
+
+
+/**
+ * A region of interest, for example a detection to pass to a second-stage classifier.
+ * @ingroup util
+ */
+struct tensorROI
+{
+	float4   box;	/**< left, top, right, bottom in pixels of the frame (as for cudaRectOutlineOverlay()) */
+	uint32_t frame;	/**< index of the frame that the box is in */
+};
+
+
+/**
+ * Pixel rectangle that a box is cropped to:  the box is extended outwards to
+ * whole pixels, clipped to the frame, and is at least one pixel in each direction.
+ * @ingroup util
+ */
+inline __host__ __device__ void tensorROIRect( const float4& box, uint32_t frameWidth, uint32_t frameHeight, uint32_t& left, uint32_t& top, uint32_t& width, uint32_t& height )
+{
+	const float x0 = fminf(fmaxf(floorf(box.x), 0.0f), float(frameWidth - 1));
+	const float y0 = fminf(fmaxf(floorf(box.y), 0.0f), float(frameHeight - 1));
+	const float x1 = fminf(fmaxf(ceilf(box.z), x0 + 1.0f), float(frameWidth));
+	const float y1 = fminf(fmaxf(ceilf(box.w), y0 + 1.0f), float(frameHeight));
+
+	left   = uint32_t(x0);
+	top    = uint32_t(y0);
+	width  = uint32_t(x1) - left;
+	height = uint32_t(y1) - top;
+}
+
+/**
+ * Crop of the frame for a box, see tensorROIRect().
+ * @ingroup util
+ */
+template<typename T>
+inline __host__ __device__ ImageView<T> tensorROICrop( const ImageView<T>& frame, const float4& box )
+{
+	uint32_t left, top, width, height;
+	tensorROIRect(box, frame.width, frame.height, left, top, width, height);
+	return frame.Crop(left, top, width, height);
+}
+
+
+/**
+ * Compute tensor pixel (x,y) of a crop and store its three channels.  The crop
+ * is resized to the tensor with bilinear sampling, the same as cudaResize()
+ * with RESIZE_BILINEAR, so only the source pixels around each of the tensor
+ * pixels are read.
+ * @ingroup util
+ */
+template<typename T, tensorFormat format, tensorLayout layout>
+inline __host__ __device__ void tensorWriteROI( const tensorWriter& w, const ImageView<T>& crop, void* output, uint32_t x, uint32_t y )
+{
+	float r, g, b;
+	tensorPixelRGB(resizeLinearSample(crop, w.width, w.height, x, y), r, g, b);
+	tensorWriteRGB<format, layout>(w, output, x, y, r, g, b);
+}
+
+
+/**
+ * Batched crop, resize and normalization of regions of interest into network input tensors,
+ * in a single kernel for all of the boxes of all of the frames.
+ *
+ * Box n is cropped from frames[rois[n].frame] (see tensorROIRect()), resized to
+ * params.width x params.height with bilinear sampling, normalized as in tensorParams
+ * and stored at output + n * tensorSize(params), so the output is a packed batch
+ * (NCHW for TENSOR_LAYOUT_CHW).  The work is proportional to the size of the batch,
+ * not of the frames or the boxes.  params.colorimetry isn't used.
+ *
+ * The values are the same as cudaResize() of each crop followed by the normalization,
+ * and bit-exact with it when mean=0 and stdDev=1.
+ *
+ * @param frames views of the frames (at most TENSOR_ROI_MAX_FRAMES), in device memory.
+ * @param rois boxes, in memory the kernel can read (mapped or device).
+ *             The tensor of a box whose frame index is out of range is left unwritten.
+ * @ingroup util
+ */
+cudaError_t cudaROIToTensor( const ImageView<uchar4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count,
+					    void* output, const tensorParams& params, cudaStream_t stream=NULL );
+
+cudaError_t cudaROIToTensor( const ImageView<float4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count,
+					    void* output, const tensorParams& params, cudaStream_t stream=NULL );
+
+
+/**
+ * Crops from a single frame, see cudaROIToTensor().
+ * @ingroup util
+ */
+inline cudaError_t cudaROIToTensor( const ImageView<float4>& frame, const tensorROI* rois, uint32_t count, void* output, const tensorParams& params, cudaStream_t stream=NULL )
+{
+	return cudaROIToTensor(&frame, 1, rois, count, output, params, stream);
+}
+
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cudaTensor.h"
+#include "trace.h"
+
+
+// gpuNV12ToTensor
+template<tensorFormat format, tensorLayout layout>
+__global__ void gpuNV12ToTensor( tensorWriter writer, uint8_t* input, size_t inputPitch, uint32_t inputHeight, void* output )
+{
+	const int x = blockIdx.x * blockDim.x + threadIdx.x;
+	const int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+	if( x >= writer.width || y >= writer.height )
+		return;
+
+	tensorWriteNV12<format, layout>(writer, input, inputPitch, inputHeight, output, x, y);
+}
+
+
+// launchTensor
+struct launchTensor
+{
+	const tensorWriter writer;
+	uint8_t* input;
+	size_t   inputPitch;
+	uint32_t inputHeight;
+	void*    output;
+	cudaStream_t stream;
+
+	launchTensor( const tensorWriter& w, uint8_t* in, size_t pitch, uint32_t height, void* out, cudaStream_t s ) : writer(w), input(in), inputPitch(pitch), inputHeight(height), output(out), stream(s)	{ }
+
+	template<tensorFormat format, tensorLayout layout>
+	void run()
+	{
+		const dim3 blockDim(32, 8);
+		const dim3 gridDim(iDivUp(writer.width,blockDim.x), iDivUp(writer.height,blockDim.y));
+
+		gpuNV12ToTensor<format, layout><<<gridDim, blockDim, 0, stream>>>(writer, input, inputPitch, inputHeight, output);
+	}
+};
+
+
+// cudaNV12ToTensor
+cudaError_t cudaNV12ToTensor( uint8_t* input, size_t inputPitch, size_t inputWidth, size_t inputHeight, void* output, const tensorParams& params, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaNV12ToTensor");
+
+	if( !input || !output )
+		return cudaErrorInvalidDevicePointer;
+
+	if( inputPitch == 0 || inputWidth == 0 || inputHeight == 0 || params.width == 0 || params.height == 0 )
+		return cudaErrorInvalidValue;
+
+	if( params.scale == 0.0f || params.stdDev.x == 0.0f || params.stdDev.y == 0.0f || params.stdDev.z == 0.0f || params.int8Scale == 0.0f )
+		return cudaErrorInvalidValue;
+
+	launchTensor launch(tensorWriterInit(params, inputWidth, inputHeight), input, inputPitch, inputHeight, output, stream);
+	tensorDispatch(launch.writer, launch);
+
+	return CUDA(cudaGetLastError());
+}
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CUDA_TENSOR_H__
+#define __CUDA_TENSOR_H__
+
+
+#include "cudaColorspace.h"
+
+
+/**
+ * Memory layout of a network input tensor.
+ * @ingroup util
+ */
+enum tensorLayout
+{
+	TENSOR_LAYOUT_CHW = 0,	/**< planar, one plane per channel (NCHW with N=1) */
+	TENSOR_LAYOUT_HWC		/**< interleaved, channels of each pixel together */
+};
+
+/**
+ * Element type of a network input tensor.
+ * @ingroup util
+ */
+enum tensorFormat
+{
+	TENSOR_FORMAT_FP32 = 0,	/**< float */
+	TENSOR_FORMAT_FP16,		/**< IEEE half, stored as uint16_t */
+	TENSOR_FORMAT_INT8		/**< int8_t, symmetric quantization:  round(value / int8Scale) */
+};
+
+
+/**
+ * Parameters of the fused NV12 preprocessing (see cudaNV12ToTensor).
+ *
+ * Each element is computed from the [0,255] RGB value of cudaNV12ToRGBAf() as:
+ *
+ *    value = (px * scale - mean[c]) / stdDev[c]
+ *
+ * The mean and stdDev are given in RGB order, before the channels are swapped for BGR.
+ * For example ImageNet models use scale=1/255, mean=(0.485, 0.456, 0.406), stdDev=(0.229, 0.224, 0.225).
+ * TENSOR_FORMAT_INT8 stores round(value / int8Scale) + int8ZeroPoint, saturated to [-128,127].
+ * @ingroup util
+ */
+struct tensorParams
+{
+	uint32_t     width;		/**< width of the tensor (the frame is resized to it) */
+	uint32_t     height;	/**< height of the tensor */
+	tensorLayout layout;
+	tensorFormat format;
+	bool         bgr;		/**< swap the channels to BGR order */
+	float        scale;
+	float3       mean;
+	float3       stdDev;
+	float        int8Scale;	/**< quantization step for TENSOR_FORMAT_INT8 */
+	int32_t      int8ZeroPoint;	/**< quantized value of 0.0 for TENSOR_FORMAT_INT8 (0 for symmetric) */
+	yuvColorimetry colorimetry;	/**< colorimetry of the NV12 frame */
+
+	tensorParams( uint32_t w=0, uint32_t h=0 ) : width(w), height(h), layout(TENSOR_LAYOUT_CHW), format(TENSOR_FORMAT_FP32),
+									    bgr(false), scale(1.0f), int8Scale(1.0f), int8ZeroPoint(0)
+	{
+		mean   = make_float3(0.0f, 0.0f, 0.0f);
+		stdDev = make_float3(1.0f, 1.0f, 1.0f);
+	}
+};
+
+
+/**
+ * Size of an element of the given format, in bytes.
+ * @ingroup util
+ */
+inline __host__ __device__ size_t tensorFormatSize( tensorFormat format )
+{
+	return (format == TENSOR_FORMAT_FP32) ? 4 : (format == TENSOR_FORMAT_FP16) ? 2 : 1;
+}
+
+/**
+ * Size of the tensor described by the parameters (3 channels), in bytes.
+ * @ingroup util
+ */
+inline __host__ __device__ size_t tensorSize( const tensorParams& params )
+{
+	return size_t(params.width) * size_t(params.height) * 3 * tensorFormatSize(params.format);
+}
+
+
+/**
+ * Quantize a value to int8 (round to nearest even, offset by the zero point, saturating).
+ * @ingroup util
+ */
+inline __host__ __device__ int8_t tensorQuantize( float value, float invScale, float zeroPoint=0.0f )
+{
+	const float q = COLOR_ADD(rintf(COLOR_MUL(value, invScale)), zeroPoint);
+	return (int8_t)fminf(fmaxf(q, -128.0f), 127.0f);
+}
+
+
+/**
+ * Sample one pixel of an NV12 frame as RGB in the [0,255] range,
+ * the same value that cudaNV12ToRGBAf() writes for it.
+ * @ingroup util
+ */
+inline __host__ __device__ void nv12SampleRGB( const yuvCoeffs& k, const uint8_t* input, size_t pitch, uint32_t height, uint32_t x, uint32_t y, float& r, float& g, float& b )
+{
+	uint32_t luma, u, v;
+	int32_t  fr, fg, fb;
+
+	nv12Sample(input, pitch, height, x, y, luma, u, v);
+	yuvToRGBFixed(k, luma, u, v, fr, fg, fb);
+
+	r = yuvFixedToFloat(fr);
+	g = yuvFixedToFloat(fg);
+	b = yuvFixedToFloat(fb);
+}
+
+
+/**
+ * Per-conversion constants derived from tensorParams, shared by the CUDA kernel and the CPU.
+ * @ingroup util
+ */
+struct tensorWriter
+{
+	float2   resize;		// source pixels per tensor pixel
+	float3   mean;		// in units of the [0,255] pixel, divided by the scale
+	float3   mult;		// scale / stdDev
+	float    invInt8Scale;
+	float    int8ZeroPoint;
+	yuvCoeffs yuv;
+	uint32_t width;
+	uint32_t height;
+	uint32_t layout;
+	uint32_t format;
+	bool     bgr;
+};
+
+/**
+ * Compute the writer constants for a conversion from a frame of the given size.
+ * The normalization is done as (px - mean/scale) * (scale/stdDev), which is one
+ * subtract and one multiply per element.
+ * @ingroup util
+ */
+inline tensorWriter tensorWriterInit( const tensorParams& params, size_t inputWidth, size_t inputHeight )
+{
+	tensorWriter w;
+
+	w.resize = make_float2(float(inputWidth) / float(params.width), float(inputHeight) / float(params.height));
+	w.mean   = make_float3(params.mean.x / params.scale, params.mean.y / params.scale, params.mean.z / params.scale);
+	w.mult   = make_float3(params.scale / params.stdDev.x, params.scale / params.stdDev.y, params.scale / params.stdDev.z);
+
+	w.invInt8Scale  = 1.0f / params.int8Scale;
+	w.int8ZeroPoint = float(params.int8ZeroPoint);
+	w.yuv = yuvCoeffsInit(params.colorimetry);
+
+	w.width  = params.width;
+	w.height = params.height;
+	w.layout = params.layout;
+	w.format = params.format;
+	w.bgr    = params.bgr;
+
+	return w;
+}
+
+/**
+ * Element type of a tensor format.
+ * @ingroup util
+ */
+template<tensorFormat format> struct tensorElement;
+
+template<> struct tensorElement<TENSOR_FORMAT_FP32>	{ typedef float type; };
+template<> struct tensorElement<TENSOR_FORMAT_FP16>	{ typedef uint16_t type; };
+template<> struct tensorElement<TENSOR_FORMAT_INT8>	{ typedef int8_t type; };
+
+/**
+ * Convert a normalized value to an element of the tensor.
+ * @ingroup util
+ */
+template<tensorFormat format>
+inline __host__ __device__ typename tensorElement<format>::type tensorConvert( const tensorWriter& w, float value )
+{
+	if( format == TENSOR_FORMAT_FP32 )
+		return value;
+	else if( format == TENSOR_FORMAT_FP16 )
+		return floatToHalf(value);
+	else
+		return tensorQuantize(value, w.invInt8Scale, w.int8ZeroPoint);
+}
+
+/**
+ * Store one element of the tensor.
+ * @ingroup util
+ */
+template<tensorFormat format>
+inline __host__ __device__ void tensorStore( const tensorWriter& w, void* output, size_t index, float value )
+{
+	((typename tensorElement<format>::type*)output)[index] = tensorConvert<format>(w, value);
+}
+
+/**
+ * Normalize a [0,255] RGB value into the three channels of the tensor, in their order.
+ * @ingroup util
+ */
+inline __host__ __device__ void tensorNormalize( const tensorWriter& w, float r, float g, float b, float& c0, float& c1, float& c2 )
+{
+	r = COLOR_MUL(COLOR_SUB(r, w.mean.x), w.mult.x);
+	g = COLOR_MUL(COLOR_SUB(g, w.mean.y), w.mult.y);
+	b = COLOR_MUL(COLOR_SUB(b, w.mean.z), w.mult.z);
+
+	c0 = w.bgr ? b : r;
+	c1 = g;
+	c2 = w.bgr ? r : b;
+}
+
+/**
+ * Channels of a pixel as [0,255] RGB floats.
+ * @ingroup util
+ */
+inline __host__ __device__ void tensorPixelRGB( const uchar4& px, float& r, float& g, float& b )	{ r = px.x; g = px.y; b = px.z; }
+inline __host__ __device__ void tensorPixelRGB( const float4& px, float& r, float& g, float& b )	{ r = px.x; g = px.y; b = px.z; }
+
+/**
+ * Normalize the [0,255] RGB value of tensor pixel (x,y) and store its three channels.
+ * The format and layout are template parameters so that the per-element branches compile out,
+ * see tensorDispatch() to select the instantiation from the writer.
+ * @ingroup util
+ */
+template<tensorFormat format, tensorLayout layout>
+inline __host__ __device__ void tensorWriteRGB( const tensorWriter& w, void* output, uint32_t x, uint32_t y, float r, float g, float b )
+{
+	float c0, c1, c2;
+	tensorNormalize(w, r, g, b, c0, c1, c2);
+
+	const size_t pixel = size_t(y) * w.width + x;
+
+	if( layout == TENSOR_LAYOUT_CHW )
+	{
+		const size_t plane = size_t(w.width) * w.height;
+
+		tensorStore<format>(w, output, pixel, c0);
+		tensorStore<format>(w, output, pixel + plane, c1);
+		tensorStore<format>(w, output, pixel + plane * 2, c2);
+	}
+	else
+	{
+		tensorStore<format>(w, output, pixel * 3, c0);
+		tensorStore<format>(w, output, pixel * 3 + 1, c1);
+		tensorStore<format>(w, output, pixel * 3 + 2, c2);
+	}
+}
+
+/**
+ * Vector type of 4 elements of the tensor.
+ * @ingroup util
+ */
+template<tensorFormat format> struct tensorVector;
+
+template<> struct tensorVector<TENSOR_FORMAT_FP32>	{ typedef float4 type; };
+template<> struct tensorVector<TENSOR_FORMAT_FP16>	{ typedef uint2 type; };
+template<> struct tensorVector<TENSOR_FORMAT_INT8>	{ typedef uint32_t type; };
+
+/**
+ * Normalize 4 pixels of a row, starting at tensor pixel (x,y), and store them with three vector stores
+ * (one per channel for CHW, or the 12 interleaved elements for HWC).  x and the width must be multiples
+ * of 4 and the output aligned to 16 bytes.  The values are the same as tensorWriteRGB() stores.
+ * @ingroup util
+ */
+template<typename T, tensorFormat format, tensorLayout layout>
+inline __host__ __device__ void tensorWriteRGB4( const tensorWriter& w, const T* input, void* output, uint32_t x, uint32_t y )
+{
+	typedef typename tensorElement<format>::type E;
+	typedef typename tensorVector<format>::type V;
+
+	union
+	{
+		E e[12];
+		V v[3];
+	} out;
+
+	for( int n=0; n < 4; n++ )
+	{
+		float r, g, b, c0, c1, c2;
+
+		tensorPixelRGB(input[n], r, g, b);
+		tensorNormalize(w, r, g, b, c0, c1, c2);
+
+		// CHW keeps the channels apart, HWC interleaves them
+		const int i = (layout == TENSOR_LAYOUT_CHW) ? n : n * 3;
+		const int s = (layout == TENSOR_LAYOUT_CHW) ? 4 : 1;
+
+		out.e[i]         = tensorConvert<format>(w, c0);
+		out.e[i + s]     = tensorConvert<format>(w, c1);
+		out.e[i + s * 2] = tensorConvert<format>(w, c2);
+	}
+
+	const size_t pixel = size_t(y) * w.width + x;
+
+	if( layout == TENSOR_LAYOUT_CHW )
+	{
+		const size_t plane = size_t(w.width) * w.height;
+
+		*(V*)((E*)output + pixel)             = out.v[0];
+		*(V*)((E*)output + pixel + plane)     = out.v[1];
+		*(V*)((E*)output + pixel + plane * 2) = out.v[2];
+	}
+	else
+	{
+		V* dst = (V*)((E*)output + pixel * 3);
+
+		dst[0] = out.v[0];
+		dst[1] = out.v[1];
+		dst[2] = out.v[2];
+	}
+}
+
+/**
+ * Compute tensor pixel (x,y) from an NV12 frame and store its three channels.
+ * The source pixel is picked with nearest-neighbor sampling, the same as cudaResizeRGBA().
+ * @ingroup util
+ */
+template<tensorFormat format, tensorLayout layout>
+inline __host__ __device__ void tensorWriteNV12( const tensorWriter& w, const uint8_t* input, size_t inputPitch, uint32_t inputHeight, void* output, uint32_t x, uint32_t y )
+{
+	const uint32_t sx = (int)((float)x * w.resize.x);
+	const uint32_t sy = (int)((float)y * w.resize.y);
+
+	float r, g, b;
+	nv12SampleRGB(w.yuv, input, inputPitch, inputHeight, sx, sy, r, g, b);
+
+	tensorWriteRGB<format, layout>(w, output, x, y, r, g, b);
+}
+
+/**
+ * Call func.template run<format, layout>() for the format and layout of the writer.
+ * @ingroup util
+ */
+template<typename T>
+inline void tensorDispatch( const tensorWriter& w, T& func )
+{
+	if( w.layout == TENSOR_LAYOUT_CHW )
+	{
+		if( w.format == TENSOR_FORMAT_FP32 )		func.template run<TENSOR_FORMAT_FP32, TENSOR_LAYOUT_CHW>();
+		else if( w.format == TENSOR_FORMAT_FP16 )	func.template run<TENSOR_FORMAT_FP16, TENSOR_LAYOUT_CHW>();
+		else								func.template run<TENSOR_FORMAT_INT8, TENSOR_LAYOUT_CHW>();
+	}
+	else
+	{
+		if( w.format == TENSOR_FORMAT_FP32 )		func.template run<TENSOR_FORMAT_FP32, TENSOR_LAYOUT_HWC>();
+		else if( w.format == TENSOR_FORMAT_FP16 )	func.template run<TENSOR_FORMAT_FP16, TENSOR_LAYOUT_HWC>();
+		else								func.template run<TENSOR_FORMAT_INT8, TENSOR_LAYOUT_HWC>();
+	}
+}
+
+
+/**
+ * Fused preprocessing of an NV12 frame into a network input tensor:
+ * color conversion, resize to params.width x params.height, normalization,
+ * channel order, layout and element type in a single pass.
+ *
+ * This reads the NV12 frame once (only the sampled pixels) and writes the
+ * tensor once, instead of the three full float4 passes of cudaNV12ToRGBAf(),
+ * cudaResizeRGBA() and cudaNormalizeRGBA().  The values are the same as that
+ * sequence, and bit-exact with it when mean=0 and stdDev=1.
+ * @ingroup util
+ */
+cudaError_t cudaNV12ToTensor( uint8_t* input, size_t inputPitch, size_t inputWidth, size_t inputHeight, void* output, const tensorParams& params, cudaStream_t stream=NULL );
+
+
+#endif
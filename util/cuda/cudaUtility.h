@@ -29,9 +29,16 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "logging.h"
+
 
 /**
  * Execute a CUDA call and print out any errors
+ *
+ * The image functions wrap their launch in CUDA(cudaGetLastError()), which
+ * reports launch errors without waiting for the GPU, so they can be queued on
+ * a cudaStream_t.  Errors during execution surface at the next synchronizing call.
+ *
  * @return the original cudaError_t result
  * @ingroup util
  */
@@ -84,13 +91,17 @@ inline cudaError_t cudaCheckError(cudaError_t retval, const char* txt, const cha
 
 	//Log("[cuda]   device %i  -  %s\n", activeDevice, txt);
 	
-	printf(LOG_CUDA "%s\n", txt);
-
-
-	if( retval != cudaSuccess )
+	// logged against the caller's file/line, so that rate-limiting applies per call site
+	if( retval == cudaSuccess )
+	{
+		if( logEnabled(LOG_CATEGORY_CUDA, LOG_LEVEL_DEBUG) )
+			logWrite(LOG_CATEGORY_CUDA, LOG_LEVEL_DEBUG, file, line, LOG_CUDA "%s\n", txt);
+	}
+	else if( logEnabled(LOG_CATEGORY_CUDA, LOG_LEVEL_ERROR) )
 	{
-		printf(LOG_CUDA "   %s (error %u) (hex 0x%02X)\n", cudaGetErrorString(retval), retval, retval);
-		printf(LOG_CUDA "   %s:%i\n", file, line);	
+		logWrite(LOG_CATEGORY_CUDA, LOG_LEVEL_ERROR, file, line, 
+			    LOG_CUDA "%s\n" LOG_CUDA "   %s (error %u) (hex 0x%02X)\n" LOG_CUDA "   %s:%i\n",
+			    txt, cudaGetErrorString(retval), retval, retval, file, line);
 	}
 
 	return retval;
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cudaYUV-Batch.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <vector>
+
+
+// yuvBatchLaunch
+//  the frames of one launch, passed by value as the kernel parameter
+struct yuvBatchLaunch
+{
+	yuvBatchParams frames[YUV_BATCH_LAUNCH];
+};
+
+
+// YUVToFormatBatch
+//  one pixel per thread, blockIdx.z selects the frame.  The grid covers the
+//  largest frame of the launch, threads past the size of theirs return.
+template<yuvFormat layout, imageFormat format>
+__global__ void YUVToFormatBatch( yuvBatchLaunch batch )
+{
+	const yuvBatchParams& p = batch.frames[blockIdx.z];
+
+	const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+	const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+
+	if( x >= p.width || y >= p.height )
+		return;
+
+	yuvBatchPixel<layout, format>(p, x, y);
+}
+
+template<yuvFormat layout, imageFormat format>
+cudaError_t launchYUVToFormatBatch( const yuvBatchFrame* frames, size_t count, cudaStream_t stream )
+{
+	if( !frames || count == 0 )
+		return cudaErrorInvalidValue;
+
+	// check every frame first, so an invalid one doesn't leave the batch half-done
+	std::vector<yuvBatchParams> params(count);
+
+	for( size_t n=0; n < count; n++ )
+	{
+		if( !yuvBatchParamsInit(frames[n], layout, params[n]) )
+			return cudaErrorInvalidValue;
+	}
+
+	const dim3 blockDim(32,8,1);
+
+	for( size_t first=0; first < count; first += YUV_BATCH_LAUNCH )
+	{
+		const size_t frameCount = std::min<size_t>(count - first, YUV_BATCH_LAUNCH);
+
+		yuvBatchLaunch batch;
+		uint32_t maxWidth  = 0;
+		uint32_t maxHeight = 0;
+
+		for( size_t n=0; n < frameCount; n++ )
+		{
+			batch.frames[n] = params[first + n];
+
+			maxWidth  = std::max(maxWidth, batch.frames[n].width);
+			maxHeight = std::max(maxHeight, batch.frames[n].height);
+		}
+
+		const dim3 gridDim(iDivUp(maxWidth,blockDim.x), iDivUp(maxHeight,blockDim.y), frameCount);
+		YUVToFormatBatch<layout, format><<<gridDim, blockDim, 0, stream>>>(batch);
+	}
+
+	return CUDA(cudaGetLastError());
+}
+
+template<yuvFormat layout>
+cudaError_t launchYUVToFormatBatch( const yuvBatchFrame* frames, size_t count, imageFormat format, cudaStream_t stream )
+{
+	switch(format)
+	{
+		case IMAGE_RGBA32F:	return launchYUVToFormatBatch<layout, IMAGE_RGBA32F>(frames, count, stream);
+		case IMAGE_RGBA16F:	return launchYUVToFormatBatch<layout, IMAGE_RGBA16F>(frames, count, stream);
+		case IMAGE_RGBA8:	return launchYUVToFormatBatch<layout, IMAGE_RGBA8>(frames, count, stream);
+		case IMAGE_RGB8:	return launchYUVToFormatBatch<layout, IMAGE_RGB8>(frames, count, stream);
+		case IMAGE_BGR8:	return launchYUVToFormatBatch<layout, IMAGE_BGR8>(frames, count, stream);
+	}
+
+	return cudaErrorInvalidValue;
+}
+
+
+// cudaYUVToFormatBatch
+cudaError_t cudaYUVToFormatBatch( const yuvBatchFrame* frames, size_t count, yuvFormat inputFormat, imageFormat format, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaYUVToFormatBatch");
+
+	switch(inputFormat)
+	{
+		case YUV_NV12:	return launchYUVToFormatBatch<YUV_NV12>(frames, count, format, stream);
+		case YUV_NV21:	return launchYUVToFormatBatch<YUV_NV21>(frames, count, format, stream);
+		case YUV_I420:	return launchYUVToFormatBatch<YUV_I420>(frames, count, format, stream);
+		case YUV_P010:	return launchYUVToFormatBatch<YUV_P010>(frames, count, format, stream);
+	}
+
+	return cudaErrorInvalidValue;
+}
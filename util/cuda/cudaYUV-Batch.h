@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CUDA_YUV_BATCH_H
+#define __CUDA_YUV_BATCH_H
+
+
+#include "cudaYUV.h"
+
+
+/*
+ * Internal to cudaYUV-Batch.cu and cpuYUV.cpp:  the frames of a batch are
+ * checked on the host and turned into yuvBatchParams, which hold what a pixel
+ * needs (the coefficients of the frame colorimetry, the ROI origin and the
+ * scale from output to ROI pixels).
+ *
+ * The kernel gets YUV_BATCH_LAUNCH of them by value as its parameter (about
+ * 3.3KB, under the 4KB limit), so a launch needs no descriptor upload, and
+ * each z slice of the grid converts one of them.  Larger batches take one launch per YUV_BATCH_LAUNCH frames.
+ */
+#define YUV_BATCH_LAUNCH	32
+
+
+struct yuvBatchParams
+{
+	yuvCoeffs coeffs;
+	float2    scale;		// ROI pixels per output pixel
+	uint8_t*  input;
+	size_t    inputPitch;
+	uint32_t  inputHeight;
+	uint32_t  roiLeft;
+	uint32_t  roiTop;
+	uint32_t  roiWidth;
+	uint32_t  roiHeight;
+	uint8_t*  output;
+	size_t    outputPitch;
+	uint32_t  width;		// of the output
+	uint32_t  height;
+};
+
+
+/*
+ * Check a frame of the batch and compute its parameters, false if it's invalid
+ */
+inline bool yuvBatchParamsInit( const yuvBatchFrame& frame, yuvFormat layout, yuvBatchParams& p )
+{
+	if( !frame.input || !frame.output || frame.inputPitch == 0 || frame.outputPitch == 0 )
+		return false;
+
+	if( frame.inputWidth == 0 || frame.inputHeight == 0 || frame.outputWidth == 0 || frame.outputHeight == 0 )
+		return false;
+
+	// P010 is read as 16-bit words
+	if( layout == YUV_P010 && (frame.inputPitch % sizeof(uint16_t) != 0 || (size_t)frame.input % sizeof(uint16_t) != 0) )
+		return false;
+
+	p.roiLeft   = frame.roiLeft;
+	p.roiTop    = frame.roiTop;
+	p.roiWidth  = (frame.roiWidth > 0) ? frame.roiWidth : frame.inputWidth - frame.roiLeft;
+	p.roiHeight = (frame.roiHeight > 0) ? frame.roiHeight : frame.inputHeight - frame.roiTop;
+
+	if( frame.roiLeft >= frame.inputWidth || frame.roiTop >= frame.inputHeight ||
+	    p.roiWidth > frame.inputWidth - frame.roiLeft || p.roiHeight > frame.inputHeight - frame.roiTop )
+		return false;
+
+	p.coeffs      = yuvCoeffsInit(frame.colorimetry, yuvFormatDepth(layout));
+	p.scale       = make_float2(float(p.roiWidth) / float(frame.outputWidth), float(p.roiHeight) / float(frame.outputHeight));
+	p.input       = frame.input;
+	p.inputPitch  = frame.inputPitch;
+	p.inputHeight = frame.inputHeight;
+	p.output      = (uint8_t*)frame.output;
+	p.outputPitch = frame.outputPitch;
+	p.width       = frame.outputWidth;
+	p.height      = frame.outputHeight;
+
+	return true;
+}
+
+
+/*
+ * Source pixel of output pixel n, nearest-neighbor like cudaResizeRGBA()
+ * (exact when the ROI and the output have the same size)
+ */
+inline __host__ __device__ uint32_t yuvBatchSource( uint32_t n, float scale, uint32_t begin, uint32_t size )
+{
+	const uint32_t s = uint32_t(float(n) * scale);
+	return begin + ((s < size) ? s : size - 1);
+}
+
+
+/*
+ * Convert output pixel (x,y) of a frame, the same value as cudaYUVToFormat()
+ * gives for its source pixel
+ */
+template<yuvFormat layout, imageFormat format>
+inline __host__ __device__ void yuvBatchPixel( const yuvBatchParams& p, uint32_t x, uint32_t y )
+{
+	uint32_t luma, u, v;
+	int32_t  r, g, b;
+
+	yuvSample<layout>(p.input, p.inputPitch, p.inputHeight, yuvBatchSource(x, p.scale.x, p.roiLeft, p.roiWidth),
+				   yuvBatchSource(y, p.scale.y, p.roiTop, p.roiHeight), luma, u, v);
+
+	yuvToRGBFixed(p.coeffs, luma, u, v, r, g, b);
+	imageStoreRGBFixed<format>(p.output + y * p.outputPitch, x, r, g, b);
+}
+
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cudaYUV.h"
+#include "trace.h"
+
+
+// YUVToGray
+//  one output sample per thread, the average of its box of the luma plane
+template<yuvFormat layout, typename T>
+__global__ void YUVToGray( uint8_t* input, size_t inputPitch, uint32_t inputWidth, uint32_t inputHeight, T* output, size_t outputPitch, uint32_t outputWidth, uint32_t outputHeight )
+{
+	const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+	const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+
+	if( x >= outputWidth || y >= outputHeight )
+		return;
+
+	uint32_t x0, x1, y0, y1;
+
+	lumaBoxRange(x, outputWidth, inputWidth, x0, x1);
+	lumaBoxRange(y, outputHeight, inputHeight, y0, y1);
+
+	T* row = (T*)((uint8_t*)output + y * outputPitch);
+	lumaBoxStore<layout>(row[x], lumaBoxSum<layout>(input, inputPitch, x0, x1, y0, y1), (x1 - x0) * (y1 - y0));
+}
+
+template<typename T>
+cudaError_t launchYUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, T* output, size_t outputPitch, size_t outputWidth, size_t outputHeight, cudaStream_t stream )
+{
+	if( !input || !output )
+		return cudaErrorInvalidDevicePointer;
+
+	if( inputPitch == 0 || inputWidth == 0 || inputHeight == 0 || outputPitch == 0 || outputWidth == 0 || outputHeight == 0 )
+		return cudaErrorInvalidValue;
+
+	// P010 is read as 16-bit words
+	if( inputFormat == YUV_P010 && (inputPitch % sizeof(uint16_t) != 0 || (size_t)input % sizeof(uint16_t) != 0) )
+		return cudaErrorInvalidValue;
+
+	if( !lumaBoxValid(inputFormat, inputWidth, inputHeight, outputWidth, outputHeight) )
+		return cudaErrorInvalidValue;
+
+	const dim3 blockDim(32,8,1);
+	const dim3 gridDim(iDivUp(outputWidth,blockDim.x), iDivUp(outputHeight,blockDim.y), 1);
+
+	// only the luma plane is read, the 8-bit layouts share it
+	if( inputFormat == YUV_P010 )
+		YUVToGray<YUV_P010, T><<<gridDim, blockDim, 0, stream>>>(input, inputPitch, inputWidth, inputHeight, output, outputPitch, outputWidth, outputHeight);
+	else
+		YUVToGray<YUV_NV12, T><<<gridDim, blockDim, 0, stream>>>(input, inputPitch, inputWidth, inputHeight, output, outputPitch, outputWidth, outputHeight);
+
+	return CUDA(cudaGetLastError());
+}
+
+
+// cudaYUVToGray
+cudaError_t cudaYUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, uint8_t* output, size_t outputPitch, size_t outputWidth, size_t outputHeight, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaYUVToGray");
+	return launchYUVToGray(input, inputPitch, inputFormat, inputWidth, inputHeight, output, outputPitch, outputWidth, outputHeight, stream);
+}
+
+cudaError_t cudaYUVToGray( uint8_t* input, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, uint8_t* output, size_t outputWidth, size_t outputHeight, cudaStream_t stream )
+{
+	return cudaYUVToGray(input, yuvFormatPitch(inputFormat, inputWidth), inputFormat, inputWidth, inputHeight, output, outputWidth * sizeof(uint8_t), outputWidth, outputHeight, stream);
+}
+
+cudaError_t cudaYUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, float* output, size_t outputPitch, size_t outputWidth, size_t outputHeight, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaYUVToGray");
+	return launchYUVToGray(input, inputPitch, inputFormat, inputWidth, inputHeight, output, outputPitch, outputWidth, outputHeight, stream);
+}
+
+cudaError_t cudaYUVToGray( uint8_t* input, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, float* output, size_t outputWidth, size_t outputHeight, cudaStream_t stream )
+{
+	return cudaYUVToGray(input, yuvFormatPitch(inputFormat, inputWidth), inputFormat, inputWidth, inputHeight, output, outputWidth * sizeof(float), outputWidth, outputHeight, stream);
+}
@@ -21,420 +21,244 @@
  */
 
 #include "cudaYUV.h"
+#include "cudaYUV-NV12.h"
+#include "trace.h"
 
 
-#define COLOR_COMPONENT_MASK            0x3FF
-#define COLOR_COMPONENT_BIT_SIZE        10
+// NV12ToFormatBlock
+//  each thread converts a blockWidth x 2 block (see cudaYUV-NV12.h), with integer
+//  fixed-point math using the coefficients of the stream colorimetry, so it's
+//  bit-exact with the CPU implementation (cpuYUV.h).  swapUV is set for NV21.
+template<imageFormat format, int blockWidth, bool swapUV>
+__global__ void NV12ToFormatBlock( yuvCoeffs coeffs, uint8_t* srcImage, size_t srcPitch, uint8_t* dstImage, size_t dstPitch, uint32_t width, uint32_t height )
+{
+	const uint32_t x = (blockIdx.x * blockDim.x + threadIdx.x) * blockWidth;
+	const uint32_t y = (blockIdx.y * blockDim.y + threadIdx.y) * NV12_BLOCK_HEIGHT;
 
-#define FIXED_DECIMAL_POINT             24
-#define FIXED_POINT_MULTIPLIER          1.0f
-#define FIXED_COLOR_COMPONENT_MASK      0xffffffff
+	if( x >= width || y >= height )
+		return;
 
-#define MUL(x,y)    (x*y)
+	nv12ConvertBlock<format, blockWidth, swapUV>(coeffs, srcImage, srcPitch, dstImage, dstPitch, x, y, height);
+}
 
 
+// YUVToFormat
+//  one pixel per thread, for I420 and P010, and for the NV12/NV21 widths or
+//  buffers that the block kernel can't handle
+template<yuvFormat layout, imageFormat format>
+__global__ void YUVToFormat( yuvCoeffs coeffs, uint8_t* srcImage, size_t srcPitch, uint8_t* dstImage, size_t dstPitch, uint32_t width, uint32_t height )
+{
+	const int x = blockIdx.x * blockDim.x + threadIdx.x;
+	const int y = blockIdx.y * blockDim.y + threadIdx.y;
 
-__constant__ uint32_t constAlpha;
-__constant__ float  constHueColorSpaceMat[9];
+	if( x >= width || y >= height )
+		return;
 
+	uint32_t luma, u, v;
+	int32_t  r, g, b;
 
+	yuvSample<layout>(srcImage, srcPitch, height, x, y, luma, u, v);
+	yuvToRGBFixed(coeffs, luma, u, v, r, g, b);
 
-__device__ void YUV2RGB(uint32_t *yuvi, float *red, float *green, float *blue)
-{
-       // Prepare for hue adjustment
-    /*
-	 float luma, chromaCb, chromaCr;
-
-	luma     = (float)yuvi[0];
-    chromaCb = (float)((int)yuvi[1] - 512.0f);
-    chromaCr = (float)((int)yuvi[2] - 512.0f);
-
-    // Convert YUV To RGB with hue adjustment
-    *red  = MUL(luma,     constHueColorSpaceMat[0]) +
-            MUL(chromaCb, constHueColorSpaceMat[1]) +
-            MUL(chromaCr, constHueColorSpaceMat[2]);
-    *green= MUL(luma,     constHueColorSpaceMat[3]) +
-            MUL(chromaCb, constHueColorSpaceMat[4]) +
-            MUL(chromaCr, constHueColorSpaceMat[5]);
-    *blue = MUL(luma,     constHueColorSpaceMat[6]) +
-            MUL(chromaCb, constHueColorSpaceMat[7]) +
-            MUL(chromaCr, constHueColorSpaceMat[8]);*/
-
-	const float luma = float(yuvi[0]);
-	const float u    = float(yuvi[1]) - 512.0f;
-	const float v    = float(yuvi[2]) - 512.0f;
-
-   /*R = Y + 1.140V
-   G = Y - 0.395U - 0.581V
-   B = Y + 2.032U*/
-
-	/**green = luma + 1.140f * v;
-	*blue  = luma - 0.395f * u - 0.581f * v;
-	*red   = luma + 2.032f * u;*/
-
-	*red    = luma + 1.140f * v;
-	*green  = luma - 0.395f * u - 0.581f * v;
-	*blue   = luma + 2.032f * u;
+	imageStoreRGBFixed<format>(dstImage + y * dstPitch, x, r, g, b);
 }
 
-
-__device__ uint32_t RGBAPACK_8bit(float red, float green, float blue, uint32_t alpha)
+template<yuvFormat layout, imageFormat format>
+cudaError_t launchYUVToFormat( uint8_t* srcDev, size_t srcPitch, void* destDev, size_t destPitch, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )
 {
-    uint32_t ARGBpixel = 0;
-
-    // Clamp final 10 bit results
-    red   = min(max(red,   0.0f), 255.0f);
-    green = min(max(green, 0.0f), 255.0f);
-    blue  = min(max(blue,  0.0f), 255.0f);
-
-    // Convert to 8 bit unsigned integers per color component
-    ARGBpixel = ((((uint32_t)red)   << 24) |
-                 (((uint32_t)green) << 16) |
-		       (((uint32_t)blue)  <<  8) | (uint32_t)alpha);
+	if( !srcDev || !destDev )
+		return cudaErrorInvalidDevicePointer;
 
-    return  ARGBpixel;
-}
+	if( srcPitch == 0 || destPitch == 0 || width == 0 || height == 0 )
+		return cudaErrorInvalidValue;
 
+	// P010 is read as 16-bit words
+	if( layout == YUV_P010 && (srcPitch % sizeof(uint16_t) != 0 || (size_t)srcDev % sizeof(uint16_t) != 0) )
+		return cudaErrorInvalidValue;
 
-__device__ uint32_t RGBAPACK_10bit(float red, float green, float blue, uint32_t alpha)
-{
-    uint32_t ARGBpixel = 0;
+	const bool      nv12   = (layout == YUV_NV12 || layout == YUV_NV21);
+	const yuvCoeffs coeffs = yuvCoeffsInit(colorimetry, yuvFormatDepth(layout));
+	const int blockWidth   = nv12 ? nv12BlockWidth(srcDev, srcPitch, destDev, destPitch, width, format) : 0;
 
-    // Clamp final 10 bit results
-    red   = min(max(red,   0.0f), 1023.f);
-    green = min(max(green, 0.0f), 1023.f);
-    blue  = min(max(blue,  0.0f), 1023.f);
+	const dim3 blockDim(32,8,1);
 
-    // Convert to 8 bit unsigned integers per color component
-    ARGBpixel = ((((uint32_t)red   >> 2) << 24) |
-                 (((uint32_t)green >> 2) << 16) |
-                 (((uint32_t)blue  >> 2) <<  8) | (uint32_t)alpha);
+	if( blockWidth == 4 )
+	{
+		const dim3 gridDim(iDivUp(width/4,blockDim.x), iDivUp(iDivUp(height,NV12_BLOCK_HEIGHT),blockDim.y), 1);
+		NV12ToFormatBlock<format, 4, layout == YUV_NV21><<<gridDim, blockDim, 0, stream>>>( coeffs, srcDev, srcPitch, (uint8_t*)destDev, destPitch, width, height );
+	}
+	else if( blockWidth == 2 )
+	{
+		const dim3 gridDim(iDivUp(width/2,blockDim.x), iDivUp(iDivUp(height,NV12_BLOCK_HEIGHT),blockDim.y), 1);
+		NV12ToFormatBlock<format, 2, layout == YUV_NV21><<<gridDim, blockDim, 0, stream>>>( coeffs, srcDev, srcPitch, (uint8_t*)destDev, destPitch, width, height );
+	}
+	else
+	{
+		const dim3 gridDim(iDivUp(width,blockDim.x), iDivUp(height,blockDim.y), 1);
+		YUVToFormat<layout, format><<<gridDim, blockDim, 0, stream>>>( coeffs, srcDev, srcPitch, (uint8_t*)destDev, destPitch, width, height );
+	}
 
-    return  ARGBpixel;
+	return CUDA(cudaGetLastError());
 }
 
-
-// CUDA kernel for outputing the final ARGB output from NV12;
-/*extern "C"*/
-__global__ void Passthru(uint32_t *srcImage,   size_t nSourcePitch,
-                         uint32_t *dstImage,   size_t nDestPitch,
-                         uint32_t width,       uint32_t height)
+template<yuvFormat layout>
+cudaError_t launchYUVToFormat( uint8_t* srcDev, size_t srcPitch, void* destDev, size_t destPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry, cudaStream_t stream )
 {
-    int x, y;
-    uint32_t yuv101010Pel[2];
-    uint32_t processingPitch = ((width) + 63) & ~63;
-    uint32_t dstImagePitch   = nDestPitch >> 2;
-    uint8_t *srcImageU8     = (uint8_t *)srcImage;
-
-    processingPitch = nSourcePitch;
+	switch(format)
+	{
+		case IMAGE_RGBA32F:	return launchYUVToFormat<layout, IMAGE_RGBA32F>(srcDev, srcPitch, destDev, destPitch, width, height, colorimetry, stream);
+		case IMAGE_RGBA16F:	return launchYUVToFormat<layout, IMAGE_RGBA16F>(srcDev, srcPitch, destDev, destPitch, width, height, colorimetry, stream);
+		case IMAGE_RGBA8:	return launchYUVToFormat<layout, IMAGE_RGBA8>(srcDev, srcPitch, destDev, destPitch, width, height, colorimetry, stream);
+		case IMAGE_RGB8:	return launchYUVToFormat<layout, IMAGE_RGB8>(srcDev, srcPitch, destDev, destPitch, width, height, colorimetry, stream);
+		case IMAGE_BGR8:	return launchYUVToFormat<layout, IMAGE_BGR8>(srcDev, srcPitch, destDev, destPitch, width, height, colorimetry, stream);
+	}
 
-    // Pad borders with duplicate pixels, and we multiply by 2 because we process 2 pixels per thread
-    x = blockIdx.x * (blockDim.x << 1) + (threadIdx.x << 1);
-    y = blockIdx.y *  blockDim.y       +  threadIdx.y;
+	return cudaErrorInvalidValue;
+}
 
-    if (x >= width)
-        return; //x = width - 1;
 
-    if (y >= height)
-        return; // y = height - 1;
+// cudaNV12ToRGBA
+cudaError_t cudaNV12ToRGBA( uint8_t* srcDev, size_t srcPitch, uchar4* destDev, size_t destPitch, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaNV12ToRGBA");
+	return launchYUVToFormat<YUV_NV12, IMAGE_RGBA8>(srcDev, srcPitch, destDev, destPitch, width, height, colorimetry, stream);
+}
 
-    // Read 2 Luma components at a time, so we don't waste processing since CbCr are decimated this way.
-    // if we move to texture we could read 4 luminance values
-    yuv101010Pel[0] = (srcImageU8[y * processingPitch + x    ]);
-    yuv101010Pel[1] = (srcImageU8[y * processingPitch + x + 1]);
+cudaError_t cudaNV12ToRGBA( uint8_t* srcDev, uchar4* destDev, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	return cudaNV12ToRGBA(srcDev, yuvFormatPitch(YUV_NV12, width), destDev, width * sizeof(uchar4), width, height, colorimetry, stream);
+}
 
-    // this steps performs the color conversion
-    float luma[2];
 
-    luma[0]   = (yuv101010Pel[0]        & 0x00FF);
-    luma[1]   = (yuv101010Pel[1]        & 0x00FF);
+// cudaNV12ToRGBAf
+cudaError_t cudaNV12ToRGBAf( uint8_t* srcDev, size_t srcPitch, float4* destDev, size_t destPitch, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaNV12ToRGBAf");
+	return launchYUVToFormat<YUV_NV12, IMAGE_RGBA32F>(srcDev, srcPitch, destDev, destPitch, width, height, colorimetry, stream);
+}
 
-    // Clamp the results to RGBA
-    dstImage[y * dstImagePitch + x     ] = RGBAPACK_8bit(luma[0], luma[0], luma[0], constAlpha);
-    dstImage[y * dstImagePitch + x + 1 ] = RGBAPACK_8bit(luma[1], luma[1], luma[1], constAlpha);
+cudaError_t cudaNV12ToRGBAf( uint8_t* srcDev, float4* destDev, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	return cudaNV12ToRGBAf(srcDev, yuvFormatPitch(YUV_NV12, width), destDev, width * sizeof(float4), width, height, colorimetry, stream);
 }
 
 
-// CUDA kernel for outputing the final ARGB output from NV12;
-/*extern "C"*/
-__global__ void NV12ToARGB(uint32_t *srcImage,     size_t nSourcePitch,
-                           uint32_t *dstImage,     size_t nDestPitch,
-                           uint32_t width,         uint32_t height)
+// cudaNV12ToFormat
+cudaError_t cudaNV12ToFormat( uint8_t* srcDev, size_t srcPitch, void* destDev, size_t destPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry, cudaStream_t stream )
 {
-    int x, y;
-    uint32_t yuv101010Pel[2];
-    uint32_t processingPitch = ((width) + 63) & ~63;
-    uint32_t dstImagePitch   = nDestPitch >> 2;
-    uint8_t *srcImageU8     = (uint8_t *)srcImage;
-
-    processingPitch = nSourcePitch;
-
-    // Pad borders with duplicate pixels, and we multiply by 2 because we process 2 pixels per thread
-    x = blockIdx.x * (blockDim.x << 1) + (threadIdx.x << 1);
-    y = blockIdx.y *  blockDim.y       +  threadIdx.y;
-
-    if (x >= width)
-        return; //x = width - 1;
-
-    if (y >= height)
-        return; // y = height - 1;
-
-    // Read 2 Luma components at a time, so we don't waste processing since CbCr are decimated this way.
-    // if we move to texture we could read 4 luminance values
-    yuv101010Pel[0] = (srcImageU8[y * processingPitch + x    ]) << 2;
-    yuv101010Pel[1] = (srcImageU8[y * processingPitch + x + 1]) << 2;
-
-    uint32_t chromaOffset    = processingPitch * height;
-    int y_chroma = y >> 1;
-
-    if (y & 1)  // odd scanline ?
-    {
-        uint32_t chromaCb;
-        uint32_t chromaCr;
-
-        chromaCb = srcImageU8[chromaOffset + y_chroma * processingPitch + x    ];
-        chromaCr = srcImageU8[chromaOffset + y_chroma * processingPitch + x + 1];
-
-        if (y_chroma < ((height >> 1) - 1)) // interpolate chroma vertically
-        {
-            chromaCb = (chromaCb + srcImageU8[chromaOffset + (y_chroma + 1) * processingPitch + x    ] + 1) >> 1;
-            chromaCr = (chromaCr + srcImageU8[chromaOffset + (y_chroma + 1) * processingPitch + x + 1] + 1) >> 1;
-        }
-
-        yuv101010Pel[0] |= (chromaCb << (COLOR_COMPONENT_BIT_SIZE       + 2));
-        yuv101010Pel[0] |= (chromaCr << ((COLOR_COMPONENT_BIT_SIZE << 1) + 2));
-
-        yuv101010Pel[1] |= (chromaCb << (COLOR_COMPONENT_BIT_SIZE       + 2));
-        yuv101010Pel[1] |= (chromaCr << ((COLOR_COMPONENT_BIT_SIZE << 1) + 2));
-    }
-    else
-    {
-        yuv101010Pel[0] |= ((uint32_t)srcImageU8[chromaOffset + y_chroma * processingPitch + x    ] << (COLOR_COMPONENT_BIT_SIZE       + 2));
-        yuv101010Pel[0] |= ((uint32_t)srcImageU8[chromaOffset + y_chroma * processingPitch + x + 1] << ((COLOR_COMPONENT_BIT_SIZE << 1) + 2));
-
-        yuv101010Pel[1] |= ((uint32_t)srcImageU8[chromaOffset + y_chroma * processingPitch + x    ] << (COLOR_COMPONENT_BIT_SIZE       + 2));
-        yuv101010Pel[1] |= ((uint32_t)srcImageU8[chromaOffset + y_chroma * processingPitch + x + 1] << ((COLOR_COMPONENT_BIT_SIZE << 1) + 2));
-    }
-
-    // this steps performs the color conversion
-    uint32_t yuvi[6];
-    float red[2], green[2], blue[2];
-
-    yuvi[0] = (yuv101010Pel[0] &   COLOR_COMPONENT_MASK);
-    yuvi[1] = ((yuv101010Pel[0] >>  COLOR_COMPONENT_BIT_SIZE)       & COLOR_COMPONENT_MASK);
-    yuvi[2] = ((yuv101010Pel[0] >> (COLOR_COMPONENT_BIT_SIZE << 1)) & COLOR_COMPONENT_MASK);
-
-    yuvi[3] = (yuv101010Pel[1] &   COLOR_COMPONENT_MASK);
-    yuvi[4] = ((yuv101010Pel[1] >>  COLOR_COMPONENT_BIT_SIZE)       & COLOR_COMPONENT_MASK);
-    yuvi[5] = ((yuv101010Pel[1] >> (COLOR_COMPONENT_BIT_SIZE << 1)) & COLOR_COMPONENT_MASK);
-
-    // YUV to RGB Transformation conversion
-    YUV2RGB(&yuvi[0], &red[0], &green[0], &blue[0]);
-    YUV2RGB(&yuvi[3], &red[1], &green[1], &blue[1]);
-
-    // Clamp the results to RGBA
-    dstImage[y * dstImagePitch + x     ] = RGBAPACK_10bit(red[0], green[0], blue[0], constAlpha);
-    dstImage[y * dstImagePitch + x + 1 ] = RGBAPACK_10bit(red[1], green[1], blue[1], constAlpha);
+	TRACE_SCOPE("cudaNV12ToFormat");
+	return launchYUVToFormat<YUV_NV12>(srcDev, srcPitch, destDev, destPitch, width, height, format, colorimetry, stream);
 }
 
+cudaError_t cudaNV12ToFormat( uint8_t* srcDev, void* destDev, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	return cudaNV12ToFormat(srcDev, yuvFormatPitch(YUV_NV12, width), destDev, width * imageFormatSize(format), width, height, format, colorimetry, stream);
+}
 
-bool nv12ColorspaceSetup = false;
 
 
-// cudaNV12ToARGB32
-cudaError_t cudaNV12ToRGBA( uint8_t* srcDev, size_t srcPitch, uchar4* destDev, size_t destPitch, size_t width, size_t height )
+// cudaYUVToFormat
+cudaError_t cudaYUVToFormat( uint8_t* srcDev, size_t srcPitch, yuvFormat srcFormat, void* destDev, size_t destPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry, cudaStream_t stream )
 {
-	if( !srcDev || !destDev )
-		return cudaErrorInvalidDevicePointer;
+	TRACE_SCOPE("cudaYUVToFormat");
 
-	if( srcPitch == 0 || destPitch == 0 || width == 0 || height == 0 )
-		return cudaErrorInvalidValue;
-
-	if( !nv12ColorspaceSetup )
-		cudaNV12SetupColorspace();
-
-	const dim3 blockDim(32,16,1);
-	const dim3 gridDim((width+(2*blockDim.x-1))/(2*blockDim.x), (height+(blockDim.y-1))/blockDim.y, 1);
+	switch(srcFormat)
+	{
+		case YUV_NV12:	return launchYUVToFormat<YUV_NV12>(srcDev, srcPitch, destDev, destPitch, width, height, format, colorimetry, stream);
+		case YUV_NV21:	return launchYUVToFormat<YUV_NV21>(srcDev, srcPitch, destDev, destPitch, width, height, format, colorimetry, stream);
+		case YUV_I420:	return launchYUVToFormat<YUV_I420>(srcDev, srcPitch, destDev, destPitch, width, height, format, colorimetry, stream);
+		case YUV_P010:	return launchYUVToFormat<YUV_P010>(srcDev, srcPitch, destDev, destPitch, width, height, format, colorimetry, stream);
+	}
 
-	NV12ToARGB<<<gridDim, blockDim>>>( (uint32_t*)srcDev, srcPitch, (uint32_t*)destDev, destPitch, width, height );
-	
-	return CUDA(cudaGetLastError());
+	return cudaErrorInvalidValue;
 }
 
-cudaError_t cudaNV12ToRGBA( uint8_t* srcDev, uchar4* destDev, size_t width, size_t height )
+cudaError_t cudaYUVToFormat( uint8_t* srcDev, yuvFormat srcFormat, void* destDev, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry, cudaStream_t stream )
 {
-	return cudaNV12ToRGBA(srcDev, width * sizeof(uint8_t), destDev, width * sizeof(uchar4), width, height);
+	return cudaYUVToFormat(srcDev, yuvFormatPitch(srcFormat, width), srcFormat, destDev, width * imageFormatSize(format), width, height, format, colorimetry, stream);
 }
 
 
-//-------------------------------------------------------------------------------------------------------------------------
-
-__global__ void NV12ToRGBAf(uint32_t* srcImage,  size_t nSourcePitch,
-                           float4* dstImage,     size_t nDestPitch,
-                           uint32_t width,       uint32_t height)
+// FormatToNV12
+//  each thread encodes a 2x2 block with nv12EncodeBlock(), the same as the
+//  scalar path of the CPU implementation (cpuFormatToNV12)
+template<imageFormat format>
+__global__ void FormatToNV12( rgbCoeffs coeffs, uint8_t* srcImage, size_t srcPitch, uint8_t* dstImage, size_t dstPitch, uint32_t width, uint32_t height )
 {
-    int x, y;
-    uint32_t yuv101010Pel[2];
-    uint32_t processingPitch = ((width) + 63) & ~63;
-    uint8_t *srcImageU8     = (uint8_t *)srcImage;
-
-    processingPitch = nSourcePitch;
-
-    // Pad borders with duplicate pixels, and we multiply by 2 because we process 2 pixels per thread
-    x = blockIdx.x * (blockDim.x << 1) + (threadIdx.x << 1);
-    y = blockIdx.y *  blockDim.y       +  threadIdx.y;
-
-    if (x >= width)
-        return; //x = width - 1;
-
-    if (y >= height)
-        return; // y = height - 1;
-
-#if 1	
-    // Read 2 Luma components at a time, so we don't waste processing since CbCr are decimated this way.
-    // if we move to texture we could read 4 luminance values
-    yuv101010Pel[0] = (srcImageU8[y * processingPitch + x    ]) << 2;
-    yuv101010Pel[1] = (srcImageU8[y * processingPitch + x + 1]) << 2;
-
-    uint32_t chromaOffset    = processingPitch * height;
-    int y_chroma = y >> 1;
-
-    if (y & 1)  // odd scanline ?
-    {
-        uint32_t chromaCb;
-        uint32_t chromaCr;
-
-        chromaCb = srcImageU8[chromaOffset + y_chroma * processingPitch + x    ];
-        chromaCr = srcImageU8[chromaOffset + y_chroma * processingPitch + x + 1];
-
-        if (y_chroma < ((height >> 1) - 1)) // interpolate chroma vertically
-        {
-            chromaCb = (chromaCb + srcImageU8[chromaOffset + (y_chroma + 1) * processingPitch + x    ] + 1) >> 1;
-            chromaCr = (chromaCr + srcImageU8[chromaOffset + (y_chroma + 1) * processingPitch + x + 1] + 1) >> 1;
-        }
-
-        yuv101010Pel[0] |= (chromaCb << (COLOR_COMPONENT_BIT_SIZE       + 2));
-        yuv101010Pel[0] |= (chromaCr << ((COLOR_COMPONENT_BIT_SIZE << 1) + 2));
-
-        yuv101010Pel[1] |= (chromaCb << (COLOR_COMPONENT_BIT_SIZE       + 2));
-        yuv101010Pel[1] |= (chromaCr << ((COLOR_COMPONENT_BIT_SIZE << 1) + 2));
-    }
-    else
-    {
-        yuv101010Pel[0] |= ((uint32_t)srcImageU8[chromaOffset + y_chroma * processingPitch + x    ] << (COLOR_COMPONENT_BIT_SIZE       + 2));
-        yuv101010Pel[0] |= ((uint32_t)srcImageU8[chromaOffset + y_chroma * processingPitch + x + 1] << ((COLOR_COMPONENT_BIT_SIZE << 1) + 2));
-
-        yuv101010Pel[1] |= ((uint32_t)srcImageU8[chromaOffset + y_chroma * processingPitch + x    ] << (COLOR_COMPONENT_BIT_SIZE       + 2));
-        yuv101010Pel[1] |= ((uint32_t)srcImageU8[chromaOffset + y_chroma * processingPitch + x + 1] << ((COLOR_COMPONENT_BIT_SIZE << 1) + 2));
-    }
-
-    // this steps performs the color conversion
-    uint32_t yuvi[6];
-    float red[2], green[2], blue[2];
-
-    yuvi[0] = (yuv101010Pel[0] &   COLOR_COMPONENT_MASK);
-    yuvi[1] = ((yuv101010Pel[0] >>  COLOR_COMPONENT_BIT_SIZE)       & COLOR_COMPONENT_MASK);
-    yuvi[2] = ((yuv101010Pel[0] >> (COLOR_COMPONENT_BIT_SIZE << 1)) & COLOR_COMPONENT_MASK);
-
-    yuvi[3] = (yuv101010Pel[1] &   COLOR_COMPONENT_MASK);
-    yuvi[4] = ((yuv101010Pel[1] >>  COLOR_COMPONENT_BIT_SIZE)       & COLOR_COMPONENT_MASK);
-    yuvi[5] = ((yuv101010Pel[1] >> (COLOR_COMPONENT_BIT_SIZE << 1)) & COLOR_COMPONENT_MASK);
-
-    // YUV to RGB Transformation conversion
-    YUV2RGB(&yuvi[0], &red[0], &green[0], &blue[0]);
-    YUV2RGB(&yuvi[3], &red[1], &green[1], &blue[1]);
-
-    // Clamp the results to RGBA
-	//printf("cuda thread %i %i  %f %f %f\n", x, y, red[0], green[0], blue[0]);
-
-	const float s = 1.0f / 1024.0f * 255.0f;
-
-	dstImage[y * width + x]     = make_float4(red[0] * s, green[0] * s, blue[0] * s, 1.0f);
-	dstImage[y * width + x + 1] = make_float4(red[1] * s, green[1] * s, blue[1] * s, 1.0f);
-#else
-	//printf("cuda thread %i %i  %i %i \n", x, y, width, height);
-		
-	dstImage[y * width + x]     = make_float4(1.0f, 0.0f, 0.0f, 1.0f);
-	dstImage[y * width + x + 1] = make_float4(1.0f, 0.0f, 0.0f, 1.0f);
-#endif
-}
+	const uint32_t x = (blockIdx.x * blockDim.x + threadIdx.x) * 2;
+	const uint32_t y = (blockIdx.y * blockDim.y + threadIdx.y) * 2;
 
+	if( x >= width || y >= height )
+		return;
 
+	const uint32_t y1 = (y + 1 < height) ? y + 1 : y;
 
-// cudaNV12ToRGBA
-cudaError_t cudaNV12ToRGBAf( uint8_t* srcDev, size_t srcPitch, float4* destDev, size_t destPitch, size_t width, size_t height )
+	nv12EncodeBlock<format>(coeffs, srcImage + y * srcPitch, srcImage + y1 * srcPitch,
+					    dstImage + y * dstPitch, dstImage + y1 * dstPitch,
+					    dstImage + dstPitch * height + (y >> 1) * dstPitch, x, width);
+}
+
+template<imageFormat format>
+cudaError_t launchFormatToNV12( void* srcDev, size_t srcPitch, uint8_t* destDev, size_t destPitch, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )
 {
 	if( !srcDev || !destDev )
 		return cudaErrorInvalidDevicePointer;
 
-	if( srcPitch == 0 || destPitch == 0 || width == 0 || height == 0 )
+	// the chroma rows hold the U/V pair of the last odd column too
+	if( srcPitch == 0 || width == 0 || height == 0 || destPitch < yuvFormatPitch(YUV_NV12, width) )
 		return cudaErrorInvalidValue;
 
-	if( !nv12ColorspaceSetup )
-		cudaNV12SetupColorspace();
+	const dim3 blockDim(32,8,1);
+	const dim3 gridDim(iDivUp(iDivUp(width,2),blockDim.x), iDivUp(iDivUp(height,2),blockDim.y), 1);
 
-	const dim3 blockDim(8,8,1);
-	//const dim3 gridDim((width+(2*blockDim.x-1))/(2*blockDim.x), (height+(blockDim.y-1))/blockDim.y, 1);
-	const dim3 gridDim(iDivUp(width,blockDim.x), iDivUp(height, blockDim.y), 1);
+	FormatToNV12<format><<<gridDim, blockDim, 0, stream>>>( rgbCoeffsInit(colorimetry), (uint8_t*)srcDev, srcPitch, destDev, destPitch, width, height );
 
-	NV12ToRGBAf<<<gridDim, blockDim>>>( (uint32_t*)srcDev, srcPitch, destDev, destPitch, width, height );
-	
 	return CUDA(cudaGetLastError());
 }
 
-cudaError_t cudaNV12ToRGBAf( uint8_t* srcDev, float4* destDev, size_t width, size_t height )
+
+// cudaRGBAToNV12
+cudaError_t cudaRGBAToNV12( uchar4* srcDev, size_t srcPitch, uint8_t* destDev, size_t destPitch, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )
 {
-	return cudaNV12ToRGBAf(srcDev, width * sizeof(uint8_t), destDev, width * sizeof(float4), width, height);
+	TRACE_SCOPE("cudaRGBAToNV12");
+	return launchFormatToNV12<IMAGE_RGBA8>(srcDev, srcPitch, destDev, destPitch, width, height, colorimetry, stream);
 }
 
+cudaError_t cudaRGBAToNV12( uchar4* srcDev, uint8_t* destDev, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	return cudaRGBAToNV12(srcDev, width * sizeof(uchar4), destDev, yuvFormatPitch(YUV_NV12, width), width, height, colorimetry, stream);
+}
 
-// cudaNV12SetupColorspace
-cudaError_t cudaNV12SetupColorspace( float hue )
+cudaError_t cudaRGBAToNV12( float4* srcDev, size_t srcPitch, uint8_t* destDev, size_t destPitch, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )
 {
-	const float hueSin = sin(hue);
-	const float hueCos = cos(hue);
+	TRACE_SCOPE("cudaRGBAToNV12");
+	return launchFormatToNV12<IMAGE_RGBA32F>(srcDev, srcPitch, destDev, destPitch, width, height, colorimetry, stream);
+}
 
-	float hueCSC[9];
+cudaError_t cudaRGBAToNV12( float4* srcDev, uint8_t* destDev, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	return cudaRGBAToNV12(srcDev, width * sizeof(float4), destDev, yuvFormatPitch(YUV_NV12, width), width, height, colorimetry, stream);
+}
 
-	const bool itu601 = false;
 
-	if( itu601 /*CSC == ITU601*/)
-	{
-		//CCIR 601
-		hueCSC[0] = 1.1644f;
-		hueCSC[1] = hueSin * 1.5960f;
-		hueCSC[2] = hueCos * 1.5960f;
-		hueCSC[3] = 1.1644f;
-		hueCSC[4] = (hueCos * -0.3918f) - (hueSin * 0.8130f);
-		hueCSC[5] = (hueSin *  0.3918f) - (hueCos * 0.8130f);
-		hueCSC[6] = 1.1644f;
-		hueCSC[7] = hueCos *  2.0172f;
-		hueCSC[8] = hueSin * -2.0172f;
-	}
-	else /*if(CSC == ITU709)*/
+// cudaFormatToNV12
+cudaError_t cudaFormatToNV12( void* srcDev, size_t srcPitch, imageFormat format, uint8_t* destDev, size_t destPitch, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaFormatToNV12");
+
+	switch(format)
 	{
-		//CCIR 709
-		hueCSC[0] = 1.0f;
-		hueCSC[1] = hueSin * 1.57480f;
-		hueCSC[2] = hueCos * 1.57480f;
-		hueCSC[3] = 1.0;
-		hueCSC[4] = (hueCos * -0.18732f) - (hueSin * 0.46812f);
-		hueCSC[5] = (hueSin *  0.18732f) - (hueCos * 0.46812f);
-		hueCSC[6] = 1.0f;
-		hueCSC[7] = hueCos *  1.85560f;
-		hueCSC[8] = hueSin * -1.85560f;
+		case IMAGE_RGBA32F:	return launchFormatToNV12<IMAGE_RGBA32F>(srcDev, srcPitch, destDev, destPitch, width, height, colorimetry, stream);
+		case IMAGE_RGBA8:	return launchFormatToNV12<IMAGE_RGBA8>(srcDev, srcPitch, destDev, destPitch, width, height, colorimetry, stream);
+		case IMAGE_RGB8:	return launchFormatToNV12<IMAGE_RGB8>(srcDev, srcPitch, destDev, destPitch, width, height, colorimetry, stream);
+		case IMAGE_BGR8:	return launchFormatToNV12<IMAGE_BGR8>(srcDev, srcPitch, destDev, destPitch, width, height, colorimetry, stream);
+		case IMAGE_RGBA16F:	break;
 	}
 
-
-	if( CUDA_FAILED(cudaMemcpyToSymbol(constHueColorSpaceMat, hueCSC, sizeof(float) * 9)) )
-		return cudaErrorInvalidSymbol;
-
-	uint32_t cudaAlpha = ((uint32_t)0xff<< 24);
-
-	if( CUDA_FAILED(cudaMemcpyToSymbol(constAlpha, &cudaAlpha, sizeof(uint32_t))) )
-		return cudaErrorInvalidSymbol;
-
-	nv12ColorspaceSetup = true;
-	return cudaSuccess;
+	return cudaErrorInvalidValue;
 }
 
+cudaError_t cudaFormatToNV12( void* srcDev, imageFormat format, uint8_t* destDev, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	return cudaFormatToNV12(srcDev, width * imageFormatSize(format), format, destDev, yuvFormatPitch(YUV_NV12, width), width, height, colorimetry, stream);
+}
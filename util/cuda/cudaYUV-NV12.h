@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CUDA_YUV_NV12_H
+#define __CUDA_YUV_NV12_H
+
+
+#include "imageFormat.h"
+#include <string.h>
+
+
+/*
+ * Internal to cudaYUV-NV12.cu:  the NV12 kernel converts a block of
+ * blockWidth x 2 pixels per thread.  The luma of each row and the chroma
+ * covering the block are read with one 16/32-bit load each, and the chroma
+ * is read once for both rows (the odd row averages it with the next chroma
+ * row, as the per-pixel nv12Sample() does).
+ *
+ * NV21 uses the same kernel with swapUV set.
+ *
+ * The block functions are __host__ __device__ so that jetson-bench --verify
+ * can run them on the CPU over the same grid as the kernel and compare them
+ * with the per-pixel conversion, without a GPU.
+ *
+ * The encode direction (RGB to NV12) converts 2x2 blocks with nv12EncodeBlock(),
+ * which is also the scalar path of the CPU implementation.
+ */
+#define NV12_BLOCK_HEIGHT	2
+
+
+/*
+ * Load/store blockWidth bytes (2 or 4) from an aligned address
+ */
+template<int bytes>
+inline __host__ __device__ uint32_t nv12Load( const uint8_t* ptr )
+{
+#ifdef __CUDA_ARCH__
+	return (bytes == 4) ? *(const uint32_t*)ptr : *(const uint16_t*)ptr;
+#else
+	uint32_t value = 0;
+	memcpy(&value, ptr, bytes);	// little-endian, same as the device
+	return value;
+#endif
+}
+
+inline __host__ __device__ void nv12Store16( uint8_t* ptr, uint32_t a, uint32_t b, uint32_t c, uint32_t d )
+{
+#ifdef __CUDA_ARCH__
+	*(uint4*)ptr = make_uint4(a, b, c, d);
+#else
+	const uint32_t v[] = { a, b, c, d };
+	memcpy(ptr, v, sizeof(v));
+#endif
+}
+
+inline __host__ __device__ void nv12Store12( uint8_t* ptr, uint32_t a, uint32_t b, uint32_t c )
+{
+#ifdef __CUDA_ARCH__
+	((uint32_t*)ptr)[0] = a;
+	((uint32_t*)ptr)[1] = b;
+	((uint32_t*)ptr)[2] = c;
+#else
+	const uint32_t v[] = { a, b, c };
+	memcpy(ptr, v, sizeof(v));
+#endif
+}
+
+
+/*
+ * chromaAverage() of the 4 bytes packed in a and b (rounding up)
+ */
+inline __host__ __device__ uint32_t chromaAverage4( uint32_t a, uint32_t b )
+{
+	return (a | b) - (((a ^ b) >> 1) & 0x7F7F7F7F);
+}
+
+
+/*
+ * Store blockWidth pixels of one row.  4-pixel RGBA8 and RGB8/BGR8 rows are
+ * written with 16 and 12 byte stores, the other formats per pixel.
+ */
+template<imageFormat format, int blockWidth>
+inline __host__ __device__ void nv12StoreRow( uint8_t* row, uint32_t x, const int32_t* r, const int32_t* g, const int32_t* b )
+{
+	if( blockWidth == 4 && format == IMAGE_RGBA8 )
+	{
+		uint32_t px[4];
+
+		for( int i=0; i < 4; i++ )
+			px[i] = rgbaPack(yuvFixedToByte(r[i]), yuvFixedToByte(g[i]), yuvFixedToByte(b[i]), 0xFF);
+
+		nv12Store16(row + x * 4, px[0], px[1], px[2], px[3]);
+	}
+	else if( blockWidth == 4 && (format == IMAGE_RGB8 || format == IMAGE_BGR8) )
+	{
+		uint32_t c[12];
+
+		for( int i=0; i < 4; i++ )
+		{
+			c[i*3+0] = yuvFixedToByte((format == IMAGE_BGR8) ? b[i] : r[i]);
+			c[i*3+1] = yuvFixedToByte(g[i]);
+			c[i*3+2] = yuvFixedToByte((format == IMAGE_BGR8) ? r[i] : b[i]);
+		}
+
+		nv12Store12(row + x * 3, c[0] | (c[1] << 8) | (c[2] << 16)  | (c[3] << 24),
+						    c[4] | (c[5] << 8) | (c[6] << 16)  | (c[7] << 24),
+						    c[8] | (c[9] << 8) | (c[10] << 16) | (c[11] << 24));
+	}
+	else
+	{
+		for( int i=0; i < blockWidth; i++ )
+			imageStoreRGBFixed<format>(row, x + i, r[i], g[i], b[i]);
+	}
+}
+
+
+/*
+ * Convert the block at (x,y), where x is a multiple of blockWidth and y is even.
+ * Requires width to be a multiple of blockWidth, see nv12BlockWidth().
+ */
+template<imageFormat format, int blockWidth, bool swapUV>
+inline __host__ __device__ void nv12ConvertBlock( const yuvCoeffs& k, const uint8_t* input, size_t inputPitch, uint8_t* output, size_t outputPitch, uint32_t x, uint32_t y, uint32_t height )
+{
+	const uint8_t* chroma = input + inputPitch * height + (y >> 1) * inputPitch + x;
+
+	// U0 V0 (U1 V1) for the even row (V0 U0 for NV21), interpolated vertically for the odd row
+	const uint32_t uvEven = nv12Load<blockWidth>(chroma);
+	uint32_t uvOdd = uvEven;
+
+	if( (y >> 1) + 1 < (height >> 1) )
+		uvOdd = chromaAverage4(uvEven, nv12Load<blockWidth>(chroma + inputPitch));
+
+	for( int row=0; row < NV12_BLOCK_HEIGHT; row++ )
+	{
+		if( y + row >= height )
+			return;
+
+		const uint32_t luma = nv12Load<blockWidth>(input + (y + row) * inputPitch + x);
+		const uint32_t uv   = (row == 0) ? uvEven : uvOdd;
+
+		int32_t r[blockWidth], g[blockWidth], b[blockWidth];
+
+		for( int i=0; i < blockWidth; i++ )
+		{
+			const uint32_t c = uv >> ((i >> 1) * 16);
+			const uint32_t u = swapUV ? (c >> 8) & 0xFF : c & 0xFF;
+			const uint32_t v = swapUV ? c & 0xFF : (c >> 8) & 0xFF;
+
+			yuvToRGBFixed(k, (luma >> (i * 8)) & 0xFF, u, v, r[i], g[i], b[i]);
+		}
+
+		nv12StoreRow<format, blockWidth>(output + (y + row) * outputPitch, x, r, g, b);
+	}
+}
+
+
+/*
+ * Encode the 2x2 block at column x (even) of a pair of rows to NV12:  four luma
+ * samples and the U/V pair of the averaged color.  For odd sizes the last column
+ * is repeated, and row1/luma1 are the same as row0/luma0 on the last odd row.
+ * chroma points to the start of the chroma row, which must hold width rounded up to even.
+ */
+template<imageFormat format>
+inline __host__ __device__ void nv12EncodeBlock( const rgbCoeffs& k, const uint8_t* row0, const uint8_t* row1, uint8_t* luma0, uint8_t* luma1, uint8_t* chroma, uint32_t x, uint32_t width )
+{
+	const uint32_t x1 = (x + 1 < width) ? x + 1 : x;
+
+	const uchar3 p00 = imageLoadRGB8<format>(row0, x);
+	const uchar3 p01 = imageLoadRGB8<format>(row0, x1);
+	const uchar3 p10 = imageLoadRGB8<format>(row1, x);
+	const uchar3 p11 = imageLoadRGB8<format>(row1, x1);
+
+	luma0[x]  = rgbToLuma(k, p00.x, p00.y, p00.z);
+	luma0[x1] = rgbToLuma(k, p01.x, p01.y, p01.z);
+	luma1[x]  = rgbToLuma(k, p10.x, p10.y, p10.z);
+	luma1[x1] = rgbToLuma(k, p11.x, p11.y, p11.z);
+
+	uint32_t u, v;
+
+	rgbToChroma(k, p00.x + p01.x + p10.x + p11.x,
+			     p00.y + p01.y + p10.y + p11.y,
+			     p00.z + p01.z + p10.z + p11.z, u, v);
+
+	chroma[x]     = u;
+	chroma[x + 1] = v;
+}
+
+
+/*
+ * Pick the widest block that the width and the alignment of the buffers allow
+ * (4 or 2), or 0 when only the per-pixel kernel can be used.
+ */
+inline int nv12BlockWidth( const void* input, size_t inputPitch, const void* output, size_t outputPitch, size_t width, imageFormat format )
+{
+	// 16-byte stores for RGBA8, 4-byte stores for RGB8/BGR8, float4/ushort4 otherwise
+	const size_t outputAlign = (format == IMAGE_RGB8 || format == IMAGE_BGR8) ? 4 : (format == IMAGE_RGBA16F) ? 8 : 16;
+
+	if( (size_t)output % outputAlign != 0 || outputPitch % outputAlign != 0 )
+		return 0;
+
+	for( int blockWidth=4; blockWidth >= 2; blockWidth /= 2 )
+	{
+		if( width % blockWidth == 0 && (size_t)input % blockWidth == 0 && inputPitch % blockWidth == 0 )
+			return blockWidth;
+	}
+
+	return 0;
+}
+
+
+#endif
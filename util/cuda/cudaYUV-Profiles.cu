@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "cudaYUV-Profiles.h"
+#include "trace.h"
+
+
+// YUVToProfiles
+//  one source pixel per thread, converted once for all the profiles
+template<yuvFormat layout>
+__global__ void YUVToProfiles( yuvProfilesLaunch launch )
+{
+	const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+	const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+
+	if( x >= launch.width || y >= launch.height )
+		return;
+
+	yuvProfilesPixel<layout>(launch, x, y);
+}
+
+template<yuvFormat layout>
+cudaError_t launchYUVToProfiles( uint8_t* input, size_t inputPitch, size_t width, size_t height, const yuvProfile* profiles, size_t count,
+						   const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	yuvProfilesLaunch launch;
+
+	if( !yuvProfilesInit(input, inputPitch, layout, width, height, profiles, count, colorimetry, launch) )
+		return cudaErrorInvalidValue;
+
+	const dim3 blockDim(32,8,1);
+	const dim3 gridDim(iDivUp(width,blockDim.x), iDivUp(height,blockDim.y), 1);
+
+	YUVToProfiles<layout><<<gridDim, blockDim, 0, stream>>>(launch);
+
+	return CUDA(cudaGetLastError());
+}
+
+
+// cudaYUVToProfiles
+cudaError_t cudaYUVToProfiles( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t width, size_t height, const yuvProfile* profiles, size_t count,
+						 const yuvColorimetry& colorimetry, cudaStream_t stream )
+{
+	TRACE_SCOPE("cudaYUVToProfiles");
+
+	switch(inputFormat)
+	{
+		case YUV_NV12:	return launchYUVToProfiles<YUV_NV12>(input, inputPitch, width, height, profiles, count, colorimetry, stream);
+		case YUV_NV21:	return launchYUVToProfiles<YUV_NV21>(input, inputPitch, width, height, profiles, count, colorimetry, stream);
+		case YUV_I420:	return launchYUVToProfiles<YUV_I420>(input, inputPitch, width, height, profiles, count, colorimetry, stream);
+		case YUV_P010:	return launchYUVToProfiles<YUV_P010>(input, inputPitch, width, height, profiles, count, colorimetry, stream);
+	}
+
+	return cudaErrorInvalidValue;
+}
+
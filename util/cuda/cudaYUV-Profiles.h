@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __CUDA_YUV_PROFILES_H
+#define __CUDA_YUV_PROFILES_H
+
+
+#include "cudaYUV-Batch.h"
+
+
+/*
+ * Internal to cudaYUV-Profiles.cu and cpuYUV.cpp:  the profiles are
+ * checked on the host and turned into a yuvProfilesLaunch, which the kernel
+ * gets by value (no descriptor upload).  The grid covers the source frame,
+ * one pixel per thread.
+ *
+ * The output pixels of a profile that sample a source pixel are found by
+ * inverting yuvBatchSource():  since it is monotonic they are a range, and
+ * the range is found with the same float math, so the outputs are the same
+ * as a batch frame of that size.
+ */
+struct yuvProfileParams
+{
+	uint8_t* output;
+	float2   scale;		// source pixels per output pixel
+	uint32_t width;
+	uint32_t height;
+	uint32_t format;	// imageFormat
+	uint32_t layout;	// imageLayout
+};
+
+struct yuvProfilesLaunch
+{
+	yuvCoeffs coeffs;
+	uint8_t*  input;
+	size_t    inputPitch;
+	uint32_t  width;		// of the source frame
+	uint32_t  height;
+	uint32_t  count;
+	yuvProfileParams profiles[YUV_PROFILES_MAX];
+};
+
+
+/*
+ * Check the frame and the profiles and compute the launch, false if one is invalid
+ */
+inline bool yuvProfilesInit( uint8_t* input, size_t inputPitch, yuvFormat layout, size_t width, size_t height, const yuvProfile* profiles, size_t count,
+					    const yuvColorimetry& colorimetry, yuvProfilesLaunch& l )
+{
+	if( !input || !profiles || inputPitch == 0 || width == 0 || height == 0 || count == 0 || count > YUV_PROFILES_MAX )
+		return false;
+
+	// P010 is read as 16-bit words
+	if( layout == YUV_P010 && (inputPitch % sizeof(uint16_t) != 0 || (size_t)input % sizeof(uint16_t) != 0) )
+		return false;
+
+	l.coeffs     = yuvCoeffsInit(colorimetry, yuvFormatDepth(layout));
+	l.input      = input;
+	l.inputPitch = inputPitch;
+	l.width      = width;
+	l.height     = height;
+	l.count      = count;
+
+	for( size_t n=0; n < count; n++ )
+	{
+		const yuvProfile& p = profiles[n];
+
+		if( !p.output || p.width == 0 || p.height == 0 || imageFormatSize(p.format) == 0 || (p.layout != IMAGE_INTERLEAVED && p.layout != IMAGE_PLANAR) )
+			return false;
+
+		l.profiles[n].output = (uint8_t*)p.output;
+		l.profiles[n].scale  = make_float2(float(width) / float(p.width), float(height) / float(p.height));
+		l.profiles[n].width  = p.width;
+		l.profiles[n].height = p.height;
+		l.profiles[n].format = p.format;
+		l.profiles[n].layout = p.layout;
+	}
+
+	return true;
+}
+
+
+/*
+ * Output samples [begin, end) of count that yuvBatchSource() maps to source sample s of size
+ */
+inline __host__ __device__ void yuvProfileRange( uint32_t s, float scale, uint32_t size, uint32_t count, uint32_t& begin, uint32_t& end )
+{
+	uint32_t n = uint32_t(fminf(float(s) / scale, float(count)));
+
+	while( n > 0 && yuvBatchSource(n - 1, scale, 0, size) >= s )
+		n--;
+
+	while( n < count && yuvBatchSource(n, scale, 0, size) < s )
+		n++;
+
+	begin = n;
+
+	while( n < count && yuvBatchSource(n, scale, 0, size) == s )
+		n++;
+
+	end = n;
+}
+
+
+/*
+ * Store output pixel (x,y) of a profile
+ */
+template<imageFormat format>
+inline __host__ __device__ void yuvProfileStore( const yuvProfileParams& p, uint32_t x, uint32_t y, int32_t r, int32_t g, int32_t b )
+{
+	if( p.layout == IMAGE_PLANAR )
+		imageStorePlanarFixed<format>(p.output, size_t(p.width) * p.height, size_t(y) * p.width + x, r, g, b);
+	else
+		imageStoreRGBFixed<format>(p.output + size_t(y) * p.width * imageFormatSize(format), x, r, g, b);
+}
+
+inline __host__ __device__ void yuvProfileStore( const yuvProfileParams& p, uint32_t x, uint32_t y, int32_t r, int32_t g, int32_t b )
+{
+	switch(p.format)
+	{
+		case IMAGE_RGBA32F:	yuvProfileStore<IMAGE_RGBA32F>(p, x, y, r, g, b); break;
+		case IMAGE_RGBA16F:	yuvProfileStore<IMAGE_RGBA16F>(p, x, y, r, g, b); break;
+		case IMAGE_RGBA8:	yuvProfileStore<IMAGE_RGBA8>(p, x, y, r, g, b); break;
+		case IMAGE_RGB8:	yuvProfileStore<IMAGE_RGB8>(p, x, y, r, g, b); break;
+		case IMAGE_BGR8:	yuvProfileStore<IMAGE_BGR8>(p, x, y, r, g, b); break;
+	}
+}
+
+
+/*
+ * Convert source pixel (sx,sy) if some profile samples it, and write it to
+ * every output pixel that does
+ */
+template<yuvFormat layout>
+inline __host__ __device__ void yuvProfilesPixel( const yuvProfilesLaunch& l, uint32_t sx, uint32_t sy )
+{
+	bool converted = false;
+	int32_t r = 0, g = 0, b = 0;
+
+	for( uint32_t n=0; n < l.count; n++ )
+	{
+		const yuvProfileParams& p = l.profiles[n];
+		uint32_t x0, x1, y0, y1;
+
+		yuvProfileRange(sy, p.scale.y, l.height, p.height, y0, y1);
+
+		if( y0 == y1 )
+			continue;
+
+		yuvProfileRange(sx, p.scale.x, l.width, p.width, x0, x1);
+
+		if( x0 == x1 )
+			continue;
+
+		if( !converted )
+		{
+			uint32_t luma, u, v;
+
+			yuvSample<layout>(l.input, l.inputPitch, l.height, sx, sy, luma, u, v);
+			yuvToRGBFixed(l.coeffs, luma, u, v, r, g, b);
+
+			converted = true;
+		}
+
+		for( uint32_t y=y0; y < y1; y++ )
+			for( uint32_t x=x0; x < x1; x++ )
+				yuvProfileStore(p, x, y, r, g, b);
+	}
+}
+
+
+#endif
@@ -21,6 +21,8 @@
  */
 
 #include "cudaYUV.h"
+#include "cudaColorspace.h"
+#include "trace.h"
 
 
 inline __device__ __host__ float clamp(float f, float a, float b)
@@ -82,27 +84,27 @@ __global__ void yuyvToRgba( uchar4* src, int srcAlignedWidth, uchar8* dst, int d
 	const float u = (formatUYVY ? macroPx.x : macroPx.y) - 128.0f;
 	const float v = (formatUYVY ? macroPx.z : macroPx.w) - 128.0f;
 
-	const float4 px0 = make_float4( y0 + 1.4065f * v,
-							  y0 - 0.3455f * u - 0.7169f * v,
-							  y0 + 1.7790f * u, 255.0f );
-
-	const float4 px1 = make_float4( y1 + 1.4065f * v,
-							  y1 - 0.3455f * u - 0.7169f * v,
-							  y1 + 1.7790f * u, 255.0f );
-
-	dst[y * dstAlignedWidth + x] = make_uchar8( clamp(px0.x, 0.0f, 255.0f), 
-									    clamp(px0.y, 0.0f, 255.0f),
-									    clamp(px0.z, 0.0f, 255.0f),
-									    clamp(px0.w, 0.0f, 255.0f),
-									    clamp(px1.x, 0.0f, 255.0f),
-									    clamp(px1.y, 0.0f, 255.0f),
-									    clamp(px1.z, 0.0f, 255.0f),
-									    clamp(px1.w, 0.0f, 255.0f) );
+	float r0, g0, b0;
+	float r1, g1, b1;
+
+	yuv8ToRGB(y0, u, v, r0, g0, b0);
+	yuv8ToRGB(y1, u, v, r1, g1, b1);
+
+	dst[y * dstAlignedWidth + x] = make_uchar8( rgb8ToByte(r0),
+									    rgb8ToByte(g0),
+									    rgb8ToByte(b0),
+									    255,
+									    rgb8ToByte(r1),
+									    rgb8ToByte(g1),
+									    rgb8ToByte(b1),
+									    255 );
 } 
 
 template<bool formatUYVY>
-cudaError_t launchYUYV( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height)
+cudaError_t launchYUYV( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )
 {
+	TRACE_SCOPE("launchYUYV");
+
 	if( !input || !inputPitch || !output || !outputPitch || !width || !height )
 		return cudaErrorInvalidValue;
 
@@ -114,30 +116,30 @@ cudaError_t launchYUYV( uchar2* input, size_t inputPitch, uchar4* output, size_t
 
 	//printf("yuyvToRgba %zu %zu %i %i %i %i %i\n", width, height, (int)formatUYVY, srcAlignedWidth, dstAlignedWidth, grid.x, grid.y);
 
-	yuyvToRgba<formatUYVY><<<grid, block>>>((uchar4*)input, srcAlignedWidth, (uchar8*)output, dstAlignedWidth, width, height);
+	yuyvToRgba<formatUYVY><<<grid, block, 0, stream>>>((uchar4*)input, srcAlignedWidth, (uchar8*)output, dstAlignedWidth, width, height);
 
 	return CUDA(cudaGetLastError());
 }
 
 
-cudaError_t cudaUYVYToRGBA( uchar2* input, uchar4* output, size_t width, size_t height )
+cudaError_t cudaUYVYToRGBA( uchar2* input, uchar4* output, size_t width, size_t height, cudaStream_t stream )
 {
-	return cudaUYVYToRGBA(input, width * sizeof(uchar2), output, width * sizeof(uchar4), width, height);
+	return cudaUYVYToRGBA(input, width * sizeof(uchar2), output, width * sizeof(uchar4), width, height, stream);
 }
 
-cudaError_t cudaUYVYToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height )
+cudaError_t cudaUYVYToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )
 {
-	return launchYUYV<true>(input, inputPitch, output, outputPitch, width, height);
+	return launchYUYV<true>(input, inputPitch, output, outputPitch, width, height, stream);
 }
 
-cudaError_t cudaYUYVToRGBA( uchar2* input, uchar4* output, size_t width, size_t height )
+cudaError_t cudaYUYVToRGBA( uchar2* input, uchar4* output, size_t width, size_t height, cudaStream_t stream )
 {
-	return cudaYUYVToRGBA(input, width * sizeof(uchar2), output, width * sizeof(uchar4), width, height);
+	return cudaYUYVToRGBA(input, width * sizeof(uchar2), output, width * sizeof(uchar4), width, height, stream);
 }
 
-cudaError_t cudaYUYVToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height )
+cudaError_t cudaYUYVToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )
 {
-	return launchYUYV<false>(input, inputPitch, output, outputPitch, width, height);
+	return launchYUYV<false>(input, inputPitch, output, outputPitch, width, height, stream);
 }
 
 
@@ -163,8 +165,10 @@ __global__ void yuyvToGray( uchar4* src, int srcAlignedWidth, float2* dst, int d
 } 
 
 template<bool formatUYVY>
-cudaError_t launchGrayYUYV( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height)
+cudaError_t launchGrayYUYV( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )
 {
+	TRACE_SCOPE("launchGrayYUYV");
+
 	if( !input || !inputPitch || !output || !outputPitch || !width || !height )
 		return cudaErrorInvalidValue;
 
@@ -174,28 +178,28 @@ cudaError_t launchGrayYUYV( uchar2* input, size_t inputPitch, float* output, siz
 	const int srcAlignedWidth = inputPitch / sizeof(uchar4);	// normally would be uchar2, but we're doubling up pixels
 	const int dstAlignedWidth = outputPitch / sizeof(float2);	// normally would be float ^^^
 
-	yuyvToGray<formatUYVY><<<grid, block>>>((uchar4*)input, srcAlignedWidth, (float2*)output, dstAlignedWidth, width, height);
+	yuyvToGray<formatUYVY><<<grid, block, 0, stream>>>((uchar4*)input, srcAlignedWidth, (float2*)output, dstAlignedWidth, width, height);
 
 	return CUDA(cudaGetLastError());
 }
 
-cudaError_t cudaUYVYToGray( uchar2* input, float* output, size_t width, size_t height )
+cudaError_t cudaUYVYToGray( uchar2* input, float* output, size_t width, size_t height, cudaStream_t stream )
 {
-	return cudaUYVYToGray(input, width * sizeof(uchar2), output, width * sizeof(uint8_t), width, height);
+	return cudaUYVYToGray(input, width * sizeof(uchar2), output, width * sizeof(float), width, height, stream);
 }
 
-cudaError_t cudaUYVYToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height )
+cudaError_t cudaUYVYToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )
 {
-	return launchGrayYUYV<true>(input, inputPitch, output, outputPitch, width, height);
+	return launchGrayYUYV<true>(input, inputPitch, output, outputPitch, width, height, stream);
 }
 
-cudaError_t cudaYUYVToGray( uchar2* input, float* output, size_t width, size_t height )
+cudaError_t cudaYUYVToGray( uchar2* input, float* output, size_t width, size_t height, cudaStream_t stream )
 {
-	return cudaYUYVToGray(input, width * sizeof(uchar2), output, width * sizeof(float), width, height);
+	return cudaYUYVToGray(input, width * sizeof(uchar2), output, width * sizeof(float), width, height, stream);
 }
 
-cudaError_t cudaYUYVToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height )
+cudaError_t cudaYUYVToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )
 {
-	return launchGrayYUYV<false>(input, inputPitch, output, outputPitch, width, height);
+	return launchGrayYUYV<false>(input, inputPitch, output, outputPitch, width, height, stream);
 }
 
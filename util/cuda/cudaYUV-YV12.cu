@@ -21,6 +21,7 @@
  */
 
 #include "cudaYUV.h"
+#include "trace.h"
 
 
 
@@ -92,8 +93,10 @@ __global__ void RGB_to_YV12( T* src, int srcAlignedWidth, uint8_t* dst, int dstP
 } 
 
 template<typename T, bool formatYV12>
-cudaError_t launch420( T* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height)
+cudaError_t launch420( T* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )
 {
+	TRACE_SCOPE("launch420");
+
 	if( !input || !inputPitch || !output || !outputPitch || !width || !height )
 		return cudaErrorInvalidValue;
 
@@ -102,7 +105,7 @@ cudaError_t launch420( T* input, size_t inputPitch, uint8_t* output, size_t outp
 
 	const int inputAlignedWidth = inputPitch / sizeof(T);
 
-	RGB_to_YV12<T, formatYV12><<<grid, block>>>(input, inputAlignedWidth, output, outputPitch, width, height);
+	RGB_to_YV12<T, formatYV12><<<grid, block, 0, stream>>>(input, inputAlignedWidth, output, outputPitch, width, height);
 
 	return CUDA(cudaGetLastError());
 }
@@ -110,27 +113,27 @@ cudaError_t launch420( T* input, size_t inputPitch, uint8_t* output, size_t outp
 
 
 // cudaRGBAToYV12
-cudaError_t cudaRGBAToYV12( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height )
+cudaError_t cudaRGBAToYV12( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )
 {
-	return launch420<uchar4,false>( input, inputPitch, output, outputPitch, width, height );
+	return launch420<uchar4,false>( input, inputPitch, output, outputPitch, width, height, stream );
 }
 
 // cudaRGBAToYV12
-cudaError_t cudaRGBAToYV12( uchar4* input, uint8_t* output, size_t width, size_t height )
+cudaError_t cudaRGBAToYV12( uchar4* input, uint8_t* output, size_t width, size_t height, cudaStream_t stream )
 {
-	return cudaRGBAToYV12( input, width * sizeof(uchar4), output, width * sizeof(uint8_t), width, height );
+	return cudaRGBAToYV12( input, width * sizeof(uchar4), output, width * sizeof(uint8_t), width, height, stream );
 }
 
 // cudaRGBAToI420
-cudaError_t cudaRGBAToI420( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height )
+cudaError_t cudaRGBAToI420( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )
 {
-	return launch420<uchar4,true>( input, inputPitch, output, outputPitch, width, height );
+	return launch420<uchar4,true>( input, inputPitch, output, outputPitch, width, height, stream );
 }
 
 // cudaRGBAToI420
-cudaError_t cudaRGBAToI420( uchar4* input, uint8_t* output, size_t width, size_t height )
+cudaError_t cudaRGBAToI420( uchar4* input, uint8_t* output, size_t width, size_t height, cudaStream_t stream )
 {
-	return cudaRGBAToI420( input, width * sizeof(uchar4), output, width * sizeof(uint8_t), width, height );
+	return cudaRGBAToI420( input, width * sizeof(uchar4), output, width * sizeof(uint8_t), width, height, stream );
 }
 
 
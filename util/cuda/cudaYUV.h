@@ -25,6 +25,7 @@
 
 
 #include "cudaUtility.h"
+#include "imageFormat.h"
 #include <stdint.h>
 
 
@@ -38,22 +39,54 @@
 /**
  * Convert an RGBA uchar4 buffer into YUV I420 planar.
  */
-cudaError_t cudaRGBAToI420( uchar4* input, uint8_t* output, size_t width, size_t height );
+cudaError_t cudaRGBAToI420( uchar4* input, uint8_t* output, size_t width, size_t height, cudaStream_t stream=NULL );
 
 /**
  * Convert an RGBA uchar4 texture into YUV I420 planar.
  */
-cudaError_t cudaRGBAToI420( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height );
+cudaError_t cudaRGBAToI420( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream=NULL );
 
 /**
  * Convert an RGBA uchar4 buffer into YUV YV12 planar.
  */
-cudaError_t cudaRGBAToYV12( uchar4* input, uint8_t* output, size_t width, size_t height );
+cudaError_t cudaRGBAToYV12( uchar4* input, uint8_t* output, size_t width, size_t height, cudaStream_t stream=NULL );
 
 /**
  * Convert an RGBA uchar4 texture into YUV YV12 planar.
  */
-cudaError_t cudaRGBAToYV12( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height );
+cudaError_t cudaRGBAToYV12( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream=NULL );
+
+///@}
+
+
+//////////////////////////////////////////////////////////////////////////////////
+/// @name RGBA to YUV 4:2:0 semi-planar (NV12)
+/// @ingroup util
+//////////////////////////////////////////////////////////////////////////////////
+
+///@{
+
+/**
+ * Convert an RGBA uchar4 or float4 ([0,255] range) image into NV12, the input of
+ * the hardware encoders.  The output is the luma plane followed by (height+1)/2
+ * rows of interleaved U/V, both with outputPitch bytes per row, which must be at
+ * least the width rounded up to even (the default).
+ *
+ * The matrix and range are given by the colorimetry.  Each 2x2 block gets the
+ * chroma of its averaged color, with the last column/row repeated for odd sizes.
+ * The math is integer fixed-point (see rgbCoeffsInit), and cpuRGBAToNV12() is bit-exact.
+ */
+cudaError_t cudaRGBAToNV12( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
+cudaError_t cudaRGBAToNV12( uchar4* input, uint8_t* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
+
+cudaError_t cudaRGBAToNV12( float4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
+cudaError_t cudaRGBAToNV12( float4* input, uint8_t* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
+
+/**
+ * Convert an image of any imageFormat except IMAGE_RGBA16F into NV12, see cudaRGBAToNV12().
+ */
+cudaError_t cudaFormatToNV12( void* input, size_t inputPitch, imageFormat format, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
+cudaError_t cudaFormatToNV12( void* input, imageFormat format, uint8_t* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
 
 ///@}
 
@@ -68,22 +101,22 @@ cudaError_t cudaRGBAToYV12( uchar4* input, size_t inputPitch, uint8_t* output, s
 /**
  * Convert a UYVY 422 packed image into RGBA uchar4.
  */
-cudaError_t cudaUYVYToRGBA( uchar2* input, uchar4* output, size_t width, size_t height );
+cudaError_t cudaUYVYToRGBA( uchar2* input, uchar4* output, size_t width, size_t height, cudaStream_t stream=NULL );
 
 /**
  * Convert a UYVY 422 packed image into RGBA uchar4.
  */
-cudaError_t cudaUYVYToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height );
+cudaError_t cudaUYVYToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream=NULL );
 
 /**
  * Convert a YUYV 422 packed image into RGBA uchar4.
  */
-cudaError_t cudaYUYVToRGBA( uchar2* input, uchar4* output, size_t width, size_t height );
+cudaError_t cudaYUYVToRGBA( uchar2* input, uchar4* output, size_t width, size_t height, cudaStream_t stream=NULL );
 
 /**
  * Convert a YUYV 422 packed image into RGBA uchar4.
  */
-cudaError_t cudaYUYVToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height );
+cudaError_t cudaYUYVToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream=NULL );
 
 ///@}
 
@@ -98,22 +131,47 @@ cudaError_t cudaYUYVToRGBA( uchar2* input, size_t inputPitch, uchar4* output, si
 /**
  * Convert a UYVY 422 packed image into a uint8 grayscale.
  */
-cudaError_t cudaUYVYToGray( uchar2* input, float* output, size_t width, size_t height );
+cudaError_t cudaUYVYToGray( uchar2* input, float* output, size_t width, size_t height, cudaStream_t stream=NULL );
 
 /**
  * Convert a UYVY 422 packed image into a uint8 grayscale.
  */
-cudaError_t cudaUYVYToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height );
+cudaError_t cudaUYVYToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream=NULL );
 
 /**
  * Convert a YUYV 422 packed image into a uint8 grayscale.
  */
-cudaError_t cudaYUYVToGray( uchar2* input, float* output, size_t width, size_t height );
+cudaError_t cudaYUYVToGray( uchar2* input, float* output, size_t width, size_t height, cudaStream_t stream=NULL );
 
 /**
  * Convert a YUYV 422 packed image into a uint8 grayscale.
  */
-cudaError_t cudaYUYVToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height );
+cudaError_t cudaYUYVToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream=NULL );
+
+///@}
+
+
+//////////////////////////////////////////////////////////////////////////////////
+/// @name YUV 4:2:0 luma to grayscale
+/// @ingroup util
+//////////////////////////////////////////////////////////////////////////////////
+
+///@{
+
+/**
+ * Downscale the luma plane of a YUV 4:2:0 frame into a uint8 ([0,255]) or
+ * float ([0,1]) grayscale image, for analytics that only need luminance.
+ * Only the luma plane is read, and inputPitch is its pitch in bytes.
+ *
+ * Each output sample is the average of the box of input samples it covers
+ * (area downscale), so any output size works, and an integer factor gives
+ * equal boxes.  The result is the same as cpuYUVToGray().
+ */
+cudaError_t cudaYUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, uint8_t* output, size_t outputPitch, size_t outputWidth, size_t outputHeight, cudaStream_t stream=NULL );
+cudaError_t cudaYUVToGray( uint8_t* input, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, uint8_t* output, size_t outputWidth, size_t outputHeight, cudaStream_t stream=NULL );
+
+cudaError_t cudaYUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, float* output, size_t outputPitch, size_t outputWidth, size_t outputHeight, cudaStream_t stream=NULL );
+cudaError_t cudaYUVToGray( uint8_t* input, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, float* output, size_t outputWidth, size_t outputHeight, cudaStream_t stream=NULL );
 
 ///@}
 
@@ -126,23 +184,146 @@ cudaError_t cudaYUYVToGray( uchar2* input, size_t inputPitch, float* output, siz
 ///@{
 
 /**
- * Convert an NV12 texture (semi-planar 4:2:0) to ARGB uchar4 format.
+ * Convert an NV12 texture (semi-planar 4:2:0) to RGBA uchar4 format.
  * NV12 = 8-bit Y plane followed by an interleaved U/V plane with 2x2 subsampling.
+ *
+ * The matrix (BT.601/709/2020) and range (limited/full) are given by the colorimetry,
+ * see gstCamera::GetColorimetry() for the one of a camera.  The conversion is
+ * done in integer fixed-point, and the CPU equivalents in cpuYUV.h are bit-exact.
  */
-cudaError_t cudaNV12ToRGBA( uint8_t* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height );
-cudaError_t cudaNV12ToRGBA( uint8_t* input, uchar4* output, size_t width, size_t height );
+cudaError_t cudaNV12ToRGBA( uint8_t* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
+cudaError_t cudaNV12ToRGBA( uint8_t* input, uchar4* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
 
-cudaError_t cudaNV12ToRGBAf( uint8_t* input, size_t inputPitch, float4* output, size_t outputPitch, size_t width, size_t height );
-cudaError_t cudaNV12ToRGBAf( uint8_t* input, float4* output, size_t width, size_t height );
+cudaError_t cudaNV12ToRGBAf( uint8_t* input, size_t inputPitch, float4* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
+cudaError_t cudaNV12ToRGBAf( uint8_t* input, float4* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
 
 /**
- * Setup NV12 color conversion constants.
- * cudaNV12SetupColorspace() isn't necessary for the user to call, it will be
- * called automatically by cudaNV12ToRGBA() with a hue of 0.0.
- * However if you want to setup custom constants (ie with a hue different than 0),
- * then you can call cudaNV12SetupColorspace() at any time, overriding the default.
+ * Convert an NV12 texture to any of the imageFormat layouts, for example 8-bit RGB
+ * or half-float RGBA to save memory.  The values are the same as cudaNV12ToRGBA()
+ * (8-bit formats) or cudaNV12ToRGBAf() (float formats).
+ */
+cudaError_t cudaNV12ToFormat( uint8_t* input, size_t inputPitch, void* output, size_t outputPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
+cudaError_t cudaNV12ToFormat( uint8_t* input, void* output, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
+
+///@}
+
+
+//////////////////////////////////////////////////////////////////////////////////
+/// @name YUV 4:2:0 (NV12, NV21, I420, P010) to RGBA
+/// @ingroup util
+//////////////////////////////////////////////////////////////////////////////////
+
+///@{
+
+/**
+ * Convert a decoder output of any yuvFormat to the imageFormat layouts, so the
+ * pipeline doesn't need a videoconvert.  The plane layout of each yuvFormat is
+ * described in cudaColorspace.h, inputPitch is the pitch of the luma plane in bytes.
+ *
+ * NV12 and NV21 use the block kernel of cudaNV12ToFormat(), I420 and P010 one
+ * pixel per thread.  P010 keeps its 10 bits through the conversion, so the float
+ * formats get the extra precision.  The CPU equivalent is cpuYUVToFormat().
+ */
+cudaError_t cudaYUVToFormat( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, void* output, size_t outputPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
+cudaError_t cudaYUVToFormat( uint8_t* input, yuvFormat inputFormat, void* output, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
+
+///@}
+
+
+//////////////////////////////////////////////////////////////////////////////////
+/// @name Batched YUV 4:2:0 to RGBA
+/// @ingroup util
+//////////////////////////////////////////////////////////////////////////////////
+
+///@{
+
+/**
+ * One frame of a batch for cudaYUVToFormatBatch().  The region of interest
+ * of the input is converted and resized to the output size (nearest-neighbor,
+ * like cudaResizeRGBA()).  A roiWidth or roiHeight of 0 extends the region to
+ * the edge of the frame, so a zero-initialized ROI converts the whole frame.
+ */
+struct yuvBatchFrame
+{
+	uint8_t* input;			/**< YUV frame */
+	size_t   inputPitch;		/**< pitch of the luma plane, in bytes */
+	uint32_t inputWidth;
+	uint32_t inputHeight;
+
+	uint32_t roiLeft;
+	uint32_t roiTop;
+	uint32_t roiWidth;
+	uint32_t roiHeight;
+
+	void*    output;			/**< image of the imageFormat of the batch */
+	size_t   outputPitch;		/**< in bytes */
+	uint32_t outputWidth;
+	uint32_t outputHeight;
+
+	yuvColorimetry colorimetry;	/**< of this frame, cameras of a batch may differ */
+
+	yuvBatchFrame() : input(NULL), inputPitch(0), inputWidth(0), inputHeight(0), roiLeft(0), roiTop(0), roiWidth(0), roiHeight(0),
+				   output(NULL), outputPitch(0), outputWidth(0), outputHeight(0)	{}
+};
+
+/**
+ * Convert a batch of frames of the same yuvFormat into the same imageFormat,
+ * with one kernel launch per 32 frames instead of one per frame, so the launch
+ * overhead doesn't grow with the number of streams.  The frames may have
+ * different sizes, ROIs and colorimetries.
+ *
+ * The frames array is read by the host and may be reused once this returns.
+ * All the frames are checked before anything is launched.  A frame with the
+ * same ROI and output size gets the same values as cudaYUVToFormat().
+ * The CPU equivalent is cpuYUVToFormatBatch().
+ */
+cudaError_t cudaYUVToFormatBatch( const yuvBatchFrame* frames, size_t count, yuvFormat inputFormat, imageFormat format, cudaStream_t stream=NULL );
+
+///@}
+
+
+//////////////////////////////////////////////////////////////////////////////////
+/// @name Several outputs of one YUV 4:2:0 frame
+/// @ingroup util
+//////////////////////////////////////////////////////////////////////////////////
+
+///@{
+
+/**
+ * Maximum number of profiles of cudaYUVToProfiles().
+ */
+#define YUV_PROFILES_MAX	8
+
+/**
+ * One output of cudaYUVToProfiles():  the whole frame resized to width x height
+ * (nearest-neighbor, like cudaResizeRGBA()) in the given format and layout.
+ * The output is packed, width * height * imageFormatSize(format) bytes in both layouts.
+ */
+struct yuvProfile
+{
+	void*       output;
+	uint32_t    width;
+	uint32_t    height;
+	imageFormat format;
+	imageLayout layout;
+
+	yuvProfile( uint32_t w=0, uint32_t h=0, imageFormat f=IMAGE_RGBA8, imageLayout l=IMAGE_INTERLEAVED ) : output(NULL), width(w), height(h), format(f), layout(l)	{}
+};
+
+/**
+ * Convert one frame to up to YUV_PROFILES_MAX outputs of different sizes,
+ * formats and layouts, for example a detector input, a preview and a full
+ * resolution snapshot, in a single pass over the frame.
+ *
+ * Each thread converts one source pixel, and only if some output samples it,
+ * then writes it to every output pixel that does.  So the frame is read once
+ * however many outputs there are, and each pixel is converted once.  The
+ * values are the same as cudaYUVToFormatBatch() with one frame per output
+ * (a whole-frame ROI), planar outputs have them as one plane per channel.
+ * The CPU equivalent is cpuYUVToProfiles().
  */
-cudaError_t cudaNV12SetupColorspace( float hue = 0.0f ); 
+cudaError_t cudaYUVToProfiles( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t width, size_t height, const yuvProfile* profiles, size_t count,
+						 const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL );
 
 ///@}
 
@@ -21,6 +21,7 @@
  */
  
 #include "glDisplay.h"
+#include "trace.h"
 
 
  
@@ -232,6 +233,8 @@ static timespec timeDiff( const timespec& start, const timespec& end)
 // Refresh
 void glDisplay::EndRender()
 {
+	TRACE_SCOPE("glDisplay::EndRender");
+
 	glXSwapBuffers(mDisplayX, mWindowX);
 
 	// measure framerate
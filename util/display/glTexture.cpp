@@ -24,6 +24,7 @@
 #include "glTexture.h"
 
 #include "cudaMappedMemory.h"
+#include "trace.h"
 
 
 //-----------------------------------------------------------------------------------
@@ -297,6 +298,8 @@ void glTexture::Unmap()
 // Upload
 bool glTexture::UploadCPU( void* data )
 {
+	TRACE_SCOPE("glTexture::UploadCPU");
+
 	// activate texture & pbo
 	GL(glEnable(GL_TEXTURE_2D));
 	GL(glActiveTextureARB(GL_TEXTURE0_ARB));
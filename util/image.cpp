@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "image.h"
+#include "cudaMappedMemory.h"
+
+#include <stdlib.h>
+#include <mutex>
+#include <vector>
+
+
+// imageMemoryToStr
+const char* imageMemoryToStr( imageMemory memory )
+{
+	switch(memory)
+	{
+		case IMAGE_MEMORY_HOST:		return "host";
+		case IMAGE_MEMORY_PINNED:	return "pinned";
+		case IMAGE_MEMORY_MAPPED:	return "mapped";
+		case IMAGE_MEMORY_DEVICE:	return "device";
+	}
+
+	return "unknown";
+}
+
+
+// imageMemoryAlloc
+bool imageMemoryAlloc( imageMemory memory, size_t size, void** cpu, void** gpu )
+{
+	if( !cpu || !gpu || size == 0 )
+		return false;
+
+	*cpu = NULL;
+	*gpu = NULL;
+
+	bool result = false;
+
+	switch(memory)
+	{
+		case IMAGE_MEMORY_HOST:		result = (posix_memalign(cpu, 64, size) == 0); break;
+		case IMAGE_MEMORY_PINNED:	result = CUDA_SUCCESS(cudaHostAlloc(cpu, size, cudaHostAllocDefault)); break;
+		case IMAGE_MEMORY_MAPPED:	result = cudaAllocMapped(cpu, gpu, size); break;
+		case IMAGE_MEMORY_DEVICE:	result = CUDA_SUCCESS(cudaMalloc(gpu, size)); break;
+	}
+
+	if( !result )
+	{
+		LogError(LOG_CATEGORY_CUDA, LOG_CUDA "failed to allocate %zu bytes of %s image memory\n", size, imageMemoryToStr(memory));
+		*cpu = NULL;
+		*gpu = NULL;
+	}
+
+	return result;
+}
+
+
+// imageMemoryFree
+void imageMemoryFree( imageMemory memory, void* cpu, void* gpu )
+{
+	switch(memory)
+	{
+		case IMAGE_MEMORY_HOST:		free(cpu); break;
+		case IMAGE_MEMORY_PINNED:
+		case IMAGE_MEMORY_MAPPED:	if( cpu != NULL ) CUDA(cudaFreeHost(cpu)); break;
+		case IMAGE_MEMORY_DEVICE:	if( gpu != NULL ) CUDA(cudaFree(gpu)); break;
+	}
+}
+
+
+// buffers returned to the pool, matched by kind and exact size
+struct imagePoolEntry
+{
+	imageMemory memory;
+	size_t      size;
+	void*       cpu;
+	void*       gpu;
+	cudaEvent_t released;	// completes once the GPU work queued before the release is done
+};
+
+static std::mutex imagePoolMutex;
+static std::vector<imagePoolEntry> imagePoolEntries;
+static size_t imagePoolBytes = 0;
+static size_t imagePoolMaxBytes = 256 * 1024 * 1024;
+
+
+// imagePoolReady
+//  the GPU may still be using a buffer that was released with work in flight,
+//  cudaFree() would have synchronized but the pool hands it out again directly
+static bool imagePoolReady( imagePoolEntry& entry )
+{
+	if( entry.released == NULL )
+		return true;
+
+	if( cudaEventQuery(entry.released) != cudaSuccess )
+		return false;
+
+	CUDA(cudaEventDestroy(entry.released));
+	entry.released = NULL;
+	return true;
+}
+
+
+// imagePoolAlloc
+bool imagePoolAlloc( imageMemory memory, size_t size, void** cpu, void** gpu )
+{
+	if( !cpu || !gpu || size == 0 )
+		return false;
+
+	{
+		std::lock_guard<std::mutex> lock(imagePoolMutex);
+
+		for( size_t n=0; n < imagePoolEntries.size(); n++ )
+		{
+			imagePoolEntry& entry = imagePoolEntries[n];
+
+			if( entry.memory != memory || entry.size != size || !imagePoolReady(entry) )
+				continue;
+
+			*cpu = entry.cpu;
+			*gpu = entry.gpu;
+
+			imagePoolBytes -= entry.size;
+			imagePoolEntries[n] = imagePoolEntries.back();
+			imagePoolEntries.pop_back();
+			return true;
+		}
+	}
+
+	return imageMemoryAlloc(memory, size, cpu, gpu);
+}
+
+
+// imagePoolFree
+void imagePoolFree( imageMemory memory, size_t size, void* cpu, void* gpu )
+{
+	if( cpu == NULL && gpu == NULL )
+		return;
+
+	imagePoolEntry entry = { memory, size, cpu, gpu, NULL };
+
+	{
+		std::lock_guard<std::mutex> lock(imagePoolMutex);
+
+		if( imagePoolBytes + size <= imagePoolMaxBytes )
+		{
+			// memory the GPU can reach isn't reused until the work queued so far has
+			// finished.  The legacy default stream waits on all the blocking streams,
+			// streams created with cudaStreamNonBlocking must be synchronized first.
+			const bool ready = (memory == IMAGE_MEMORY_HOST) ||
+						    (CUDA_SUCCESS(cudaEventCreateWithFlags(&entry.released, cudaEventDisableTiming)) &&
+						     CUDA_SUCCESS(cudaEventRecord(entry.released, cudaStreamLegacy)));
+
+			if( ready )
+			{
+				imagePoolBytes += size;
+				imagePoolEntries.push_back(entry);
+				return;
+			}
+
+			if( entry.released != NULL )
+				CUDA(cudaEventDestroy(entry.released));
+		}
+	}
+
+	// the pool is full (or the release couldn't be tracked), free it directly
+	imageMemoryFree(memory, cpu, gpu);
+}
+
+
+// imagePoolSetLimit
+void imagePoolSetLimit( size_t bytes )
+{
+	std::lock_guard<std::mutex> lock(imagePoolMutex);
+	imagePoolMaxBytes = bytes;
+}
+
+
+// imagePoolTrim
+size_t imagePoolTrim()
+{
+	std::vector<imagePoolEntry> entries;
+
+	{
+		std::lock_guard<std::mutex> lock(imagePoolMutex);
+		entries.swap(imagePoolEntries);
+		imagePoolBytes = 0;
+	}
+
+	size_t freed = 0;
+
+	for( size_t n=0; n < entries.size(); n++ )
+	{
+		// cudaFree() and cudaFreeHost() synchronize, so pending work is done first
+		if( entries[n].released != NULL )
+			CUDA(cudaEventDestroy(entries[n].released));
+
+		imageMemoryFree(entries[n].memory, entries[n].cpu, entries[n].gpu);
+		freed += entries[n].size;
+	}
+
+	if( freed > 0 )
+		LogVerbose(LOG_CATEGORY_CUDA, LOG_CUDA "image pool -- released %zu buffers (%zu bytes)\n", entries.size(), freed);
+
+	return freed;
+}
+
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __IMAGE_H_
+#define __IMAGE_H_
+
+
+#include "imageView.h"
+#include <type_traits>
+#include <utility>
+
+
+/**
+ * Kinds of memory an Image can be allocated in.
+ * @ingroup util
+ */
+enum imageMemory
+{
+	IMAGE_MEMORY_HOST = 0,	/**< cached system memory, CPU only (posix_memalign) */
+	IMAGE_MEMORY_PINNED,	/**< page-locked system memory, CPU only, for async copies (cudaHostAlloc) */
+	IMAGE_MEMORY_MAPPED,	/**< zeroCopy memory shared by the CPU and GPU (cudaAllocMapped) */
+	IMAGE_MEMORY_DEVICE	/**< GPU only (cudaMalloc) */
+};
+
+/**
+ * Convert an imageMemory to a string ("host", "pinned", "mapped", "device").
+ * @ingroup util
+ */
+const char* imageMemoryToStr( imageMemory memory );
+
+/**
+ * Allocate size bytes of the given kind of memory.  cpu or gpu is set to
+ * NULL when that side can't access it, they are equal for mapped memory on UVA.
+ * @ingroup util
+ */
+bool imageMemoryAlloc( imageMemory memory, size_t size, void** cpu, void** gpu );
+
+/**
+ * Free memory from imageMemoryAlloc().
+ * @ingroup util
+ */
+void imageMemoryFree( imageMemory memory, void* cpu, void* gpu );
+
+/**
+ * Like imageMemoryAlloc(), but reuses a buffer of the same kind and size
+ * returned by imagePoolFree() when there is one, once the GPU work queued
+ * before it was returned has completed.
+ * @ingroup util
+ */
+bool imagePoolAlloc( imageMemory memory, size_t size, void** cpu, void** gpu );
+
+/**
+ * Return a buffer from imagePoolAlloc() to the pool, it stays allocated until imagePoolTrim().
+ * Work still queued on the default stream or any blocking stream may keep using it, but
+ * streams created with cudaStreamNonBlocking must be synchronized before the release.
+ * Buffers beyond the pool limit are freed directly.
+ * @ingroup util
+ */
+void imagePoolFree( imageMemory memory, size_t size, void* cpu, void* gpu );
+
+/**
+ * Set how many bytes the pool may hold for reuse (256MB by default).
+ * @ingroup util
+ */
+void imagePoolSetLimit( size_t bytes );
+
+/**
+ * Release the buffers held by the pool, returns the number of bytes freed.
+ * Call it before the CUDA context is destroyed, the pool is not freed at exit.
+ * @ingroup util
+ */
+size_t imagePoolTrim();
+
+
+/**
+ * Allocator policy of an Image, allocating one kind of memory directly.
+ * Custom policies provide the same members.
+ * @ingroup util
+ */
+template<imageMemory kind>
+struct imageAllocator
+{
+	static const imageMemory memory = kind;
+	static const bool cpuAccess = (kind != IMAGE_MEMORY_DEVICE);
+	static const bool gpuAccess = (kind == IMAGE_MEMORY_MAPPED || kind == IMAGE_MEMORY_DEVICE);
+
+	static inline bool Alloc( size_t size, void** cpu, void** gpu )	{ return imageMemoryAlloc(kind, size, cpu, gpu); }
+	static inline void Free( size_t size, void* cpu, void* gpu )		{ imageMemoryFree(kind, cpu, gpu); }
+};
+
+typedef imageAllocator<IMAGE_MEMORY_HOST>   imageAllocHost;	/**< @see IMAGE_MEMORY_HOST */
+typedef imageAllocator<IMAGE_MEMORY_PINNED> imageAllocPinned;	/**< @see IMAGE_MEMORY_PINNED */
+typedef imageAllocator<IMAGE_MEMORY_MAPPED> imageAllocMapped;	/**< @see IMAGE_MEMORY_MAPPED */
+typedef imageAllocator<IMAGE_MEMORY_DEVICE> imageAllocDevice;	/**< @see IMAGE_MEMORY_DEVICE */
+
+
+/**
+ * Allocator policy recycling the buffers of another policy through the pool,
+ * so images allocated once per frame don't go back to the driver each time.
+ * @ingroup util
+ */
+template<typename Allocator>
+struct imageAllocPool
+{
+	static const imageMemory memory = Allocator::memory;
+	static const bool cpuAccess = Allocator::cpuAccess;
+	static const bool gpuAccess = Allocator::gpuAccess;
+
+	static inline bool Alloc( size_t size, void** cpu, void** gpu )	{ return imagePoolAlloc(memory, size, cpu, gpu); }
+	static inline void Free( size_t size, void* cpu, void* gpu )		{ imagePoolFree(memory, size, cpu, gpu); }
+};
+
+
+/**
+ * Image owning its memory, with the pixel type and the kind of memory in its type.
+ *
+ *    Image<float4, imageAllocMapped> rgba(1920, 1080);
+ *    Image<float4, imageAllocPool<imageAllocDevice> > tile(224, 224);
+ *
+ *    ops->ResizeRGBA(rgba.GetViewGPU().Crop(640, 360, 640, 360), tile.GetViewGPU());
+ *
+ * Images are move-only, the memory is freed (or returned to the pool) by the
+ * destructor.  Asking for the CPU pointer of device memory, or the GPU pointer
+ * of host memory, doesn't compile, and neither does passing an Image<uchar4>
+ * view to an op expecting float4.  The rows are packed (pitch = width * sizeof(T)).
+ * @ingroup util
+ */
+template<typename T, typename Allocator=imageAllocMapped>
+class Image
+{
+public:
+	static_assert(std::is_pod<T>::value, "Image pixels must be plain data");
+
+	/**
+	 * Empty image, see Alloc().
+	 */
+	Image() : mCPU(NULL), mGPU(NULL), mWidth(0), mHeight(0)	{ }
+
+	/**
+	 * Allocate an image, check IsEmpty() for failure.
+	 */
+	Image( uint32_t width, uint32_t height ) : mCPU(NULL), mGPU(NULL), mWidth(0), mHeight(0)	{ Alloc(width, height); }
+
+	/**
+	 * Take the memory of another image, which is left empty.
+	 */
+	Image( Image&& other ) : mCPU(other.mCPU), mGPU(other.mGPU), mWidth(other.mWidth), mHeight(other.mHeight)
+	{
+		other.mCPU = other.mGPU = NULL;
+		other.mWidth = other.mHeight = 0;
+	}
+
+	Image& operator=( Image&& other )
+	{
+		if( this != &other )
+		{
+			Free();
+
+			mCPU    = other.mCPU;
+			mGPU    = other.mGPU;
+			mWidth  = other.mWidth;
+			mHeight = other.mHeight;
+
+			other.mCPU = other.mGPU = NULL;
+			other.mWidth = other.mHeight = 0;
+		}
+
+		return *this;
+	}
+
+	Image( const Image& ) = delete;
+	Image& operator=( const Image& ) = delete;
+
+	/**
+	 * Destructor
+	 */
+	~Image()		{ Free(); }
+
+	/**
+	 * (Re)allocate the image, keeping the memory if the size is unchanged.
+	 * The contents are undefined after a reallocation.
+	 */
+	bool Alloc( uint32_t width, uint32_t height )
+	{
+		if( width == mWidth && height == mHeight && !IsEmpty() )
+			return true;
+
+		Free();
+
+		if( width == 0 || height == 0 )
+			return false;
+
+		void* cpu = NULL;
+		void* gpu = NULL;
+
+		if( !Allocator::Alloc(size_t(width) * height * sizeof(T), &cpu, &gpu) )
+			return false;
+
+		mCPU    = (T*)cpu;
+		mGPU    = (T*)gpu;
+		mWidth  = width;
+		mHeight = height;
+
+		return true;
+	}
+
+	/**
+	 * Release the memory, the image is empty afterwards.
+	 */
+	void Free()
+	{
+		if( IsEmpty() )
+			return;
+
+		Allocator::Free(GetSize(), mCPU, mGPU);
+
+		mCPU = mGPU = NULL;
+		mWidth = mHeight = 0;
+	}
+
+	inline bool IsEmpty() const		{ return mCPU == NULL && mGPU == NULL; }
+
+	inline uint32_t GetWidth() const	{ return mWidth; }
+	inline uint32_t GetHeight() const	{ return mHeight; }
+	inline size_t GetPitch() const	{ return mWidth * sizeof(T); }
+	inline size_t GetSize() const		{ return GetPitch() * mHeight; }
+
+	/**
+	 * Pointer for the CPU (not available for device memory).
+	 */
+	inline T* GetCPU() const
+	{
+		static_assert(Allocator::cpuAccess, "the CPU can't access this kind of image memory");
+		return mCPU;
+	}
+
+	/**
+	 * Pointer for the GPU (only for mapped and device memory).
+	 */
+	inline T* GetGPU() const
+	{
+		static_assert(Allocator::gpuAccess, "the GPU can't access this kind of image memory");
+		return mGPU;
+	}
+
+	inline ImageView<T> GetViewCPU() const	{ return ImageView<T>(GetCPU(), mWidth, mHeight); }
+	inline ImageView<T> GetViewGPU() const	{ return ImageView<T>(GetGPU(), mWidth, mHeight); }
+
+protected:
+	T* mCPU;
+	T* mGPU;
+
+	uint32_t mWidth;
+	uint32_t mHeight;
+};
+
+
+#endif
+
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __IMAGE_FORMAT_H_
+#define __IMAGE_FORMAT_H_
+
+
+#include "cudaColorspace.h"
+#include <stdint.h>
+
+
+/**
+ * Pixel formats that the camera frames can be converted to.
+ * The components are in the order of the name in memory.
+ * @ingroup util
+ */
+enum imageFormat
+{
+	IMAGE_RGBA32F = 0,	/**< float4, [0,255] range (16 bytes per pixel) */
+	IMAGE_RGBA16F,		/**< IEEE half x4, [0,255] range (8 bytes per pixel) */
+	IMAGE_RGBA8,		/**< uchar4 (4 bytes per pixel) */
+	IMAGE_RGB8,		/**< uchar3 (3 bytes per pixel) */
+	IMAGE_BGR8		/**< uchar3, as used by OpenCV (3 bytes per pixel) */
+};
+
+
+/**
+ * Size of one pixel of the given format, in bytes.
+ * @ingroup util
+ */
+inline __host__ __device__ size_t imageFormatSize( imageFormat format )
+{
+	switch(format)
+	{
+		case IMAGE_RGBA32F:	return 16;
+		case IMAGE_RGBA16F:	return 8;
+		case IMAGE_RGBA8:	return 4;
+		case IMAGE_RGB8:	return 3;
+		case IMAGE_BGR8:	return 3;
+	}
+
+	return 0;
+}
+
+
+/**
+ * Number of channels of the given format (3 or 4).
+ * @ingroup util
+ */
+inline __host__ __device__ uint32_t imageFormatChannels( imageFormat format )
+{
+	return (format == IMAGE_RGB8 || format == IMAGE_BGR8) ? 3 : 4;
+}
+
+
+/**
+ * Arrangement of the channels of an image in memory.
+ * @ingroup util
+ */
+enum imageLayout
+{
+	IMAGE_INTERLEAVED = 0,	/**< the channels of each pixel together (HWC) */
+	IMAGE_PLANAR		/**< one plane of width x height per channel, in the order of the format (CHW) */
+};
+
+/**
+ * Convert an imageLayout to a string.
+ * @ingroup util
+ */
+inline const char* imageLayoutToStr( imageLayout layout )
+{
+	return (layout == IMAGE_PLANAR) ? "planar" : "interleaved";
+}
+
+
+/**
+ * Convert an imageFormat to a string.
+ * @ingroup util
+ */
+inline const char* imageFormatToStr( imageFormat format )
+{
+	switch(format)
+	{
+		case IMAGE_RGBA32F:	return "rgba32f";
+		case IMAGE_RGBA16F:	return "rgba16f";
+		case IMAGE_RGBA8:	return "rgba8";
+		case IMAGE_RGB8:	return "rgb8";
+		case IMAGE_BGR8:	return "bgr8";
+	}
+
+	return "unknown";
+}
+
+
+/**
+ * Store pixel x of a row from the fixed-point RGB of the NV12 conversion (see yuvToRGBFixed).
+ * The values match cudaNV12ToRGBA() for the 8-bit formats and cudaNV12ToRGBAf() for the float ones.
+ * @ingroup util
+ */
+template<imageFormat format>
+inline __host__ __device__ void imageStoreRGBFixed( void* row, uint32_t x, int32_t r, int32_t g, int32_t b )
+{
+	if( format == IMAGE_RGBA32F )
+	{
+		((float4*)row)[x] = make_float4(yuvFixedToFloat(r), yuvFixedToFloat(g), yuvFixedToFloat(b), 1.0f);
+	}
+	else if( format == IMAGE_RGBA16F )
+	{
+		((ushort4*)row)[x] = make_ushort4(floatToHalf(yuvFixedToFloat(r)), floatToHalf(yuvFixedToFloat(g)),
+								    floatToHalf(yuvFixedToFloat(b)), floatToHalf(1.0f));
+	}
+	else if( format == IMAGE_RGBA8 )
+	{
+		((uint32_t*)row)[x] = rgbaPack(yuvFixedToByte(r), yuvFixedToByte(g), yuvFixedToByte(b), 0xFF);
+	}
+	else
+	{
+		uint8_t* px = (uint8_t*)row + x * 3;
+
+		px[0] = yuvFixedToByte((format == IMAGE_BGR8) ? b : r);
+		px[1] = yuvFixedToByte(g);
+		px[2] = yuvFixedToByte((format == IMAGE_BGR8) ? r : b);
+	}
+}
+
+
+/**
+ * Store pixel index of a planar image (IMAGE_PLANAR) from the fixed-point RGB of the
+ * NV12 conversion, with the same values as imageStoreRGBFixed().  Each channel of
+ * the format is a plane of planeSize elements (float, half or uint8_t).
+ * @ingroup util
+ */
+template<imageFormat format>
+inline __host__ __device__ void imageStorePlanarFixed( void* planes, size_t planeSize, size_t index, int32_t r, int32_t g, int32_t b )
+{
+	if( format == IMAGE_RGBA32F )
+	{
+		float* px = (float*)planes + index;
+
+		px[0]             = yuvFixedToFloat(r);
+		px[planeSize]     = yuvFixedToFloat(g);
+		px[planeSize * 2] = yuvFixedToFloat(b);
+		px[planeSize * 3] = 1.0f;
+	}
+	else if( format == IMAGE_RGBA16F )
+	{
+		uint16_t* px = (uint16_t*)planes + index;
+
+		px[0]             = floatToHalf(yuvFixedToFloat(r));
+		px[planeSize]     = floatToHalf(yuvFixedToFloat(g));
+		px[planeSize * 2] = floatToHalf(yuvFixedToFloat(b));
+		px[planeSize * 3] = floatToHalf(1.0f);
+	}
+	else
+	{
+		uint8_t* px = (uint8_t*)planes + index;
+
+		px[0]             = yuvFixedToByte((format == IMAGE_BGR8) ? b : r);
+		px[planeSize]     = yuvFixedToByte(g);
+		px[planeSize * 2] = yuvFixedToByte((format == IMAGE_BGR8) ? r : b);
+
+		if( format == IMAGE_RGBA8 )
+			px[planeSize * 3] = 0xFF;
+	}
+}
+
+
+/**
+ * Store pixel x of a row from 8-bit RGB, matching cudaRGBToRGBAf() for IMAGE_RGBA32F.
+ * @ingroup util
+ */
+template<imageFormat format>
+inline __host__ __device__ void imageStoreRGB8( void* row, uint32_t x, uchar3 px )
+{
+	if( format == IMAGE_RGBA32F )
+		((float4*)row)[x] = make_float4(px.x, px.y, px.z, 255.0f);
+	else if( format == IMAGE_RGBA16F )
+		((ushort4*)row)[x] = make_ushort4(floatToHalf(px.x), floatToHalf(px.y), floatToHalf(px.z), floatToHalf(255.0f));
+	else if( format == IMAGE_RGBA8 )
+		((uchar4*)row)[x] = make_uchar4(px.x, px.y, px.z, 255);
+	else if( format == IMAGE_RGB8 )
+		((uchar3*)row)[x] = px;
+	else
+		((uchar3*)row)[x] = make_uchar3(px.z, px.y, px.x);
+}
+
+
+/**
+ * Load pixel x of a row as 8-bit RGB, for the RGB to YUV conversions.
+ * IMAGE_RGBA32F is clamped to [0,255] and rounded (see rgbFloatToByte),
+ * IMAGE_RGBA16F isn't supported.
+ * @ingroup util
+ */
+template<imageFormat format>
+inline __host__ __device__ uchar3 imageLoadRGB8( const void* row, uint32_t x )
+{
+	if( format == IMAGE_RGBA32F )
+	{
+		const float4 px = ((const float4*)row)[x];
+		return make_uchar3(rgbFloatToByte(px.x), rgbFloatToByte(px.y), rgbFloatToByte(px.z));
+	}
+	else if( format == IMAGE_RGBA8 )
+	{
+		const uchar4 px = ((const uchar4*)row)[x];
+		return make_uchar3(px.x, px.y, px.z);
+	}
+	else
+	{
+		const uint8_t* px = (const uint8_t*)row + x * 3;
+
+		if( format == IMAGE_BGR8 )
+			return make_uchar3(px[2], px[1], px[0]);
+
+		return make_uchar3(px[0], px[1], px[2]);
+	}
+}
+
+
+#endif
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "imageOps.h"
+#include "logging.h"
+
+#include "cudaLetterbox.h"
+#include "cudaMappedMemory.h"
+#include "cudaMosaic.h"
+#include "cudaNormalize.h"
+#include "cudaOverlay.h"
+#include "cudaResize.h"
+#include "cudaRGB.h"
+#include "cudaTensor.h"
+#include "cudaTensor-ROI.h"
+#include "cudaYUV.h"
+
+#include "cpuLetterbox.h"
+#include "cpuMosaic.h"
+#include "cpuNormalize.h"
+#include "cpuOverlay.h"
+#include "cpuResize.h"
+#include "cpuRGB.h"
+#include "cpuTensor.h"
+#include "cpuYUV.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <mutex>
+
+
+// imageBackendToStr
+const char* imageBackendToStr( imageBackend backend )
+{
+	switch(backend)
+	{
+		case IMAGE_BACKEND_DEFAULT:	return "default";
+		case IMAGE_BACKEND_CUDA:		return "cuda";
+		case IMAGE_BACKEND_CPU:		return "cpu";
+	}
+
+	return "unknown";
+}
+
+
+// imageBackendFromStr
+imageBackend imageBackendFromStr( const char* str )
+{
+	if( !str )
+		return IMAGE_BACKEND_DEFAULT;
+
+	if( strcasecmp(str, "cuda") == 0 || strcasecmp(str, "gpu") == 0 )
+		return IMAGE_BACKEND_CUDA;
+	else if( strcasecmp(str, "cpu") == 0 )
+		return IMAGE_BACKEND_CPU;
+
+	return IMAGE_BACKEND_DEFAULT;
+}
+
+
+//-----------------------------------------------------------------------------------
+// CUDA backend
+//-----------------------------------------------------------------------------------
+class cudaImageOps : public imageOps
+{
+public:
+	cudaImageOps() : imageOps(IMAGE_BACKEND_CUDA)	{ }
+
+	virtual bool Alloc( void** cpuPtr, void** devPtr, size_t size )	{ return cudaAllocMapped(cpuPtr, devPtr, size); }
+	virtual void Free( void* cpuPtr )							{ if( cpuPtr != NULL ) CUDA(cudaFreeHost(cpuPtr)); }
+	virtual bool Synchronize( cudaStream_t stream )				{ return CUDA_SUCCESS(stream ? cudaStreamSynchronize(stream) : cudaDeviceSynchronize()); }
+
+	// the util/cuda functions already report their launch errors through CUDA(),
+	// so they are compared with cudaSuccess directly instead of being logged twice
+
+	virtual bool NV12ToRGBA( uint8_t* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )	{ return (cudaNV12ToRGBA(input, inputPitch, output, outputPitch, width, height, colorimetry, stream) == cudaSuccess); }
+	virtual bool NV12ToRGBAf( uint8_t* input, size_t inputPitch, float4* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )	{ return (cudaNV12ToRGBAf(input, inputPitch, output, outputPitch, width, height, colorimetry, stream) == cudaSuccess); }
+	virtual bool NV12ToFormat( uint8_t* input, size_t inputPitch, void* output, size_t outputPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry, cudaStream_t stream )	{ return (cudaNV12ToFormat(input, inputPitch, output, outputPitch, width, height, format, colorimetry, stream) == cudaSuccess); }
+	virtual bool YUVToFormat( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, void* output, size_t outputPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry, cudaStream_t stream )	{ return (cudaYUVToFormat(input, inputPitch, inputFormat, output, outputPitch, width, height, format, colorimetry, stream) == cudaSuccess); }
+	virtual bool YUVToFormatBatch( const yuvBatchFrame* frames, size_t count, yuvFormat inputFormat, imageFormat format, cudaStream_t stream )	{ return (cudaYUVToFormatBatch(frames, count, inputFormat, format, stream) == cudaSuccess); }
+	virtual bool YUVToProfiles( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t width, size_t height, const yuvProfile* profiles, size_t count, const yuvColorimetry& colorimetry, cudaStream_t stream )	{ return (cudaYUVToProfiles(input, inputPitch, inputFormat, width, height, profiles, count, colorimetry, stream) == cudaSuccess); }
+	virtual bool UYVYToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )	{ return (cudaUYVYToRGBA(input, inputPitch, output, outputPitch, width, height, stream) == cudaSuccess); }
+	virtual bool YUYVToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )	{ return (cudaYUYVToRGBA(input, inputPitch, output, outputPitch, width, height, stream) == cudaSuccess); }
+	virtual bool UYVYToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )	{ return (cudaUYVYToGray(input, inputPitch, output, outputPitch, width, height, stream) == cudaSuccess); }
+	virtual bool YUYVToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )	{ return (cudaYUYVToGray(input, inputPitch, output, outputPitch, width, height, stream) == cudaSuccess); }
+	virtual bool YUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, uint8_t* output, size_t outputPitch, size_t outputWidth, size_t outputHeight, cudaStream_t stream )	{ return (cudaYUVToGray(input, inputPitch, inputFormat, inputWidth, inputHeight, output, outputPitch, outputWidth, outputHeight, stream) == cudaSuccess); }
+	virtual bool YUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, float* output, size_t outputPitch, size_t outputWidth, size_t outputHeight, cudaStream_t stream )	{ return (cudaYUVToGray(input, inputPitch, inputFormat, inputWidth, inputHeight, output, outputPitch, outputWidth, outputHeight, stream) == cudaSuccess); }
+	virtual bool RGBAToI420( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )	{ return (cudaRGBAToI420(input, inputPitch, output, outputPitch, width, height, stream) == cudaSuccess); }
+	virtual bool RGBAToYV12( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream )	{ return (cudaRGBAToYV12(input, inputPitch, output, outputPitch, width, height, stream) == cudaSuccess); }
+	virtual bool FormatToNV12( void* input, size_t inputPitch, imageFormat format, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t stream )	{ return (cudaFormatToNV12(input, inputPitch, format, output, outputPitch, width, height, colorimetry, stream) == cudaSuccess); }
+
+	virtual bool RGBToRGBAf( uchar3* input, float4* output, size_t width, size_t height, cudaStream_t stream )
+	{
+		return (cudaRGBToRGBAf(input, output, width, height, stream) == cudaSuccess);
+	}
+
+	virtual bool RGBToFormat( uchar3* input, void* output, size_t width, size_t height, imageFormat format, cudaStream_t stream )
+	{
+		return (cudaRGBToFormat(input, output, width, height, format, stream) == cudaSuccess);
+	}
+
+	virtual bool Resize( const ImageView<float>& input, const ImageView<float>& output, cudaStream_t stream )
+	{
+		return (cudaResize(input, output, stream) == cudaSuccess);
+	}
+
+	virtual bool ResizeRGBA( const ImageView<float4>& input, const ImageView<float4>& output, cudaStream_t stream )
+	{
+		return (cudaResizeRGBA(input, output, stream) == cudaSuccess);
+	}
+
+	virtual bool Resize( const ImageView<uint8_t>& input, const ImageView<uint8_t>& output, resizeFilter filter, cudaStream_t stream )	{ return (cudaResize(input, output, filter, stream) == cudaSuccess); }
+	virtual bool Resize( const ImageView<uchar4>& input, const ImageView<uchar4>& output, resizeFilter filter, cudaStream_t stream )	{ return (cudaResize(input, output, filter, stream) == cudaSuccess); }
+	virtual bool Resize( const ImageView<float>& input, const ImageView<float>& output, resizeFilter filter, cudaStream_t stream )		{ return (cudaResize(input, output, filter, stream) == cudaSuccess); }
+	virtual bool Resize( const ImageView<float4>& input, const ImageView<float4>& output, resizeFilter filter, cudaStream_t stream )	{ return (cudaResize(input, output, filter, stream) == cudaSuccess); }
+
+	virtual bool Letterbox( const ImageView<uchar4>& input, const ImageView<uchar4>& output, resizeFilter filter, const uchar4& padding, letterboxTransform* transform, cudaStream_t stream )	{ return (cudaLetterbox(input, output, filter, padding, transform, stream) == cudaSuccess); }
+	virtual bool Letterbox( const ImageView<float4>& input, const ImageView<float4>& output, resizeFilter filter, const float4& padding, letterboxTransform* transform, cudaStream_t stream )	{ return (cudaLetterbox(input, output, filter, padding, transform, stream) == cudaSuccess); }
+	virtual bool Mosaic( const ImageView<uchar4>* inputs, uint32_t count, const ImageView<uchar4>& output, resizeFilter filter, cudaStream_t stream )	{ return (cudaMosaic(inputs, count, output, filter, stream) == cudaSuccess); }
+	virtual bool Mosaic( const ImageView<float4>* inputs, uint32_t count, const ImageView<float4>& output, resizeFilter filter, cudaStream_t stream )	{ return (cudaMosaic(inputs, count, output, filter, stream) == cudaSuccess); }
+	virtual bool MosaicNV12( const ImageView<uchar4>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height, resizeFilter filter, const yuvColorimetry& colorimetry, cudaStream_t stream )	{ return (cudaMosaicNV12(inputs, count, output, outputPitch, width, height, filter, colorimetry, stream) == cudaSuccess); }
+	virtual bool MosaicNV12( const ImageView<float4>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height, resizeFilter filter, const yuvColorimetry& colorimetry, cudaStream_t stream )	{ return (cudaMosaicNV12(inputs, count, output, outputPitch, width, height, filter, colorimetry, stream) == cudaSuccess); }
+
+	virtual bool NormalizeRGBA( const ImageView<float4>& input, const float2& input_range, const ImageView<float4>& output, const float2& output_range, cudaStream_t stream )
+	{
+		return (cudaNormalizeRGBA(input, input_range, output, output_range, stream) == cudaSuccess);
+	}
+
+	virtual bool NormalizeRGBA( const ImageView<uchar4>& input, void* output, const tensorParams& params, cudaStream_t stream )	{ return (cudaNormalizeRGBA(input, output, params, stream) == cudaSuccess); }
+	virtual bool NormalizeRGBA( const ImageView<float4>& input, void* output, const tensorParams& params, cudaStream_t stream )	{ return (cudaNormalizeRGBA(input, output, params, stream) == cudaSuccess); }
+
+	virtual bool NV12ToTensor( uint8_t* input, size_t inputPitch, size_t inputWidth, size_t inputHeight, void* output, const tensorParams& params, cudaStream_t stream )
+	{
+		return (cudaNV12ToTensor(input, inputPitch, inputWidth, inputHeight, output, params, stream) == cudaSuccess);
+	}
+
+	virtual bool ROIToTensor( const ImageView<uchar4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count, void* output, const tensorParams& params, cudaStream_t stream )	{ return (cudaROIToTensor(frames, frameCount, rois, count, output, params, stream) == cudaSuccess); }
+	virtual bool ROIToTensor( const ImageView<float4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count, void* output, const tensorParams& params, cudaStream_t stream )	{ return (cudaROIToTensor(frames, frameCount, rois, count, output, params, stream) == cudaSuccess); }
+
+	virtual bool RectOutlineOverlay( const ImageView<float4>& input, const ImageView<float4>& output, float4* boundingBoxes, int numBoxes, const float4& color, cudaStream_t stream )
+	{
+		return (cudaRectOutlineOverlay(input, output, boundingBoxes, numBoxes, color, stream) == cudaSuccess);
+	}
+};
+
+
+//-----------------------------------------------------------------------------------
+// CPU backend
+//-----------------------------------------------------------------------------------
+class cpuImageOps : public imageOps
+{
+public:
+	cpuImageOps() : imageOps(IMAGE_BACKEND_CPU)	{ }
+
+	virtual bool Alloc( void** cpuPtr, void** devPtr, size_t size )
+	{
+		if( !cpuPtr || !devPtr || size == 0 )
+			return false;
+
+		// 64-byte alignment for the AVX2 loads
+		if( posix_memalign(cpuPtr, 64, size) != 0 )
+		{
+			LogError(LOG_CATEGORY_DEFAULT, "imageOps -- failed to allocate %zu bytes of CPU memory\n", size);
+			return false;
+		}
+
+		memset(*cpuPtr, 0, size);
+		*devPtr = *cpuPtr;
+		return true;
+	}
+
+	virtual void Free( void* cpuPtr )	{ free(cpuPtr); }
+	virtual bool Synchronize( cudaStream_t )	{ return true; }
+
+	virtual bool NV12ToRGBA( uint8_t* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t )	{ return cpuNV12ToRGBA(input, inputPitch, output, outputPitch, width, height, colorimetry); }
+	virtual bool NV12ToRGBAf( uint8_t* input, size_t inputPitch, float4* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t )	{ return cpuNV12ToRGBAf(input, inputPitch, output, outputPitch, width, height, colorimetry); }
+	virtual bool NV12ToFormat( uint8_t* input, size_t inputPitch, void* output, size_t outputPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry, cudaStream_t )	{ return cpuNV12ToFormat(input, inputPitch, output, outputPitch, width, height, format, colorimetry); }
+	virtual bool YUVToFormat( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, void* output, size_t outputPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry, cudaStream_t )	{ return cpuYUVToFormat(input, inputPitch, inputFormat, output, outputPitch, width, height, format, colorimetry); }
+	virtual bool YUVToFormatBatch( const yuvBatchFrame* frames, size_t count, yuvFormat inputFormat, imageFormat format, cudaStream_t )	{ return cpuYUVToFormatBatch(frames, count, inputFormat, format); }
+	virtual bool YUVToProfiles( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t width, size_t height, const yuvProfile* profiles, size_t count, const yuvColorimetry& colorimetry, cudaStream_t )	{ return cpuYUVToProfiles(input, inputPitch, inputFormat, width, height, profiles, count, colorimetry); }
+	virtual bool UYVYToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, cudaStream_t )	{ return cpuUYVYToRGBA(input, inputPitch, output, outputPitch, width, height); }
+	virtual bool YUYVToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, cudaStream_t )	{ return cpuYUYVToRGBA(input, inputPitch, output, outputPitch, width, height); }
+	virtual bool UYVYToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height, cudaStream_t )	{ return cpuUYVYToGray(input, inputPitch, output, outputPitch, width, height); }
+	virtual bool YUYVToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height, cudaStream_t )	{ return cpuYUYVToGray(input, inputPitch, output, outputPitch, width, height); }
+	virtual bool YUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, uint8_t* output, size_t outputPitch, size_t outputWidth, size_t outputHeight, cudaStream_t )	{ return cpuYUVToGray(input, inputPitch, inputFormat, inputWidth, inputHeight, output, outputPitch, outputWidth, outputHeight); }
+	virtual bool YUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, float* output, size_t outputPitch, size_t outputWidth, size_t outputHeight, cudaStream_t )	{ return cpuYUVToGray(input, inputPitch, inputFormat, inputWidth, inputHeight, output, outputPitch, outputWidth, outputHeight); }
+	virtual bool RGBAToI420( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, cudaStream_t )	{ return cpuRGBAToI420(input, inputPitch, output, outputPitch, width, height); }
+	virtual bool RGBAToYV12( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, cudaStream_t )	{ return cpuRGBAToYV12(input, inputPitch, output, outputPitch, width, height); }
+	virtual bool FormatToNV12( void* input, size_t inputPitch, imageFormat format, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry, cudaStream_t )	{ return cpuFormatToNV12(input, inputPitch, format, output, outputPitch, width, height, colorimetry); }
+
+	virtual bool RGBToRGBAf( uchar3* input, float4* output, size_t width, size_t height, cudaStream_t )
+	{
+		return cpuRGBToRGBAf(input, output, width, height);
+	}
+
+	virtual bool RGBToFormat( uchar3* input, void* output, size_t width, size_t height, imageFormat format, cudaStream_t )
+	{
+		return cpuRGBToFormat(input, output, width, height, format);
+	}
+
+	virtual bool Resize( const ImageView<float>& input, const ImageView<float>& output, cudaStream_t )
+	{
+		return cpuResize(input, output);
+	}
+
+	virtual bool ResizeRGBA( const ImageView<float4>& input, const ImageView<float4>& output, cudaStream_t )
+	{
+		return cpuResizeRGBA(input, output);
+	}
+
+	virtual bool Resize( const ImageView<uint8_t>& input, const ImageView<uint8_t>& output, resizeFilter filter, cudaStream_t )	{ return cpuResize(input, output, filter); }
+	virtual bool Resize( const ImageView<uchar4>& input, const ImageView<uchar4>& output, resizeFilter filter, cudaStream_t )	{ return cpuResize(input, output, filter); }
+	virtual bool Resize( const ImageView<float>& input, const ImageView<float>& output, resizeFilter filter, cudaStream_t )		{ return cpuResize(input, output, filter); }
+	virtual bool Resize( const ImageView<float4>& input, const ImageView<float4>& output, resizeFilter filter, cudaStream_t )	{ return cpuResize(input, output, filter); }
+
+	virtual bool Letterbox( const ImageView<uchar4>& input, const ImageView<uchar4>& output, resizeFilter filter, const uchar4& padding, letterboxTransform* transform, cudaStream_t )	{ return cpuLetterbox(input, output, filter, padding, transform); }
+	virtual bool Letterbox( const ImageView<float4>& input, const ImageView<float4>& output, resizeFilter filter, const float4& padding, letterboxTransform* transform, cudaStream_t )	{ return cpuLetterbox(input, output, filter, padding, transform); }
+	virtual bool Mosaic( const ImageView<uchar4>* inputs, uint32_t count, const ImageView<uchar4>& output, resizeFilter filter, cudaStream_t )	{ return cpuMosaic(inputs, count, output, filter); }
+	virtual bool Mosaic( const ImageView<float4>* inputs, uint32_t count, const ImageView<float4>& output, resizeFilter filter, cudaStream_t )	{ return cpuMosaic(inputs, count, output, filter); }
+	virtual bool MosaicNV12( const ImageView<uchar4>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height, resizeFilter filter, const yuvColorimetry& colorimetry, cudaStream_t )	{ return cpuMosaicNV12(inputs, count, output, outputPitch, width, height, filter, colorimetry); }
+	virtual bool MosaicNV12( const ImageView<float4>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height, resizeFilter filter, const yuvColorimetry& colorimetry, cudaStream_t )	{ return cpuMosaicNV12(inputs, count, output, outputPitch, width, height, filter, colorimetry); }
+
+	virtual bool NormalizeRGBA( const ImageView<float4>& input, const float2& input_range, const ImageView<float4>& output, const float2& output_range, cudaStream_t )
+	{
+		return cpuNormalizeRGBA(input, input_range, output, output_range);
+	}
+
+	virtual bool NormalizeRGBA( const ImageView<uchar4>& input, void* output, const tensorParams& params, cudaStream_t )	{ return cpuNormalizeRGBA(input, output, params); }
+	virtual bool NormalizeRGBA( const ImageView<float4>& input, void* output, const tensorParams& params, cudaStream_t )	{ return cpuNormalizeRGBA(input, output, params); }
+
+	virtual bool NV12ToTensor( uint8_t* input, size_t inputPitch, size_t inputWidth, size_t inputHeight, void* output, const tensorParams& params, cudaStream_t )
+	{
+		return cpuNV12ToTensor(input, inputPitch, inputWidth, inputHeight, output, params);
+	}
+
+	virtual bool ROIToTensor( const ImageView<uchar4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count, void* output, const tensorParams& params, cudaStream_t )	{ return cpuROIToTensor(frames, frameCount, rois, count, output, params); }
+	virtual bool ROIToTensor( const ImageView<float4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count, void* output, const tensorParams& params, cudaStream_t )	{ return cpuROIToTensor(frames, frameCount, rois, count, output, params); }
+
+	virtual bool RectOutlineOverlay( const ImageView<float4>& input, const ImageView<float4>& output, float4* boundingBoxes, int numBoxes, const float4& color, cudaStream_t )
+	{
+		return cpuRectOutlineOverlay(input, output, boundingBoxes, numBoxes, color);
+	}
+};
+
+
+//-----------------------------------------------------------------------------------
+// imageOps
+//-----------------------------------------------------------------------------------
+
+// constructor
+imageOps::imageOps( imageBackend backend )
+{
+	mBackend = backend;
+}
+
+
+// destructor
+imageOps::~imageOps()
+{
+
+}
+
+
+// HasCUDA
+bool imageOps::HasCUDA()
+{
+	static bool available = false;
+	static std::once_flag flag;
+
+	std::call_once(flag, []()
+	{
+		// cudart loads the driver on first use, so without a GPU or driver this returns an
+		// error (the CUDA runtime libraries themselves still have to be installed)
+		int devices = 0;
+
+		if( cudaGetDeviceCount(&devices) == cudaSuccess && devices > 0 )
+			available = true;
+		else
+			cudaGetLastError();		// clear the error
+
+		LogInfo(LOG_CATEGORY_CUDA, LOG_CUDA "imageOps -- %d CUDA device(s) found\n", devices);
+	});
+
+	return available;
+}
+
+
+// DefaultBackend
+imageBackend imageOps::DefaultBackend()
+{
+	static imageBackend backend = IMAGE_BACKEND_DEFAULT;
+	static std::once_flag flag;
+
+	std::call_once(flag, []()
+	{
+		backend = imageBackendFromStr(getenv("JETSON_BACKEND"));
+
+		if( backend == IMAGE_BACKEND_DEFAULT )
+			backend = HasCUDA() ? IMAGE_BACKEND_CUDA : IMAGE_BACKEND_CPU;
+
+		LogInfo(LOG_CATEGORY_DEFAULT, "imageOps -- default backend:  %s\n", imageBackendToStr(backend));
+	});
+
+	return backend;
+}
+
+
+// Get
+imageOps* imageOps::Get( imageBackend backend )
+{
+	static cudaImageOps cudaOps;
+	static cpuImageOps  cpuOps;
+
+	if( backend == IMAGE_BACKEND_DEFAULT )
+		backend = DefaultBackend();
+
+	if( backend == IMAGE_BACKEND_CUDA && !HasCUDA() )
+	{
+		LogWarning(LOG_CATEGORY_CUDA, LOG_CUDA "imageOps -- no CUDA device available, using the CPU backend\n");
+		backend = IMAGE_BACKEND_CPU;
+	}
+
+	if( backend == IMAGE_BACKEND_CUDA )
+		return &cudaOps;
+
+	return &cpuOps;
+}
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __IMAGE_OPS_H_
+#define __IMAGE_OPS_H_
+
+
+#include "cudaLetterbox.h"
+#include "cudaMosaic.h"
+#include "cudaResize.h"
+#include "cudaTensor.h"
+#include "cudaTensor-ROI.h"
+#include "cudaYUV.h"
+#include "imageFormat.h"
+#include "imageView.h"
+#include <stdint.h>
+
+
+/**
+ * Compute backend used to run the image operations.
+ * @ingroup util
+ */
+enum imageBackend
+{
+	IMAGE_BACKEND_DEFAULT = 0,	/**< CUDA when a GPU is present, otherwise the CPU (overridden by JETSON_BACKEND=cpu|cuda) */
+	IMAGE_BACKEND_CUDA,		/**< the kernels from util/cuda */
+	IMAGE_BACKEND_CPU		/**< the SIMD + thread pool implementations from util/cpu */
+};
+
+/**
+ * Convert an imageBackend to a string ("default", "cuda", "cpu").
+ * @ingroup util
+ */
+const char* imageBackendToStr( imageBackend backend );
+
+/**
+ * Parse an imageBackend from a string, returning IMAGE_BACKEND_DEFAULT if it isn't recognized.
+ * @ingroup util
+ */
+imageBackend imageBackendFromStr( const char* str );
+
+
+/**
+ * Runtime-selectable implementation of the image operations in util/cuda.
+ *
+ * Every backend produces the same results (the CPU versions are bit-exact
+ * with the CUDA kernels), so the choice can be made per device at startup
+ * or per call, for example to keep a small conversion off a busy GPU:
+ *
+ *    imageOps::Get()->NV12ToRGBAf(...);                    // CUDA if available
+ *    imageOps::Get(IMAGE_BACKEND_CPU)->ResizeRGBA(...);    // always on the CPU
+ *
+ * Buffers passed to an op must be accessible by its backend, use Alloc().
+ * The resize, normalize and overlay ops also take an ImageView, so they can
+ * work on pitched buffers and crops without a copy.
+ * CUDA ops are asynchronous, call Synchronize() before reading the results
+ * from the CPU.  CPU ops return once the output is complete.
+ * Every op takes an optional cudaStream_t (NULL is the default stream, as
+ * before) so independent pipelines can overlap, the CPU backend ignores it.
+ * The functions return false on invalid arguments or launch failure.
+ *
+ * Both backends are built into the same library, and the CPU kernels share the
+ * headers (vector types, colorspace helpers) of the CUDA ones.  So building the
+ * CPU backend still needs the CUDA toolkit, and running it needs the CUDA runtime
+ * libraries installed (TensorRT links the shared libcudart).  Only the GPU and its
+ * driver are optional at runtime.
+ * @ingroup util
+ */
+class imageOps
+{
+public:
+	/**
+	 * Get the shared instance of a backend.  IMAGE_BACKEND_DEFAULT resolves to DefaultBackend().
+	 * Requesting CUDA without a usable GPU falls back to the CPU.
+	 */
+	static imageOps* Get( imageBackend backend=IMAGE_BACKEND_DEFAULT );
+
+	/**
+	 * The backend selected by IMAGE_BACKEND_DEFAULT, from the JETSON_BACKEND
+	 * environment variable or the availability of a CUDA device.
+	 */
+	static imageBackend DefaultBackend();
+
+	/**
+	 * True if a CUDA device is present and the runtime could be initialized.
+	 */
+	static bool HasCUDA();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~imageOps();
+
+	/**
+	 * The backend implemented by this instance (never IMAGE_BACKEND_DEFAULT).
+	 */
+	inline imageBackend GetBackend() const		{ return mBackend; }
+
+	/**
+	 * Allocate a buffer usable by this backend and the CPU (zeroCopy mapped memory for CUDA).
+	 * devPtr is the pointer to pass to the ops, cpuPtr the one for CPU access (they may be equal).
+	 */
+	virtual bool Alloc( void** cpuPtr, void** devPtr, size_t size ) = 0;
+
+	/**
+	 * Free a buffer from Alloc(), given its CPU pointer.
+	 */
+	virtual void Free( void* cpuPtr ) = 0;
+
+	/**
+	 * Wait for the ops issued so far to complete, on the whole device if stream
+	 * is NULL or only on the given stream otherwise.
+	 */
+	virtual bool Synchronize( cudaStream_t stream=NULL ) = 0;
+
+	/**
+	 * @see cudaNV12ToRGBA(), cudaNV12ToRGBAf()
+	 */
+	virtual bool NV12ToRGBA( uint8_t* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL ) = 0;
+	virtual bool NV12ToRGBAf( uint8_t* input, size_t inputPitch, float4* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL ) = 0;
+
+	inline bool NV12ToRGBA( uint8_t* input, uchar4* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL )	{ return NV12ToRGBA(input, width * sizeof(uint8_t), output, width * sizeof(uchar4), width, height, colorimetry, stream); }
+	inline bool NV12ToRGBAf( uint8_t* input, float4* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL )	{ return NV12ToRGBAf(input, width * sizeof(uint8_t), output, width * sizeof(float4), width, height, colorimetry, stream); }
+
+	/**
+	 * @see cudaNV12ToFormat()
+	 */
+	virtual bool NV12ToFormat( uint8_t* input, size_t inputPitch, void* output, size_t outputPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL ) = 0;
+
+	inline bool NV12ToFormat( uint8_t* input, void* output, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL )	{ return NV12ToFormat(input, width * sizeof(uint8_t), output, width * imageFormatSize(format), width, height, format, colorimetry, stream); }
+
+	/**
+	 * @see cudaYUVToFormat()
+	 */
+	virtual bool YUVToFormat( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, void* output, size_t outputPitch, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL ) = 0;
+
+	inline bool YUVToFormat( uint8_t* input, yuvFormat inputFormat, void* output, size_t width, size_t height, imageFormat format, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL )	{ return YUVToFormat(input, yuvFormatPitch(inputFormat, width), inputFormat, output, width * imageFormatSize(format), width, height, format, colorimetry, stream); }
+
+	/**
+	 * @see cudaYUVToFormatBatch()
+	 */
+	virtual bool YUVToFormatBatch( const yuvBatchFrame* frames, size_t count, yuvFormat inputFormat, imageFormat format, cudaStream_t stream=NULL ) = 0;
+
+	/**
+	 * @see cudaYUVToProfiles()
+	 */
+	virtual bool YUVToProfiles( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t width, size_t height, const yuvProfile* profiles, size_t count, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL ) = 0;
+
+	/**
+	 * @see cudaUYVYToRGBA(), cudaYUYVToRGBA()
+	 */
+	virtual bool UYVYToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream=NULL ) = 0;
+	virtual bool YUYVToRGBA( uchar2* input, size_t inputPitch, uchar4* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream=NULL ) = 0;
+
+	inline bool UYVYToRGBA( uchar2* input, uchar4* output, size_t width, size_t height, cudaStream_t stream=NULL )		{ return UYVYToRGBA(input, width * sizeof(uchar2), output, width * sizeof(uchar4), width, height, stream); }
+	inline bool YUYVToRGBA( uchar2* input, uchar4* output, size_t width, size_t height, cudaStream_t stream=NULL )		{ return YUYVToRGBA(input, width * sizeof(uchar2), output, width * sizeof(uchar4), width, height, stream); }
+
+	/**
+	 * @see cudaUYVYToGray(), cudaYUYVToGray()
+	 */
+	virtual bool UYVYToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream=NULL ) = 0;
+	virtual bool YUYVToGray( uchar2* input, size_t inputPitch, float* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream=NULL ) = 0;
+
+	inline bool UYVYToGray( uchar2* input, float* output, size_t width, size_t height, cudaStream_t stream=NULL )		{ return UYVYToGray(input, width * sizeof(uchar2), output, width * sizeof(float), width, height, stream); }
+	inline bool YUYVToGray( uchar2* input, float* output, size_t width, size_t height, cudaStream_t stream=NULL )		{ return YUYVToGray(input, width * sizeof(uchar2), output, width * sizeof(float), width, height, stream); }
+
+	/**
+	 * @see cudaYUVToGray()
+	 */
+	virtual bool YUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, uint8_t* output, size_t outputPitch, size_t outputWidth, size_t outputHeight, cudaStream_t stream=NULL ) = 0;
+	virtual bool YUVToGray( uint8_t* input, size_t inputPitch, yuvFormat inputFormat, size_t inputWidth, size_t inputHeight, float* output, size_t outputPitch, size_t outputWidth, size_t outputHeight, cudaStream_t stream=NULL ) = 0;
+
+	/**
+	 * @see cudaRGBAToI420(), cudaRGBAToYV12()
+	 */
+	virtual bool RGBAToI420( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream=NULL ) = 0;
+	virtual bool RGBAToYV12( uchar4* input, size_t inputPitch, uint8_t* output, size_t outputPitch, size_t width, size_t height, cudaStream_t stream=NULL ) = 0;
+
+	inline bool RGBAToI420( uchar4* input, uint8_t* output, size_t width, size_t height, cudaStream_t stream=NULL )		{ return RGBAToI420(input, width * sizeof(uchar4), output, width * sizeof(uint8_t), width, height, stream); }
+	inline bool RGBAToYV12( uchar4* input, uint8_t* output, size_t width, size_t height, cudaStream_t stream=NULL )		{ return RGBAToYV12(input, width * sizeof(uchar4), output, width * sizeof(uint8_t), width, height, stream); }
+
+	/**
+	 * @see cudaFormatToNV12(), cudaRGBAToNV12()
+	 */
+	virtual bool FormatToNV12( void* input, size_t inputPitch, imageFormat format, uint8_t* output, size_t outputPitch, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL ) = 0;
+
+	inline bool FormatToNV12( void* input, imageFormat format, uint8_t* output, size_t width, size_t height, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL )	{ return FormatToNV12(input, width * imageFormatSize(format), format, output, yuvFormatPitch(YUV_NV12, width), width, height, colorimetry, stream); }
+
+	/**
+	 * @see cudaRGBToRGBAf()
+	 */
+	virtual bool RGBToRGBAf( uchar3* input, float4* output, size_t width, size_t height, cudaStream_t stream=NULL ) = 0;
+
+	/**
+	 * @see cudaRGBToFormat()
+	 */
+	virtual bool RGBToFormat( uchar3* input, void* output, size_t width, size_t height, imageFormat format, cudaStream_t stream=NULL ) = 0;
+
+	/**
+	 * @see cudaResize(), cudaResizeRGBA()
+	 */
+	virtual bool Resize( const ImageView<float>& input, const ImageView<float>& output, cudaStream_t stream=NULL ) = 0;
+	virtual bool ResizeRGBA( const ImageView<float4>& input, const ImageView<float4>& output, cudaStream_t stream=NULL ) = 0;
+
+	/**
+	 * @see cudaResize() with a resizeFilter
+	 */
+	virtual bool Resize( const ImageView<uint8_t>& input, const ImageView<uint8_t>& output, resizeFilter filter, cudaStream_t stream=NULL ) = 0;
+	virtual bool Resize( const ImageView<uchar4>& input, const ImageView<uchar4>& output, resizeFilter filter, cudaStream_t stream=NULL ) = 0;
+	virtual bool Resize( const ImageView<float>& input, const ImageView<float>& output, resizeFilter filter, cudaStream_t stream=NULL ) = 0;
+	virtual bool Resize( const ImageView<float4>& input, const ImageView<float4>& output, resizeFilter filter, cudaStream_t stream=NULL ) = 0;
+
+	/**
+	 * @see cudaLetterbox()
+	 */
+	virtual bool Letterbox( const ImageView<uchar4>& input, const ImageView<uchar4>& output, resizeFilter filter, const uchar4& padding, letterboxTransform* transform=NULL, cudaStream_t stream=NULL ) = 0;
+	virtual bool Letterbox( const ImageView<float4>& input, const ImageView<float4>& output, resizeFilter filter, const float4& padding, letterboxTransform* transform=NULL, cudaStream_t stream=NULL ) = 0;
+
+	/**
+	 * @see cudaMosaic(), cudaMosaicNV12()
+	 */
+	virtual bool Mosaic( const ImageView<uchar4>* inputs, uint32_t count, const ImageView<uchar4>& output, resizeFilter filter, cudaStream_t stream=NULL ) = 0;
+	virtual bool Mosaic( const ImageView<float4>* inputs, uint32_t count, const ImageView<float4>& output, resizeFilter filter, cudaStream_t stream=NULL ) = 0;
+	virtual bool MosaicNV12( const ImageView<uchar4>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height, resizeFilter filter, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL ) = 0;
+	virtual bool MosaicNV12( const ImageView<float4>* inputs, uint32_t count, uint8_t* output, size_t outputPitch, uint32_t width, uint32_t height, resizeFilter filter, const yuvColorimetry& colorimetry=yuvColorimetry(), cudaStream_t stream=NULL ) = 0;
+
+	inline bool Resize( float* input, size_t inputWidth, size_t inputHeight, float* output, size_t outputWidth, size_t outputHeight, cudaStream_t stream=NULL )			{ return Resize(ImageView<float>(input, inputWidth, inputHeight), ImageView<float>(output, outputWidth, outputHeight), stream); }
+	inline bool ResizeRGBA( float4* input, size_t inputWidth, size_t inputHeight, float4* output, size_t outputWidth, size_t outputHeight, cudaStream_t stream=NULL )	{ return ResizeRGBA(ImageView<float4>(input, inputWidth, inputHeight), ImageView<float4>(output, outputWidth, outputHeight), stream); }
+
+	/**
+	 * @see cudaNormalizeRGBA()
+	 */
+	virtual bool NormalizeRGBA( const ImageView<float4>& input, const float2& input_range, const ImageView<float4>& output, const float2& output_range, cudaStream_t stream=NULL ) = 0;
+
+	inline bool NormalizeRGBA( float4* input, const float2& input_range, float4* output, const float2& output_range, size_t width, size_t height, cudaStream_t stream=NULL )	{ return NormalizeRGBA(ImageView<float4>(input, width, height), input_range, ImageView<float4>(output, width, height), output_range, stream); }
+
+	virtual bool NormalizeRGBA( const ImageView<uchar4>& input, void* output, const tensorParams& params, cudaStream_t stream=NULL ) = 0;
+	virtual bool NormalizeRGBA( const ImageView<float4>& input, void* output, const tensorParams& params, cudaStream_t stream=NULL ) = 0;
+
+	/**
+	 * @see cudaNV12ToTensor()
+	 */
+	virtual bool NV12ToTensor( uint8_t* input, size_t inputPitch, size_t inputWidth, size_t inputHeight, void* output, const tensorParams& params, cudaStream_t stream=NULL ) = 0;
+
+	inline bool NV12ToTensor( uint8_t* input, size_t inputWidth, size_t inputHeight, void* output, const tensorParams& params, cudaStream_t stream=NULL )	{ return NV12ToTensor(input, inputWidth * sizeof(uint8_t), inputWidth, inputHeight, output, params, stream); }
+
+	/**
+	 * @see cudaROIToTensor()
+	 */
+	virtual bool ROIToTensor( const ImageView<uchar4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count, void* output, const tensorParams& params, cudaStream_t stream=NULL ) = 0;
+	virtual bool ROIToTensor( const ImageView<float4>* frames, uint32_t frameCount, const tensorROI* rois, uint32_t count, void* output, const tensorParams& params, cudaStream_t stream=NULL ) = 0;
+
+	inline bool ROIToTensor( const ImageView<float4>& frame, const tensorROI* rois, uint32_t count, void* output, const tensorParams& params, cudaStream_t stream=NULL )	{ return ROIToTensor(&frame, 1, rois, count, output, params, stream); }
+
+	/**
+	 * @see cudaRectOutlineOverlay()
+	 */
+	virtual bool RectOutlineOverlay( const ImageView<float4>& input, const ImageView<float4>& output, float4* boundingBoxes, int numBoxes, const float4& color, cudaStream_t stream=NULL ) = 0;
+
+	inline bool RectOutlineOverlay( float4* input, float4* output, uint32_t width, uint32_t height, float4* boundingBoxes, int numBoxes, const float4& color, cudaStream_t stream=NULL )	{ return RectOutlineOverlay(ImageView<float4>(input, width, height), ImageView<float4>(output, width, height), boundingBoxes, numBoxes, color, stream); }
+
+protected:
+	imageOps( imageBackend backend );
+
+	imageBackend mBackend;
+};
+
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#ifndef __IMAGE_VIEW_H_
+#define __IMAGE_VIEW_H_
+
+
+#include "cudaUtility.h"
+#include <stdint.h>
+
+
+/**
+ * Non-owning view of a 2D image: a pointer to the first pixel, the size in
+ * pixels and the pitch (bytes between the starts of two rows).
+ *
+ * The ops that take views read and write through the pitch, so padded
+ * allocations work without a copy and a crop is just a pointer offset:
+ *
+ *    ImageView<float4> frame(rgba, 1920, 1080);
+ *    ops->ResizeRGBA(frame.Crop(640, 360, 640, 360), ImageView<float4>(tile, 224, 224));
+ *
+ * The pointer must be accessible by the backend the view is passed to
+ * (device or mapped memory for CUDA), the view itself is passed by value.
+ * @ingroup util
+ */
+template<typename T>
+struct ImageView
+{
+	T*       ptr;		/**< first pixel */
+	uint32_t width;	/**< in pixels */
+	uint32_t height;	/**< in rows */
+	size_t   pitch;	/**< bytes between rows, at least width * sizeof(T) */
+
+	/**
+	 * Empty view.
+	 */
+	__host__ __device__ ImageView() : ptr(NULL), width(0), height(0), pitch(0)	{ }
+
+	/**
+	 * View of an image, pitch=0 means tightly packed rows.
+	 */
+	__host__ __device__ ImageView( T* image, uint32_t w, uint32_t h, size_t rowPitch=0 )
+		: ptr(image), width(w), height(h), pitch(rowPitch != 0 ? rowPitch : w * sizeof(T))	{ }
+
+	/**
+	 * Pointer to the first pixel of row y.
+	 */
+	__host__ __device__ inline T* Row( uint32_t y ) const			{ return (T*)((uint8_t*)ptr + y * pitch); }
+
+	/**
+	 * Pixel (x,y).
+	 */
+	__host__ __device__ inline T& operator()( uint32_t x, uint32_t y ) const	{ return Row(y)[x]; }
+
+	/**
+	 * True if the view points somewhere, is not empty and the rows don't overlap.
+	 */
+	__host__ __device__ inline bool IsValid() const	{ return ptr != NULL && width != 0 && height != 0 && pitch >= width * sizeof(T); }
+
+	/**
+	 * True if there is no padding between the rows.
+	 */
+	__host__ __device__ inline bool IsPacked() const	{ return pitch == width * sizeof(T); }
+
+	/**
+	 * Sub-rectangle sharing this view's memory and pitch.  The rectangle is
+	 * clipped to the image, a rectangle outside of it gives an empty view.
+	 */
+	__host__ __device__ inline ImageView<T> Crop( uint32_t left, uint32_t top, uint32_t w, uint32_t h ) const
+	{
+		if( left >= width || top >= height )
+			return ImageView<T>();
+
+		if( w > width - left )
+			w = width - left;
+
+		if( h > height - top )
+			h = height - top;
+
+		return ImageView<T>(Row(top) + left, w, h, pitch);
+	}
+};
+
+
+#endif
+
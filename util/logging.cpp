@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "logging.h"
+
+#include <stdarg.h>
+#include <string.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <time.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+
+// size of the message queue (power of two) and of each record
+#define LOG_QUEUE_SIZE		1024
+#define LOG_RECORD_SIZE		512
+
+// number of call sites tracked for rate-limiting (power of two)
+#define LOG_SITES			1024
+
+
+// fixed-size queued message
+struct logRecord
+{
+	std::atomic<uint64_t> sequence;
+	char text[LOG_RECORD_SIZE];
+};
+
+
+// rate-limiting state of one call site
+struct logSite
+{
+	std::atomic<uintptr_t> key;
+	std::atomic<uint64_t>  second;
+	std::atomic<uint32_t>  count;
+	std::atomic<uint32_t>  suppressed;
+};
+
+
+static std::atomic<int>      gLevels[LOG_NUM_CATEGORIES];
+static std::atomic<uint32_t> gRateLimit(20);
+static std::atomic<FILE*>    gOutput(NULL);
+static std::atomic<uint64_t> gDropped(0);
+static std::atomic<bool>     gRunning(false);
+
+static logRecord             gQueue[LOG_QUEUE_SIZE];
+static std::atomic<uint64_t> gQueueTail(0);	// next record to claim (producers)
+static std::atomic<uint64_t> gQueueHead(0);	// next record to write (writer thread)
+
+static logSite               gSites[LOG_SITES];
+static std::once_flag        gInitFlag;
+
+
+// background writer thread, joined at exit after draining the queue
+class logWriter
+{
+public:
+	~logWriter()
+	{
+		if( !gRunning.exchange(false) )
+			return;
+
+		if( mThread.joinable() )
+			mThread.join();
+
+		drain();
+	}
+
+	void start()
+	{
+		gRunning = true;
+		mThread  = std::thread(&logWriter::run, this);
+	}
+
+	static bool drain()
+	{
+		FILE* output = gOutput.load(std::memory_order_relaxed);
+		bool wrote = false;
+
+		while( true )
+		{
+			const uint64_t head = gQueueHead.load(std::memory_order_relaxed);
+			logRecord& record = gQueue[head % LOG_QUEUE_SIZE];
+
+			if( record.sequence.load(std::memory_order_acquire) != head + 1 )
+				break;
+
+			fputs(record.text, output);
+
+			record.sequence.store(head + LOG_QUEUE_SIZE, std::memory_order_release);
+			gQueueHead.store(head + 1, std::memory_order_release);
+			wrote = true;
+		}
+
+		const uint64_t dropped = gDropped.exchange(0, std::memory_order_relaxed);
+
+		if( dropped > 0 )
+		{
+			fprintf(output, "[log]    %llu messages dropped, queue was full\n", (unsigned long long)dropped);
+			wrote = true;
+		}
+
+		if( wrote )
+			fflush(output);
+
+		return wrote;
+	}
+
+private:
+	void run()
+	{
+		const timespec idle = { 0, 2 * 1000 * 1000 };
+
+		while( gRunning.load(std::memory_order_relaxed) )
+		{
+			if( !drain() )
+				nanosleep(&idle, NULL);
+		}
+	}
+
+	std::thread mThread;
+};
+
+static logWriter gWriter;
+
+
+// parse a level name or number
+static int logParseLevel( const char* str )
+{
+	static const char* names[] = { "error", "warning", "info", "verbose", "debug" };
+
+	for( int n=0; n <= LOG_LEVEL_DEBUG; n++ )
+	{
+		if( strcasecmp(str, names[n]) == 0 )
+			return n;
+	}
+
+	if( str[0] >= '0' && str[0] <= '9' )
+		return atoi(str);
+
+	return LOG_LEVEL_INFO;
+}
+
+
+// logInit
+static void logInit()
+{
+	const char* env = getenv("JETSON_LOG_LEVEL");
+	const int level = (env != NULL) ? logParseLevel(env) : LOG_LEVEL_INFO;
+
+	for( int n=0; n < LOG_NUM_CATEGORIES; n++ )
+		gLevels[n] = level;
+
+	if( !gOutput.load() )
+		gOutput = stdout;
+
+	for( uint64_t n=0; n < LOG_QUEUE_SIZE; n++ )
+		gQueue[n].sequence = n;
+
+	gWriter.start();
+}
+
+
+// logTime
+static inline uint64_t logTime()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+	return uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+
+// logRateLimit
+static bool logRateLimit( const char* file, int line, uint32_t* suppressed )
+{
+	const uint32_t limit = gRateLimit.load(std::memory_order_relaxed);
+
+	if( limit == 0 )
+		return true;
+
+	const uintptr_t key = (uintptr_t)file * 31 + line;
+	logSite& site = gSites[(key ^ (key >> 12)) % LOG_SITES];
+
+	const uint64_t second = logTime() / 1000000000ULL;
+
+	// on a hash collision the slot is taken over by the newer call site
+	if( site.key.load(std::memory_order_relaxed) != key )
+	{
+		site.key.store(key, std::memory_order_relaxed);
+		site.second.store(second, std::memory_order_relaxed);
+		site.count.store(0, std::memory_order_relaxed);
+		site.suppressed.store(0, std::memory_order_relaxed);
+	}
+	else if( site.second.load(std::memory_order_relaxed) != second )
+	{
+		site.second.store(second, std::memory_order_relaxed);
+		site.count.store(0, std::memory_order_relaxed);
+	}
+
+	if( site.count.fetch_add(1, std::memory_order_relaxed) >= limit )
+	{
+		site.suppressed.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	*suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+	return true;
+}
+
+
+// logFormat
+static void logFormat( char* text, uint32_t suppressed, const char* format, va_list args )
+{
+	int length = vsnprintf(text, LOG_RECORD_SIZE, format, args);
+
+	if( length < 0 )
+		length = 0;
+	else if( length >= LOG_RECORD_SIZE )
+	{
+		length = LOG_RECORD_SIZE - 1;
+		memcpy(text + length - 4, "...\n", 4);
+	}
+
+	if( suppressed > 0 && length < LOG_RECORD_SIZE - 1 )
+		snprintf(text + length, LOG_RECORD_SIZE - length, "[log]    (%u similar messages suppressed)\n", suppressed);
+}
+
+
+// logEnabled
+bool logEnabled( int category, int level )
+{
+	std::call_once(gInitFlag, logInit);
+
+	if( category < 0 || category >= LOG_NUM_CATEGORIES )
+		category = LOG_CATEGORY_DEFAULT;
+
+	return level <= gLevels[category].load(std::memory_order_relaxed);
+}
+
+
+// logWrite
+void logWrite( int category, int level, const char* file, int line, const char* format, ... )
+{
+	uint32_t suppressed = 0;
+
+	if( !format || !logRateLimit(file, line, &suppressed) )
+		return;
+
+	va_list args;
+	va_start(args, format);
+
+	// during shutdown, write straight through
+	if( !gRunning.load(std::memory_order_relaxed) )
+	{
+		char text[LOG_RECORD_SIZE];
+		logFormat(text, suppressed, format, args);
+		fputs(text, gOutput.load() ? gOutput.load() : stdout);
+		va_end(args);
+		return;
+	}
+
+	// claim a record (bounded MPSC queue, each record carries its sequence number)
+	uint64_t tail = gQueueTail.load(std::memory_order_relaxed);
+	logRecord* record = NULL;
+
+	while( true )
+	{
+		record = &gQueue[tail % LOG_QUEUE_SIZE];
+
+		const int64_t diff = (int64_t)record->sequence.load(std::memory_order_acquire) - (int64_t)tail;
+
+		if( diff == 0 )
+		{
+			if( gQueueTail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed) )
+				break;
+		}
+		else if( diff < 0 )
+		{
+			gDropped.fetch_add(1, std::memory_order_relaxed);
+			va_end(args);
+			return;
+		}
+		else
+		{
+			tail = gQueueTail.load(std::memory_order_relaxed);
+		}
+	}
+
+	logFormat(record->text, suppressed, format, args);
+	va_end(args);
+
+	record->sequence.store(tail + 1, std::memory_order_release);
+}
+
+
+// logSetLevel
+void logSetLevel( int level )
+{
+	std::call_once(gInitFlag, logInit);
+
+	for( int n=0; n < LOG_NUM_CATEGORIES; n++ )
+		gLevels[n] = level;
+}
+
+
+// logSetLevel
+void logSetLevel( int category, int level )
+{
+	std::call_once(gInitFlag, logInit);
+
+	if( category >= 0 && category < LOG_NUM_CATEGORIES )
+		gLevels[category] = level;
+}
+
+
+// logSetRateLimit
+void logSetRateLimit( uint32_t messagesPerSecond )
+{
+	gRateLimit = messagesPerSecond;
+}
+
+
+// logSetOutput
+void logSetOutput( FILE* file )
+{
+	gOutput = (file != NULL) ? file : stdout;
+}
+
+
+// logFlush
+void logFlush()
+{
+	if( !gRunning.load() )
+		return;
+
+	const uint64_t tail = gQueueTail.load(std::memory_order_acquire);
+	const timespec wait = { 0, 1000 * 1000 };
+
+	while( gRunning.load(std::memory_order_relaxed) && gQueueHead.load(std::memory_order_acquire) < tail )
+		nanosleep(&wait, NULL);
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+ 
+#ifndef __LOGGING_UTILITY_H_
+#define __LOGGING_UTILITY_H_
+
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+/**
+ * Log levels, from most to least severe.
+ * @ingroup util
+ */
+#define LOG_LEVEL_ERROR		0
+#define LOG_LEVEL_WARNING	1
+#define LOG_LEVEL_INFO		2
+#define LOG_LEVEL_VERBOSE	3
+#define LOG_LEVEL_DEBUG		4
+
+
+/**
+ * Messages above this level are removed at compile-time.
+ * Define it before including logging.h (or on the compiler command line) to override.
+ * @ingroup util
+ */
+#ifndef LOG_LEVEL_COMPILED
+#define LOG_LEVEL_COMPILED	LOG_LEVEL_VERBOSE
+#endif
+
+
+/**
+ * Log categories, each with its own runtime threshold.
+ * @ingroup util
+ */
+enum logCategory
+{
+	LOG_CATEGORY_DEFAULT = 0,
+	LOG_CATEGORY_CUDA,
+	LOG_CATEGORY_GSTREAMER,
+	LOG_CATEGORY_GL,
+	LOG_NUM_CATEGORIES
+};
+
+
+/**
+ * Log a printf-style message.
+ *
+ * The message is formatted into a fixed-size record and queued for the
+ * background writer thread, so the caller never blocks on the output stream.
+ * Each call site is rate-limited (see logSetRateLimit), and if the queue is
+ * full the message is dropped and counted rather than waited on.
+ * @ingroup util
+ */
+#define LogMessage(category, level, ...)											\
+	do {																			\
+		if( (level) <= LOG_LEVEL_COMPILED && logEnabled(category, level) )		\
+			logWrite(category, level, __FILE__, __LINE__, __VA_ARGS__);			\
+	} while(0)
+
+#define LogError(category, ...)		LogMessage(category, LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LogWarning(category, ...)	LogMessage(category, LOG_LEVEL_WARNING, __VA_ARGS__)
+#define LogInfo(category, ...)		LogMessage(category, LOG_LEVEL_INFO, __VA_ARGS__)
+#define LogVerbose(category, ...)	LogMessage(category, LOG_LEVEL_VERBOSE, __VA_ARGS__)
+#define LogDebug(category, ...)		LogMessage(category, LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+
+/**
+ * Returns true if messages of this level are currently logged for the category.
+ * @ingroup util
+ */
+bool logEnabled( int category, int level );
+
+
+/**
+ * Queue a message, use the LogMessage() macros instead of calling this directly.
+ * @ingroup util
+ */
+void logWrite( int category, int level, const char* file, int line, const char* format, ... ) __attribute__((format(printf, 5, 6)));
+
+
+/**
+ * Set the runtime level of every category.
+ * The initial level is LOG_LEVEL_INFO, or the JETSON_LOG_LEVEL environment
+ * variable (error, warning, info, verbose, debug or 0-4) if set.
+ * @ingroup util
+ */
+void logSetLevel( int level );
+
+
+/**
+ * Set the runtime level of one category.
+ * @ingroup util
+ */
+void logSetLevel( int category, int level );
+
+
+/**
+ * Set the maximum number of messages per second from any one call site (0 for no limit).
+ * Suppressed messages are counted and reported with the next message from that site.
+ * @ingroup util
+ */
+void logSetRateLimit( uint32_t messagesPerSecond );
+
+
+/**
+ * Set the stream messages are written to (stdout by default).
+ * @ingroup util
+ */
+void logSetOutput( FILE* file );
+
+
+/**
+ * Wait until the writer thread has written every queued message.
+ * @ingroup util
+ */
+void logFlush();
+
+
+#endif
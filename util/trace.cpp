@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+
+#include "trace.h"
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include <atomic>
+#include <vector>
+
+
+// a completed span
+struct traceEvent
+{
+	const char* name;
+	uint64_t    begin;
+	uint64_t    end;
+	uint64_t    sequence;
+	uint32_t    stream;
+};
+
+
+// per-thread span buffer, only written by the thread that owns it.
+// head is the total number of spans recorded, published after each write.
+struct traceBuffer
+{
+	traceBuffer*          next;
+	pid_t                 tid;
+	std::atomic<uint64_t> head;
+	traceEvent            events[TRACE_BUFFER_SIZE];
+};
+
+
+// buffers of every thread that has recorded a span (never freed, so dumps stay valid)
+static std::atomic<traceBuffer*> gBuffers(NULL);
+
+static thread_local traceBuffer* tBuffer   = NULL;
+static thread_local uint32_t     tStream   = 0;
+static thread_local uint64_t     tSequence = 0;
+
+
+// traceSetContext
+void traceSetContext( uint32_t stream, uint64_t sequence )
+{
+	tStream   = stream;
+	tSequence = sequence;
+}
+
+
+// traceRecord
+void traceRecord( const char* name, uint64_t begin, uint64_t end )
+{
+	traceBuffer* buffer = tBuffer;
+
+	if( !buffer )
+	{
+		buffer = new traceBuffer();
+
+		buffer->tid  = syscall(SYS_gettid);
+		buffer->head = 0;
+		buffer->next = gBuffers.load(std::memory_order_relaxed);
+
+		while( !gBuffers.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed) );
+
+		tBuffer = buffer;
+	}
+
+	const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+	traceEvent& event = buffer->events[head % TRACE_BUFFER_SIZE];
+
+	event.name     = name;
+	event.begin    = begin;
+	event.end      = end;
+	event.stream   = tStream;
+	event.sequence = tSequence;
+
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+
+// traceDump
+bool traceDump( const char* filename )
+{
+	if( !filename )
+		return false;
+
+	FILE* file = fopen(filename, "w");
+
+	if( !file )
+	{
+		printf("trace -- failed to open %s for writing\n", filename);
+		return false;
+	}
+
+	const pid_t pid = getpid();
+
+	std::vector<traceEvent> events;
+	bool first = true;
+	uint64_t total = 0;
+
+	fprintf(file, "{\"traceEvents\":[\n");
+
+	for( traceBuffer* buffer = gBuffers.load(std::memory_order_acquire); buffer != NULL; buffer = buffer->next )
+	{
+		const uint64_t head  = buffer->head.load(std::memory_order_acquire);
+		const uint64_t begin = (head > TRACE_BUFFER_SIZE) ? head - TRACE_BUFFER_SIZE : 0;
+
+		events.clear();
+
+		for( uint64_t n=begin; n < head; n++ )
+			events.push_back(buffer->events[n % TRACE_BUFFER_SIZE]);
+
+		// drop the spans the owning thread may have overwritten while they were copied
+		const uint64_t after = buffer->head.load(std::memory_order_acquire);
+		const uint64_t valid = (after + 1 > TRACE_BUFFER_SIZE) ? after + 1 - TRACE_BUFFER_SIZE : 0;
+		const uint64_t skip  = (valid > begin) ? valid - begin : 0;
+
+		for( uint64_t n=skip; n < events.size(); n++ )
+		{
+			const traceEvent& e = events[n];
+
+			fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+					"\"args\":{\"stream\":%u,\"frame\":%llu}}",
+					first ? "" : ",\n", e.name, (int)pid, (int)buffer->tid,
+					e.begin * 0.001, (e.end - e.begin) * 0.001,
+					e.stream, (unsigned long long)e.sequence);
+
+			first = false;
+			total++;
+		}
+	}
+
+	fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+	const bool success = (ferror(file) == 0);
+	fclose(file);
+
+	printf("trace -- wrote %llu spans to %s\n", (unsigned long long)total, filename);
+	return success;
+}
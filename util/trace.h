@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+ 
+ 
+#ifndef __TRACE_UTILITY_H_
+#define __TRACE_UTILITY_H_
+
+
+#include <stdint.h>
+#include <time.h>
+
+
+/**
+ * Hot-path tracing.
+ *
+ * TRACE_SCOPE(name) records a span from the point of declaration until the
+ * end of the enclosing scope, tagged with the stream ID and frame sequence
+ * number set on the calling thread by TRACE_CONTEXT(stream, sequence).
+ * Spans are written into a per-thread buffer without taking any locks, and
+ * the most recent ones can be written out as Chrome trace JSON with
+ * traceDump() (open in chrome://tracing or https://ui.perfetto.dev).
+ *
+ * Unless the library is built with ENABLE_TRACE, the macros expand to nothing.
+ * The name passed to TRACE_SCOPE must be a string literal.
+ *
+ * Note that CUDA kernel launches are asynchronous, so their spans only cover
+ * the launch itself unless the stream is synchronized inside the scope.
+ * @ingroup util
+ */
+#ifdef ENABLE_TRACE
+	#define TRACE_CONCAT_(a, b)				a##b
+	#define TRACE_CONCAT(a, b)				TRACE_CONCAT_(a, b)
+	#define TRACE_SCOPE(name)				traceScope TRACE_CONCAT(__traceScope, __LINE__)(name)
+	#define TRACE_CONTEXT(stream, sequence)	traceSetContext(stream, sequence)
+#else
+	#define TRACE_SCOPE(name)
+	#define TRACE_CONTEXT(stream, sequence)
+#endif
+
+
+/**
+ * Number of spans kept per thread, older spans are overwritten.
+ * @ingroup util
+ */
+#define TRACE_BUFFER_SIZE 16384
+
+
+/**
+ * Monotonic timestamp in nanoseconds, used for the span times.
+ * @ingroup util
+ */
+inline uint64_t traceTime()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * Set the stream ID and frame sequence number attached to subsequent spans on this thread.
+ * @ingroup util
+ */
+void traceSetContext( uint32_t stream, uint64_t sequence );
+
+
+/**
+ * Record a completed span on the calling thread.
+ * @ingroup util
+ */
+void traceRecord( const char* name, uint64_t begin, uint64_t end );
+
+
+/**
+ * Write the spans currently held in every thread's buffer to a Chrome trace JSON file.
+ * @returns true on success, false if the file couldn't be written.
+ * @ingroup util
+ */
+bool traceDump( const char* filename );
+
+
+/**
+ * Scoped span, see TRACE_SCOPE.
+ * @ingroup util
+ */
+class traceScope
+{
+public:
+	inline traceScope( const char* name ) : mName(name), mBegin(traceTime())	{ }
+	inline ~traceScope()														{ traceRecord(mName, mBegin, traceTime()); }
+
+private:
+	traceScope( const traceScope& );
+	traceScope& operator=( const traceScope& );
+
+	const char* mName;
+	uint64_t    mBegin;
+};
+
+
+#endif